@@ -25,6 +25,7 @@
 #include <wx/numdlg.h>
 #include "ResultDialog.h"
 #include "../xLights/IPEntryDialog.h"
+#include "../xLights/utils/UDPReceiver.h"
 
 #ifndef __WXMSW__
 #include <netinet/in.h>
@@ -100,7 +101,7 @@ void xCaptureFrame::PurgeCollectedData()
     }
 }
 
-void xCaptureFrame::StashPacket(long type, wxByte* packet, int len)
+void xCaptureFrame::StashPacket(long type, const wxByte* packet, int len, wxDateTime timeStamp)
 {
     int universe = -1;
     if (type == ID_E131SOCKET)
@@ -145,7 +146,7 @@ void xCaptureFrame::StashPacket(long type, wxByte* packet, int len)
         if (it->_protocol == type && it->_universe == universe)
         {
             _capturedPackets++;
-            it->AddPacket(type, packet, len);
+            it->AddPacket(type, packet, len, timeStamp);
             return;
         }
     }
@@ -155,7 +156,7 @@ void xCaptureFrame::StashPacket(long type, wxByte* packet, int len)
 
     Collector* c = new Collector(type, universe);
     _capturedData.push_back(c);
-    c->AddPacket(type, packet, len);
+    c->AddPacket(type, packet, len, timeStamp);
     _capturedPackets++;
 }
 
@@ -215,8 +216,8 @@ xCaptureFrame::xCaptureFrame(wxWindow* parent, const std::string& showdir, const
 {
     // static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
-    _e131Socket = nullptr;
-    _artNETSocket = nullptr;
+    _e131Receiver = nullptr;
+    _artNETReceiver = nullptr;
     _capturing = false;
     _capturedPackets = 0;
     _capturedDesc = "";
@@ -381,8 +382,6 @@ xCaptureFrame::xCaptureFrame(wxWindow* parent, const std::string& showdir, const
     FileMenu->Append(quitMenItem1);
     Connect(wxID_EXIT,wxEVT_COMMAND_MENU_SELECTED,(wxObjectEventFunction)&xCaptureFrame::OnQuit);
 #endif
-    Connect(ID_E131SOCKET, wxEVT_SOCKET, (wxObjectEventFunction)&xCaptureFrame::OnE131SocketEvent);
-    Connect(ID_ARTNETSOCKET, wxEVT_SOCKET, (wxObjectEventFunction)&xCaptureFrame::OnArtNETSocketEvent);
 
     SetTitle("xLights Capture " + GetDisplayVersionString());
 
@@ -570,21 +569,19 @@ void xCaptureFrame::CloseSockets(bool force)
 {
     if (force || !CheckBox_E131->GetValue())
     {
-        if (_e131Socket != nullptr)
+        if (_e131Receiver != nullptr)
         {
-            _e131Socket->Close();
-            delete _e131Socket;
-            _e131Socket = nullptr;
+            delete _e131Receiver;
+            _e131Receiver = nullptr;
         }
     }
 
     if (force || !CheckBox_ArtNET->GetValue())
     {
-        if (_artNETSocket != nullptr)
+        if (_artNETReceiver != nullptr)
         {
-            _artNETSocket->Close();
-            delete _artNETSocket;
-            _artNETSocket = nullptr;
+            delete _artNETReceiver;
+            _artNETReceiver = nullptr;
         }
     }
 }
@@ -595,10 +592,10 @@ void xCaptureFrame::OnAbout(wxCommandEvent& event)
     wxMessageBox(about, _("Welcome to..."));
 }
 
-PacketData::PacketData(long type, wxByte* packet, int len)
+PacketData::PacketData(long type, const wxByte* packet, int len, wxDateTime timeStamp)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-    _timeStamp = wxDateTime::UNow();
+    _timeStamp = timeStamp;
     _frameTimeMS = -1;
     _seq = 0;
     _length = 0;
@@ -838,7 +835,7 @@ void xCaptureFrame::ValidateWindow()
         Button_StartStop->Enable(true);
     }
 
-    if (_artNETSocket == nullptr && _e131Socket == nullptr)
+    if (_artNETReceiver == nullptr && _e131Receiver == nullptr)
     {
         Button_StartStop->Enable(false);
     }
@@ -875,54 +872,40 @@ void xCaptureFrame::ValidateWindow()
     }
 }
 
-void xCaptureFrame::CreateE131Listener()
+std::list<int> xCaptureFrame::GetMulticastUniverses()
 {
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-    if (_e131Socket != nullptr) return;
-
-    //Local address to bind to
-    wxIPV4address addr;
-    addr.AnyAddress();
-    addr.Service(E131PORT);
-    //create and bind to the address above
-    _e131Socket = new wxDatagramSocket(addr);
-
-    if (_e131Socket->IsOk())
+    std::list<int> res;
+    for (int i = 0; i < ListView_Universes->GetItemCount(); i++)
     {
-        logger_base.debug("E131 listening on %s", (const char*)_localIP.c_str());
-
-        for (int i = 0; i < ListView_Universes->GetItemCount(); i++)
+        if (ListView_Universes->GetItemText(i) != "All")
         {
-            if (ListView_Universes->GetItemText(i) != "All")
+            int start = wxAtoi(ListView_Universes->GetItemText(i));
+            int end = wxAtoi(ListView_Universes->GetItemText(i, 1));
+            for (int u = start; u <= end; u++)
             {
-                int start = wxAtoi(ListView_Universes->GetItemText(i));
-                int end = wxAtoi(ListView_Universes->GetItemText(i, 1));
-                for (int u = start; u <= end; u++)
-                {
-                    struct ip_mreq mreq;
-                    wxString ip = wxString::Format("239.255.%d.%d", u >> 8, u & 0xFF);
-                    logger_base.debug("E131 registering for multicast on %s.", (const char *)ip.c_str());
-                    mreq.imr_multiaddr.s_addr = inet_addr(ip.c_str());
-                    mreq.imr_interface.s_addr = inet_addr(_localIP.c_str()); // this will only listen on the default interface
-                    if (!_e131Socket->SetOption(IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char *)&mreq, sizeof(mreq)))
-                    {
-                        logger_base.warn("    Error opening E131 multicast listener %s.", (const char *)ip.c_str());
-                    }
-                }
+                res.push_back(u);
             }
         }
+    }
+    return res;
+}
+
+void xCaptureFrame::CreateE131Listener()
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    if (_e131Receiver != nullptr) return;
+
+    // packets are read on the receivers own thread and handed to us to stash on the UI thread
+    _e131Receiver = new UDPReceiver(UDPReceiver::PROTOCOL::E131, "", _localIP.ToStdString(), GetMulticastUniverses(), [this]() { CallAfter(&xCaptureFrame::DrainReceivers); });
 
-        //enable event handling
-        _e131Socket->SetEventHandler(*this, ID_E131SOCKET);
-        //Notify us about incomming data
-        _e131Socket->SetNotify(wxSOCKET_INPUT_FLAG);
-        //enable event handling
-        _e131Socket->Notify(true);
+    if (_e131Receiver->IsOk())
+    {
+        logger_base.debug("E131 listening on %s", (const char*)_localIP.c_str());
     }
     else
     {
-        delete _e131Socket;
-        _e131Socket = nullptr;
+        delete _e131Receiver;
+        _e131Receiver = nullptr;
         logger_base.warn("Error opening socket to listen for e131 data");
         wxMessageBox("Error listening for E1.31 data.");
     }
@@ -931,51 +914,18 @@ void xCaptureFrame::CreateE131Listener()
 void xCaptureFrame::CreateArtNETListener()
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-    if (_artNETSocket != nullptr) return;
+    if (_artNETReceiver != nullptr) return;
 
-    //Local address to bind to
-    wxIPV4address addr;
-    addr.AnyAddress();
-    addr.Service(ARTNETPORT);
-    //create and bind to the address above
-    _artNETSocket = new wxDatagramSocket(addr);
+    _artNETReceiver = new UDPReceiver(UDPReceiver::PROTOCOL::ARTNET, "", _localIP.ToStdString(), {}, [this]() { CallAfter(&xCaptureFrame::DrainReceivers); });
 
-    if (_artNETSocket->IsOk())
+    if (_artNETReceiver->IsOk())
     {
         logger_base.debug("ARTNet listening on %s", (const char*)_localIP.c_str());
-
-        for (int i = 0; i < ListView_Universes->GetItemCount(); i++)
-        {
-            if (ListView_Universes->GetItemText(i) != "All")
-            {
-                int start = wxAtoi(ListView_Universes->GetItemText(i));
-                int end = wxAtoi(ListView_Universes->GetItemText(i, 1));
-                for (int u = start; u <= end; u++)
-                {
-                    struct ip_mreq mreq;
-                    wxString ip = wxString::Format("239.255.%d.%d", u >> 8, u & 0xFF);
-                    logger_base.debug("ARTNet registering for multicast on %s.", (const char *)ip.c_str());
-                    mreq.imr_multiaddr.s_addr = inet_addr(ip.c_str());
-                    mreq.imr_interface.s_addr = inet_addr(_localIP.c_str()); // this will only listen on the default interface
-                    if (!_artNETSocket->SetOption(IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char *)&mreq, sizeof(mreq)))
-                    {
-                        logger_base.warn("    Error opening ARTNet multicast listener %s.", (const char *)ip.c_str());
-                    }
-                }
-            }
-        }
-
-        //enable event handling
-        _artNETSocket->SetEventHandler(*this, ID_ARTNETSOCKET);
-        //Notify us about incomming data
-        _artNETSocket->SetNotify(wxSOCKET_INPUT_FLAG);
-        //enable event handling
-        _artNETSocket->Notify(true);
     }
     else
     {
-        delete _artNETSocket;
-        _artNETSocket = nullptr;
+        delete _artNETReceiver;
+        _artNETReceiver = nullptr;
         logger_base.warn("Error opening socket to listen for ArtNET data");
         wxMessageBox("Error listening for E1.ArtNET data.");
     }
@@ -1260,6 +1210,8 @@ void xCaptureFrame::OnButton_ClearClick(wxCommandEvent& event)
 {
     _capturedDesc = "";
     _capturedPackets = 0;
+    if (_e131Receiver != nullptr) _e131Receiver->ResetStats();
+    if (_artNETReceiver != nullptr) _artNETReceiver->ResetStats();
     PurgeCollectedData();
     ValidateWindow();
 }
@@ -1284,59 +1236,19 @@ void xCaptureFrame::OnCheckBox_ArtNETClick(wxCommandEvent& event)
     ValidateWindow();
 }
 
-void xCaptureFrame::OnE131SocketEvent(wxSocketEvent& event)
+void xCaptureFrame::DrainReceivers()
 {
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-
-    wxIPV4address addr;
-    addr.Service(E131PORT);
-    wxByte buf[126+512];
-    switch (event.GetSocketEvent())
-    {
-    case wxSOCKET_INPUT:
+    if (_e131Receiver != nullptr)
     {
-        _e131Socket->Notify(false);
-        size_t n = _e131Socket->RecvFrom(addr, buf, sizeof(buf)).LastCount();
-        if (!n) {
-            logger_base.error("ERROR: failed to receive E131 data");
-            return;
-        }
-        //logger_base.debug("E131 packet received.");
-        StashPacket(ID_E131SOCKET, buf, n);
-        _e131Socket->Notify(true);
-    }
-        break;
-    default:
-        logger_base.warn("OnE131SocketEvent: Unexpected event !");
-        break;
+        _e131Receiver->Drain([this](const UDPReceiver::Packet& p) {
+            StashPacket(ID_E131SOCKET, p._data, p._size, wxDateTime(wxLongLong((wxLongLong_t)p._timeMS)));
+        });
     }
-}
-
-void xCaptureFrame::OnArtNETSocketEvent(wxSocketEvent & event)
-{
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-
-    wxIPV4address addr;
-    addr.Service(ARTNETPORT);
-    wxByte buf[18 + 512];
-    switch (event.GetSocketEvent())
-    {
-    case wxSOCKET_INPUT:
+    if (_artNETReceiver != nullptr)
     {
-        _artNETSocket->Notify(false);
-        size_t n = _artNETSocket->RecvFrom(addr, buf, sizeof(buf)).LastCount();
-        if (!n) {
-            logger_base.error("ERROR: failed to receive ArtNET data");
-            return;
-        }
-        //logger_base.debug("ArtNet packet received.");
-        StashPacket(ID_ARTNETSOCKET, buf, n);
-        _artNETSocket->Notify(true);
-    }
-        break;
-    default:
-        logger_base.warn("OnArtNETSocketEvent: Unexpected event !");
-        break;
+        _artNETReceiver->Drain([this](const UDPReceiver::Packet& p) {
+            StashPacket(ID_ARTNETSOCKET, p._data, p._size, wxDateTime(wxLongLong((wxLongLong_t)p._timeMS)));
+        });
     }
 }
 
@@ -1374,7 +1286,28 @@ void xCaptureFrame::OnButton_DeleteClick(wxCommandEvent& event)
 
 void xCaptureFrame::OnUITimerTrigger(wxTimerEvent& event)
 {
-    StatusBar1->SetStatusText(wxString::Format("Universes: %d Total Packets: %ld %s", (int)_capturedData.size(), _capturedPackets, _capturedDesc));
+    // lost is what the sequence numbers say never arrived ... dropped is what arrived but we were too slow to keep
+    uint64_t lost = 0;
+    uint64_t dropped = 0;
+    if (_e131Receiver != nullptr)
+    {
+        lost += _e131Receiver->GetLost();
+        dropped += _e131Receiver->GetOverflowed();
+    }
+    if (_artNETReceiver != nullptr)
+    {
+        lost += _artNETReceiver->GetLost();
+        dropped += _artNETReceiver->GetOverflowed();
+    }
+
+    if (lost == 0 && dropped == 0)
+    {
+        StatusBar1->SetStatusText(wxString::Format("Universes: %d Total Packets: %ld %s", (int)_capturedData.size(), _capturedPackets, _capturedDesc));
+    }
+    else
+    {
+        StatusBar1->SetStatusText(wxString::Format("Universes: %d Total Packets: %ld Lost: %llu Dropped: %llu %s", (int)_capturedData.size(), _capturedPackets, (unsigned long long)lost, (unsigned long long)dropped, _capturedDesc));
+    }
 }
 
 void xCaptureFrame::SaveFSEQ(wxString file, int frameMS, long channelsPerFrame, int frames, wxString& log)
@@ -1641,6 +1574,33 @@ void xCaptureFrame::OnButton_AnalyseClick(wxCommandEvent& event)
     }
     log += wxString::Format("Channel Structure End!\n");
 
+    // sequence gaps seen by the receivers
+    std::map<uint32_t, UDPReceiver::UniverseStats> e131Stats;
+    std::map<uint32_t, UDPReceiver::UniverseStats> artNETStats;
+    if (_e131Receiver != nullptr) e131Stats = _e131Receiver->GetUniverseStats();
+    if (_artNETReceiver != nullptr) artNETStats = _artNETReceiver->GetUniverseStats();
+    log += wxString::Format("Receive Statistics Start:\n");
+    for (const auto& it : _capturedData)
+    {
+        auto& stats = it->_protocol == ID_E131SOCKET ? e131Stats : artNETStats;
+        auto s = stats.find(it->_universe);
+        if (s != stats.end())
+        {
+            log += wxString::Format("Protocol %s, Universe %d, Packets %llu, Lost %llu, Out Of Order %llu\n",
+                it->_protocol == ID_E131SOCKET ? "E131" : "ArtNET", it->_universe,
+                (unsigned long long)s->second._packets, (unsigned long long)s->second._lost, (unsigned long long)s->second._outOfOrder);
+        }
+    }
+    if (_e131Receiver != nullptr && _e131Receiver->GetOverflowed() > 0)
+    {
+        log += wxString::Format("E131 packets dropped because we could not keep up: %llu\n", (unsigned long long)_e131Receiver->GetOverflowed());
+    }
+    if (_artNETReceiver != nullptr && _artNETReceiver->GetOverflowed() > 0)
+    {
+        log += wxString::Format("ArtNET packets dropped because we could not keep up: %llu\n", (unsigned long long)_artNETReceiver->GetOverflowed());
+    }
+    log += wxString::Format("Receive Statistics End!\n");
+
     ResultDialog dlgLog(this, log);
     dlgLog.ShowModal();
 }
@@ -43,7 +43,7 @@
 #include <wx/socket.h>
 
 class wxDebugReportCompress;
-class wxDatagramSocket;
+class UDPReceiver;
 
 class PacketData
 {
@@ -54,7 +54,7 @@ public:
     wxByte* _pdata;
     int _frameTimeMS;
     virtual ~PacketData() { if (_pdata != nullptr) free(_pdata); }
-    PacketData(long type, wxByte* packet, int len);
+    PacketData(long type, const wxByte* packet, int len, wxDateTime timeStamp);
     PacketData(PacketData& pd, int seq, int time);
 };
 
@@ -69,7 +69,7 @@ public:
     std::list<PacketData*> _packets;
     virtual ~Collector();
     Collector(long type, int universe) { _startChannel = -1; _universe = universe; _protocol = type; }
-    void AddPacket(long type, wxByte* packet, int len) { _packets.push_back(new PacketData(type, packet, len)); }
+    void AddPacket(long type, const wxByte* packet, int len, wxDateTime timeStamp) { _packets.push_back(new PacketData(type, packet, len, timeStamp)); }
     void CalculateFrames(wxDateTime startTime, int frameMS);
     PacketData* GetPacket(long ms);
     bool operator<(const Collector& c) const;
@@ -81,8 +81,8 @@ class xCaptureFrame : public xlFrame
     void ValidateWindow();
 
     std::list<Collector*> _capturedData;
-    wxDatagramSocket* _e131Socket;
-    wxDatagramSocket* _artNETSocket;
+    UDPReceiver* _e131Receiver;
+    UDPReceiver* _artNETReceiver;
     bool _capturing;
     long _capturedPackets;
     std::string _capturedDesc;
@@ -95,7 +95,9 @@ class xCaptureFrame : public xlFrame
     void CreateArtNETListener();
     void AddUniverseRange(int low, int high);
     void PurgeCollectedData();
-    void StashPacket(long type, wxByte* packet, int len);
+    void StashPacket(long type, const wxByte* packet, int len, wxDateTime timeStamp);
+    void DrainReceivers();
+    std::list<int> GetMulticastUniverses();
     bool IsUniverseToBeCaptured(int universe, bool ignoreall = false);
     int GuessFrameMS();
     long GetChannelsPerFrame();
@@ -220,9 +222,6 @@ private:
         //*)
 
         DECLARE_EVENT_TABLE()
-
-        void OnE131SocketEvent(wxSocketEvent& event);
-        void OnArtNETSocketEvent(wxSocketEvent& event);
 };
 
 #endif // xCAPTUREMAIN_H
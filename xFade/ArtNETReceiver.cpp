@@ -9,6 +9,11 @@
 #include "PacketData.h"
 #include "UniverseData.h"
 #include "../xLights/UtilFunctions.h"
+#include "../xLights/utils/UDPReceiver.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 #include <log4cpp/Category.hh>
 
@@ -56,65 +61,39 @@ public:
         static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
         logger_base.debug("artNET Receiver thread started");
 
-        wxIPV4address addr;
-        if (_localIP == "")
-        {
-            addr.AnyAddress();
-        }
-        else
-        {
-            addr.Hostname(_localIP.c_str());
-        }
-        addr.Service(ARTNETPORT);
-        //create and bind to the address above
-        wxDatagramSocket* artNETSocketReceive = new wxDatagramSocket(addr);
-
-        if (artNETSocketReceive == nullptr)
-        {
-            logger_base.error("Problem listening for artNET. artNET Receiver thread exiting.");
-            return nullptr;
-        }
-        else if (!artNETSocketReceive->IsOk())
+        // the receiver empties the socket on its own thread ... we just process what it hands over
+        std::mutex lock;
+        std::condition_variable signal;
+        bool ready = false;
+        UDPReceiver receiver(UDPReceiver::PROTOCOL::ARTNET, _localIP, _localIP, {}, [&lock, &signal, &ready]() {
+            std::unique_lock<std::mutex> l(lock);
+            ready = true;
+            signal.notify_all();
+        });
+
+        if (!receiver.IsOk())
         {
             logger_base.error("Problem listening for artNET. artNET Receiver thread exiting.");
-            delete artNETSocketReceive;
-            artNETSocketReceive = nullptr;
             return nullptr;
         }
-        else if (artNETSocketReceive->Error() != wxSOCKET_NOERROR)
-        {
-            logger_base.error("Problem listening for artNET => %d : %s, from %s.", artNETSocketReceive->LastError(), (const char*)DecodeIPError(artNETSocketReceive->LastError()).c_str(), (const char*)addr.IPAddress().c_str());
-            delete artNETSocketReceive;
-            artNETSocketReceive = nullptr;
-            return nullptr;
-        }
-
-        logger_base.debug("artNET listening on %s", (const char*)addr.IPAddress().c_str());
-
-        artNETSocketReceive->Notify(false);
-        artNETSocketReceive->SetTimeout(1);
-
-        uint8_t buffer[ARTNET_PACKET_HEADERLEN + 512];
 
         while (!_stop)
         {
-            memset(buffer, 0x00, sizeof(buffer));
+            {
+                std::unique_lock<std::mutex> l(lock);
+                signal.wait_for(l, std::chrono::milliseconds(100), [&ready]() { return ready; });
+                ready = false;
+            }
 
-            artNETSocketReceive->Read(buffer, sizeof(buffer));
             if (!_stop)
             {
-                //logger_base.debug(" Read done. %ldms", sw.Time());
-                int read = artNETSocketReceive->GetLastIOReadSize();
-                _receiver->StashPacket(buffer, read);
+                receiver.Drain([this](const UDPReceiver::Packet& p) {
+                    _receiver->StashPacket((uint8_t*)p._data, p._size);
+                });
             }
         }
 
-        if (artNETSocketReceive != nullptr)
-        {
-            artNETSocketReceive->Close();
-            delete artNETSocketReceive;
-            artNETSocketReceive = nullptr;
-        }
+        receiver.Stop();
 
         logger_base.debug("artNET Receiving thread exiting.");
         return nullptr;
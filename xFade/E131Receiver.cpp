@@ -9,6 +9,11 @@
 #include "PacketData.h"
 #include "UniverseData.h"
 #include "../xLights/UtilFunctions.h"
+#include "../xLights/utils/UDPReceiver.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 #include <log4cpp/Category.hh>
 
@@ -59,82 +64,39 @@ public:
         static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
         logger_base.debug("E131 Receiver thread started");
 
-        wxIPV4address addr;
-        if (_localIP == "")
-        {
-            addr.AnyAddress();
-        }
-        else
-        {
-            addr.Hostname(_localIP.c_str());
-        }
-        addr.Service(E131PORT);
-        //create and bind to the address above
-        wxDatagramSocket* e131SocketReceive = new wxDatagramSocket(addr);
-
-        if (e131SocketReceive == nullptr)
-        {
-            logger_base.error("Problem listening for e131. E131 Receiver thread exiting.");
-            return nullptr;
-        }
-        else if (!e131SocketReceive->IsOk())
-        {
-            logger_base.error("Problem listening for e131. E131 Receiver thread exiting.");
-            delete e131SocketReceive;
-            e131SocketReceive = nullptr;
-            return nullptr;
-        }
-        else if (e131SocketReceive->Error() != wxSOCKET_NOERROR)
+        // the receiver empties the socket on its own thread ... we just process what it hands over
+        std::mutex lock;
+        std::condition_variable signal;
+        bool ready = false;
+        UDPReceiver receiver(UDPReceiver::PROTOCOL::E131, _localIP, _localIP, _universes, [&lock, &signal, &ready]() {
+            std::unique_lock<std::mutex> l(lock);
+            ready = true;
+            signal.notify_all();
+        });
+
+        if (!receiver.IsOk())
         {
-            logger_base.error("Problem listening for e131 => %d : %s, from %s.", e131SocketReceive->LastError(), (const char*)DecodeIPError(e131SocketReceive->LastError()).c_str(), (const char*)addr.IPAddress().c_str());
-            delete e131SocketReceive;
-            e131SocketReceive = nullptr;
+            logger_base.error("Problem listening for e131. e131 Receiver thread exiting.");
             return nullptr;
         }
 
-        logger_base.debug("E131 listening on %s", (const char*)addr.IPAddress().c_str());
-
-        for (const auto& it : _universes)
+        while (!_stop)
         {
-            struct ip_mreq mreq;
-            wxString ip = wxString::Format("239.255.%d.%d", it >> 8, it & 0xFF);
-            logger_base.debug("E131 registering for multicast on %s.", (const char*)ip.c_str());
-            mreq.imr_multiaddr.s_addr = inet_addr(ip.c_str());
-            mreq.imr_interface.s_addr = inet_addr(_localIP.c_str()); // this will only listen on the default interface
-            if (!e131SocketReceive->SetOption(IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char*)& mreq, sizeof(mreq)))
-            {
-                logger_base.warn("    Error opening E131 multicast listener %s.", (const char*)ip.c_str());
-            }
-            else
             {
-                logger_base.debug("    E131 multicast listener %s registered.", (const char*)ip.c_str());
+                std::unique_lock<std::mutex> l(lock);
+                signal.wait_for(l, std::chrono::milliseconds(100), [&ready]() { return ready; });
+                ready = false;
             }
-        }
-
-        e131SocketReceive->Notify(false);
-        e131SocketReceive->SetTimeout(1);
 
-        uint8_t buffer[E131_PACKET_HEADERLEN + 512];
-
-        while (!_stop)
-        {
-            memset(buffer, 0x00, sizeof(buffer));
-
-            e131SocketReceive->Read(buffer, sizeof(buffer));
             if (!_stop)
             {
-                //logger_base.debug(" Read done. %ldms", sw.Time());
-                int read = e131SocketReceive->GetLastIOReadSize();
-                if (read > 0) _receiver->StashPacket(buffer, read);
+                receiver.Drain([this](const UDPReceiver::Packet& p) {
+                    _receiver->StashPacket((uint8_t*)p._data, p._size);
+                });
             }
         }
 
-        if (e131SocketReceive != nullptr)
-        {
-            e131SocketReceive->Close();
-            delete e131SocketReceive;
-            e131SocketReceive = nullptr;
-        }
+        receiver.Stop();
 
         logger_base.debug("E131 Receiving thread exiting.");
         return nullptr;
@@ -0,0 +1,203 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "MockHTTPServer.h"
+
+#include <wx/socket.h>
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    std::string Lower(std::string s)
+    {
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return s;
+    }
+
+    std::string ReasonPhrase(int code)
+    {
+        switch (code) {
+        case 200:
+            return "OK";
+        case 401:
+            return "Unauthorized";
+        case 404:
+            return "Not Found";
+        default:
+            return "Error";
+        }
+    }
+
+    bool Write(wxSocketBase* socket, const std::string& s)
+    {
+        socket->Write(s.data(), s.size());
+        return !socket->Error() && socket->LastCount() == s.size();
+    }
+}
+
+MockHTTPServer::MockHTTPServer(Handler&& handler) :
+    _handler(handler)
+{
+    wxSocketBase::Initialize();
+
+    wxIPV4address addr;
+    addr.Hostname("127.0.0.1");
+    addr.Service(0);
+    _server = new wxSocketServer(addr, wxSOCKET_BLOCK | wxSOCKET_REUSEADDR);
+    if (!_server->IsOk()) {
+        return;
+    }
+    wxIPV4address local;
+    if (_server->GetLocal(local)) {
+        _port = local.Service();
+    }
+    if (_port != 0) {
+        _listener = std::thread(&MockHTTPServer::Listen, this);
+    }
+}
+
+MockHTTPServer::~MockHTTPServer()
+{
+    _stop = true;
+    if (_listener.joinable()) {
+        _listener.join();
+    }
+    for (auto& it : _threads) {
+        it.join();
+    }
+    delete _server;
+}
+
+std::string MockHTTPServer::GetHost() const
+{
+    return "127.0.0.1:" + std::to_string(_port);
+}
+
+std::vector<MockHTTPServer::Request> MockHTTPServer::GetRequests() const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    return _requests;
+}
+
+void MockHTTPServer::ClearRequests()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _requests.clear();
+}
+
+void MockHTTPServer::Listen()
+{
+    while (!_stop) {
+        if (_server->WaitForAccept(0, 100)) {
+            wxSocketBase* socket = _server->Accept(false);
+            if (socket != nullptr) {
+                ++_connections;
+                _threads.emplace_back(&MockHTTPServer::Serve, this, socket);
+            }
+        }
+    }
+}
+
+void MockHTTPServer::Serve(wxSocketBase* socket)
+{
+    socket->SetFlags(wxSOCKET_BLOCK | wxSOCKET_WAITALL_WRITE);
+    socket->SetTimeout(5);
+
+    std::string buffer;
+    Request request;
+    while (ReadRequest(socket, buffer, request)) {
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _requests.push_back(request);
+        }
+        Response response = _handler(request);
+        std::string header = "HTTP/1.1 " + std::to_string(response.code) + " " + ReasonPhrase(response.code) + "\r\n" +
+                             "Content-Type: " + response.contentType + "\r\n" +
+                             "Content-Length: " + std::to_string(response.body.size()) + "\r\n\r\n";
+        if (!Write(socket, header + response.body) || request.close) {
+            break;
+        }
+    }
+    socket->Close();
+    delete socket;
+}
+
+// reads the next request on the connection into request. Anything read past its end is left in buffer
+bool MockHTTPServer::ReadRequest(wxSocketBase* socket, std::string& buffer, Request& request)
+{
+    auto readMore = [this, socket, &buffer]() {
+        char data[64 * 1024];
+        while (!_stop) {
+            // true when there is data or the connection has gone
+            if (socket->WaitForRead(0, 100)) {
+                socket->Read(data, sizeof(data));
+                if (socket->LastCount() == 0) {
+                    return false;
+                }
+                buffer.append(data, socket->LastCount());
+                return true;
+            }
+        }
+        return false;
+    };
+
+    size_t headerEnd;
+    while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+        if (!readMore()) {
+            return false;
+        }
+    }
+
+    std::string header = buffer.substr(0, headerEnd);
+    buffer.erase(0, headerEnd + 4);
+
+    size_t lineEnd = header.find("\r\n");
+    std::string requestLine = header.substr(0, lineEnd);
+    size_t methodEnd = requestLine.find(' ');
+    size_t pathEnd = requestLine.find(' ', methodEnd + 1);
+    if (methodEnd == std::string::npos || pathEnd == std::string::npos) {
+        return false;
+    }
+    request.method = requestLine.substr(0, methodEnd);
+    request.path = requestLine.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+    request.body.clear();
+    request.close = requestLine.substr(pathEnd + 1) == "HTTP/1.0";
+
+    size_t length = 0;
+    bool expectContinue = false;
+    while (lineEnd != std::string::npos) {
+        size_t start = lineEnd + 2;
+        lineEnd = header.find("\r\n", start);
+        std::string line = Lower(header.substr(start, lineEnd == std::string::npos ? std::string::npos : lineEnd - start));
+        if (line.rfind("content-length:", 0) == 0) {
+            length = std::stoul(line.substr(15));
+        } else if (line.rfind("expect:", 0) == 0 && line.find("100-continue") != std::string::npos) {
+            expectContinue = true;
+        } else if (line.rfind("connection:", 0) == 0) {
+            request.close = line.find("close") != std::string::npos;
+        }
+    }
+
+    if (expectContinue && length > buffer.size() && !Write(socket, "HTTP/1.1 100 Continue\r\n\r\n")) {
+        return false;
+    }
+    while (buffer.size() < length) {
+        if (!readMore()) {
+            return false;
+        }
+    }
+    request.body.assign(buffer.begin(), buffer.begin() + length);
+    buffer.erase(0, length);
+    return true;
+}
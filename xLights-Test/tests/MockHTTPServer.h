@@ -0,0 +1,76 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+class wxSocketBase;
+class wxSocketServer;
+
+// A stand in for a controller's web server listening on a free port of 127.0.0.1.
+//
+// Each connection is served on its own thread and kept alive for as many requests as the client
+// sends. Every request is handed to the handler, which may be called on several threads at once,
+// and recorded so a test can check what was asked for.
+class MockHTTPServer
+{
+public:
+    struct Request
+    {
+        std::string method;
+        std::string path;
+        std::vector<uint8_t> body;
+        bool close = false; // HTTP/1.0 or Connection: close ... the connection ends after the response
+    };
+
+    struct Response
+    {
+        int code = 200;
+        std::string body;
+        std::string contentType = "application/json";
+    };
+
+    typedef std::function<Response(const Request&)> Handler;
+
+    // must be created on the main thread
+    explicit MockHTTPServer(Handler&& handler);
+    virtual ~MockHTTPServer();
+
+    bool IsOk() const { return _port != 0; }
+    // "127.0.0.1:<port>"
+    std::string GetHost() const;
+    std::vector<Request> GetRequests() const;
+    size_t GetConnections() const { return _connections; }
+    void ClearRequests();
+
+private:
+    void Listen();
+    void Serve(wxSocketBase* socket);
+    bool ReadRequest(wxSocketBase* socket, std::string& buffer, Request& request);
+
+    Handler _handler;
+    wxSocketServer* _server = nullptr;
+    int _port = 0;
+    std::atomic<bool> _stop = false;
+    std::atomic<size_t> _connections = 0;
+    std::thread _listener;
+    std::list<std::thread> _threads; // only touched by the listener
+    mutable std::mutex _lock;
+    std::vector<Request> _requests;
+};
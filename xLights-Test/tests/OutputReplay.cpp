@@ -0,0 +1,291 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "OutputReplay.h"
+
+#include "../xLights/FSEQFile.h"
+#include "../xLights/outputs/ControllerEthernet.h"
+#include "../xLights/outputs/DDPOutput.h"
+#include "../xLights/outputs/Output.h"
+#include "../xLights/outputs/OutputManager.h"
+#include "../xLights/utils/UDPReceiver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+OutputReplay::OutputReplay(OutputManager* outputManager) :
+    _outputManager(outputManager)
+{
+}
+
+ControllerEthernet* OutputReplay::AddLoopbackController(OutputManager& om, const std::string& protocol, int32_t channels)
+{
+    auto c = new ControllerEthernet(&om, true);
+    c->SetProtocol(protocol);
+    c->SetIP("127.0.0.1");
+    if (protocol == OUTPUT_E131 || protocol == OUTPUT_ARTNET || protocol == OUTPUT_KINET) {
+        c->GetFirstOutput()->SetChannels(510);
+        while (c->GetOutputCount() * 510 < channels) {
+            c->AddOutput();
+        }
+        c->GetOutputs().back()->SetChannels(channels - (c->GetOutputCount() - 1) * 510);
+    } else {
+        c->GetFirstOutput()->SetChannels(channels);
+    }
+    om.AddController(c, -1);
+    return c;
+}
+
+bool OutputReplay::CreateTestSequence(const std::string& fseq, uint32_t channels, uint32_t frames, int frameMS)
+{
+    std::unique_ptr<FSEQFile> file(FSEQFile::createFSEQFile(fseq, 2, FSEQFile::CompressionType::zstd));
+    if (file == nullptr) return false;
+
+    file->setChannelCount(channels);
+    file->setStepTime(frameMS);
+    file->setNumFrames(frames);
+    file->writeHeader();
+
+    // every third universe sized block stays the same so the unchanged output paths get exercised too
+    std::vector<uint8_t> data(channels);
+    for (uint32_t f = 0; f < frames; f++) {
+        for (uint32_t c = 0; c < channels; c++) {
+            data[c] = (uint8_t)(c + f * ((c / 510) % 3));
+        }
+        file->addFrame(f, data.data());
+    }
+    file->finalize();
+    return true;
+}
+
+OutputReplay::Target* OutputReplay::Match(const std::string& protocol, const uint8_t* packet, size_t size, int32_t& start, const uint8_t*& data, size_t& channels)
+{
+    if (protocol == OUTPUT_E131) {
+        if (size < 126 || memcmp(&packet[4], "ASC-E1.17", 9) != 0) return nullptr;
+        int universe = ((int)packet[113] << 8) + (int)packet[114];
+        for (auto& t : _targets) {
+            if (t.protocol == protocol && t.output->GetUniverse() == universe) {
+                start = t.start;
+                data = &packet[126];
+                channels = size - 126;
+                return &t;
+            }
+        }
+    } else if (protocol == OUTPUT_ARTNET) {
+        if (size < 18 || memcmp(packet, "Art-Net", 8) != 0 || packet[9] != 0x50) return nullptr;
+        int universe = ((int)packet[15] << 8) + (int)packet[14];
+        for (auto& t : _targets) {
+            if (t.protocol == protocol && t.output->GetUniverse() == universe) {
+                start = t.start;
+                data = &packet[18];
+                channels = std::min(size - 18, (size_t)(((int)packet[16] << 8) + (int)packet[17]));
+                return &t;
+            }
+        }
+    } else if (protocol == OUTPUT_DDP) {
+        size_t header = (packet[0] & DDP_FLAGS1_TIMECODE) ? 14 : 10;
+        if (size < header || packet[3] != DDP_ID_DISPLAY) return nullptr;
+        int32_t offset = ((int32_t)packet[4] << 24) + ((int32_t)packet[5] << 16) + ((int32_t)packet[6] << 8) + (int32_t)packet[7];
+        for (auto& t : _targets) {
+            if (t.protocol == protocol && offset >= t.start && offset < t.start + t.channels) {
+                start = offset;
+                data = &packet[header];
+                channels = std::min(size - header, (size_t)(((int)packet[8] << 8) + (int)packet[9]));
+                return &t;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void OutputReplay::Check(const std::string& protocol, const uint8_t* packet, size_t size, uint64_t timeMS, const std::vector<uint8_t>& frame, int64_t frameIndex, bool late, Report& report)
+{
+    int32_t start = 0;
+    const uint8_t* data = nullptr;
+    size_t channels = 0;
+    Target* t = Match(protocol, packet, size, start, data, channels);
+    if (t == nullptr) {
+        report.unmatched++;
+        return;
+    }
+
+    auto& o = report.outputs[t->report];
+    report.received++;
+    o.packets++;
+    if (late) {
+        report.late++;
+    }
+
+    bool const whole = protocol == OUTPUT_DDP || channels == (size_t)t->channels;
+    if (!whole || start + channels > frame.size() || memcmp(&frame[start], data, channels) != 0) {
+        report.mismatched++;
+        o.mismatched++;
+    }
+
+    // jitter is measured between the first packets of consecutive frames
+    if (t->lastFrame != frameIndex) {
+        if (t->lastFrame == frameIndex - 1) {
+            double jitter = std::abs((double)(int64_t)(timeMS - t->lastArrivalMS) - report.frameMS);
+            t->jitterSamples++;
+            t->jitterTotalMS += jitter;
+            o.maxJitterMS = std::max(o.maxJitterMS, jitter);
+            o.meanJitterMS = t->jitterTotalMS / t->jitterSamples;
+        }
+        t->lastFrame = frameIndex;
+        t->lastArrivalMS = timeMS;
+    }
+}
+
+bool OutputReplay::Run(const std::string& fseq, Report& report)
+{
+    report = Report();
+
+    std::unique_ptr<FSEQFile> file(FSEQFile::openFSEQFile(fseq));
+    if (file == nullptr) return false;
+
+    report.frames = file->getNumFrames();
+    report.frameMS = file->getStepTime();
+    if (report.frameMS <= 0) return false;
+
+    _targets.clear();
+    for (const auto& it : _outputManager->GetAllOutputs()) {
+        if (!it->IsEnabled()) continue;
+        auto const type = it->GetType();
+        if (type != OUTPUT_E131 && type != OUTPUT_ARTNET && type != OUTPUT_DDP) continue;
+
+        Target t;
+        t.output = it;
+        t.protocol = type;
+        t.start = it->GetStartChannel() - 1;
+        t.channels = it->GetChannels();
+        t.packets = 1;
+        OutputReport o;
+        o.name = type + " " + std::to_string(type == OUTPUT_DDP ? it->GetStartChannel() : it->GetUniverse());
+        if (type == OUTPUT_DDP) {
+            auto ddp = dynamic_cast<DDPOutput*>(it);
+            // without absolute channel numbers packets from different DDP outputs cannot be told apart
+            if (ddp == nullptr || !ddp->IsKeepChannelNumbers()) return false;
+            t.packets = (t.channels + ddp->GetChannelsPerPacket() - 1) / ddp->GetChannelsPerPacket();
+        }
+        t.report = report.outputs.size();
+        report.outputs.push_back(o);
+        _targets.push_back(t);
+    }
+
+    // size each receiver for the packets a frame of its outputs sends
+    std::map<std::string, size_t> expected;
+    for (const auto& t : _targets) {
+        expected[t.protocol] += t.packets;
+    }
+    std::map<std::string, std::unique_ptr<UDPReceiver>> receivers;
+    for (const auto& t : _targets) {
+        if (receivers.find(t.protocol) != receivers.end()) continue;
+        auto protocol = t.protocol == OUTPUT_E131 ? UDPReceiver::PROTOCOL::E131 : (t.protocol == OUTPUT_ARTNET ? UDPReceiver::PROTOCOL::ARTNET : UDPReceiver::PROTOCOL::DDP);
+        receivers[t.protocol] = std::make_unique<UDPReceiver>(protocol, "127.0.0.1", "", std::list<int>(), nullptr, expected[t.protocol]);
+        if (!receivers[t.protocol]->IsOk()) return false;
+    }
+
+    int packetsPerFrame = 0;
+    for (const auto& t : _targets) {
+        packetsPerFrame += t.packets;
+    }
+
+    // what was sent for this frame and the last one. Channels past the end of the sequence stay off
+    size_t const sequenceChannels = file->getChannelCount();
+    std::vector<uint8_t> all(std::max((size_t)_outputManager->GetTotalChannels(), sequenceChannels));
+    std::vector<uint8_t> last(all.size());
+
+    auto drain = [&](const std::vector<uint8_t>& data, int64_t frameIndex, bool late) {
+        size_t count = 0;
+        for (auto& it : receivers) {
+            auto const& protocol = it.first;
+            count += it.second->Drain([&](const UDPReceiver::Packet& p) {
+                Check(protocol, p._data, p._size, p._timeMS, data, frameIndex, late, report);
+            });
+        }
+        return count;
+    };
+
+    if (!_outputManager->StartOutput()) return false;
+
+    double totalSendMS = 0;
+    auto const begin = std::chrono::steady_clock::now();
+    for (uint32_t f = 0; f < report.frames; f++) {
+        // anything still to come in from the last frame arrived after this one was due
+        if (f > 0) {
+            drain(last, f - 1, true);
+        }
+
+        file->readFrame(f, all.data(), sequenceChannels);
+
+        auto const sendStart = std::chrono::steady_clock::now();
+        _outputManager->StartFrame(f * report.frameMS);
+        _outputManager->SetFrame(all.data(), _outputManager->GetTotalChannels());
+        _outputManager->EndFrame();
+        double const sendMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sendStart).count();
+        totalSendMS += sendMS;
+        report.maxSendMS = std::max(report.maxSendMS, sendMS);
+        report.expected += packetsPerFrame;
+
+        auto const due = begin + std::chrono::milliseconds((f + 1) * report.frameMS);
+        size_t got = 0;
+        while (got < (size_t)packetsPerFrame && std::chrono::steady_clock::now() < due) {
+            got += drain(all, f, false);
+            if (got < (size_t)packetsPerFrame) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        std::this_thread::sleep_until(due);
+        std::swap(last, all);
+    }
+    if (report.frames > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(report.frameMS));
+        drain(last, report.frames - 1, true);
+    }
+
+    _outputManager->StopOutput();
+
+    report.missing = report.expected > report.received ? report.expected - report.received : 0;
+    report.meanSendMS = report.frames == 0 ? 0 : totalSendMS / report.frames;
+    uint64_t samples = 0;
+    double jitter = 0;
+    for (const auto& t : _targets) {
+        samples += t.jitterSamples;
+        jitter += t.jitterTotalMS;
+        report.maxJitterMS = std::max(report.maxJitterMS, report.outputs[t.report].maxJitterMS);
+    }
+    report.meanJitterMS = samples == 0 ? 0 : jitter / samples;
+
+    return true;
+}
+
+std::string OutputReplay::Report::ToString() const
+{
+    std::ostringstream ss;
+    ss.setf(std::ios::fixed);
+    ss.precision(2);
+    ss << frames << " frames at " << frameMS << "ms. Packets expected " << expected << ", received " << received
+       << ", mismatched " << mismatched << ", missing " << missing << ", late " << late << ", unmatched " << unmatched << ".\n";
+    ss << "Send time per frame mean " << meanSendMS << "ms, max " << maxSendMS << "ms.\n";
+    ss << "Arrival jitter mean " << meanJitterMS << "ms, max " << maxJitterMS << "ms (receive times are in whole ms).\n";
+    for (const auto& it : outputs) {
+        ss << "    " << it.name << ": packets " << it.packets << ", mismatched " << it.mismatched
+           << ", jitter mean " << it.meanJitterMS << "ms max " << it.maxJitterMS << "ms\n";
+    }
+    return ss.str();
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+class ControllerEthernet;
+class OutputManager;
+class Output;
+
+// Plays an FSEQ through an OutputManager in real time and checks what its E1.31, ArtNet and DDP outputs put on
+// the wire using loopback receivers (the UDPReceiver xCapture and xFade use).
+//
+// The outputs must all send to this machine. Every packet received is matched to the output which sent it and
+// its channels compared byte for byte against the frame being played. Alongside that it measures how long
+// each frame took to hand to the outputs and how evenly each output's packets arrived.
+class OutputReplay
+{
+public:
+    struct OutputReport
+    {
+        std::string name; // eg "E131 1" or "DDP 1021"
+        uint64_t packets = 0;
+        uint64_t mismatched = 0;
+        double meanJitterMS = 0; // mean difference between the time between frames arriving and the frame time
+        double maxJitterMS = 0;
+    };
+
+    struct Report
+    {
+        uint32_t frames = 0;
+        int frameMS = 0;
+        uint64_t expected = 0;   // packets
+        uint64_t received = 0;
+        uint64_t mismatched = 0; // packets whose channels did not match the frame
+        uint64_t missing = 0;    // packets not received before the next frame was due
+        uint64_t late = 0;       // of the received packets, those which arrived after the next frame was due
+        uint64_t unmatched = 0;  // packets no output could have sent
+        double meanSendMS = 0;   // time to set a frame's channels and send it
+        double maxSendMS = 0;
+        double meanJitterMS = 0;
+        double maxJitterMS = 0;
+        std::vector<OutputReport> outputs;
+
+        bool IsExact() const { return received == expected && mismatched == 0 && missing == 0 && unmatched == 0; }
+        std::string ToString() const;
+    };
+
+    OutputReplay(OutputManager* outputManager);
+
+    // Adds a controller sending channels to this machine, in 510 channel universes for the universe based protocols.
+    // This is what ControllerEthernet::SetChannelSize does but that is part of the network UI the tests are built without
+    static ControllerEthernet* AddLoopbackController(OutputManager& om, const std::string& protocol, int32_t channels);
+
+    // Writes a sequence of changing test patterns
+    static bool CreateTestSequence(const std::string& fseq, uint32_t channels, uint32_t frames, int frameMS = 25);
+
+    // Starts output, plays the whole sequence at its frame rate and stops output again
+    bool Run(const std::string& fseq, Report& report);
+
+private:
+    struct Target
+    {
+        Output* output = nullptr;
+        std::string protocol;
+        int32_t start = 0; // zero based
+        int32_t channels = 0;
+        int packets = 0;   // per frame
+        size_t report = 0; // index into Report::outputs
+        int64_t lastFrame = -1;
+        uint64_t lastArrivalMS = 0;
+        uint64_t jitterSamples = 0;
+        double jitterTotalMS = 0;
+    };
+
+    // works out which output sent the packet and where its channels are
+    Target* Match(const std::string& protocol, const uint8_t* packet, size_t size, int32_t& start, const uint8_t*& data, size_t& channels);
+    void Check(const std::string& protocol, const uint8_t* packet, size_t size, uint64_t timeMS, const std::vector<uint8_t>& frame, int64_t frameIndex, bool late, Report& report);
+
+    OutputManager* _outputManager = nullptr;
+    std::vector<Target> _targets;
+};
@@ -0,0 +1,292 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "wxfixture.h"
+#include "MockHTTPServer.h"
+
+#include <wx/thread.h>
+
+#include "../xLights/controllers/BaseController.h"
+#include "../xLights/controllers/ControllerUploadScheduler.h"
+#include "../xLights/outputs/ControllerEthernet.h"
+#include "../xLights/outputs/OutputManager.h"
+#include "../xLights/utils/CurlManager.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Connecting to stand in controllers ... each a web server answering a status page the way a driver
+// probes a real one ... from the job pool and, for drivers which cannot be created there, the UI thread
+
+class StubController : public BaseController
+{
+public:
+    StubController(bool connected) { _connected = connected; }
+    virtual ~StubController() {}
+
+    virtual bool SetOutputs(ModelManager* allmodels, OutputManager* outputManager, Controller* controller, wxWindow* parent) override { return false; }
+    virtual bool UsesHTTP() const override { return true; }
+};
+
+// the controllers of a show and the web servers standing in for them
+class StandIns
+{
+public:
+    StandIns() {
+        OutputManager::SetInteractive(false);
+    }
+
+    // a server answering as a controller does after delay
+    MockHTTPServer* AddServer(int delayMS) {
+        Load* load = new Load();
+        _loads.emplace_back(load);
+        _servers.emplace_back(new MockHTTPServer([this, load, delayMS](const MockHTTPServer::Request& r) {
+            _all.Begin();
+            load->Begin();
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMS));
+            load->End();
+            _all.End();
+            MockHTTPServer::Response response;
+            if (r.path != "/status") {
+                response.code = 404;
+            } else {
+                response.body = "{\"connected\":true}";
+            }
+            return response;
+        }));
+        _serverLoads[_servers.back().get()] = load;
+        return _servers.back().get();
+    }
+
+    // host is the address of the server answering for the controller, ip the one the show has for it
+    Controller* AddController(const std::string& ip, const std::string& host, bool background) {
+        auto c = new ControllerEthernet(&_om, true);
+        c->SetProtocol(OUTPUT_DDP);
+        c->SetIP(ip);
+        _om.AddController(c, -1);
+        std::unique_lock<std::mutex> lock(_lock);
+        _hosts[c] = host;
+        _background[c] = background;
+        return c;
+    }
+
+    // connects the way a driver does, a controller which does not answer its status page is not connected
+    BaseController* Connect(Controller* c) {
+        std::string host;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            host = _hosts[c];
+            (wxThread::IsMain() ? _onMain : _offMain)[c]++;
+        }
+        if (host.empty()) {
+            return nullptr;
+        }
+        int rc = 0;
+        CurlManager::INSTANCE.doGet("http://" + host + "/status", rc);
+        return new StubController(rc == 200);
+    }
+
+    bool CanConnectOnBackgroundThread(Controller* c) {
+        std::unique_lock<std::mutex> lock(_lock);
+        return _background[c];
+    }
+
+    ControllerUploadScheduler::Connector GetConnector() {
+        return [this](Controller* c) { return Connect(c); };
+    }
+    ControllerUploadScheduler::BackgroundCheck GetBackgroundCheck() {
+        return [this](Controller* c) { return CanConnectOnBackgroundThread(c); };
+    }
+
+    int GetOnMain(Controller* c) {
+        std::unique_lock<std::mutex> lock(_lock);
+        return _onMain[c];
+    }
+    int GetOffMain(Controller* c) {
+        std::unique_lock<std::mutex> lock(_lock);
+        return _offMain[c];
+    }
+    // the most requests answered at once, by all servers or just server
+    int GetMaxInFlight(MockHTTPServer* server = nullptr) {
+        return server == nullptr ? (int)_all.max : (int)_serverLoads[server]->max;
+    }
+
+private:
+    struct Load
+    {
+        std::atomic<int> inFlight = 0;
+        std::atomic<int> max = 0;
+
+        void Begin() {
+            int const now = ++inFlight;
+            int m = max;
+            while (now > m && !max.compare_exchange_weak(m, now)) {
+            }
+        }
+        void End() { --inFlight; }
+    };
+
+    std::mutex _lock;
+    std::map<Controller*, std::string> _hosts;
+    std::map<Controller*, bool> _background;
+    std::map<Controller*, int> _onMain;
+    std::map<Controller*, int> _offMain;
+    Load _all;
+    std::vector<std::unique_ptr<Load>> _loads;
+    std::map<MockHTTPServer*, Load*> _serverLoads;
+    OutputManager _om;
+    std::vector<std::unique_ptr<MockHTTPServer>> _servers; // last so they stop before what they use goes
+};
+
+static bool RunToCompletion(ControllerUploadScheduler& scheduler) {
+    auto const end = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (!scheduler.Process(100)) {
+        if (std::chrono::steady_clock::now() > end) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_F(wxApp_Tests, ControllerUpload_Background) {
+    StandIns show;
+    auto a = show.AddServer(100);
+    ASSERT_TRUE(a->IsOk());
+
+    // two controllers behind one address are asked one after the other
+    Controller* a1 = show.AddController("10.0.0.1", a->GetHost(), true);
+    Controller* a2 = show.AddController("10.0.0.1", a->GetHost(), true);
+
+    std::vector<Controller*> others;
+    for (int i = 0; i < 4; i++) {
+        auto s = show.AddServer(100);
+        ASSERT_TRUE(s->IsOk());
+        others.push_back(show.AddController("10.0.1." + std::to_string(i + 1), s->GetHost(), true));
+    }
+
+    // nothing listening
+    std::string unreachable;
+    {
+        MockHTTPServer gone([](const MockHTTPServer::Request&) { return MockHTTPServer::Response(); });
+        unreachable = gone.GetHost();
+    }
+    Controller* down = show.AddController("10.0.2.1", unreachable, true);
+    // no driver for it
+    Controller* unknown = show.AddController("10.0.3.1", "", true);
+
+    ControllerUploadScheduler scheduler(show.GetConnector(), show.GetBackgroundCheck(), 4, 1);
+    for (auto c : { a1, a2 }) {
+        scheduler.Add(c);
+    }
+    for (auto c : others) {
+        scheduler.Add(c);
+    }
+    scheduler.Add(down);
+    scheduler.Add(unknown);
+    scheduler.Start();
+    ASSERT_TRUE(RunToCompletion(scheduler));
+
+    for (auto c : { a1, a2 }) {
+        EXPECT_EQ(scheduler.GetState(c), ControllerUploadScheduler::State::CONNECTED);
+        EXPECT_NE(scheduler.GetBaseController(c), nullptr);
+        EXPECT_EQ(show.GetOnMain(c), 0);
+        EXPECT_EQ(show.GetOffMain(c), 1);
+    }
+    for (auto c : others) {
+        EXPECT_EQ(scheduler.GetState(c), ControllerUploadScheduler::State::CONNECTED);
+        EXPECT_EQ(scheduler.GetAttempts(c), 1);
+        EXPECT_EQ(show.GetOnMain(c), 0);
+    }
+    EXPECT_EQ(a->GetRequests().size(), 2u);
+    EXPECT_EQ(show.GetMaxInFlight(a), 1);
+
+    // tried again then given up on
+    EXPECT_EQ(scheduler.GetState(down), ControllerUploadScheduler::State::FAILED);
+    EXPECT_EQ(scheduler.GetBaseController(down), nullptr);
+    EXPECT_EQ(scheduler.GetAttempts(down), 2);
+    EXPECT_EQ(scheduler.GetState(unknown), ControllerUploadScheduler::State::FAILED);
+    EXPECT_EQ(scheduler.GetAttempts(unknown), 1);
+
+    auto p = scheduler.GetProgress();
+    EXPECT_EQ(p.total, 8);
+    EXPECT_EQ(p.connected, 6);
+    EXPECT_EQ(p.failed, 2);
+    EXPECT_EQ(p.GetDone(), 8);
+    EXPECT_LE(show.GetMaxInFlight(), 4);
+}
+
+TEST_F(wxApp_Tests, ControllerUpload_Foreground) {
+    StandIns show;
+    std::vector<Controller*> background;
+    std::vector<Controller*> foreground;
+    for (int i = 0; i < 3; i++) {
+        auto s = show.AddServer(50);
+        ASSERT_TRUE(s->IsOk());
+        background.push_back(show.AddController("10.0.0." + std::to_string(i + 1), s->GetHost(), true));
+        auto f = show.AddServer(50);
+        ASSERT_TRUE(f->IsOk());
+        foreground.push_back(show.AddController("10.0.1." + std::to_string(i + 1), f->GetHost(), false));
+    }
+
+    ControllerUploadScheduler scheduler(show.GetConnector(), show.GetBackgroundCheck());
+    for (int i = 0; i < 3; i++) {
+        scheduler.Add(foreground[i]);
+        scheduler.Add(background[i]);
+    }
+    // nothing is connected on the UI thread before the others start
+    EXPECT_FALSE(scheduler.Process(0));
+    for (auto c : foreground) {
+        EXPECT_EQ(scheduler.GetState(c), ControllerUploadScheduler::State::WAITING);
+    }
+    scheduler.Start();
+    ASSERT_TRUE(RunToCompletion(scheduler));
+    EXPECT_TRUE(scheduler.IsComplete());
+
+    for (auto c : background) {
+        EXPECT_EQ(scheduler.GetState(c), ControllerUploadScheduler::State::CONNECTED);
+        EXPECT_EQ(show.GetOnMain(c), 0);
+        EXPECT_EQ(show.GetOffMain(c), 1);
+    }
+    for (auto c : foreground) {
+        EXPECT_EQ(scheduler.GetState(c), ControllerUploadScheduler::State::CONNECTED);
+        EXPECT_EQ(show.GetOnMain(c), 1);
+        EXPECT_EQ(show.GetOffMain(c), 0);
+    }
+}
+
+TEST_F(wxApp_Tests, ControllerUpload_Cancel) {
+    StandIns show;
+    auto s = show.AddServer(0);
+    ASSERT_TRUE(s->IsOk());
+    Controller* b = show.AddController("10.0.0.1", s->GetHost(), true);
+    Controller* f = show.AddController("10.0.0.2", s->GetHost(), false);
+
+    ControllerUploadScheduler scheduler(show.GetConnector(), show.GetBackgroundCheck());
+    scheduler.Add(b);
+    scheduler.Add(f);
+    scheduler.Cancel();
+    scheduler.Start();
+    ASSERT_TRUE(RunToCompletion(scheduler));
+
+    for (auto c : { b, f }) {
+        EXPECT_EQ(scheduler.GetState(c), ControllerUploadScheduler::State::CANCELLED);
+        EXPECT_EQ(scheduler.GetBaseController(c), nullptr);
+        EXPECT_EQ(show.GetOnMain(c) + show.GetOffMain(c), 0);
+    }
+    EXPECT_TRUE(s->GetRequests().empty());
+    EXPECT_EQ(scheduler.GetProgress().cancelled, 2);
+}
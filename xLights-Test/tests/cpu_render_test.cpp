@@ -0,0 +1,406 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "../xLights/CPURenderUtils.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// The CPU blur and rotations must produce exactly what the single threaded versions they replaced did.
+// Those are kept here as the reference.
+
+static const float PI_2 = 6.283185307f;
+
+#pragma region Reference
+#define RED(a, b) a[(b) * 4]
+#define GREEN(a, b) a[(b) * 4 + 1]
+#define BLUE(a, b) a[(b) * 4 + 2]
+#define ALPHA(a, b) a[(b) * 4 + 3]
+static inline void SET(std::vector<float>& ar, int idx, float r, float g, float b, float a) {
+    idx *= 4;
+    ar[idx++] = r;
+    ar[idx++] = g;
+    ar[idx++] = b;
+    ar[idx] = a;
+}
+
+static void boxBlurH_4(const std::vector<float>& scl, std::vector<float>& tcl, int w, int h, float r) {
+    float iarr = 1.0f / (r + r + 1.0f);
+    for (int i = 0; i < h; i++) {
+        int ti = i * w;
+        int li = ti;
+        int ri = ti + r;
+        int maxri = ti + w - 1;
+        int fvIdx = ti;
+        int lvIdx = ti + w - 1;
+
+        float valr = (r + 1.0) * RED(scl, fvIdx);
+        float valg = (r + 1.0) * GREEN(scl, fvIdx);
+        float valb = (r + 1.0) * BLUE(scl, fvIdx);
+        float vala = (r + 1.0) * ALPHA(scl, fvIdx);
+
+        float fvRed = RED(scl, fvIdx);
+        float fvGreen = GREEN(scl, fvIdx);
+        float fvBlue = BLUE(scl, fvIdx);
+        float fvAlpha = ALPHA(scl, fvIdx);
+        float lvRed = RED(scl, lvIdx);
+        float lvGreen = GREEN(scl, lvIdx);
+        float lvBlue = BLUE(scl, lvIdx);
+        float lvAlpha = ALPHA(scl, lvIdx);
+
+        for (int j = 0; j < r; j++) {
+            int idx = j < w ? ti + j : lvIdx;
+            valr += RED(scl, idx);
+            valg += GREEN(scl, idx);
+            valb += BLUE(scl, idx);
+            vala += ALPHA(scl, idx);
+        }
+        for (int j = 0; j <= r; j++) {
+            int idx = ri <= maxri ? ri++ : lvIdx;
+            valr += RED(scl, idx) - fvRed;
+            valg += GREEN(scl, idx) - fvGreen;
+            valb += BLUE(scl, idx) - fvBlue;
+            vala += ALPHA(scl, idx) - fvAlpha;
+
+            if (ti <= maxri) {
+                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
+                ti++;
+            }
+        }
+        for (int j = r + 1; j < w - r; j++) {
+            int c = ri <= maxri ? ri++ : lvIdx;
+            int c2 = li <= maxri ? li++ : lvIdx;
+            valr += RED(scl, c) - RED(scl, c2);
+            valg += GREEN(scl, c) - GREEN(scl, c2);
+            valb += BLUE(scl, c) - BLUE(scl, c2);
+            vala += ALPHA(scl, c) - ALPHA(scl, c2);
+            if (ti <= maxri) {
+                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
+                ti++;
+            }
+        }
+
+        for (int j = w - r; j < w; j++) {
+            int c2 = li <= maxri ? li++ : lvIdx;
+            valr += lvRed - RED(scl, c2);
+            valg += lvGreen - GREEN(scl, c2);
+            valb += lvBlue - BLUE(scl, c2);
+            vala += lvAlpha - ALPHA(scl, c2);
+            if (ti <= maxri) {
+                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
+                ti++;
+            }
+        }
+    }
+}
+
+static void boxBlurT_4(const std::vector<float>& scl, std::vector<float>& tcl, int w, int h, float r) {
+    float iarr = 1.0f / (r + r + 1.0f);
+    for (int i = 0; i < w; i++) {
+        int ti = i;
+        int li = ti;
+        int ri = ti + r * w;
+
+        int maxri = ti + w * (h - 1);
+
+        int fvIdx = ti;
+        int lvIdx = ti + w * (h - 1);
+
+        float fvRed = RED(scl, fvIdx);
+        float fvGreen = GREEN(scl, fvIdx);
+        float fvBlue = BLUE(scl, fvIdx);
+        float fvAlpha = ALPHA(scl, fvIdx);
+        float lvRed = RED(scl, lvIdx);
+        float lvGreen = GREEN(scl, lvIdx);
+        float lvBlue = BLUE(scl, lvIdx);
+        float lvAlpha = ALPHA(scl, lvIdx);
+
+        float valr = (r + 1) * fvRed;
+        float valg = (r + 1) * fvGreen;
+        float valb = (r + 1) * fvBlue;
+        float vala = (r + 1) * fvAlpha;
+
+        for (int j = 0; j < r; j++) {
+            // the original tested j < w here and read past the end of short buffers
+            int idx = j < h ? ti + j * w : lvIdx;
+            valr += RED(scl, idx);
+            valg += GREEN(scl, idx);
+            valb += BLUE(scl, idx);
+            vala += ALPHA(scl, idx);
+        }
+        for (int j = 0; j <= r; j++) {
+            int idx = ri <= maxri ? ri : lvIdx;
+            valr += RED(scl, idx) - fvRed;
+            valg += GREEN(scl, idx) - fvGreen;
+            valb += BLUE(scl, idx) - fvBlue;
+            vala += ALPHA(scl, idx) - fvAlpha;
+            if (ti <= maxri) {
+                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
+            }
+            ri += w;
+            ti += w;
+        }
+        for (int j = r + 1; j < h - r; j++) {
+            int c = ri <= maxri ? ri : lvIdx;
+            int c2 = li <= maxri ? li : lvIdx;
+            valr += RED(scl, c) - RED(scl, c2);
+            valg += GREEN(scl, c) - GREEN(scl, c2);
+            valb += BLUE(scl, c) - BLUE(scl, c2);
+            vala += ALPHA(scl, c) - ALPHA(scl, c2);
+            if (ti <= maxri) {
+                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
+            }
+            li += w;
+            ri += w;
+            ti += w;
+        }
+        for (int j = h - r; j < h; j++) {
+            int c2 = li <= maxri ? li : lvIdx;
+            valr += lvRed - RED(scl, c2);
+            valg += lvGreen - GREEN(scl, c2);
+            valb += lvBlue - BLUE(scl, c2);
+            vala += lvAlpha - ALPHA(scl, c2);
+            if (ti <= maxri) {
+                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
+            }
+            li += w;
+            ti += w;
+        }
+    }
+}
+
+static void boxBlur_4(std::vector<float>& scl, std::vector<float>& tcl, int w, int h, float r) {
+    tcl = scl;
+    boxBlurH_4(tcl, scl, w, h, r);
+    boxBlurT_4(scl, tcl, w, h, r);
+}
+
+// the result ends up in tcl
+static void gaussBlur_4(std::vector<float>& scl, std::vector<float>& tcl, int w, int h, int r) {
+    std::vector<float> bxs;
+    CPURenderUtils::BoxesForGauss(r - 1, 3, bxs);
+    boxBlur_4(scl, tcl, w, h, (bxs[0] - 1) / 2);
+    boxBlur_4(tcl, scl, w, h, (bxs[1] - 1) / 2);
+    boxBlur_4(scl, tcl, w, h, (bxs[2] - 1) / 2);
+}
+
+// The rotations scattered every pixel with SetPixel so later pixels win. Pixels are just ids here and 0 is clear.
+static void SetPixel(std::vector<int>& buffer, int w, int h, int x, int y, int c) {
+    if (x >= 0 && x < w && y >= 0 && y < h) {
+        buffer[y * w + x] = c;
+    }
+}
+
+static std::vector<int> RotateX(const std::vector<int>& orig, int w, int h, const GPURenderUtils::RotoZoomSettings& settings) {
+    std::vector<int> buffer(w * h, 0);
+    float sine = sin((settings.xrotation + 90) * M_PI / 180);
+    float pivot = settings.xpivot * w / 100;
+
+    for (int x = pivot; x < w; ++x) {
+        float tox = sine * (x - pivot) + pivot;
+        for (int y = 0; y < h; ++y) {
+            SetPixel(buffer, w, h, tox, y, orig[y * w + x]);
+        }
+    }
+    for (int x = pivot - 1; x >= 0; --x) {
+        float tox = -1 * sine * (pivot - x) + pivot;
+        for (int y = 0; y < h; ++y) {
+            SetPixel(buffer, w, h, tox, y, orig[y * w + x]);
+        }
+    }
+    return buffer;
+}
+
+static std::vector<int> RotateY(const std::vector<int>& orig, int w, int h, const GPURenderUtils::RotoZoomSettings& settings) {
+    std::vector<int> buffer(w * h, 0);
+    float sine = sin((settings.yrotation + 90) * M_PI / 180);
+    float pivot = settings.ypivot * h / 100;
+
+    for (int y = pivot; y < h; ++y) {
+        float toy = sine * (y - pivot) + pivot;
+        for (int x = 0; x < w; ++x) {
+            SetPixel(buffer, w, h, x, toy, orig[y * w + x]);
+        }
+    }
+    for (int y = pivot - 1; y >= 0; --y) {
+        float toy = -1 * sine * (pivot - y) + pivot;
+        for (int x = 0; x < w; ++x) {
+            SetPixel(buffer, w, h, x, toy, orig[y * w + x]);
+        }
+    }
+    return buffer;
+}
+
+static std::vector<int> RotateZAndZoom(const std::vector<int>& orig, int w, int h, const GPURenderUtils::RotoZoomSettings& settings) {
+    std::vector<int> buffer(w * h, 0);
+    float zoom = settings.zoom;
+    int q = settings.zoomquality;
+    float inc = 1.0 / (float)q;
+
+    float angle = PI_2 * -settings.zrotation;
+    float xoff = (settings.pivotpointx * w) / 100.0;
+    float yoff = (settings.pivotpointy * h) / 100.0;
+    float anglecos = cos(-angle);
+    float anglesin = sin(-angle);
+
+    for (int x = 0; x < w; x++) {
+        for (int i = 0; i < q; i++) {
+            for (int y = 0; y < h; y++) {
+                int c = orig[y * w + x];
+                for (int j = 0; j < q; j++) {
+                    float xx = (float)x + ((float)i * inc) - xoff;
+                    float yy = (float)y + ((float)j * inc) - yoff;
+                    float u = xoff + anglecos * xx * zoom + anglesin * yy * zoom;
+                    if (u >= 0 && u < w) {
+                        float v = yoff + -anglesin * xx * zoom + anglecos * yy * zoom;
+                        if (v >= 0 && v < h) {
+                            SetPixel(buffer, w, h, u, v, c);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return buffer;
+}
+#pragma endregion
+
+static const std::vector<std::pair<int, int>> SIZES = { { 1, 1 }, { 1, 7 }, { 7, 1 }, { 2, 3 }, { 16, 16 }, { 17, 5 }, { 5, 33 }, { 50, 50 }, { 123, 41 } };
+
+static std::vector<int> Pixels(int w, int h) {
+    // 1 based so 0 can mean nothing landed there
+    std::vector<int> pixels(w * h);
+    for (int i = 0; i < w * h; i++) {
+        pixels[i] = i + 1;
+    }
+    return pixels;
+}
+
+// the rotated buffer from the map the same way PixelBufferClass copies it
+template <typename F>
+static std::vector<int> Gather(const std::vector<int>& orig, int w, int h, F&& sourceOf) {
+    std::vector<int> buffer(w * h, 0);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int s = sourceOf(x, y);
+            buffer[y * w + x] = s >= 0 ? orig[s] : 0;
+        }
+    }
+    return buffer;
+}
+
+TEST(CPU_Render_Tests, GaussBlur_MatchesReference) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> colour(0.0f, 255.0f);
+
+    for (const auto& size : SIZES) {
+        int w = size.first;
+        int h = size.second;
+        std::vector<float> image(w * h * 4);
+        for (auto& it : image) {
+            it = colour(rng);
+        }
+
+        // the layer blur only uses the box blurs from 3 up
+        for (int r = 3; r <= 16; r++) {
+            std::vector<float> expected = image;
+            std::vector<float> expectedTmp(image.size());
+            gaussBlur_4(expected, expectedTmp, w, h, r);
+
+            std::vector<float> actual = image;
+            std::vector<float> tmp(image.size());
+            CPURenderUtils::GaussBlur(actual, tmp, w, h, r);
+
+            ASSERT_EQ(actual, expectedTmp) << w << "x" << h << " radius " << r;
+        }
+    }
+}
+
+TEST(CPU_Render_Tests, RotateX_MatchesReference) {
+    for (const auto& size : SIZES) {
+        int w = size.first;
+        int h = size.second;
+        auto const orig = Pixels(w, h);
+        for (int pivot : { 0, 13, 50, 99, 100 }) {
+            for (float rotation : { 1.0f, 45.0f, 90.0f, 135.0f, 180.0f, 250.0f, 359.0f }) {
+                GPURenderUtils::RotoZoomSettings settings;
+                settings.xrotation = rotation;
+                settings.xpivot = pivot;
+
+                auto const from = CPURenderUtils::RotateXMap(w, settings);
+                auto const actual = Gather(orig, w, h, [&](int x, int y) { return from[x] < 0 ? -1 : y * w + from[x]; });
+                ASSERT_EQ(actual, RotateX(orig, w, h, settings)) << w << "x" << h << " pivot " << pivot << " rotation " << rotation;
+            }
+        }
+    }
+}
+
+TEST(CPU_Render_Tests, RotateY_MatchesReference) {
+    for (const auto& size : SIZES) {
+        int w = size.first;
+        int h = size.second;
+        auto const orig = Pixels(w, h);
+        for (int pivot : { 0, 13, 50, 99, 100 }) {
+            for (float rotation : { 1.0f, 45.0f, 90.0f, 135.0f, 180.0f, 250.0f, 359.0f }) {
+                GPURenderUtils::RotoZoomSettings settings;
+                settings.yrotation = rotation;
+                settings.ypivot = pivot;
+
+                auto const from = CPURenderUtils::RotateYMap(h, settings);
+                auto const actual = Gather(orig, w, h, [&](int x, int y) { return from[y] < 0 ? -1 : from[y] * w + x; });
+                ASSERT_EQ(actual, RotateY(orig, w, h, settings)) << w << "x" << h << " pivot " << pivot << " rotation " << rotation;
+            }
+        }
+    }
+}
+
+TEST(CPU_Render_Tests, RotateZAndZoom_MatchesReference) {
+    for (const auto& size : SIZES) {
+        int w = size.first;
+        int h = size.second;
+        auto const orig = Pixels(w, h);
+        for (int quality : { 1, 2, 3 }) {
+            for (float zoom : { 0.3f, 1.0f, 2.5f }) {
+                for (float rotation : { 0.0f, 0.1f, 0.25f, 0.6f }) {
+                    for (int pivot : { 0, 50, 77 }) {
+                        GPURenderUtils::RotoZoomSettings settings;
+                        settings.zrotation = rotation;
+                        settings.zoom = zoom;
+                        settings.zoomquality = quality;
+                        settings.pivotpointx = pivot;
+                        settings.pivotpointy = 100 - pivot;
+
+                        auto const from = CPURenderUtils::RotateZAndZoomMap(w, h, settings);
+                        ASSERT_EQ(from.size(), (size_t)(w * h));
+                        auto const actual = Gather(orig, w, h, [&](int x, int y) { return from[y * w + x]; });
+                        ASSERT_EQ(actual, RotateZAndZoom(orig, w, h, settings))
+                            << w << "x" << h << " quality " << quality << " zoom " << zoom << " rotation " << rotation << " pivot " << pivot;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(CPU_Render_Tests, RotateZAndZoom_EmptyBuffer) {
+    GPURenderUtils::RotoZoomSettings settings;
+    settings.zrotation = 0.25f;
+    settings.zoom = 2.0f;
+    settings.zoomquality = 1;
+    settings.pivotpointx = 50;
+    settings.pivotpointy = 50;
+
+    EXPECT_TRUE(CPURenderUtils::RotateZAndZoomMap(0, 0, settings).empty());
+    EXPECT_TRUE(CPURenderUtils::RotateZAndZoomMap(10, 0, settings).empty());
+    EXPECT_TRUE(CPURenderUtils::RotateZAndZoomMap(0, 10, settings).empty());
+}
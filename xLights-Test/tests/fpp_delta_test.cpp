@@ -0,0 +1,231 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "wxfixture.h"
+#include "MockHTTPServer.h"
+
+#include <wx/file.h>
+#include <wx/filename.h>
+
+#include "../xLights/controllers/FPPSequenceDelta.h"
+#include "../xLights/utils/CurlManager.h"
+#include "../xSchedule/wxJSON/jsonreader.h"
+
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Delta uploads of a 1MB uncompressed V2 sequence to a stand in FPP player which applies them the way the
+// real endpoint would. The player is only sent the changed pieces when it still holds the file uploaded last.
+
+static const uint32_t CHANNELS = 4096;
+static const uint32_t FRAMES = 256;
+static const std::string SEQUENCE = "delta_test.fseq";
+static const std::string DELTA_URL = "/api/sequence/" + SEQUENCE + "/delta";
+
+static std::vector<uint8_t> CreateSequence(uint64_t id, int changedFrame) {
+    std::vector<uint8_t> file(32 + CHANNELS * FRAMES);
+    memcpy(&file[0], "PSEQ", 4);
+    file[4] = 32; // data offset
+    file[7] = 2;  // V2 uncompressed
+    file[8] = 32; // header length
+    memcpy(&file[10], &CHANNELS, 4);
+    memcpy(&file[14], &FRAMES, 4);
+    file[18] = 25;
+    memcpy(&file[24], &id, 8);
+    for (uint32_t f = 0; f < FRAMES; f++) {
+        for (uint32_t c = 0; c < CHANNELS; c++) {
+            file[32 + f * CHANNELS + c] = (uint8_t)((int)f == changedFrame ? 255 - c : f + c);
+        }
+    }
+    return file;
+}
+
+static std::string WriteSequence(const std::string& name, const std::vector<uint8_t>& data) {
+    std::string path = wxFileName(wxFileName::GetTempDir(), name).GetFullPath().ToStdString();
+    wxFile f;
+    if (f.Create(path, true)) {
+        f.Write(data.data(), data.size());
+    }
+    return path;
+}
+
+// what the player holds and how it answers the delta endpoint
+class DeltaPlayer
+{
+public:
+    DeltaPlayer() :
+        _server([this](const MockHTTPServer::Request& r) { return Handle(r); })
+    {
+    }
+
+    MockHTTPServer& GetServer() { return _server; }
+
+    void Hold(const std::vector<uint8_t>& file, const std::string& id) {
+        std::unique_lock<std::mutex> lock(_lock);
+        _file = file;
+        _id = id;
+    }
+    std::vector<uint8_t> GetFile() {
+        std::unique_lock<std::mutex> lock(_lock);
+        return _file;
+    }
+
+    // sends file the way FPP::uploadSequenceDelta does
+    bool Upload(const std::string& file) {
+        std::string base = "http://" + _server.GetHost();
+        return FPPSequenceDelta::Upload(_server.GetHost(), SEQUENCE, file, DELTA_URL,
+            [base](const std::string& url, wxJSONValue& val) {
+                int rc = 0;
+                std::string resp = CurlManager::INSTANCE.doGet(base + url, rc);
+                if (rc != 200) return false;
+                wxJSONReader reader;
+                reader.Parse(resp, &val);
+                return true;
+            },
+            [base](const std::string& url, const std::vector<uint8_t>& body) {
+                int rc = 0;
+                CurlManager::INSTANCE.doPost(base + url, "application/octet-stream", body, rc);
+                return rc;
+            });
+    }
+
+private:
+    MockHTTPServer::Response Handle(const MockHTTPServer::Request& r) {
+        MockHTTPServer::Response response;
+        std::unique_lock<std::mutex> lock(_lock);
+        if (r.path != DELTA_URL || _id.empty()) {
+            response.code = 404;
+        } else if (r.method == "GET") {
+            response.body = "{\"ID\":\"" + _id + "\"}";
+        } else if (r.method == "POST") {
+            response.code = Apply(r.body) ? 200 : 400;
+        }
+        return response;
+    }
+
+    // rebuilds the file from the one held and the new data as described
+    bool Apply(const std::vector<uint8_t>& body) {
+        if (body.size() < 4) return false;
+        uint32_t dlen = body[0] | (body[1] << 8) | (body[2] << 16) | ((uint32_t)body[3] << 24);
+        if (4 + dlen > body.size()) return false;
+        wxJSONValue desc;
+        wxJSONReader reader;
+        if (reader.Parse(std::string((const char*)&body[4], dlen), &desc) > 0) return false;
+        if (desc["baseID"].AsString().ToStdString() != _id) return false;
+
+        const uint8_t* data = &body[4 + dlen];
+        size_t dataLen = body.size() - 4 - dlen;
+        std::vector<uint8_t> file;
+        wxJSONValue& segments = desc["segments"];
+        for (int x = 0; x < segments.Size(); x++) {
+            uint64_t offset = segments[x]["offset"].AsUInt64();
+            uint64_t length = segments[x]["length"].AsUInt64();
+            bool fromBase = segments[x]["source"].AsString() == "base";
+            if (offset + length > (fromBase ? _file.size() : dataLen)) return false;
+            const uint8_t* src = fromBase ? &_file[offset] : data + offset;
+            file.insert(file.end(), src, src + length);
+        }
+        if (file.size() != desc["length"].AsUInt64()) return false;
+        _file = file;
+        _id = desc["ID"].AsString().ToStdString();
+        return true;
+    }
+
+    std::mutex _lock;
+    std::vector<uint8_t> _file;
+    std::string _id;
+    MockHTTPServer _server; // last so it stops before what it serves goes
+};
+
+TEST_F(wxApp_Tests, FPPDelta_NoManifest) {
+    DeltaPlayer player;
+    ASSERT_TRUE(player.GetServer().IsOk());
+    std::string manifest = FPPSequenceDelta::ManifestFile(player.GetServer().GetHost(), SEQUENCE);
+    wxRemoveFile(manifest);
+
+    auto a = CreateSequence(1001, -1);
+    player.Hold(a, "1001");
+    std::string fa = WriteSequence("xLightsDeltaTestA.fseq", a);
+
+    // nothing recorded of what the player has so it needs everything and is not asked
+    EXPECT_FALSE(player.Upload(fa));
+    EXPECT_TRUE(player.GetServer().GetRequests().empty());
+    EXPECT_TRUE(wxFile::Exists(manifest));
+
+    wxRemoveFile(fa);
+    wxRemoveFile(manifest);
+}
+
+TEST_F(wxApp_Tests, FPPDelta_IDMatches) {
+    DeltaPlayer player;
+    ASSERT_TRUE(player.GetServer().IsOk());
+    std::string manifest = FPPSequenceDelta::ManifestFile(player.GetServer().GetHost(), SEQUENCE);
+    wxRemoveFile(manifest);
+
+    auto a = CreateSequence(1001, -1);
+    auto b = CreateSequence(1002, 100);
+    std::string fa = WriteSequence("xLightsDeltaTestA.fseq", a);
+    std::string fb = WriteSequence("xLightsDeltaTestB.fseq", b);
+
+    // the full upload of a
+    EXPECT_FALSE(player.Upload(fa));
+    player.Hold(a, "1001");
+
+    ASSERT_TRUE(player.Upload(fb));
+    auto requests = player.GetServer().GetRequests();
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_EQ(requests[0].method, "GET");
+    EXPECT_EQ(requests[1].method, "POST");
+    // the header and the 64KB piece holding frame 100
+    EXPECT_LT(requests[1].body.size(), (size_t)(70 * 1024));
+    EXPECT_TRUE(player.GetFile() == b);
+
+    // sending it again only asks
+    player.GetServer().ClearRequests();
+    EXPECT_TRUE(player.Upload(fb));
+    requests = player.GetServer().GetRequests();
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0].method, "GET");
+
+    wxRemoveFile(fa);
+    wxRemoveFile(fb);
+    wxRemoveFile(manifest);
+}
+
+TEST_F(wxApp_Tests, FPPDelta_IDDiffers) {
+    DeltaPlayer player;
+    ASSERT_TRUE(player.GetServer().IsOk());
+    std::string manifest = FPPSequenceDelta::ManifestFile(player.GetServer().GetHost(), SEQUENCE);
+    wxRemoveFile(manifest);
+
+    auto a = CreateSequence(1001, -1);
+    auto b = CreateSequence(1002, 100);
+    std::string fa = WriteSequence("xLightsDeltaTestA.fseq", a);
+    std::string fb = WriteSequence("xLightsDeltaTestB.fseq", b);
+
+    EXPECT_FALSE(player.Upload(fa));
+    // something else replaced a on the player
+    auto other = CreateSequence(999, 5);
+    player.Hold(other, "999");
+
+    EXPECT_FALSE(player.Upload(fb));
+    auto requests = player.GetServer().GetRequests();
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0].method, "GET");
+    EXPECT_TRUE(player.GetFile() == other);
+
+    wxRemoveFile(fa);
+    wxRemoveFile(fb);
+    wxRemoveFile(manifest);
+}
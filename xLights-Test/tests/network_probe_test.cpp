@@ -0,0 +1,190 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "wxfixture.h"
+#include "MockHTTPServer.h"
+
+#include "../xLights/utils/NetworkProbe.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Probing stand in controllers on this machine ... web servers which answer, are slow to or are not there at all
+
+// collects the results of an owner's probes as the probe thread calls back
+class Results
+{
+public:
+    ~Results() {
+        NetworkProbe::INSTANCE.Cancel(this);
+    }
+
+    NetworkProbe::Callback Callback() {
+        return [this](const NetworkProbe::Result& result) {
+            std::unique_lock<std::mutex> lock(_lock);
+            _results.push_back(result);
+            _signal.notify_all();
+        };
+    }
+
+    // waits until count results have arrived ... false if they did not in time
+    bool Wait(size_t count, int timeoutMS) {
+        std::unique_lock<std::mutex> lock(_lock);
+        return _signal.wait_for(lock, std::chrono::milliseconds(timeoutMS), [this, count] { return _results.size() >= count; });
+    }
+
+    std::vector<NetworkProbe::Result> Get() const {
+        std::unique_lock<std::mutex> lock(_lock);
+        return _results;
+    }
+
+private:
+    mutable std::mutex _lock;
+    std::condition_variable _signal;
+    std::vector<NetworkProbe::Result> _results;
+};
+
+static int Port(const MockHTTPServer& server) {
+    std::string host = server.GetHost();
+    return std::stoi(host.substr(host.find(':') + 1));
+}
+
+static MockHTTPServer::Response Answer(const MockHTTPServer::Request& request, int delayMS) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(delayMS));
+    MockHTTPServer::Response response;
+    response.body = "{\"path\":\"" + request.path + "\"}";
+    return response;
+}
+
+TEST_F(wxApp_Tests, NetworkProbe_ConnectAccepted) {
+    MockHTTPServer server([](const MockHTTPServer::Request& r) { return Answer(r, 0); });
+    ASSERT_TRUE(server.IsOk());
+
+    Results results;
+    NetworkProbe::INSTANCE.Connect(&results, "127.0.0.1", Port(server), 1000, results.Callback());
+    ASSERT_TRUE(results.Wait(1, 2000));
+
+    auto const r = results.Get().front();
+    EXPECT_EQ(r.probe, NetworkProbe::PROBE::CONNECT);
+    EXPECT_EQ(r.ip, "127.0.0.1");
+    EXPECT_EQ(r.port, Port(server));
+    EXPECT_TRUE(r.ok);
+    EXPECT_TRUE(r.connected);
+    EXPECT_FALSE(r.refused);
+    EXPECT_LT(r.ms, 1000u);
+}
+
+TEST_F(wxApp_Tests, NetworkProbe_ConnectRefused) {
+    // a port something was listening on a moment ago
+    int port = 0;
+    {
+        MockHTTPServer server([](const MockHTTPServer::Request& r) { return Answer(r, 0); });
+        ASSERT_TRUE(server.IsOk());
+        port = Port(server);
+    }
+
+    Results results;
+    NetworkProbe::INSTANCE.Connect(&results, "127.0.0.1", port, 1000, results.Callback());
+    ASSERT_TRUE(results.Wait(1, 2000));
+
+    auto const r = results.Get().front();
+    EXPECT_FALSE(r.ok);
+    EXPECT_FALSE(r.connected);
+    EXPECT_TRUE(r.refused);
+    // refused straight away rather than timing out
+    EXPECT_LT(r.ms, 1000u);
+}
+
+TEST_F(wxApp_Tests, NetworkProbe_HTTPGet) {
+    MockHTTPServer server([](const MockHTTPServer::Request& r) { return Answer(r, 0); });
+    ASSERT_TRUE(server.IsOk());
+
+    Results results;
+    NetworkProbe::INSTANCE.HTTPGet(&results, "127.0.0.1", Port(server), "/api/system/status", 2000, results.Callback());
+    ASSERT_TRUE(results.Wait(1, 3000));
+
+    auto const r = results.Get().front();
+    EXPECT_TRUE(r.ok);
+    EXPECT_TRUE(r.connected);
+    EXPECT_EQ(r.httpStatus, 200);
+    EXPECT_EQ(r.body, "{\"path\":\"/api/system/status\"}");
+
+    auto const requests = server.GetRequests();
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests.front().method, "GET");
+    EXPECT_EQ(requests.front().path, "/api/system/status");
+}
+
+TEST_F(wxApp_Tests, NetworkProbe_Timeout) {
+    // connects but takes far longer to answer than we wait
+    MockHTTPServer server([](const MockHTTPServer::Request& r) { return Answer(r, 1500); });
+    ASSERT_TRUE(server.IsOk());
+
+    Results results;
+    NetworkProbe::INSTANCE.HTTPGet(&results, "127.0.0.1", Port(server), "/", 300, results.Callback());
+    ASSERT_TRUE(results.Wait(1, 1000));
+
+    auto const r = results.Get().front();
+    EXPECT_FALSE(r.ok);
+    EXPECT_TRUE(r.connected);
+    EXPECT_EQ(r.httpStatus, 0);
+    EXPECT_GE(r.ms, 300u);
+    EXPECT_LT(r.ms, 1000u);
+}
+
+TEST_F(wxApp_Tests, NetworkProbe_Cancel) {
+    MockHTTPServer server([](const MockHTTPServer::Request& r) { return Answer(r, 300); });
+    ASSERT_TRUE(server.IsOk());
+
+    Results results;
+    Results other;
+    for (int i = 0; i < 5; i++) {
+        NetworkProbe::INSTANCE.HTTPGet(&results, "127.0.0.1", Port(server), "/", 2000, results.Callback());
+    }
+    NetworkProbe::INSTANCE.HTTPGet(&other, "127.0.0.1", Port(server), "/", 2000, other.Callback());
+    EXPECT_GE(NetworkProbe::INSTANCE.GetPending(&results), 1u);
+
+    // once it returns none of ours are called back but everyone else's still are
+    NetworkProbe::INSTANCE.Cancel(&results);
+    EXPECT_EQ(NetworkProbe::INSTANCE.GetPending(&results), 0u);
+    ASSERT_TRUE(other.Wait(1, 3000));
+    EXPECT_TRUE(other.Get().front().ok);
+    EXPECT_FALSE(results.Wait(1, 500));
+}
+
+TEST_F(wxApp_Tests, NetworkProbe_ManyAtOnce) {
+    // every probe is answered after 200ms so in flight together they take about that long, not the sum of them
+    MockHTTPServer server([](const MockHTTPServer::Request& r) { return Answer(r, 200); });
+    ASSERT_TRUE(server.IsOk());
+    EXPECT_GE(NetworkProbe::INSTANCE.GetMaxActive(), NetworkProbe::MIN_ACTIVE);
+    EXPECT_LE(NetworkProbe::INSTANCE.GetMaxActive(), NetworkProbe::MAX_ACTIVE);
+
+    size_t const count = NetworkProbe::MIN_ACTIVE;
+    Results results;
+    auto const start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        NetworkProbe::INSTANCE.HTTPGet(&results, "127.0.0.1", Port(server), "/" + std::to_string(i), 5000, results.Callback());
+    }
+    ASSERT_TRUE(results.Wait(count, 10000));
+    auto const ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    for (const auto& r : results.Get()) {
+        EXPECT_TRUE(r.ok) << r.port;
+        EXPECT_EQ(r.httpStatus, 200);
+    }
+    EXPECT_LT(ms, 200 * (int)count / 4);
+}
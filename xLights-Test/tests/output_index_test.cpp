@@ -0,0 +1,138 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "wxfixture.h"
+#include "OutputReplay.h"
+
+#include "../xLights/outputs/Output.h"
+#include "../xLights/outputs/OutputManager.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// A 300k channel show ... about 590 E1.31 universes and a DDP controller. The channel lookups must find the same
+// outputs walking every output did and the benchmark prints the time of each so they can be compared
+
+static const int32_t CHANNELS = 300000;
+
+static void CreateShow(OutputManager& om) {
+    OutputManager::SetInteractive(false);
+    OutputReplay::AddLoopbackController(om, OUTPUT_E131, 250 * 510);
+    OutputReplay::AddLoopbackController(om, OUTPUT_DDP, 50000);
+    OutputReplay::AddLoopbackController(om, OUTPUT_E131, CHANNELS - 250 * 510 - 50000);
+    om.SomethingChanged();
+}
+
+// how outputs were found before the index
+static Output* ScanForOutput(const OutputManager& om, int32_t absoluteChannel, int32_t& startChannel) {
+    for (const auto& it : om.GetAllOutputs()) {
+        if (absoluteChannel >= it->GetStartChannel() && absoluteChannel <= it->GetEndChannel()) {
+            startChannel = absoluteChannel - it->GetStartChannel() + 1;
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+TEST_F(wxApp_Tests, ChannelIndex_MatchesScan) {
+    OutputManager om;
+    CreateShow(om);
+    ASSERT_EQ(om.GetTotalChannels(), CHANNELS);
+
+    std::vector<int32_t> channels = { -1, 0, 1, 2, 510, 511, CHANNELS - 1, CHANNELS, CHANNELS + 1 };
+    for (const auto& it : om.GetAllOutputs()) {
+        channels.push_back(it->GetStartChannel());
+        channels.push_back(it->GetEndChannel());
+    }
+    for (int32_t ch = 1; ch <= CHANNELS; ch += 997) {
+        channels.push_back(ch);
+    }
+
+    for (auto ch : channels) {
+        int32_t expectedStart = 0;
+        int32_t start = 0;
+        Output* expected = ScanForOutput(om, ch, expectedStart);
+        EXPECT_EQ(om.GetOutput(ch, start), expected) << ch;
+        if (expected != nullptr) {
+            EXPECT_EQ(start, expectedStart) << ch;
+        }
+    }
+
+    // the index follows the outputs when they change
+    OutputReplay::AddLoopbackController(om, OUTPUT_DDP, 1000);
+    int32_t start = 0;
+    Output* o = om.GetOutput(CHANNELS + 1, start);
+    ASSERT_NE(o, nullptr);
+    EXPECT_EQ(o->GetType(), OUTPUT_DDP);
+    EXPECT_EQ(start, 1);
+
+    // and when an output changes size without the manager being told
+    o->SetChannels(2000);
+    EXPECT_EQ(om.GetOutput(CHANNELS + 1500, start), o);
+    EXPECT_EQ(start, 1500);
+}
+
+TEST_F(wxApp_Tests, ChannelIndex_Benchmark) {
+    OutputManager om;
+    CreateShow(om);
+
+    std::vector<uint8_t> frame(CHANNELS);
+    for (int32_t i = 0; i < CHANNELS; i++) {
+        frame[i] = (uint8_t)i;
+    }
+
+    // a lookup of every 100th channel
+    auto start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (int32_t ch = 1; ch <= CHANNELS; ch += 100) {
+        int32_t sc = 0;
+        if (ScanForOutput(om, ch, sc) != nullptr) found++;
+    }
+    double const scanMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    size_t indexed = 0;
+    for (int32_t ch = 1; ch <= CHANNELS; ch += 100) {
+        int32_t sc = 0;
+        if (om.GetOutput(ch, sc) != nullptr) indexed++;
+    }
+    double const indexMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(found, indexed);
+
+    // whole frames handed out one output at a time as they used to be and in one call
+    int const frames = 40;
+    start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        for (const auto& it : om.GetAllOutputs()) {
+            om.SetManyChannels(it->GetStartChannel() - 1, &frame[it->GetStartChannel() - 1], it->GetChannels());
+        }
+    }
+    double const perOutputMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        om.SetFrame(frame.data(), frame.size());
+    }
+    double const frameMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    // a frame set a channel at a time as the test dialogs do
+    start = std::chrono::steady_clock::now();
+    for (int32_t ch = 0; ch < CHANNELS; ch++) {
+        om.SetOneChannel(ch, frame[ch]);
+    }
+    double const oneMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << CHANNELS << " channels, " << om.GetOutputCount() << " outputs.\n"
+              << "    " << found << " lookups scanning " << scanMS << "ms, indexed " << indexMS << "ms\n"
+              << "    frame per output " << perOutputMS << "ms, whole frame " << frameMS << "ms, a channel at a time " << oneMS << "ms\n";
+}
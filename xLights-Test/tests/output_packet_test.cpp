@@ -0,0 +1,143 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "wxfixture.h"
+
+#include <wx/socket.h>
+
+#include "../xLights/outputs/ArtNetOutput.h"
+#include "../xLights/outputs/DDPOutput.h"
+#include "../xLights/outputs/E131Output.h"
+#include "../xLights/outputs/KinetOutput.h"
+#include "../xLights/utils/ip_utils.h"
+
+#include <vector>
+
+// Each output sends the same frames twice over loopback ... once copying the channels into its own packet
+// buffer and once sending straight from frame data ... and the packets must match byte for byte
+
+static std::vector<std::vector<uint8_t>> ReceivePackets(wxDatagramSocket& rx, int count) {
+    std::vector<std::vector<uint8_t>> res;
+    uint8_t buffer[2048];
+    for (int i = 0; i < count; i++) {
+        wxIPV4address from;
+        rx.RecvFrom(from, buffer, sizeof(buffer));
+        if (rx.Error()) break;
+        res.emplace_back(buffer, buffer + rx.LastCount());
+    }
+    return res;
+}
+
+static void ComparePackets(Output* copying, Output* zeroCopy, int port, int packetsPerFrame) {
+    wxIPV4address local;
+    local.Hostname("127.0.0.1");
+    local.Service(port);
+    wxDatagramSocket rx(local, wxSOCKET_BLOCK);
+    ASSERT_TRUE(rx.IsOk());
+    rx.SetTimeout(2);
+
+    for (auto o : { copying, zeroCopy }) {
+        o->SetIP("127.0.0.1", true);
+    }
+    ip_utils::waitForAllToResolve();
+    ASSERT_TRUE(copying->Open());
+    ASSERT_TRUE(zeroCopy->Open());
+
+    int32_t channels = copying->GetChannels();
+    std::vector<uint8_t> frame(channels);
+    for (int32_t i = 0; i < channels; i++) {
+        frame[i] = (uint8_t)(i * 7 + 3);
+    }
+    ASSERT_TRUE(zeroCopy->SetFrameData(frame.data(), frame.size()));
+
+    for (int f = 0; f < 3; f++) {
+        if (f > 0) {
+            for (int32_t i = f; i < channels; i += 5) {
+                frame[i] ^= 0xFF;
+            }
+            zeroCopy->FrameDataChanged();
+        }
+        copying->StartFrame(f * 25);
+        copying->SetManyChannels(0, frame.data(), channels);
+        copying->EndFrame(0);
+        auto expected = ReceivePackets(rx, packetsPerFrame);
+
+        zeroCopy->StartFrame(f * 25);
+        zeroCopy->EndFrame(0);
+        auto actual = ReceivePackets(rx, packetsPerFrame);
+
+        ASSERT_EQ(expected.size(), (size_t)packetsPerFrame);
+        EXPECT_EQ(expected, actual);
+    }
+
+    // going back to its own buffer the output carries on sending the last frame data
+    EXPECT_TRUE(zeroCopy->SetFrameData(nullptr, 0));
+    copying->EndFrame(0);
+    auto expected = ReceivePackets(rx, packetsPerFrame);
+    zeroCopy->EndFrame(0);
+    EXPECT_EQ(expected, ReceivePackets(rx, packetsPerFrame));
+
+    copying->Close();
+    zeroCopy->Close();
+}
+
+TEST_F(wxApp_Tests, E131_ZeroCopy) {
+    E131Output copying;
+    E131Output zeroCopy;
+    for (auto o : { &copying, &zeroCopy }) {
+        o->SetUniverse(1);
+        o->SetChannels(510);
+    }
+    ComparePackets(&copying, &zeroCopy, E131_PORT, 1);
+}
+
+TEST_F(wxApp_Tests, ArtNet_ZeroCopy) {
+    ArtNetOutput copying;
+    ArtNetOutput zeroCopy;
+    for (auto o : { &copying, &zeroCopy }) {
+        o->SetUniverse(1);
+        o->SetChannels(512);
+    }
+    ComparePackets(&copying, &zeroCopy, ARTNET_PORT, 1);
+}
+
+TEST_F(wxApp_Tests, DDP_ZeroCopy) {
+    DDPOutput copying;
+    DDPOutput zeroCopy;
+    for (auto o : { &copying, &zeroCopy }) {
+        o->SetChannels(3000); // 1440 + 1440 + 120
+    }
+    ComparePackets(&copying, &zeroCopy, DDP_PORT, 3);
+}
+
+TEST_F(wxApp_Tests, Kinet_ZeroCopy) {
+    KinetOutput copying;
+    KinetOutput zeroCopy;
+    for (auto o : { &copying, &zeroCopy }) {
+        o->SetUniverse(1);
+        o->SetChannels(512);
+    }
+    ComparePackets(&copying, &zeroCopy, KINET_PORT, 1);
+}
+
+TEST_F(wxApp_Tests, ProxiedOutputKeepsItsOwnBuffer) {
+    E131Output output;
+    output.SetUniverse(1);
+    output.SetChannels(512);
+    output.SetFPPProxyIP("127.0.0.1");
+    output.SetIP("127.0.0.1", true);
+    ip_utils::waitForAllToResolve();
+    output.Open();
+    std::vector<uint8_t> frame(512);
+    EXPECT_FALSE(output.SetFrameData(frame.data(), frame.size()));
+    output.Close();
+}
@@ -0,0 +1,104 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "wxfixture.h"
+
+#include <wx/filename.h>
+
+#include "OutputReplay.h"
+
+#include "../xLights/outputs/Output.h"
+#include "../xLights/outputs/OutputManager.h"
+#include "../xLights/utils/ip_utils.h"
+
+#include <iostream>
+
+// These play a generated sequence at 40fps through controllers sending to this machine. Each prints its
+// report so the timings can be compared before and after a change to the outputs.
+
+static std::string CreateSequence(const std::string& name, uint32_t channels, uint32_t frames) {
+    std::string const fseq = wxFileName::GetTempDir().ToStdString() + wxFileName::GetPathSeparator() + name + ".fseq";
+    EXPECT_TRUE(OutputReplay::CreateTestSequence(fseq, channels, frames, 25));
+    return fseq;
+}
+
+// the share of packets which must arrive
+static const uint64_t MIN_RECEIVED_PERCENT = 90;
+
+static bool IsMost(uint64_t received, uint64_t expected) {
+    return received * 100 >= expected * MIN_RECEIVED_PERCENT;
+}
+
+static void Replay(OutputManager& om, const std::string& fseq, OutputReplay::Report& report) {
+    OutputManager::SetInteractive(false);
+    ip_utils::waitForAllToResolve();
+    om.SomethingChanged();
+
+    OutputReplay replay(&om);
+    ASSERT_TRUE(replay.Run(fseq, report));
+    std::cout << report.ToString();
+
+    // a busy machine can drop the odd packet so most, not all, must arrive and every output must be heard from
+    EXPECT_TRUE(IsMost(report.received, report.expected)) << report.received << " of " << report.expected;
+    EXPECT_EQ(report.mismatched, 0u);
+    EXPECT_EQ(report.unmatched, 0u);
+    for (const auto& it : report.outputs) {
+        EXPECT_GT(it.packets, 0u) << it.name;
+        EXPECT_EQ(it.mismatched, 0u) << it.name;
+    }
+}
+
+TEST_F(wxApp_Tests, Replay_E131) {
+    OutputManager om;
+    OutputReplay::AddLoopbackController(om, OUTPUT_E131, 100 * 510);
+    auto const fseq = CreateSequence("replay_e131", om.GetTotalChannels(), 80);
+
+    OutputReplay::Report report;
+    Replay(om, fseq, report);
+    EXPECT_EQ(report.outputs.size(), 100u);
+    EXPECT_EQ(report.expected, 100u * 80u);
+    wxRemoveFile(fseq);
+}
+
+TEST_F(wxApp_Tests, Replay_Mixed) {
+    OutputManager om;
+    OutputReplay::AddLoopbackController(om, OUTPUT_E131, 20 * 510);
+    OutputReplay::AddLoopbackController(om, OUTPUT_ARTNET, 20 * 510);
+    OutputReplay::AddLoopbackController(om, OUTPUT_DDP, 5000);
+    // the sequence is a little short so the last channels sent are always off
+    auto const fseq = CreateSequence("replay_mixed", om.GetTotalChannels() - 100, 80);
+
+    OutputReplay::Report report;
+    Replay(om, fseq, report);
+    wxRemoveFile(fseq);
+}
+
+TEST_F(wxApp_Tests, Replay_ZeroCopyMatchesCopying) {
+    OutputManager om;
+    OutputReplay::AddLoopbackController(om, OUTPUT_E131, 100 * 510);
+    OutputReplay::AddLoopbackController(om, OUTPUT_DDP, 20000);
+    auto const fseq = CreateSequence("replay_zerocopy", om.GetTotalChannels(), 80);
+
+    OutputReplay::Report copying;
+    om.SetZeroCopyOutput(false);
+    Replay(om, fseq, copying);
+
+    OutputReplay::Report zeroCopy;
+    om.SetZeroCopyOutput(true);
+    Replay(om, fseq, zeroCopy);
+
+    // both send the same packets so each run should get about as many through as the other
+    EXPECT_EQ(copying.expected, zeroCopy.expected);
+    EXPECT_TRUE(IsMost(copying.received, zeroCopy.received)) << copying.received << " copying, " << zeroCopy.received << " zero copy";
+    EXPECT_TRUE(IsMost(zeroCopy.received, copying.received)) << copying.received << " copying, " << zeroCopy.received << " zero copy";
+    wxRemoveFile(fseq);
+}
@@ -0,0 +1,87 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <cmath>
+
+#include "../xLights/ValueCurve.h"
+
+#include <thread>
+#include <vector>
+
+// Effects which read timing tracks, lyrics or the music while rendering find them through
+// ValueCurve::GetRenderSequenceElements. The serial render of the open sequence must get the open
+// one while each render thread of a batch render gets the sequence it is rendering.
+
+// ValueCurve.cpp needs the whole sequencer so only the state the header uses is defined here
+AudioManager* ValueCurve::__audioManager = nullptr;
+SequenceElements* ValueCurve::__sequenceElements = nullptr;
+thread_local AudioManager* ValueCurve::__threadAudioManager = nullptr;
+thread_local SequenceElements* ValueCurve::__threadSequenceElements = nullptr;
+
+// only the addresses matter
+static int __sequences[5];
+static SequenceElements* Sequence(int i) {
+    return reinterpret_cast<SequenceElements*>(&__sequences[i]);
+}
+
+TEST(RenderSequence, SerialUsesOpenSequence) {
+    ValueCurve::SetSequenceElements(Sequence(0));
+    EXPECT_EQ(ValueCurve::GetRenderSequenceElements(Sequence(0)), Sequence(0));
+    EXPECT_EQ(ValueCurve::GetSequenceElements(), Sequence(0));
+
+    // the open sequence renders with no sequence set on the thread
+    {
+        ValueCurve::ThreadSequence threadSequence(nullptr, nullptr);
+        EXPECT_EQ(ValueCurve::GetRenderSequenceElements(Sequence(0)), Sequence(0));
+        EXPECT_EQ(ValueCurve::GetSequenceElements(), Sequence(0));
+    }
+    ValueCurve::SetSequenceElements(nullptr);
+}
+
+TEST(RenderSequence, ParallelUsesItsOwnSequence) {
+    ValueCurve::SetSequenceElements(Sequence(0));
+
+    // four sequences rendering at once alongside the open one
+    std::vector<SequenceElements*> seen(4, nullptr);
+    std::vector<SequenceElements*> seenNested(4, nullptr);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([i, &seen, &seenNested]() {
+            ValueCurve::ThreadSequence threadSequence(nullptr, Sequence(i + 1));
+            for (int j = 0; j < 1000; j++) {
+                if (ValueCurve::GetRenderSequenceElements(Sequence(0)) != Sequence(i + 1)) return;
+                std::this_thread::yield();
+            }
+            // per model buffers set it again on the threads they render on
+            {
+                ValueCurve::ThreadSequence nested(nullptr, Sequence(i + 1));
+                seenNested[i] = ValueCurve::GetSequenceElements();
+            }
+            seen[i] = ValueCurve::GetRenderSequenceElements(Sequence(0));
+        });
+    }
+    // meanwhile the open sequence is unaffected
+    for (int j = 0; j < 1000; j++) {
+        ASSERT_EQ(ValueCurve::GetRenderSequenceElements(Sequence(0)), Sequence(0));
+        std::this_thread::yield();
+    }
+    for (auto& it : threads) {
+        it.join();
+    }
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(seen[i], Sequence(i + 1)) << i;
+        EXPECT_EQ(seenNested[i], Sequence(i + 1)) << i;
+    }
+    EXPECT_EQ(ValueCurve::GetRenderSequenceElements(Sequence(0)), Sequence(0));
+    ValueCurve::SetSequenceElements(nullptr);
+}
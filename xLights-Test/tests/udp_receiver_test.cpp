@@ -0,0 +1,213 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "wxfixture.h"
+
+#include <wx/socket.h>
+
+#include "../xLights/utils/UDPReceiver.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <set>
+#include <thread>
+
+// These replay a synthetic 1000 universe E1.31 stream at 40fps to this machine and check the receiver
+// hands over every packet and reports the sequence gaps it is sent exactly.
+
+static const int UNIVERSES = 1000;
+static const int FRAMES = 40;
+
+static void CreateE131Packet(uint8_t* p, int universe, uint8_t seq) {
+    memset(p, 0x00, 638);
+    p[1] = 0x10;
+    memcpy(&p[4], "ASC-E1.17", 9);
+    p[21] = 0x04;
+    p[111] = seq;
+    p[113] = universe >> 8;
+    p[114] = universe & 0xFF;
+    for (int i = 126; i < 638; i++) {
+        p[i] = (uint8_t)(universe + seq + i);
+    }
+}
+
+// Sends the stream a frame every 25ms draining the receiver between frames like xCapture does.
+// Universes in skip have those frames left out. Returns the packets handed over per universe.
+static std::map<int, int> Replay(UDPReceiver& receiver, const std::set<std::pair<int, int>>& skip, size_t& sent) {
+    std::map<int, int> drained;
+    auto process = [&drained](const UDPReceiver::Packet& p) {
+        if (p._size == 638) {
+            drained[((int)p._data[113] << 8) + (int)p._data[114]]++;
+        }
+    };
+
+    wxIPV4address local;
+    local.AnyAddress();
+    wxDatagramSocket socket(local, wxSOCKET_BLOCK);
+    EXPECT_TRUE(socket.IsOk());
+
+    wxIPV4address remote;
+    remote.Hostname("127.0.0.1");
+    remote.Service(5568);
+
+    uint8_t packet[638];
+    sent = 0;
+    for (int f = 0; f < FRAMES; f++) {
+        auto const frameStart = std::chrono::steady_clock::now();
+        for (int u = 1; u <= UNIVERSES; u++) {
+            if (skip.find({ u, f }) != skip.end()) continue;
+            CreateE131Packet(packet, u, (uint8_t)f);
+            socket.SendTo(remote, packet, sizeof(packet));
+            if (socket.LastWriteCount() == sizeof(packet)) {
+                sent++;
+            }
+            // the OS may cap the receive buffer well below a whole frame so spread it out a little like a
+            // busy sender would rather than testing how fast loopback can fill a buffer
+            if (u % 100 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        while (std::chrono::steady_clock::now() - frameStart < std::chrono::milliseconds(25)) {
+            receiver.Drain(process);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // let the last frame arrive
+    auto const end = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (receiver.GetReceived() < sent && std::chrono::steady_clock::now() < end) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    receiver.Drain(process);
+
+    return drained;
+}
+
+TEST_F(wxApp_Tests, UDPReceiver_NothingDropped) {
+    std::atomic<int> callbacks = 0;
+    UDPReceiver receiver(UDPReceiver::PROTOCOL::E131, "127.0.0.1", "", {}, [&callbacks]() { callbacks++; });
+    ASSERT_TRUE(receiver.IsOk());
+
+    size_t sent = 0;
+    auto const drained = Replay(receiver, {}, sent);
+    std::cout << sent << " packets sent, " << receiver.GetReceived() << " received, " << callbacks << " data callbacks.\n";
+
+    EXPECT_EQ(sent, (size_t)(UNIVERSES * FRAMES));
+    EXPECT_EQ(receiver.GetReceived(), sent);
+    EXPECT_EQ(receiver.GetOverflowed(), 0u);
+    EXPECT_EQ(receiver.GetLost(), 0u);
+
+    ASSERT_EQ(drained.size(), (size_t)UNIVERSES);
+    auto const stats = receiver.GetUniverseStats();
+    for (int u = 1; u <= UNIVERSES; u++) {
+        EXPECT_EQ(drained.at(u), FRAMES) << u;
+        EXPECT_EQ(stats.at(u)._packets, (uint64_t)FRAMES) << u;
+        EXPECT_EQ(stats.at(u)._outOfOrder, 0u) << u;
+    }
+}
+
+TEST_F(wxApp_Tests, UDPReceiver_SequenceGaps) {
+    UDPReceiver receiver(UDPReceiver::PROTOCOL::E131, "127.0.0.1", "", {}, nullptr);
+    ASSERT_TRUE(receiver.IsOk());
+
+    // one frame missing from universe 10, three in a row from 500 and two apart from 1000
+    std::set<std::pair<int, int>> const skip = { { 10, 5 }, { 500, 20 }, { 500, 21 }, { 500, 22 }, { 1000, 3 }, { 1000, 30 } };
+
+    size_t sent = 0;
+    Replay(receiver, skip, sent);
+    EXPECT_EQ(receiver.GetReceived(), sent);
+    EXPECT_EQ(receiver.GetOverflowed(), 0u);
+    EXPECT_EQ(receiver.GetLost(), (uint64_t)skip.size());
+
+    auto const stats = receiver.GetUniverseStats();
+    EXPECT_EQ(stats.at(10)._lost, 1u);
+    EXPECT_EQ(stats.at(500)._lost, 3u);
+    EXPECT_EQ(stats.at(1000)._lost, 2u);
+    EXPECT_EQ(stats.at(11)._lost, 0u);
+}
+
+TEST_F(wxApp_Tests, UDPReceiver_GrowsOnDemand) {
+    UDPReceiver receiver(UDPReceiver::PROTOCOL::E131, "127.0.0.1", "", {}, nullptr);
+    ASSERT_TRUE(receiver.IsOk());
+    // nothing was said about the traffic so it starts small
+    EXPECT_EQ(receiver.GetQueueSize(), UDPReceiver::MIN_QUEUE_PACKETS);
+
+    wxIPV4address local;
+    local.AnyAddress();
+    wxDatagramSocket socket(local, wxSOCKET_BLOCK);
+    ASSERT_TRUE(socket.IsOk());
+    wxIPV4address remote;
+    remote.Hostname("127.0.0.1");
+    remote.Service(5568);
+
+    // a whole frame of every universe with nobody draining
+    uint8_t packet[638];
+    size_t sent = 0;
+    for (int u = 1; u <= UNIVERSES; u++) {
+        CreateE131Packet(packet, u, 0);
+        socket.SendTo(remote, packet, sizeof(packet));
+        if (socket.LastWriteCount() == sizeof(packet)) {
+            sent++;
+        }
+        if (u % 100 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    auto const end = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (receiver.GetReceived() < sent && std::chrono::steady_clock::now() < end) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    EXPECT_EQ(receiver.GetReceived(), sent);
+    EXPECT_EQ(receiver.GetOverflowed(), 0u);
+    EXPECT_GE(receiver.GetQueueSize(), sent);
+    EXPECT_LE(receiver.GetQueueSize(), UDPReceiver::MAX_QUEUE_PACKETS);
+    EXPECT_EQ(receiver.Drain([](const UDPReceiver::Packet&) {}), sent);
+}
+
+TEST_F(wxApp_Tests, UDPReceiver_DDPStartChannel) {
+    UDPReceiver receiver(UDPReceiver::PROTOCOL::DDP, "127.0.0.1", "", {}, nullptr);
+    ASSERT_TRUE(receiver.IsOk());
+
+    wxIPV4address local;
+    local.AnyAddress();
+    wxDatagramSocket socket(local, wxSOCKET_BLOCK);
+    ASSERT_TRUE(socket.IsOk());
+    wxIPV4address remote;
+    remote.Hostname("127.0.0.1");
+    remote.Service(4048);
+
+    // a start channel past what fits in an int
+    uint32_t const start = 0x80000010;
+    uint8_t packet[10 + 3];
+    memset(packet, 0x00, sizeof(packet));
+    packet[0] = 0x41;
+    packet[3] = 0x01;
+    packet[4] = start >> 24;
+    packet[5] = (start >> 16) & 0xFF;
+    packet[6] = (start >> 8) & 0xFF;
+    packet[7] = start & 0xFF;
+    packet[9] = 3;
+    socket.SendTo(remote, packet, sizeof(packet));
+
+    auto const end = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (receiver.GetReceived() < 1 && std::chrono::steady_clock::now() < end) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    auto const stats = receiver.GetUniverseStats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats.begin()->first, start);
+    EXPECT_EQ(stats.begin()->second._packets, 1u);
+}
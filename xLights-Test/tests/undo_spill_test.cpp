@@ -0,0 +1,311 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "wxfixture.h"
+
+#include "../xLights/sequencer/UndoManager.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+// Operations spilled to disk once the undo history passes its limit must come back exactly as captured and be
+// undone newest first, each undoing its changes in the reverse of the order they were made
+
+// UndoApply.cpp needs the whole sequencer so the managers here put changes back themselves and these are never called
+AddedEffectInfo* UndoManager::UndoDeleted(const DeletedEffectInfo& info) { return nullptr; }
+DeletedEffectInfo* UndoManager::UndoAdded(const AddedEffectInfo& info) { return nullptr; }
+MovedEffectInfo* UndoManager::UndoMoved(const MovedEffectInfo& info) { return nullptr; }
+ModifiedEffectInfo* UndoManager::UndoModified(const ModifiedEffectInfo& info) { return nullptr; }
+
+// undoes without a sequence by taking the steps as UndoLastStep would and noting what each change restores
+class SpillingUndoManager : public UndoManager
+{
+public:
+    SpillingUndoManager() :
+        UndoManager(nullptr) {}
+
+    // the "element/id settings|palette" of each change of the last operation in the order it would be undone
+    std::vector<std::string> UndoOperation() {
+        std::vector<std::string> undone;
+        RemoveUnusedMarkers();
+        if (GetUndoSteps().empty()) {
+            LoadSpilled();
+        }
+        while (!GetUndoSteps().empty()) {
+            const UndoStep* step = GetUndoSteps().back();
+            bool const marker = step->undo_action == UNDO_MARKER;
+            if (!step->modified_effect_info.empty()) {
+                const ModifiedEffectInfo* info = step->modified_effect_info.back();
+                undone.push_back(GetStrings().Get(info->element_name) + "/" + std::to_string(info->id) + " " +
+                                 GetStrings().GetSettings(info->settings) + "|" + GetStrings().GetSettings(info->palette));
+            }
+            // drops the last change, or the step once it has none
+            CancelLastStep();
+            if (marker) break;
+        }
+        return undone;
+    }
+};
+
+// a stand in for the sequence ... edits are captured the way the sequencer captures them and are put back by the real
+// UndoLastStep and RedoLastStep
+class EditedSequence : public UndoManager
+{
+public:
+    EditedSequence() :
+        UndoManager(nullptr) {}
+
+    // an effect already in the sequence when it was opened
+    int Create(const std::string& element, const std::string& name, const std::string& settings, const std::string& palette, int start, int end) {
+        int const id = _nextId++;
+        _effects[id] = { element, name, settings, palette, start, end };
+        return id;
+    }
+
+    int Add(const std::string& element, const std::string& name, const std::string& settings, const std::string& palette, int start, int end) {
+        int const id = Create(element, name, settings, palette, start, end);
+        CaptureAddedEffect(element, 0, id);
+        return id;
+    }
+
+    void Delete(int id) {
+        const auto& e = _effects.at(id);
+        CaptureEffectToBeDeleted(e.element, 0, e.name, e.settings, e.palette, e.start, e.end, 0, false);
+        _effects.erase(id);
+    }
+
+    void Move(int id, int start, int end) {
+        auto& e = _effects.at(id);
+        CaptureEffectToBeMoved(e.element, 0, id, e.start, e.end);
+        e.start = start;
+        e.end = end;
+    }
+
+    void Modify(int id, const std::string& settings, const std::string& palette) {
+        auto& e = _effects.at(id);
+        CaptureModifiedEffect(e.element, 0, id, e.settings, e.palette);
+        e.settings = settings;
+        e.palette = palette;
+    }
+
+    // every effect in order ... effects put back after being deleted get new ids so they are left out
+    std::string GetContents() const {
+        std::vector<std::string> effects;
+        for (const auto& it : _effects) {
+            const auto& e = it.second;
+            effects.push_back(e.element + " " + e.name + " " + std::to_string(e.start) + "-" + std::to_string(e.end) + " " + e.settings + "|" + e.palette);
+        }
+        std::sort(effects.begin(), effects.end());
+        std::string contents;
+        for (const auto& it : effects) {
+            contents += it + "\n";
+        }
+        return contents;
+    }
+
+protected:
+    AddedEffectInfo* UndoDeleted(const DeletedEffectInfo& info) override {
+        SequenceEffect e = { GetStrings().Get(info.element_name), GetStrings().Get(info.name), GetStrings().GetSettings(info.settings),
+                     GetStrings().GetSettings(info.palette), info.startTimeMS, info.endTimeMS };
+        int const id = Create(e.element, e.name, e.settings, e.palette, e.start, e.end);
+        return new AddedEffectInfo(GetStrings(), e.element, info.layer_index, id);
+    }
+
+    DeletedEffectInfo* UndoAdded(const AddedEffectInfo& info) override {
+        auto it = Find(info.element_name, info.id);
+        if (it == _effects.end()) return nullptr;
+        SequenceEffect const e = it->second;
+        _effects.erase(it);
+        return new DeletedEffectInfo(GetStrings(), e.element, info.layer_index, e.name, e.settings, e.palette, e.start, e.end, 0, false);
+    }
+
+    MovedEffectInfo* UndoMoved(const MovedEffectInfo& info) override {
+        auto it = Find(info.element_name, info.id);
+        if (it == _effects.end()) return nullptr;
+        SequenceEffect& e = it->second;
+        auto replaced = new MovedEffectInfo(GetStrings(), e.element, info.layer_index, info.id, e.start, e.end);
+        e.start = info.startTimeMS;
+        e.end = info.endTimeMS;
+        return replaced;
+    }
+
+    ModifiedEffectInfo* UndoModified(const ModifiedEffectInfo& info) override {
+        auto it = Find(info.element_name, info.id);
+        if (it == _effects.end()) return nullptr;
+        SequenceEffect& e = it->second;
+        auto replaced = new ModifiedEffectInfo(GetStrings(), e.element, info.layer_index, info.id, e.settings, e.palette);
+        e.settings = GetStrings().GetSettings(info.settings);
+        e.palette = GetStrings().GetSettings(info.palette);
+        return replaced;
+    }
+
+private:
+    struct SequenceEffect
+    {
+        std::string element;
+        std::string name;
+        std::string settings;
+        std::string palette;
+        int start = 0;
+        int end = 0;
+    };
+
+    std::map<int, SequenceEffect>::iterator Find(uint32_t element, int id) {
+        auto it = _effects.find(id);
+        if (it == _effects.end() || it->second.element != GetStrings().Get(element)) return _effects.end();
+        return it;
+    }
+
+    std::map<int, SequenceEffect> _effects;
+    int _nextId = 1;
+};
+
+static std::string Settings(int op, int effect) {
+    return "E_TEXTCTRL_Text=Op " + std::to_string(op) + "\\, effect " + std::to_string(effect) +
+           ",E_SLIDER_Speed=" + std::to_string(op * 10 + effect) + ",T_CHECKBOX_LayerMorph=0";
+}
+
+static std::string Palette(int op) {
+    return "C_BUTTON_Palette1=#FF0000,C_CHECKBOX_Palette1=" + std::to_string(op % 2);
+}
+
+static std::string Undone(int op, int effect) {
+    return "Model " + std::to_string(op) + "/" + std::to_string(effect) + " " + Settings(op, effect) + "|" + Palette(op);
+}
+
+TEST_F(wxApp_Tests, UndoSpill_RoundTrip) {
+    SpillingUndoManager undo;
+    // everything but the operation being captured is over the limit
+    undo.SetMemoryLimit(1);
+
+    int const ops = 5;
+    int const effects = 3;
+    for (int op = 0; op < ops; op++) {
+        undo.CreateUndoStep();
+        for (int e = 0; e < effects; e++) {
+            undo.CaptureModifiedEffect("Model " + std::to_string(op), 0, e, Settings(op, e), Palette(op));
+        }
+    }
+    // each operation is written out as the one after next begins so only the last two are still in memory
+    EXPECT_GT(undo.GetSpilledSize(), 0u);
+    EXPECT_EQ(undo.GetUndoString(), "Undo: Effect(s) Modified");
+
+    for (int op = ops - 1; op >= 0; op--) {
+        ASSERT_TRUE(undo.CanUndo()) << op;
+        auto undone = undo.UndoOperation();
+        ASSERT_EQ(undone.size(), (size_t)effects) << op;
+        for (int e = 0; e < effects; e++) {
+            EXPECT_EQ(undone[e], Undone(op, effects - 1 - e)) << op;
+        }
+        if (op > 0) {
+            // the older operations are still on disk and say what they are without being read
+            EXPECT_EQ(undo.GetUndoString(), "Undo: Effect(s) Modified") << op;
+        }
+    }
+    EXPECT_FALSE(undo.CanUndo());
+    EXPECT_EQ(undo.GetSpilledSize(), 0u);
+}
+
+TEST_F(wxApp_Tests, UndoSpill_NewOperationsAfterLoad) {
+    SpillingUndoManager undo;
+    undo.SetMemoryLimit(1);
+
+    for (int op = 0; op < 3; op++) {
+        undo.CreateUndoStep();
+        undo.CaptureModifiedEffect("Model " + std::to_string(op), 0, 0, Settings(op, 0), Palette(op));
+    }
+    // undo the operations still in memory then carry on editing
+    EXPECT_EQ(undo.UndoOperation(), std::vector<std::string>({ Undone(2, 0) }));
+    EXPECT_EQ(undo.UndoOperation(), std::vector<std::string>({ Undone(1, 0) }));
+
+    undo.CreateUndoStep();
+    undo.CaptureModifiedEffect("Model 3", 0, 0, Settings(3, 0), Palette(3));
+    undo.CreateUndoStep();
+    undo.CaptureModifiedEffect("Model 4", 0, 0, Settings(4, 0), Palette(4));
+
+    // the new operations come before the one still spilled
+    EXPECT_EQ(undo.UndoOperation(), std::vector<std::string>({ Undone(4, 0) }));
+    EXPECT_EQ(undo.UndoOperation(), std::vector<std::string>({ Undone(3, 0) }));
+    EXPECT_EQ(undo.UndoOperation(), std::vector<std::string>({ Undone(0, 0) }));
+    EXPECT_FALSE(undo.CanUndo());
+}
+
+TEST_F(wxApp_Tests, UndoSpill_UnderLimit) {
+    SpillingUndoManager undo;
+
+    for (int op = 0; op < 3; op++) {
+        undo.CreateUndoStep();
+        undo.CaptureModifiedEffect("Model " + std::to_string(op), 0, 0, Settings(op, 0), Palette(op));
+    }
+    undo.CreateUndoStep();
+    // well under the default limit so nothing goes to disk
+    EXPECT_EQ(undo.GetSpilledSize(), 0u);
+    EXPECT_LE(undo.GetMemoryUsage(), undo.GetMemoryLimit());
+    EXPECT_EQ(undo.UndoOperation(), std::vector<std::string>({ Undone(2, 0) }));
+}
+
+TEST_F(wxApp_Tests, UndoSpill_UndoRedoLastStep) {
+    EditedSequence sequence;
+    sequence.SetMemoryLimit(1);
+
+    int const ops = 6;
+    int const effects = 3;
+    std::vector<std::vector<int>> modified(ops);
+    std::vector<int> deleted(ops);
+    for (int op = 0; op < ops; op++) {
+        std::string const element = "Model " + std::to_string(op);
+        for (int e = 0; e < effects; e++) {
+            modified[op].push_back(sequence.Create(element, "On", Settings(0, e), Palette(0), e * 1000, e * 1000 + 500));
+        }
+        deleted[op] = sequence.Create(element, "Bars", Settings(0, effects), Palette(0), 5000, 6000);
+    }
+
+    // each operation changes every kind of thing so each kind of step goes to disk and comes back
+    std::vector<std::string> contents = { sequence.GetContents() };
+    for (int op = 0; op < ops; op++) {
+        std::string const element = "Model " + std::to_string(op);
+        sequence.CreateUndoStep();
+        for (int e = 0; e < effects; e++) {
+            sequence.Modify(modified[op][e], Settings(op + 1, e), Palette(op + 1));
+        }
+        sequence.Move(modified[op][0], 250, 750);
+        sequence.Add(element, "Twinkle", Settings(op + 1, effects), Palette(op + 1), 7000, 8000);
+        sequence.Delete(deleted[op]);
+        contents.push_back(sequence.GetContents());
+    }
+    EXPECT_GT(sequence.GetSpilledSize(), 0u);
+
+    for (int op = ops; op > 0; op--) {
+        ASSERT_TRUE(sequence.CanUndo()) << op;
+        sequence.UndoLastStep();
+        EXPECT_EQ(sequence.GetContents(), contents[op - 1]) << op;
+    }
+    EXPECT_FALSE(sequence.CanUndo());
+    EXPECT_EQ(sequence.GetSpilledSize(), 0u);
+
+    for (int op = 1; op <= ops; op++) {
+        ASSERT_TRUE(sequence.CanRedo()) << op;
+        sequence.RedoLastStep();
+        EXPECT_EQ(sequence.GetContents(), contents[op]) << op;
+    }
+    EXPECT_FALSE(sequence.CanRedo());
+
+    // what redo put back can be undone again
+    for (int op = ops; op > 0; op--) {
+        ASSERT_TRUE(sequence.CanUndo()) << op;
+        sequence.UndoLastStep();
+        EXPECT_EQ(sequence.GetContents(), contents[op - 1]) << op;
+    }
+    EXPECT_FALSE(sequence.CanUndo());
+}
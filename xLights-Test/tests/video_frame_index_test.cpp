@@ -0,0 +1,69 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "../xLights/VideoFrameCache.h"
+
+#include <cmath>
+
+// The video frame cache keys frames by their index in the video so the time a render asks for and
+// the time the decoder is sent to must agree on which frame that is, however long the video plays
+
+// frame length in ms as num / den for a rate of rateNum / rateDen fps, as VideoReader gives it
+static void Duration(int rateNum, int rateDen, int64_t& num, int64_t& den) {
+    num = (int64_t)rateDen * 1000;
+    den = rateNum;
+}
+
+// the nearest frame worked out the long way
+static long Nearest(int timestampMS, double frameMS) {
+    return (long)std::ceil(timestampMS / frameMS - 0.5);
+}
+
+TEST(VideoFrameIndex, WholeMSFrames) {
+    // 20fps ... frames 50ms long, the first of two equally near
+    EXPECT_EQ(VideoFrameCacheStream::FrameIndex(0, 50, 1), 0);
+    EXPECT_EQ(VideoFrameCacheStream::FrameIndex(25, 50, 1), 0);
+    EXPECT_EQ(VideoFrameCacheStream::FrameIndex(26, 50, 1), 1);
+    EXPECT_EQ(VideoFrameCacheStream::FrameIndex(75, 50, 1), 1);
+    EXPECT_EQ(VideoFrameCacheStream::FrameIndex(76, 50, 1), 2);
+    for (long f = 0; f < 1000; f++) {
+        EXPECT_EQ(VideoFrameCacheStream::FrameTimeMS(f, 50, 1), f * 50);
+    }
+}
+
+TEST(VideoFrameIndex, NonIntegerFrameRates) {
+    for (auto rate : { std::make_pair(30000, 1001), std::make_pair(24000, 1001), std::make_pair(60000, 1001) }) {
+        int64_t num;
+        int64_t den;
+        Duration(rate.first, rate.second, num, den);
+        double const frameMS = (double)num / (double)den;
+
+        // an hour of video ... with frames rounded down to a whole ms this drifts by over 3000 frames at 29.97fps
+        long const frames = (long)(3600000 / frameMS);
+        for (long f = 0; f < frames; f++) {
+            int const ms = VideoFrameCacheStream::FrameTimeMS(f, num, den);
+            ASSERT_LE(std::abs(ms - f * frameMS), 0.5) << rate.first << " " << f;
+            // the decoder is sent to the frame it is decoding
+            ASSERT_EQ(VideoFrameCacheStream::FrameIndex(ms, num, den), f) << rate.first << " " << f;
+        }
+
+        // a 50ms sequence asks for the nearest frame all the way through
+        for (int ms = 0; ms < 3600000; ms += 50) {
+            ASSERT_EQ(VideoFrameCacheStream::FrameIndex(ms, num, den), Nearest(ms, frameMS)) << rate.first << " " << ms;
+        }
+    }
+}
+
+TEST(VideoFrameIndex, UnknownDuration) {
+    EXPECT_EQ(VideoFrameCacheStream::FrameIndex(1000, 0, 1), 0);
+    EXPECT_EQ(VideoFrameCacheStream::FrameTimeMS(10, 0, 1), 0);
+}
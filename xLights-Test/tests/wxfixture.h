@@ -14,13 +14,20 @@
 
 #include "wx/app.h"
 
-struct IP_Host_Tests : public ::testing::Test, wxApp 
+// Tests which need wxWidgets ... sockets, files, strings ... initialised as it is in xLights
+struct wxApp_Tests : public ::testing::Test, wxApp
 {
     wxInitializer init;
-    IP_Host_Tests() {
+    wxApp_Tests() {
         wxApp::SetInstance(new wxApp);
-        if ( !init.IsOk() ) {
-            printf("Failed to initialize wxWidgets.\n");
-        }
     }
+
+    virtual void SetUp() override {
+        ASSERT_TRUE(init.IsOk()) << "Failed to initialize wxWidgets.";
+    }
+};
+
+// the name the IP and host name tests have always used
+struct IP_Host_Tests : public wxApp_Tests
+{
 };
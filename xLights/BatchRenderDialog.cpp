@@ -17,6 +17,7 @@
 #include <wx/intl.h>
 #include <wx/panel.h>
 #include <wx/sizer.h>
+#include <wx/spinctrl.h>
 #include <wx/stattext.h>
 #include <wx/string.h>
 #include <wx/textctrl.h>
@@ -36,6 +37,8 @@ const long BatchRenderDialog::ID_CHOICE_FOLDER = wxNewId();
 const long BatchRenderDialog::ID_STATICTEXT1 = wxNewId();
 const long BatchRenderDialog::ID_TEXTCTRL1 = wxNewId();
 const long BatchRenderDialog::ID_CHECKBOX1 = wxNewId();
+const long BatchRenderDialog::ID_STATICTEXT2 = wxNewId();
+const long BatchRenderDialog::ID_SPINCTRL_CONCURRENT = wxNewId();
 const long BatchRenderDialog::ID_PANEL_HOLDER = wxNewId();
 const long BatchRenderDialog::ID_BUTTON1 = wxNewId();
 const long BatchRenderDialog::ID_BUTTON2 = wxNewId();
@@ -90,6 +93,12 @@ BatchRenderDialog::BatchRenderDialog(wxWindow* parent)
 	CheckBox_ForceHighDefinition = new wxCheckBox(this, ID_CHECKBOX1, _("Force High Definition"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX1"));
 	CheckBox_ForceHighDefinition->SetValue(true);
 	FlexGridSizer2->Add(CheckBox_ForceHighDefinition, 1, wxALL|wxEXPAND, 5);
+	StaticText4 = new wxStaticText(this, ID_STATICTEXT2, _("Sequences at once:"), wxDefaultPosition, wxDefaultSize, 0, _T("ID_STATICTEXT2"));
+	FlexGridSizer2->Add(StaticText4, 1, wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
+	SpinCtrl_Concurrent = new wxSpinCtrl(this, ID_SPINCTRL_CONCURRENT, _T("1"), wxDefaultPosition, wxDefaultSize, 0, 1, 16, 1, _T("ID_SPINCTRL_CONCURRENT"));
+	SpinCtrl_Concurrent->SetValue(_T("1"));
+	SpinCtrl_Concurrent->SetToolTip(_("Render this many sequences at the same time. They share the render threads so this helps most with many small sequences on machines with lots of cores."));
+	FlexGridSizer2->Add(SpinCtrl_Concurrent, 1, wxALL|wxEXPAND, 5);
 	FlexGridSizer1->Add(FlexGridSizer2, 1, wxALL|wxEXPAND, 5);
 	CheckListBoxHolder = new wxPanel(this, ID_PANEL_HOLDER, wxDefaultPosition, wxDefaultSize, wxTAB_TRAVERSAL, _T("ID_PANEL_HOLDER"));
 	CheckListBoxHolder->SetMinSize(wxSize(150,200));
@@ -252,6 +261,7 @@ bool BatchRenderDialog::Prepare(const wxString &showDir)
         wxString folderSelect = "";
         config->Read("BatchRendererFilterSelection", &filterSelect);
         config->Read("BatchRendererFolderSelection", &folderSelect);
+        SpinCtrl_Concurrent->SetValue(config->ReadLong("BatchRendererConcurrent", 1));
         if (filterSelect != wxNOT_FOUND) {
             FilterChoice->SetSelection(filterSelect);
         }
@@ -450,6 +460,7 @@ void BatchRenderDialog::SaveSettings()
         config->Write("BatchRendererFolderSelection", FolderChoice->GetString(FolderChoice->GetSelection()));
         config->Write("BatchRendererSortCol", sortCol);
         config->Write("BatchRendererSortOrder", ascendingOrder);
+        config->Write("BatchRendererConcurrent", SpinCtrl_Concurrent->GetValue());
     }
     SaveWindowPosition("BatchRendererPos", this);
 }
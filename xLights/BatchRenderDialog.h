@@ -17,6 +17,7 @@
  class wxChoice;
  class wxFlexGridSizer;
  class wxPanel;
+ class wxSpinCtrl;
  class wxStaticText;
  class wxTextCtrl;
  //*)
@@ -41,7 +42,9 @@ class BatchRenderDialog: public wxDialog
 		wxChoice* FilterChoice;
 		wxChoice* FolderChoice;
 		wxPanel* CheckListBoxHolder;
+		wxSpinCtrl* SpinCtrl_Concurrent;
 		wxStaticText* StaticText3;
+		wxStaticText* StaticText4;
 		wxTextCtrl* TextCtrl_Selected;
 		//*)
 
@@ -67,6 +70,8 @@ protected:
 		static const long ID_STATICTEXT1;
 		static const long ID_TEXTCTRL1;
 		static const long ID_CHECKBOX1;
+		static const long ID_STATICTEXT2;
+		static const long ID_SPINCTRL_CONCURRENT;
 		static const long ID_PANEL_HOLDER;
 		static const long ID_BUTTON1;
 		static const long ID_BUTTON2;
@@ -0,0 +1,247 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "CPURenderUtils.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#pragma region Blur
+// http://blog.ivank.net/fastest-gaussian-blur.html
+void CPURenderUtils::BoxesForGauss(int d, int n, std::vector<float>& boxes) // standard deviation, number of boxes
+{
+    switch (d) {
+    case 2:
+    case 3:
+        boxes.push_back(1.0);
+        break;
+    case 4:
+    case 5:
+    case 6:
+        boxes.push_back(3.0);
+        break;
+    case 7:
+    case 8:
+    case 9:
+        boxes.push_back(5.0);
+        break;
+    case 10:
+    case 11:
+    case 12:
+        boxes.push_back(7.0);
+        break;
+    case 13:
+    case 14:
+    case 15:
+        boxes.push_back(9.0);
+        break;
+    default:
+        break;
+    }
+    float b = boxes.back();
+    switch (d) {
+    case 2:
+    case 4:
+    case 5:
+    case 7:
+    case 8:
+    case 10:
+    case 11:
+    case 13:
+    case 14:
+        boxes.push_back(b);
+        break;
+    default:
+        boxes.push_back(b + 2.0);
+        break;
+    }
+    switch (d) {
+    case 4:
+    case 7:
+    case 10:
+    case 13:
+        boxes.push_back(b);
+        break;
+    default:
+        boxes.push_back(b + 2.0);
+    }
+}
+
+// Running sum box blur over several lines at once. Element e of line l is at (l * lineStride + e * stride) * 4.
+// Rows are blurred one per call, columns in strips of neighbours so the inner loop walks contiguous memory.
+#define BLUR_STRIP 16
+static void boxBlurLines(const float* scl, float* tcl, int lines, int lineStride, int n, int stride, int r) {
+    float iarr = 1.0f / (r + r + 1.0f);
+    float val[BLUR_STRIP * 4];
+    int maxri = n - 1;
+
+    for (int l = 0; l < lines; l++) {
+        const float* fv = &scl[l * lineStride * 4];
+        float* v = &val[l * 4];
+        for (int c = 0; c < 4; c++) {
+            v[c] = (r + 1) * fv[c];
+        }
+        for (int j = 0; j < r; j++) {
+            const float* p = &scl[(l * lineStride + (j < n ? j : maxri) * stride) * 4];
+            for (int c = 0; c < 4; c++) {
+                v[c] += p[c];
+            }
+        }
+    }
+
+    int ti = 0;
+    int li = 0;
+    int ri = r;
+    auto update = [&](int add, int sub) {
+        for (int l = 0; l < lines; l++) {
+            const float* a = &scl[(l * lineStride + add * stride) * 4];
+            const float* s = &scl[(l * lineStride + sub * stride) * 4];
+            float* v = &val[l * 4];
+            for (int c = 0; c < 4; c++) {
+                v[c] += a[c] - s[c];
+            }
+            if (ti <= maxri) {
+                float* t = &tcl[(l * lineStride + ti * stride) * 4];
+                for (int c = 0; c < 4; c++) {
+                    t[c] = v[c] * iarr;
+                }
+            }
+        }
+        if (ti <= maxri) {
+            ti++;
+        }
+    };
+    for (int j = 0; j <= r; j++) {
+        update(ri <= maxri ? ri++ : maxri, 0);
+    }
+    for (int j = r + 1; j < n - r; j++) {
+        int c = ri <= maxri ? ri++ : maxri;
+        update(c, li <= maxri ? li++ : maxri);
+    }
+    for (int j = n - r; j < n; j++) {
+        update(maxri, li <= maxri ? li++ : maxri);
+    }
+}
+
+void CPURenderUtils::GaussBlur(std::vector<float>& scl, std::vector<float>& tcl, int w, int h, int r) {
+    std::vector<float> bxs;
+    BoxesForGauss(r - 1, 3, bxs);
+    for (float b : bxs) {
+        int br = (b - 1) / 2;
+        parallel_for(0, h, [&](int y) {
+            boxBlurLines(&scl[y * w * 4], &tcl[y * w * 4], 1, w, w, 1, br);
+        }, 8);
+        parallel_for(0, (w + BLUR_STRIP - 1) / BLUR_STRIP, [&](int s) {
+            int x = s * BLUR_STRIP;
+            boxBlurLines(&tcl[x * 4], &scl[x * 4], std::min(BLUR_STRIP, w - x), 1, h, w, br);
+        }, 2);
+    }
+}
+
+#pragma endregion
+
+#pragma region Rotations
+// every row moves the same way so this is the map along one axis
+static std::vector<int> RotateMap(int size, float rotation, int pivotPercent) {
+    float sine = sin((rotation + 90) * M_PI / 180);
+    float pivot = pivotPercent * size / 100;
+
+    std::vector<int> from(size, -1);
+    auto move = [&](int s, float to) {
+        int t = to;
+        if (t >= 0 && t < size) {
+            from[t] = s;
+        }
+    };
+    for (int s = pivot; s < size; ++s) {
+        move(s, sine * (s - pivot) + pivot);
+    }
+    for (int s = pivot - 1; s >= 0; --s) {
+        move(s, -1 * sine * (pivot - s) + pivot);
+    }
+    return from;
+}
+
+std::vector<int> CPURenderUtils::RotateXMap(int w, const GPURenderUtils::RotoZoomSettings& settings) {
+    return RotateMap(w, settings.xrotation, settings.xpivot);
+}
+
+std::vector<int> CPURenderUtils::RotateYMap(int h, const GPURenderUtils::RotoZoomSettings& settings) {
+    return RotateMap(h, settings.yrotation, settings.ypivot);
+}
+
+std::vector<int> CPURenderUtils::RotateZAndZoomMap(int w, int h, const GPURenderUtils::RotoZoomSettings& settings) {
+    if (w <= 0 || h <= 0) {
+        return {};
+    }
+
+    static const float PI_2 = 6.283185307f;
+    float zoom = settings.zoom;
+    int q = settings.zoomquality;
+    int cx = settings.pivotpointx;
+    int cy = settings.pivotpointy;
+    float inc = 1.0 / (float)q;
+
+    float angle = PI_2 * -settings.zrotation;
+    float xoff = (cx * w) / 100.0;
+    float yoff = (cy * h) / 100.0;
+    float anglecos = cos(-angle);
+    float anglesin = sin(-angle);
+
+    // Later samples win, so split the columns into contiguous chunks each recording which source
+    // pixel lands where in their own map. The last chunk to hit a pixel then has the winner.
+    int chunks = std::min(std::min(w, (int)std::thread::hardware_concurrency()), std::min(8, (1 << 22) / (w * h)));
+    chunks = std::max(1, chunks);
+    int perChunk = (w + chunks - 1) / chunks;
+    std::vector<int> from(chunks * w * h, -1);
+    parallel_for(0, chunks, [&](int chunk) {
+        int* f = &from[chunk * w * h];
+        int end = std::min(w, (chunk + 1) * perChunk);
+        for (int x = chunk * perChunk; x < end; x++) {
+            for (int i = 0; i < q; i++) {
+                float xx = (float)x + ((float)i * inc) - xoff;
+                float ux = anglecos * xx * zoom;
+                float vx = -anglesin * xx * zoom;
+                for (int y = 0; y < h; y++) {
+                    for (int j = 0; j < q; j++) {
+                        float yy = (float)y + ((float)j * inc) - yoff;
+                        float u = xoff + ux + anglesin * yy * zoom;
+                        if (u >= 0 && u < w) {
+                            float v = yoff + vx + anglecos * yy * zoom;
+                            if (v >= 0 && v < h) {
+                                f[(int)v * w + (int)u] = y * w + x;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    // fold the later chunks over the first
+    if (chunks > 1) {
+        parallel_for(0, h, [&](int y) {
+            for (int idx = y * w; idx < (y + 1) * w; idx++) {
+                for (int chunk = chunks - 1; chunk > 0; chunk--) {
+                    int s = from[chunk * w * h + idx];
+                    if (s >= 0) {
+                        from[idx] = s;
+                        break;
+                    }
+                }
+            }
+        }, 8);
+        from.resize(w * h);
+    }
+    return from;
+}
+#pragma endregion
@@ -0,0 +1,36 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <vector>
+
+#include "GPURenderUtils.h"
+
+// The CPU versions of the layer blur and roto zoom used when GPURenderUtils does not handle them.
+// They work on plain arrays so their output can be checked on its own.
+class CPURenderUtils {
+public:
+    // the sizes of the n box blurs which approximate a gaussian blur of standard deviation d
+    static void BoxesForGauss(int d, int n, std::vector<float>& boxes);
+    // blurs the w x h RGBA image in scl in place using tcl as scratch
+    static void GaussBlur(std::vector<float>& scl, std::vector<float>& tcl, int w, int h, int r);
+
+    // The rotations used to scatter each source pixel to where it lands with later writes winning. These
+    // work out up front which source pixel ends up on each destination pixel of a w x h buffer so the
+    // copy can be done a row at a time in parallel. -1 means nothing lands there.
+
+    // the source column of each destination column
+    static std::vector<int> RotateXMap(int w, const GPURenderUtils::RotoZoomSettings& settings);
+    // the source row of each destination row
+    static std::vector<int> RotateYMap(int h, const GPURenderUtils::RotoZoomSettings& settings);
+    // the source pixel (y * w + x) of each destination pixel ... empty if the buffer is
+    static std::vector<int> RotateZAndZoomMap(int w, int h, const GPURenderUtils::RotoZoomSettings& settings);
+};
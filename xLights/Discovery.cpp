@@ -31,6 +31,8 @@
 #include <log4cpp/Category.hh>
 
 #include "utils/CurlManager.h"
+#include "utils/NetworkProbe.h"
+#include "utils/ip_utils.h"
 
 #if __has_include(<dns_sd.h>)
 // if the dns_sd include header is available, we can do the bonjour discovery
@@ -307,6 +309,7 @@ Discovery::Discovery(wxWindow* frame, OutputManager* outputManager) : _frame(fra
 }
 
 Discovery::~Discovery() {
+    NetworkProbe::INSTANCE.Cancel(this);
     while (CurlManager::INSTANCE.processCurls()) {
         wxYieldIfNeeded();
     }
@@ -457,6 +460,16 @@ void Discovery::AddBonjour(const std::string &serviceName, std::function<void(co
 }
 
 
+void Discovery::AddConnectProbe(const std::string &ip, int port, std::function<void(bool connected)>&& callback) {
+    probesPending++;
+    NetworkProbe::INSTANCE.Connect(this, ip_utils::ResolveIP(ip), port, 2000, [this, callback](const NetworkProbe::Result& result) {
+        // this is on the probe thread so leave the callback for Discover
+        std::unique_lock<std::mutex> lock(probeLock);
+        bool connected = result.connected;
+        probeResults.push_back([callback, connected]() { callback(connected); });
+    });
+}
+
 void Discovery::SendBroadcastData(int port, uint8_t *buffer, int len) {
     wxIPV4address bcAddress;
     bcAddress.BroadcastAddress();
@@ -489,12 +502,18 @@ DiscoveredData *Discovery::AddController(ControllerEthernet *c) {
     std::string ipaddr = c->GetResolvedIP();
     DiscoveredData *byIp = FindByIp(ipaddr);
     if (byIp == dd) {
-        //first time, probe
-        AddCurl(ipaddr, "/", [ipaddr, c, this] (int rc, const std::string &buffer, const std::string &errorBuffer) {
-            if (rc == 200) {
-                DetectControllerType(ipaddr, c->GetFPPProxy(), buffer);
+        //first time, probe ... but only ask for the page if there is a web server as a controller which is
+        //turned off would otherwise hold discovery open until it gives up
+        AddConnectProbe(ipaddr, 80, [ipaddr, c, this](bool connected) {
+            if (!connected) {
+                return;
             }
-            return true;
+            AddCurl(ipaddr, "/", [ipaddr, c, this] (int rc, const std::string &buffer, const std::string &errorBuffer) {
+                if (rc == 200) {
+                    DetectControllerType(ipaddr, c->GetFPPProxy(), buffer);
+                }
+                return true;
+            });
         });
     }
     return dd;
@@ -647,7 +666,7 @@ DiscoveredData* Discovery::DetectControllerType(const std::string &ip, const std
 void Discovery::Discover() {
     auto endBroadcastTime = wxGetLocalTimeMillis().GetValue() + 2000l;
     discoveryFinishTime = wxGetLocalTimeMillis().GetValue() + 10000L; // 10 seconds max
-    bool running = CurlManager::INSTANCE.processCurls();
+    bool running = CurlManager::INSTANCE.processCurls() || probesPending > 0;
     uint8_t buffer[1500];
     finished = false;
     
@@ -674,8 +693,19 @@ void Discovery::Discover() {
             bj->handleEvents();
         }
 
+        //call back any probes that have finished
+        std::list<std::function<void()>> probed;
+        {
+            std::unique_lock<std::mutex> lock(probeLock);
+            std::swap(probed, probeResults);
+        }
+        for (auto &cb : probed) {
+            cb();
+            probesPending--;
+        }
+
         //now check the http/curls
-        running = CurlManager::INSTANCE.processCurls();
+        running = CurlManager::INSTANCE.processCurls() || probesPending > 0;
         wxYieldIfNeeded();
     }
     finished = true;
@@ -15,6 +15,7 @@
 #include <list>
 #include <vector>
 #include <map>
+#include <mutex>
 #include <curl/curl.h>
 
 #include "outputs/ControllerEthernet.h"
@@ -121,6 +122,9 @@ public:
     // bonjour discovery (on platforms that support it)
     void AddBonjour(const std::string &serviceName, std::function<void(const std::string &ipAddress)>&& callback);
 
+    // checks something is listening on the port without waiting on it (see NetworkProbe). The callback is called from Discover
+    void AddConnectProbe(const std::string &ip, int port, std::function<void(bool connected)>&& callback);
+
     void SendBroadcastData(int port, uint8_t *buffer, int len);
     void SendData(int port, const std::string &host, uint8_t *buffer, int len);
 
@@ -170,6 +174,9 @@ private:
     std::list<DatagramData *> datagrams;
     std::list<BonjourData *> bonjours;
     std::vector<DiscoveredData*> results;
+    std::mutex probeLock;
+    std::list<std::function<void()>> probeResults; // completed probes waiting for Discover to call them back
+    int probesPending = 0;
     bool finished = false;
     
     uint64_t discoveryFinishTime;
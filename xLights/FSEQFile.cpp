@@ -417,6 +417,14 @@ FSEQFile::~FSEQFile() {
     }
 }
 
+bool FSEQFile::readFrame(uint32_t frame, uint8_t* data, uint32_t maxChannels) {
+    std::unique_ptr<FrameData> fd(getFrame(frame));
+    if (fd == nullptr) {
+        return false;
+    }
+    return fd->readFrame(data, maxChannels);
+}
+
 int FSEQFile::seek(uint64_t location, int origin) {
     if (m_seqFile) {
         return fseeko(m_seqFile, location, origin);
@@ -666,6 +674,26 @@ V1FSEQFile::V1FSEQFile(const std::string& fn, FILE* file, const std::vector<uint
 V1FSEQFile::~V1FSEQFile() {
 }
 
+// Copy the ranges from src into the channel indexed data. If packed the ranges are stored
+// back to back in src otherwise src is also channel indexed.
+static bool copyRanges(const uint8_t* src, uint32_t srcSize, bool packed,
+                       const std::vector<std::pair<uint32_t, uint32_t>>& ranges,
+                       uint8_t* data, uint32_t maxChannels) {
+    uint32_t offset = 0;
+    for (auto& rng : ranges) {
+        uint32_t from = packed ? offset : rng.first;
+        if (from + rng.second > srcSize) {
+            return false;
+        }
+        if (rng.first < maxChannels) {
+            uint32_t toCopy = std::min(rng.second, maxChannels - rng.first);
+            memcpy(&data[rng.first], &src[from], toCopy);
+        }
+        offset += rng.second;
+    }
+    return true;
+}
+
 class UncompressedFrameData : public FSEQFile::FrameData {
 public:
     UncompressedFrameData(uint32_t frame,
@@ -685,18 +713,7 @@ public:
     virtual bool readFrame(uint8_t* data, uint32_t maxChannels) override {
         if (m_data == nullptr)
             return false;
-        uint32_t offset = 0;
-        for (auto& rng : m_ranges) {
-            uint32_t toRead = rng.second;
-            if (offset + toRead <= m_size) {
-                uint32_t toCopy = std::min(toRead, maxChannels - rng.first);
-                memcpy(&data[rng.first], &m_data[offset], toCopy);
-                offset += toRead;
-            } else {
-                return false;
-            }
-        }
-        return true;
+        return copyRanges(m_data, m_size, true, m_ranges, data, maxChannels);
     }
 
     [[nodiscard]] virtual size_t GetSize() const override {
@@ -796,6 +813,13 @@ public:
 
     virtual uint8_t getCompressionType() = 0;
     virtual FrameData* getFrame(uint32_t frame) = 0;
+    virtual bool readFrame(uint32_t frame, uint8_t* data, uint32_t maxChannels) {
+        std::unique_ptr<FrameData> fd(getFrame(frame));
+        if (fd == nullptr) {
+            return false;
+        }
+        return fd->readFrame(data, maxChannels);
+    }
 
     virtual uint32_t computeMaxBlocks(int max = 255) { return 0; }
     virtual void addFrame(uint32_t frame, const uint8_t* data) = 0;
@@ -889,6 +913,38 @@ public:
         }
         return data;
     }
+    virtual bool readFrame(uint32_t frame, uint8_t* data, uint32_t maxChannels) override {
+        uint64_t offset = m_file->getChannelCount();
+        offset *= frame;
+        offset += m_seqChanDataOffset;
+        if (seek(offset, SEEK_SET)) {
+            LogErr(VB_SEQUENCE, "Failed to seek to proper offset for channel data! %" PRIu64 "\n", offset);
+            return false;
+        }
+        if (m_file->m_sparseRanges.empty()) {
+            for (auto& rng : m_file->m_rangesToRead) {
+                if (rng.first < m_file->getChannelCount() && rng.first < maxChannels) {
+                    uint32_t toRead = std::min(rng.second, maxChannels - rng.first);
+                    uint64_t doffset = offset;
+                    doffset += rng.first;
+                    seek(doffset, SEEK_SET);
+                    size_t bread = read(&data[rng.first], toRead);
+                    if (bread != toRead) {
+                        LogErr(VB_SEQUENCE, "Failed to read channel data!   Needed to read %d but read %d\n", toRead, (int)bread);
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+        m_readBuffer.resize(m_file->m_dataBlockSize);
+        size_t bread = read(m_readBuffer.data(), m_file->m_dataBlockSize);
+        if (bread != m_file->m_dataBlockSize) {
+            LogErr(VB_SEQUENCE, "Failed to read channel data!   Needed to read %d but read %d\n", m_file->m_dataBlockSize, (int)bread);
+            return false;
+        }
+        return copyRanges(m_readBuffer.data(), m_readBuffer.size(), true, m_file->m_rangesToRead, data, maxChannels);
+    }
     virtual void addFrame(uint32_t frame, const uint8_t* data) override {
         if (m_file->m_sparseRanges.empty()) {
             write(data, m_file->getChannelCount());
@@ -898,6 +954,9 @@ public:
             }
         }
     }
+
+    // reused by readFrame for sparse files so we don't allocate per frame
+    std::vector<uint8_t> m_readBuffer;
 };
 class V2CompressedHandler : public V2Handler {
 public:
@@ -913,6 +972,40 @@ public:
     }
     virtual ~V2CompressedHandler() {}
 
+    // Locate the block containing the frame, decompressing as needed, and return a
+    // pointer to the frame data within the decompressed block
+    virtual const uint8_t* decompressFrame(uint32_t frame) = 0;
+
+    virtual FrameData* getFrame(uint32_t frame) override {
+        const uint8_t* fdata = decompressFrame(frame);
+        UncompressedFrameData* data = new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
+        if (fdata == nullptr) {
+            return data;
+        }
+        if (!m_file->m_sparseRanges.empty()) {
+            memcpy(data->m_data, fdata, m_file->getChannelCount());
+        } else {
+            uint32_t sz = 0;
+            //read the ranges into the buffer
+            for (auto& rng : data->m_ranges) {
+                if (rng.first < m_file->getChannelCount()) {
+                    memcpy(&data->m_data[sz], &fdata[rng.first], rng.second);
+                    sz += rng.second;
+                }
+            }
+        }
+        return data;
+    }
+
+    virtual bool readFrame(uint32_t frame, uint8_t* data, uint32_t maxChannels) override {
+        const uint8_t* fdata = decompressFrame(frame);
+        if (fdata == nullptr) {
+            return false;
+        }
+        // sparse files decompress to just the sparse ranges packed together
+        return copyRanges(fdata, m_file->getChannelCount(), !m_file->m_sparseRanges.empty(), m_file->m_rangesToRead, data, maxChannels);
+    }
+
     virtual uint32_t computeMaxBlocks(int maxNumBlocks) override {
         if (m_maxBlocks > 0) {
             return m_maxBlocks;
@@ -1029,7 +1122,7 @@ public:
     virtual uint8_t getCompressionType() override { return 1; }
     virtual std::string GetType() const override { return "Compressed ZSTD"; }
 
-    virtual FrameData *getFrame(uint32_t frame) override {
+    virtual const uint8_t* decompressFrame(uint32_t frame) override {
 
         if (m_file == nullptr) LogDebug(VB_SEQUENCE, " getFrame m_file unexpectantly null.\n");
 
@@ -1113,30 +1206,15 @@ public:
 
         fidx *= m_file->getChannelCount();
         uint8_t* fdata = (uint8_t*)m_outBuffer.dst;
-        UncompressedFrameData* data = new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
 
         // This stops the crash on load ... but it is not the root cause.
         // But better to not load completely than crashing
         if (fidx < 0) {
             // this is not going to end well ... best to give up here
             LogErr(VB_SEQUENCE, "Frame index calculated as a negative number. Aborting frame %d load.\n", (int)frame);
-            return data;
+            return nullptr;
         }
-
-        if (!m_file->m_sparseRanges.empty()) {
-            memcpy(data->m_data, &fdata[fidx], m_file->getChannelCount());
-        } else {
-            uint32_t sz = 0;
-            //read the ranges into the buffer
-            for (auto& rng : data->m_ranges) {
-                if (rng.first < m_file->getChannelCount()) {
-                    uint64_t start = fidx + rng.first;
-                    memcpy(&data->m_data[sz], &fdata[start], rng.second);
-                    sz += rng.second;
-                }
-            }
-        }
-        return data;
+        return &fdata[fidx];
     }
     void compressData(ZSTD_CStream* m_cctx, ZSTD_inBuffer_s& input, ZSTD_outBuffer_s& output) {
         ZSTD_compressStream2(m_cctx, &output, &input, ZSTD_e_continue);
@@ -1279,7 +1357,7 @@ public:
     virtual uint8_t getCompressionType() override { return 2; }
     virtual std::string GetType() const override { return "Compressed ZLIB"; }
 
-    virtual FrameData* getFrame(uint32_t frame) override {
+    virtual const uint8_t* decompressFrame(uint32_t frame) override {
         if (m_curBlock >= m_file->m_frameOffsets.size() || (frame < m_file->m_frameOffsets[m_curBlock].first) || (frame >= m_file->m_frameOffsets[m_curBlock + 1].first)) {
             //frame is not in the current block
             m_curBlock = 0;
@@ -1329,20 +1407,7 @@ public:
         int fidx = frame - m_file->m_frameOffsets[m_curBlock].first;
         fidx *= m_file->getChannelCount();
         uint8_t* fdata = (uint8_t*)m_outBuffer;
-        UncompressedFrameData* data = new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
-        if (!m_file->m_sparseRanges.empty()) {
-            memcpy(data->m_data, &fdata[fidx], m_file->getChannelCount());
-        } else {
-            uint32_t sz = 0;
-            //read the ranges into the buffer
-            for (auto& rng : data->m_ranges) {
-                if (rng.first < m_file->getChannelCount()) {
-                    memcpy(&data->m_data[sz], &fdata[fidx + rng.first], rng.second);
-                    sz += rng.second;
-                }
-            }
-        }
-        return data;
+        return &fdata[fidx];
     }
     virtual void addFrame(uint32_t frame, const uint8_t* data) override {
         if (m_outBuffer == nullptr) {
@@ -1822,6 +1887,24 @@ void V2FSEQFile::prepareRead(const std::vector<std::pair<uint32_t, uint32_t>>& r
     }
     m_handler->prepareRead(startFrame);
 }
+bool V2FSEQFile::readFrame(uint32_t frame, uint8_t* data, uint32_t maxChannels) {
+    if (m_rangesToRead.empty()) {
+        std::vector<std::pair<uint32_t, uint32_t>> range;
+        range.push_back(std::pair<uint32_t, uint32_t>(0, getMaxChannel()));
+        prepareRead(range, frame);
+    }
+    if (frame >= m_seqNumFrames) {
+        return false;
+    }
+    if (m_handler != nullptr) {
+        try {
+            return m_handler->readFrame(frame, data, maxChannels);
+        } catch (...) {
+            LogErr(VB_SEQUENCE, "Error reading frame from handler %s.\n", m_handler->GetType().c_str());
+        }
+    }
+    return false;
+}
 FrameData* V2FSEQFile::getFrame(uint32_t frame) {
     if (m_rangesToRead.empty()) {
         std::vector<std::pair<uint32_t, uint32_t>> range;
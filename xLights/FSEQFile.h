@@ -73,6 +73,10 @@ public:
     //It may not be used right away and will be deleted at some point in the future
     virtual FrameData *getFrame(uint32_t frame) = 0;
 
+    //Read the frame straight into the callers buffer (indexed by channel) without
+    //allocating a FrameData.  Only the ranges passed to prepareRead are written.
+    virtual bool readFrame(uint32_t frame, uint8_t *data, uint32_t maxChannels);
+
     //For writing to the fseq file
     virtual void enableMinorVersionFeatures(uint8_t ver) {}
     virtual void initializeFromFSEQ(const FSEQFile& fseq);
@@ -168,6 +172,7 @@ public:
 
     virtual void prepareRead(const std::vector<std::pair<uint32_t, uint32_t>> &ranges, uint32_t startFrame = 0) override;
     virtual FrameData *getFrame(uint32_t frame) override;
+    virtual bool readFrame(uint32_t frame, uint8_t *data, uint32_t maxChannels) override;
 
     virtual void writeHeader() override;
     virtual void addFrame(uint32_t frame,
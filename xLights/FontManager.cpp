@@ -9,6 +9,9 @@
  **************************************************************/
 
 #include "FontManager.h"
+
+#include <mutex>
+
 #include "../../../include/xLightsFontImages.h"
 
 #define FONT_BITMAP_COLUMNS 8
@@ -36,6 +39,16 @@ int xlFont::GetCharWidth(int ascii)
     return widths[ascii];
 }
 
+const uint8_t* xlFont::GetGlyph(int ascii) const
+{
+    if (ascii < 0 || ascii >= XL_FONT_WIDTHS || glyphs.empty())
+    {
+        return nullptr;
+    }
+
+    return &glyphs[ascii * char_width * char_height];
+}
+
 void xlFont::GatherInfo()
 {
     int index = 0;
@@ -64,6 +77,27 @@ void xlFont::GatherInfo()
             index++;
         }
     }
+
+    glyphs.assign(XL_FONT_WIDTHS * char_width * char_height, 0);
+    for( int ascii = 0; ascii < XL_FONT_WIDTHS; ascii++ )
+    {
+        int x_start_corner = (ascii % FONT_BITMAP_COLUMNS) * (char_width + 1) + 1;
+        int y_start_corner = (ascii / FONT_BITMAP_COLUMNS) * (char_height + 1) + 1;
+        uint8_t* glyph = &glyphs[ascii * char_width * char_height];
+        for( int y = 0; y < char_height; y++ )
+        {
+            int y_pos = y_start_corner + y;
+            for( int x = 0; x < char_width; x++ )
+            {
+                int x_pos = x_start_corner + x;
+                if( x_pos < image.GetWidth() && y_pos < image.GetHeight() &&
+                    image.GetRed(x_pos, y_pos) == 255 && image.GetGreen(x_pos, y_pos) == 255 && image.GetBlue(x_pos, y_pos) == 255 )
+                {
+                    glyph[y * char_width + x] = 1;
+                }
+            }
+        }
+    }
 }
 
 FontManager::FontManager()
@@ -81,6 +115,10 @@ FontManager::~FontManager()
 
 void FontManager::init()
 {
+    // text effects on several render threads can all get here at once
+    static std::mutex lock;
+    std::unique_lock<std::mutex> locker(lock);
+
     if( !initialized )
     {
         bitmaps.push_back(wxBITMAP_PNG_FROM_DATA(font_5_5x5_thin_system));
@@ -11,6 +11,7 @@
  **************************************************************/
 
 #include <vector>
+#include <stdint.h>
 #include "wx/wx.h"
 
 #define XL_FONT_WIDTHS 128
@@ -27,12 +28,16 @@ class xlFont
         int GetCapsHeight() { return caps_height; }
         void SetCapsHeight( int height ) { caps_height = height; }
         void GatherInfo();
+        // GetWidth() x GetHeight() bytes, rows top down, non zero where the character has a pixel set.
+        // nullptr for characters outside the font
+        const uint8_t* GetGlyph(int ascii) const;
 
     protected:
         int char_width;   // the standard character width
         int char_height;  // the standard character height
         int caps_height;  // the capital letter height
         int widths[XL_FONT_WIDTHS];  // the trimmed width of each character
+        std::vector<uint8_t> glyphs; // the pixels of every character so rendering never needs to touch the bitmap
         wxBitmap& bitmap;
 };
 
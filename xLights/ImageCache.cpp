@@ -0,0 +1,357 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "ImageCache.h"
+#include "effects/GIFImage.h"
+
+#include <wx/filefn.h>
+#include <wx/image.h>
+#include <wx/log.h>
+
+#include <algorithm>
+
+#include <log4cpp/Category.hh>
+
+std::mutex ImageCache::__lock;
+std::map<std::string, std::shared_ptr<ImageCacheSource>> ImageCache::__sources;
+std::map<std::string, ImageCache::Entry> ImageCache::__images;
+std::atomic<size_t> ImageCache::__budget = 256 * 1024 * 1024;
+std::atomic<uint64_t> ImageCache::__generation = 1;
+
+static std::atomic<size_t> __used = 0;
+static uint64_t __clock = 0; // protected by __lock
+static std::atomic<uint64_t> __hits = 0;
+static std::atomic<uint64_t> __misses = 0;
+
+// One file on disk
+class ImageCacheSource
+{
+public:
+    std::string _filename;
+    time_t _modified = 0;
+    int _frameCount = 1;
+    size_t _bytes = 0; // what the GIF decoder holds
+    uint64_t _lastUsed = 0;
+    std::atomic<uint64_t> _checked = 0; // generation the modified time was last checked in
+    std::mutex _lock; // GIFImage composes frames as they are first asked for so only one caller at a time
+    std::unique_ptr<GIFImage> _gif;
+
+    ImageCacheSource(const std::string& filename, bool suppressGIFBackground, time_t modified, uint64_t generation) :
+        _filename(filename), _modified(modified), _checked(generation)
+    {
+        static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+        wxLogNull logNo; // suppress popups from png images. See http://trac.wxwidgets.org/ticket/15331
+
+        // There seems to be a bug on linux where this function crashes occasionally
+#ifdef LINUX
+        logger_base.debug("About to count images in bitmap %s.", (const char*)filename.c_str());
+#endif
+        _frameCount = wxImage::GetImageCount(filename);
+        if (_frameCount <= 0) {
+            logger_base.error("Image %s reports %d frames which is invalid. Overriding it to be 1.", (const char*)filename.c_str(), _frameCount);
+
+            // override it to 1
+            _frameCount = 1;
+        }
+
+        if (_frameCount > 1) {
+#ifdef DEBUG_GIF
+            logger_base.debug("Preparing GIF file for reading: %s", (const char*)filename.c_str());
+#endif
+            _gif = std::make_unique<GIFImage>(filename, suppressGIFBackground);
+            if (!_gif->IsOk()) {
+                _gif.reset();
+                _frameCount = 1;
+            } else {
+                // the decoder keeps every frame at a byte a pixel plus the last composed frame
+                size_t pixels = (size_t)_gif->GetImageSize().GetWidth() * _gif->GetImageSize().GetHeight();
+                _bytes = pixels * _frameCount + pixels * 4;
+            }
+        }
+    }
+};
+
+static std::shared_ptr<CachedImage> FromImage(const wxImage& image)
+{
+    auto res = std::make_shared<CachedImage>();
+    if (!image.IsOk()) return res;
+
+    res->_width = image.GetWidth();
+    res->_height = image.GetHeight();
+    size_t pixels = (size_t)res->_width * res->_height;
+    res->_data.resize(pixels * 4);
+
+    const unsigned char* rgb = image.GetData();
+    const unsigned char* alpha = image.HasAlpha() ? image.GetAlpha() : nullptr;
+    bool hasMask = image.HasMask();
+    unsigned char mr = hasMask ? image.GetMaskRed() : 0;
+    unsigned char mg = hasMask ? image.GetMaskGreen() : 0;
+    unsigned char mb = hasMask ? image.GetMaskBlue() : 0;
+
+    uint8_t* d = res->_data.data();
+    for (size_t i = 0; i < pixels; ++i, rgb += 3, d += 4) {
+        d[0] = rgb[0];
+        d[1] = rgb[1];
+        d[2] = rgb[2];
+        d[3] = alpha == nullptr ? 255 : alpha[i];
+        // same test as wxImage::IsTransparent
+        if ((hasMask && rgb[0] == mr && rgb[1] == mg && rgb[2] == mb) || (alpha != nullptr && alpha[i] < wxIMAGE_ALPHA_THRESHOLD)) {
+            d[3] = 0;
+        }
+    }
+    return res;
+}
+
+static std::string SourceKey(const std::string& filename, bool suppressGIFBackground)
+{
+    return filename + (suppressGIFBackground ? "|S" : "|B");
+}
+
+// images include the modified time so ones from a file since replaced on disk are never used
+static std::string ImageKey(const std::string& sourceKey, time_t modified)
+{
+    return sourceKey + "|" + std::to_string(modified) + "|";
+}
+
+#pragma region ImageCache
+std::shared_ptr<ImageCacheSource> ImageCache::GetSource(const std::string& filename, bool suppressGIFBackground)
+{
+    std::string key = SourceKey(filename, suppressGIFBackground);
+    uint64_t generation = __generation;
+    std::shared_ptr<ImageCacheSource> existing;
+    {
+        std::unique_lock<std::mutex> lock(__lock);
+        auto it = __sources.find(key);
+        if (it != __sources.end()) {
+            it->second->_lastUsed = ++__clock;
+            if (it->second->_checked == generation) return it->second;
+            existing = it->second;
+        }
+    }
+
+    // first use since the render started so see if the file has been replaced
+    time_t modified = wxFileModificationTime(filename);
+    if (existing != nullptr && existing->_modified == modified) {
+        existing->_checked = generation;
+        return existing;
+    }
+
+    // reading a large GIF can take a while so dont hold everyone else up while we do it
+    auto source = std::make_shared<ImageCacheSource>(filename, suppressGIFBackground, modified, generation);
+
+    std::unique_lock<std::mutex> lock(__lock);
+    auto it = __sources.find(key);
+    if (it != __sources.end()) {
+        if (it->second->_modified == modified) {
+            it->second->_checked = generation;
+            return it->second;
+        }
+        // the file changed so nothing from the old one will be asked for again
+        RemoveSource(it);
+    }
+    source->_lastUsed = ++__clock;
+    __sources[key] = source;
+    __used += source->_bytes;
+    Trim();
+    return source;
+}
+
+// __lock must be held. Drops the source and every image made from it
+void ImageCache::RemoveSource(std::map<std::string, std::shared_ptr<ImageCacheSource>>::iterator it)
+{
+    std::string prefix = ImageKey(it->first, it->second->_modified);
+    for (auto i = __images.lower_bound(prefix); i != __images.end() && i->first.compare(0, prefix.size(), prefix) == 0;) {
+        __used -= i->second._image->_data.size();
+        i = __images.erase(i);
+    }
+    __used -= it->second->_bytes;
+    __sources.erase(it);
+}
+
+std::shared_ptr<const CachedImage> ImageCache::Find(const std::string& key)
+{
+    std::unique_lock<std::mutex> lock(__lock);
+    auto it = __images.find(key);
+    if (it == __images.end()) {
+        ++__misses;
+        return nullptr;
+    }
+    ++__hits;
+    it->second._lastUsed = ++__clock;
+    return it->second._image;
+}
+
+std::shared_ptr<const CachedImage> ImageCache::Add(const std::string& key, std::shared_ptr<const CachedImage> image)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::unique_lock<std::mutex> lock(__lock);
+
+    // someone else may have built it while we were
+    auto it = __images.find(key);
+    if (it != __images.end()) {
+        it->second._lastUsed = ++__clock;
+        return it->second._image;
+    }
+
+    __images[key] = { image, ++__clock };
+    __used += image->_data.size();
+    Trim();
+    return image;
+}
+
+// __lock must be held. Once over budget frees the least recently used images and GIFs down to 3/4 of
+// it so we are not doing this on every image. Anything an effect is still holding stays valid
+void ImageCache::Trim()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (__used <= __budget) return;
+
+    // second is true for a source
+    std::vector<std::pair<uint64_t, std::pair<bool, std::string>>> ages;
+    ages.reserve(__images.size() + __sources.size());
+    for (const auto& i : __images) {
+        ages.push_back({ i.second._lastUsed, { false, i.first } });
+    }
+    for (const auto& s : __sources) {
+        if (s.second->_bytes != 0) {
+            ages.push_back({ s.second->_lastUsed, { true, s.first } });
+        }
+    }
+    std::sort(ages.begin(), ages.end());
+
+    size_t target = __budget * 3 / 4;
+    size_t before = __used;
+    for (const auto& a : ages) {
+        if (__used <= target) break;
+        if (a.second.first) {
+            auto s = __sources.find(a.second.second);
+            __used -= s->second->_bytes;
+            __sources.erase(s);
+        } else {
+            auto i = __images.find(a.second.second);
+            __used -= i->second._image->_data.size();
+            __images.erase(i);
+        }
+    }
+
+    logger_base.debug("ImageCache: Over budget %dMB ... released %dMB.", (int)(__budget / (1024 * 1024)), (int)((before - __used) / (1024 * 1024)));
+}
+
+int ImageCache::GetFrameCount(const std::string& filename, bool suppressGIFBackground)
+{
+    return GetSource(filename, suppressGIFBackground)->_frameCount;
+}
+
+int ImageCache::GetFrameForTime(const std::string& filename, bool suppressGIFBackground, int msec, bool loop)
+{
+    auto source = GetSource(filename, suppressGIFBackground);
+    if (source->_gif == nullptr) return 0;
+    return source->_gif->CalcFrameForTime(msec, loop);
+}
+
+std::shared_ptr<const CachedImage> ImageCache::GetImage(const std::string& filename, bool suppressGIFBackground, int frame)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    auto source = GetSource(filename, suppressGIFBackground);
+    std::string key = ImageKey(SourceKey(filename, suppressGIFBackground), source->_modified) + std::to_string(frame);
+    auto image = Find(key);
+    if (image != nullptr) return image;
+
+    std::shared_ptr<CachedImage> res;
+    if (source->_gif != nullptr) {
+        std::unique_lock<std::mutex> lock(source->_lock);
+        if (frame < 0) {
+            // past the end of a gif which does not loop
+            res = FromImage(wxImage(source->_gif->GetImageSize()));
+        } else {
+            int f = std::min(frame, source->_frameCount - 1);
+            res = FromImage(source->_gif->GetFrame(f));
+            // the cache now has it ... only the composed frame the next one is built on needs to be kept
+            source->_gif->ReleaseFrames(f);
+        }
+    } else {
+        wxLogNull logNo; // suppress popups from png images. See http://trac.wxwidgets.org/ticket/15331
+        wxImage i;
+        if (!i.LoadFile(filename, wxBITMAP_TYPE_ANY, 0)) {
+            logger_base.error("Error loading image file: %s.", (const char*)filename.c_str());
+            i.Create(5, 5, true);
+        }
+        res = FromImage(i);
+    }
+    return Add(key, res);
+}
+
+std::shared_ptr<const CachedImage> ImageCache::GetImage(const std::string& filename, bool suppressGIFBackground, int frame, int width, int height)
+{
+    if (width < 1 || height < 1) return nullptr;
+
+    auto source = GetSource(filename, suppressGIFBackground);
+    std::string key = ImageKey(SourceKey(filename, suppressGIFBackground), source->_modified) + std::to_string(frame) + "|" + std::to_string(width) + "x" + std::to_string(height);
+    auto image = Find(key);
+    if (image != nullptr) return image;
+
+    auto raw = GetImage(filename, suppressGIFBackground, frame);
+    if (raw->_width == width && raw->_height == height) return raw;
+    if (raw->_width == 0 || raw->_height == 0) return nullptr;
+
+    // back into a wxImage so the scaling is identical to what the effects always did. Transparency
+    // is already folded into the alpha so it survives nearest neighbour scaling unchanged
+    wxImage i(raw->_width, raw->_height, false);
+    i.InitAlpha();
+    unsigned char* rgb = i.GetData();
+    unsigned char* alpha = i.GetAlpha();
+    const uint8_t* s = raw->_data.data();
+    size_t pixels = (size_t)raw->_width * raw->_height;
+    for (size_t p = 0; p < pixels; ++p, s += 4, rgb += 3) {
+        rgb[0] = s[0];
+        rgb[1] = s[1];
+        rgb[2] = s[2];
+        alpha[p] = s[3];
+    }
+    i.Rescale(width, height);
+
+    return Add(key, FromImage(i));
+}
+
+void ImageCache::Purge()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::unique_lock<std::mutex> lock(__lock);
+    uint64_t hits = __hits;
+    uint64_t lookups = hits + __misses;
+    if (lookups != 0) {
+        logger_base.debug("ImageCache: %d images %dMB, %llu hits from %llu lookups (%d%%).", (int)__images.size(), (int)(__used / (1024 * 1024)),
+                          (unsigned long long)hits, (unsigned long long)lookups, (int)(hits * 100 / lookups));
+    }
+    __images.clear();
+    __sources.clear();
+    __used = 0;
+}
+
+size_t ImageCache::GetMemoryUsed()
+{
+    return __used;
+}
+
+uint64_t ImageCache::GetHits()
+{
+    return __hits;
+}
+
+uint64_t ImageCache::GetMisses()
+{
+    return __misses;
+}
+#pragma endregion
@@ -0,0 +1,82 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+class ImageCacheSource;
+
+// A decoded image. Pixels are RGBA, rows top down. Pixels wxImage considers transparent
+// (mask colour or alpha below the threshold) have an alpha of 0
+struct CachedImage
+{
+    int _width = 0;
+    int _height = 0;
+    std::vector<uint8_t> _data;
+
+    const uint8_t* GetPixel(int x, int y) const { return &_data[(y * _width + x) * 4]; }
+};
+
+// Decoded and rescaled images shared across every effect using the same picture.
+//
+// Images are keyed by file, modified time, frame and size so the same logo or GIF on dozens of
+// models is decoded and scaled once no matter how many buffers or render threads show it. Animated
+// GIFs are composed once per file. Images and the GIFs they come from share one memory budget and the
+// least recently used are dropped first. Files are checked for changes on disk once per render.
+class ImageCache
+{
+    struct Entry
+    {
+        std::shared_ptr<const CachedImage> _image;
+        uint64_t _lastUsed = 0;
+    };
+
+    static std::mutex __lock;
+    static std::map<std::string, std::shared_ptr<ImageCacheSource>> __sources;
+    static std::map<std::string, Entry> __images;
+    static std::atomic<size_t> __budget;
+    static std::atomic<uint64_t> __generation;
+
+    static std::shared_ptr<ImageCacheSource> GetSource(const std::string& filename, bool suppressGIFBackground);
+    static std::shared_ptr<const CachedImage> Find(const std::string& key);
+    static std::shared_ptr<const CachedImage> Add(const std::string& key, std::shared_ptr<const CachedImage> image);
+    static void RemoveSource(std::map<std::string, std::shared_ptr<ImageCacheSource>>::iterator it);
+    static void Trim();
+
+public:
+
+    // Number of frames in the file ... always at least 1
+    static int GetFrameCount(const std::string& filename, bool suppressGIFBackground);
+    // The frame of an animated image to show at a time, -1 once it has ended if not looping
+    static int GetFrameForTime(const std::string& filename, bool suppressGIFBackground, int msec, bool loop);
+
+    // The frame at its own size. A file which cannot be loaded gives a small black image like wxImage::Create
+    static std::shared_ptr<const CachedImage> GetImage(const std::string& filename, bool suppressGIFBackground, int frame = 0);
+    // The frame rescaled exactly as wxImage::Rescale would. nullptr if the size is empty
+    static std::shared_ptr<const CachedImage> GetImage(const std::string& filename, bool suppressGIFBackground, int frame, int width, int height);
+
+    // call before each render ... files are only checked for changes the first time they are used after it
+    static void CheckForChanges() { ++__generation; }
+    // drop everything ... images effects are still holding remain valid until they let go
+    static void Purge();
+    static void SetMemoryBudget(size_t bytes) { __budget = bytes; }
+    static size_t GetMemoryBudget() { return __budget; }
+    static size_t GetMemoryUsed();
+    static uint64_t GetHits();
+    static uint64_t GetMisses();
+};
@@ -29,6 +29,8 @@
 #include "models/ModelGroup.h"
 #include "ExternalHooks.h"
 
+#include <algorithm>
+
 #include <log4cpp/Category.hh>
 
 BEGIN_EVENT_TABLE(ModelPreview, GRAPHICS_BASE_CLASS)
@@ -757,25 +759,123 @@ void ModelPreview::Render()
     }
 }
 
+bool ModelPreview::IsFramePlanValid(const std::vector<Model*>& models) const
+{
+    if (!framePlanValid || xlights == nullptr || framePlanModelsChangeCount != xlights->modelsChangeCount || framePlanModels.size() != models.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < models.size(); ++i) {
+        const auto& pm = framePlanModels[i];
+        Model* m = models[i];
+        if (pm.model != m || pm.changeCount != m->GetChangeCount() || pm.nodeCount != m->GetNodeCount() ||
+            pm.firstNode != (pm.nodeCount == 0 ? nullptr : m->GetNode(0))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ModelPreview::BuildFramePlan(const std::vector<Model*>& models)
+{
+    framePlanModels.clear();
+    framePlanRGBSource.clear();
+    framePlanRGBTarget.clear();
+    framePlanByteSource.clear();
+    framePlanByteTarget.clear();
+    framePlanOther.clear();
+
+    framePlanModels.reserve(models.size());
+    for (auto m : models) {
+        FramePlanModel pm;
+        pm.model = m;
+        pm.changeCount = m->GetChangeCount();
+        pm.nodeCount = m->GetNodeCount();
+        pm.firstNode = pm.nodeCount == 0 ? nullptr : m->GetNode(0);
+        framePlanModels.push_back(pm);
+
+        for (uint32_t n = 0; n < pm.nodeCount; ++n) {
+            NodeBaseClass* node = m->GetNode(n);
+            uint32_t start = m->NodeStartChannel(n);
+            uint8_t mapping[3];
+            if (!node->GetDirectChannelMapping(mapping)) {
+                framePlanOther.push_back({ node, start });
+            } else if (mapping[0] == 0 && mapping[1] == 1 && mapping[2] == 2) {
+                framePlanRGBSource.push_back(start);
+                framePlanRGBTarget.push_back(node->GetColorData());
+            } else {
+                for (int x = 0; x < 3; ++x) {
+                    if (mapping[x] != 255) {
+                        framePlanByteSource.push_back(start + mapping[x]);
+                        framePlanByteTarget.push_back(node->GetColorData() + x);
+                    }
+                }
+            }
+        }
+    }
+
+    framePlanModelsChangeCount = xlights == nullptr ? 0 : xlights->modelsChangeCount;
+    framePlanValid = true;
+    depthSortedValid = false;
+}
+
+void ModelPreview::ApplyFramePlan(const unsigned char* data) const
+{
+    const size_t rgb = framePlanRGBSource.size();
+    const uint32_t* rgbSource = framePlanRGBSource.data();
+    uint8_t* const* rgbTarget = framePlanRGBTarget.data();
+    for (size_t i = 0; i < rgb; ++i) {
+        const unsigned char* s = data + rgbSource[i];
+        uint8_t* t = rgbTarget[i];
+        t[0] = s[0];
+        t[1] = s[1];
+        t[2] = s[2];
+    }
+
+    const size_t bytes = framePlanByteSource.size();
+    const uint32_t* byteSource = framePlanByteSource.data();
+    uint8_t* const* byteTarget = framePlanByteTarget.data();
+    for (size_t i = 0; i < bytes; ++i) {
+        *byteTarget[i] = data[byteSource[i]];
+    }
+
+    for (const auto& it : framePlanOther) {
+        it.first->SetFromChannels(&data[it.second]);
+    }
+}
+
+const std::vector<Model*>& ModelPreview::GetDepthSortedModels(const std::vector<Model*>& models)
+{
+    if (!depthSortedValid || depthSortedMatrix != ProjViewMatrix) {
+        std::vector<std::pair<int32_t, Model*>> sorted;
+        sorted.reserve(models.size());
+        for (auto m : models) {
+            auto p = ProjViewMatrix * glm::vec4(m->GetHcenterPos(), m->GetVcenterPos(), m->GetDcenterPos(), 1);
+            sorted.push_back({ (int32_t)std::round(p.z * 100), m });
+        }
+        // back to front, models at the same depth keep their order
+        std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        depthSortedModels.clear();
+        depthSortedModels.reserve(sorted.size());
+        for (const auto& it : sorted) {
+            depthSortedModels.push_back(it.second);
+        }
+        depthSortedMatrix = ProjViewMatrix;
+        depthSortedValid = true;
+    }
+    return depthSortedModels;
+}
+
 void ModelPreview::Render(uint32_t frameTime, const unsigned char *data, bool swapBuffers/*=true*/) {
     currentFrameTime = frameTime;
     if (StartDrawing(mPointSize)) {
         const std::vector<Model*> &models = GetModels();
-        std::map<int32_t, std::list<Model*>> sortedModels;
-        for (auto m : models) {
-            int NodeCnt = m->GetNodeCount();
-            for (size_t n = 0; n < NodeCnt; ++n) {
-                int start = m->NodeStartChannel(n);
-                m->SetNodeChannelValues(n, &data[start]);
-            }
-            auto p = ProjViewMatrix * glm::vec4(m->GetHcenterPos(), m->GetVcenterPos(), m->GetDcenterPos(), 1);
-            int z = std::round(p.z * 100);
-            sortedModels[z].push_back(m);
+        if (!IsFramePlanValid(models)) {
+            BuildFramePlan(models);
         }
-        for (auto iter = sortedModels.rbegin(); iter != sortedModels.rend(); ++iter) {
-            for (auto m : iter->second) {
-                m->DisplayModelOnWindow(this, currentContext, solidProgram, transparentProgram, is3d);
-            }
+        ApplyFramePlan(data);
+        for (auto m : GetDepthSortedModels(models)) {
+            m->DisplayModelOnWindow(this, currentContext, solidProgram, transparentProgram, is3d);
         }
         // draw all the view objects
         if (is3d) {
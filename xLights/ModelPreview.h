@@ -33,6 +33,7 @@
 
 class Model;
 class ModelGroup;
+class NodeBaseClass;
 class PreviewPane;
 class LayoutGroup;
 class xLightsFrame;
@@ -240,6 +241,31 @@ private:
     xlGraphicsContext *currentContext = nullptr;
     std::list<xlTexture *> texturesToDelete;
 
+    // Precomputed conversion of a whole frame of channel data into the node colours of the models in
+    // this preview plus their back to front draw order. Rebuilt only when the models or camera change.
+    struct FramePlanModel {
+        Model* model = nullptr;
+        unsigned long changeCount = 0;
+        uint32_t nodeCount = 0;
+        NodeBaseClass* firstNode = nullptr;
+    };
+    std::vector<FramePlanModel> framePlanModels;
+    unsigned int framePlanModelsChangeCount = 0;
+    bool framePlanValid = false;
+    std::vector<uint32_t> framePlanRGBSource;    // in order rgb nodes ... one 3 byte copy each
+    std::vector<uint8_t*> framePlanRGBTarget;
+    std::vector<uint32_t> framePlanByteSource;   // every other directly mapped colour byte
+    std::vector<uint8_t*> framePlanByteTarget;
+    std::vector<std::pair<NodeBaseClass*, uint32_t>> framePlanOther; // nodes which must convert themselves
+    std::vector<Model*> depthSortedModels;
+    glm::mat4 depthSortedMatrix;
+    bool depthSortedValid = false;
+
+    bool IsFramePlanValid(const std::vector<Model*>& models) const;
+    void BuildFramePlan(const std::vector<Model*>& models);
+    void ApplyFramePlan(const unsigned char* data) const;
+    const std::vector<Model*>& GetDepthSortedModels(const std::vector<Model*>& models);
+
 
 	DECLARE_EVENT_TABLE()
 };
@@ -16,9 +16,12 @@
 //*)
 
 #include <wx/listbase.h>
+#include <wx/progdlg.h>
 
 #include "xLightsMain.h"
+#include "controllers/BaseController.h"
 #include "controllers/ControllerCaps.h"
+#include "controllers/ControllerUploadScheduler.h"
 #include "outputs/ControllerEthernet.h"
 
 #include "utils/ip_utils.h"
@@ -121,16 +124,44 @@ void MultiControllerUploadDialog::OnButton_UploadClick(wxCommandEvent& event)
 
     wxArrayInt ch;
     CheckListBox_Controllers->GetCheckedItems(ch);
-    std::list<int> fake;
+
+    // connect to all the controllers at once, then upload to them one at a time as the drivers' uploads show dialogs
+    ControllerUploadScheduler scheduler([](Controller* c) { return BaseController::CreateBaseController(c); }, BaseController::CanConnectOnBackgroundThread);
+    for (int i = 0; i < ch.Count(); i++) {
+        scheduler.Add(_controllers[ch[i]]);
+    }
+    scheduler.Start();
+    {
+        wxProgressDialog progress("Connecting to controllers ...", "", ch.Count(), this, wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME);
+        while (!scheduler.Process(100)) {
+            auto p = scheduler.GetProgress();
+            if (!progress.Update(p.GetDone(), wxString::Format("%d of %d connected. %s", p.connected, p.total, p.current)) ||
+                wxGetKeyState(WXK_ESCAPE)) {
+                scheduler.Cancel();
+            }
+        }
+    }
 
     for (int i = 0; i < ch.Count() && wxGetKeyState(WXK_ESCAPE) == false; i++) {
         auto c = _controllers[ch[i]];
         wxString message;
         TextCtrl_Log->AppendText("Uploading to controller '" + c->GetName() + "' [" + c->GetIP() + "] " + c->GetVMV() + "\n");
-        _frame->UploadInputToController(c, message);
+        auto bc = scheduler.GetBaseController(c);
+        if (bc == nullptr) {
+            if (scheduler.GetState(c) == ControllerUploadScheduler::State::CANCELLED) {
+                TextCtrl_Log->AppendText("    Cancelled.\n");
+            } else {
+                TextCtrl_Log->AppendText(wxString::Format("    Unable to connect after %d attempts.\n", scheduler.GetAttempts(c)));
+            }
+            continue;
+        }
+        _frame->UploadInputToController(c, message, bc);
         TextCtrl_Log->AppendText(message);
         TextCtrl_Log->AppendText("\n");
-        _frame->UploadOutputToController(c, message);
+        // uploading the inputs may change the controller mode or reboot it so the outputs are uploaded
+        // against a fresh look at the controller, as when uploading to just this one
+        auto caps = c->GetControllerCaps();
+        _frame->UploadOutputToController(c, message, (caps != nullptr && caps->SupportsInputOnlyUpload()) ? nullptr : bc);
         TextCtrl_Log->AppendText(message);
         TextCtrl_Log->AppendText("\n");
         TextCtrl_Log->AppendText("    Done.");
@@ -20,11 +20,13 @@
 #include <log4cpp/Category.hh>
 #include <wx/tokenzr.h>
 
+#include "CPURenderUtils.h"
 #include "DissolveTransitionPattern.h"
 #include "GPURenderUtils.h"
 #include "Parallel.h"
 #include "UtilFunctions.h"
 #include <cmath>
+#include <limits>
 #include <random>
 
 // This is needed for visual studio
@@ -1693,237 +1695,6 @@ void PixelBufferClass::GetMixedColor(int lx, int ly, xlColor& c, const std::vect
     }
 }
 
-// http://blog.ivank.net/fastest-gaussian-blur.html
-static void boxesForGauss(int d, int n, std::vector<float>& boxes) // standard deviation, number of boxes
-{
-    switch (d) {
-    case 2:
-    case 3:
-        boxes.push_back(1.0);
-        break;
-    case 4:
-    case 5:
-    case 6:
-        boxes.push_back(3.0);
-        break;
-    case 7:
-    case 8:
-    case 9:
-        boxes.push_back(5.0);
-        break;
-    case 10:
-    case 11:
-    case 12:
-        boxes.push_back(7.0);
-        break;
-    case 13:
-    case 14:
-    case 15:
-        boxes.push_back(9.0);
-        break;
-    default:
-        break;
-    }
-    float b = boxes.back();
-    switch (d) {
-    case 2:
-    case 4:
-    case 5:
-    case 7:
-    case 8:
-    case 10:
-    case 11:
-    case 13:
-    case 14:
-        boxes.push_back(b);
-        break;
-    default:
-        boxes.push_back(b + 2.0);
-        break;
-    }
-    switch (d) {
-    case 4:
-    case 7:
-    case 10:
-    case 13:
-        boxes.push_back(b);
-        break;
-    default:
-        boxes.push_back(b + 2.0);
-    }
-}
-
-#define RED(a, b) a[(b) * 4]
-#define GREEN(a, b) a[(b) * 4 + 1]
-#define BLUE(a, b) a[(b) * 4 + 2]
-#define ALPHA(a, b) a[(b) * 4 + 3]
-static inline void SET(std::vector<float>& ar, int idx, float r, float g, float b, float a) {
-    idx *= 4;
-    ar[idx++] = r;
-    ar[idx++] = g;
-    ar[idx++] = b;
-    ar[idx] = a;
-}
-
-static void boxBlurH_4(const std::vector<float>& scl, std::vector<float>& tcl, int w, int h, float r) {
-    float iarr = 1.0f / (r + r + 1.0f);
-    for (int i = 0; i < h; i++) {
-        int ti = i * w;
-        int li = ti;
-        int ri = ti + r;
-        int maxri = ti + w - 1;
-        int fvIdx = ti;
-        int lvIdx = ti + w - 1;
-
-        float valr = (r + 1.0) * RED(scl, fvIdx);
-        float valg = (r + 1.0) * GREEN(scl, fvIdx);
-        float valb = (r + 1.0) * BLUE(scl, fvIdx);
-        float vala = (r + 1.0) * ALPHA(scl, fvIdx);
-
-        float fvRed = RED(scl, fvIdx);
-        float fvGreen = GREEN(scl, fvIdx);
-        float fvBlue = BLUE(scl, fvIdx);
-        float fvAlpha = ALPHA(scl, fvIdx);
-        float lvRed = RED(scl, lvIdx);
-        float lvGreen = GREEN(scl, lvIdx);
-        float lvBlue = BLUE(scl, lvIdx);
-        float lvAlpha = ALPHA(scl, lvIdx);
-
-        for (int j = 0; j < r; j++) {
-            int idx = j < w ? ti + j : lvIdx;
-            valr += RED(scl, idx);
-            valg += GREEN(scl, idx);
-            valb += BLUE(scl, idx);
-            vala += ALPHA(scl, idx);
-        }
-        for (int j = 0; j <= r; j++) {
-            int idx = ri <= maxri ? ri++ : lvIdx;
-            valr += RED(scl, idx) - fvRed;
-            valg += GREEN(scl, idx) - fvGreen;
-            valb += BLUE(scl, idx) - fvBlue;
-            vala += ALPHA(scl, idx) - fvAlpha;
-
-            if (ti <= maxri) {
-                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
-                ti++;
-            }
-        }
-        for (int j = r + 1; j < w - r; j++) {
-            int c = ri <= maxri ? ri++ : lvIdx;
-            int c2 = li <= maxri ? li++ : lvIdx;
-            valr += RED(scl, c) - RED(scl, c2);
-            valg += GREEN(scl, c) - GREEN(scl, c2);
-            valb += BLUE(scl, c) - BLUE(scl, c2);
-            vala += ALPHA(scl, c) - ALPHA(scl, c2);
-            if (ti <= maxri) {
-                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
-                ti++;
-            }
-        }
-
-        for (int j = w - r; j < w; j++) {
-            int c2 = li <= maxri ? li++ : lvIdx;
-            valr += lvRed - RED(scl, c2);
-            valg += lvGreen - GREEN(scl, c2);
-            valb += lvBlue - BLUE(scl, c2);
-            vala += lvAlpha - ALPHA(scl, c2);
-            if (ti <= maxri) {
-                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
-                ti++;
-            }
-        }
-    }
-}
-
-static void boxBlurT_4(const std::vector<float>& scl, std::vector<float>& tcl, int w, int h, float r) {
-    float iarr = 1.0f / (r + r + 1.0f);
-    for (int i = 0; i < w; i++) {
-        int ti = i;
-        int li = ti;
-        int ri = ti + r * w;
-
-        int maxri = ti + w * (h - 1);
-
-        int fvIdx = ti;
-        int lvIdx = ti + w * (h - 1);
-
-        float fvRed = RED(scl, fvIdx);
-        float fvGreen = GREEN(scl, fvIdx);
-        float fvBlue = BLUE(scl, fvIdx);
-        float fvAlpha = ALPHA(scl, fvIdx);
-        float lvRed = RED(scl, lvIdx);
-        float lvGreen = GREEN(scl, lvIdx);
-        float lvBlue = BLUE(scl, lvIdx);
-        float lvAlpha = ALPHA(scl, lvIdx);
-
-        float valr = (r + 1) * fvRed;
-        float valg = (r + 1) * fvGreen;
-        float valb = (r + 1) * fvBlue;
-        float vala = (r + 1) * fvAlpha;
-
-        for (int j = 0; j < r; j++) {
-            int idx = j < w ? ti + j * w : lvIdx;
-            valr += RED(scl, idx);
-            valg += GREEN(scl, idx);
-            valb += BLUE(scl, idx);
-            vala += ALPHA(scl, idx);
-        }
-        for (int j = 0; j <= r; j++) {
-            int idx = ri <= maxri ? ri : lvIdx;
-            valr += RED(scl, idx) - fvRed;
-            valg += GREEN(scl, idx) - fvGreen;
-            valb += BLUE(scl, idx) - fvBlue;
-            vala += ALPHA(scl, idx) - fvAlpha;
-            if (ti <= maxri) {
-                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
-            }
-            ri += w;
-            ti += w;
-        }
-        for (int j = r + 1; j < h - r; j++) {
-            int c = ri <= maxri ? ri : lvIdx;
-            int c2 = li <= maxri ? li : lvIdx;
-            valr += RED(scl, c) - RED(scl, c2);
-            valg += GREEN(scl, c) - GREEN(scl, c2);
-            valb += BLUE(scl, c) - BLUE(scl, c2);
-            vala += ALPHA(scl, c) - ALPHA(scl, c2);
-            if (ti <= maxri) {
-                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
-            }
-            li += w;
-            ri += w;
-            ti += w;
-        }
-        for (int j = h - r; j < h; j++) {
-            int c2 = li <= maxri ? li : lvIdx;
-            valr += lvRed - RED(scl, c2);
-            valg += lvGreen - GREEN(scl, c2);
-            valb += lvBlue - BLUE(scl, c2);
-            vala += lvAlpha - ALPHA(scl, c2);
-            if (ti <= maxri) {
-                SET(tcl, ti, valr * iarr, valg * iarr, valb * iarr, vala * iarr);
-            }
-            li += w;
-            ti += w;
-        }
-    }
-}
-
-static void boxBlur_4(std::vector<float>& scl, std::vector<float>& tcl, int w, int h, float r, int size) {
-    tcl = scl;
-    // memcpy(tcl, scl, sizeof(float)*4*size);
-    boxBlurH_4(tcl, scl, w, h, r);
-    boxBlurT_4(scl, tcl, w, h, r);
-}
-
-static void gaussBlur_4(std::vector<float>& scl, std::vector<float>& tcl, int w, int h, int r, int size) {
-    std::vector<float> bxs;
-    boxesForGauss(r - 1, 3, bxs);
-    boxBlur_4(scl, tcl, w, h, (bxs[0] - 1) / 2, size);
-    boxBlur_4(tcl, scl, w, h, (bxs[1] - 1) / 2, size);
-    boxBlur_4(scl, tcl, w, h, (bxs[2] - 1) / 2, size);
-}
-
 static inline int roundInt(float r) {
     int tmp = static_cast<int>(r);
     tmp += (r - tmp >= .5) - (r - tmp <= -.5);
@@ -1962,13 +1733,13 @@ void PixelBufferClass::Blur(LayerInfo* layer, float offset) {
                 input[x * 4 + 2] = c.blue;
                 input[x * 4 + 3] = c.alpha;
             }
-            gaussBlur_4(input, tmp, layer->BufferWi, layer->BufferHt, b, pixCount);
+            CPURenderUtils::GaussBlur(input, tmp, layer->BufferWi, layer->BufferHt, b);
 
             for (int x = 0; x < pixCount; x++) {
-                layer->buffer.pixels[x].Set(roundInt(tmp[x * 4]),
-                                            roundInt(tmp[x * 4 + 1]),
-                                            roundInt(tmp[x * 4 + 2]),
-                                            roundInt(tmp[x * 4 + 3]));
+                layer->buffer.pixels[x].Set(roundInt(input[x * 4]),
+                                            roundInt(input[x * 4 + 1]),
+                                            roundInt(input[x * 4 + 2]),
+                                            roundInt(input[x * 4 + 3]));
             }
         }
     } else {
@@ -2718,33 +2489,48 @@ void PixelBufferClass::SetColors(int layer, const unsigned char* fdata) {
     }
 }
 
+// sourceOf(x, y) returns the index of the source pixel which lands on the destination or -1 if none does
+template <typename F>
+static void GatherPixels(RenderBuffer& buffer, F&& sourceOf) {
+    int w = buffer.BufferWi;
+    int h = buffer.BufferHt;
+    std::vector<xlColor> orig(buffer.pixels, buffer.pixels + buffer.pixelVector.size());
+
+    if (!buffer.IsDmxBuffer() && buffer.pixelVector.size() == (size_t)w * h) {
+        parallel_for(0, h, [&](int y) {
+            xlColor* row = &buffer.pixels[y * w];
+            for (int x = 0; x < w; ++x) {
+                int s = sourceOf(x, y);
+                row[x] = s >= 0 ? orig[s] : xlCLEAR;
+            }
+        }, 8);
+    } else {
+        // buffers which are not simply w x h pixels still have to go through SetPixel
+        xlColor outside = buffer.allowAlpha ? xlCLEAR : xlBLACK;
+        buffer.Clear();
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                int s = sourceOf(x, y);
+                if (s != -1) {
+                    buffer.SetPixel(x, y, s < (int)orig.size() ? orig[s] : outside);
+                }
+            }
+        }
+    }
+}
+
 void PixelBufferClass::RotateX(RenderBuffer& buffer, GPURenderUtils::RotoZoomSettings& settings) {
     // Now do the rotation around a point on the x axis
 
     float xrotation = settings.xrotation;
     if (xrotation != 0 && xrotation != 360) {
         GPURenderUtils::waitForRenderCompletion(&buffer);
-        int xpivot = settings.xpivot;
-
-        RenderBuffer orig(buffer);
-        buffer.Clear();
-
-        float sine = sin((xrotation + 90) * M_PI / 180);
-        float pivot = xpivot * buffer.BufferWi / 100;
-
-        for (int x = pivot; x < buffer.BufferWi; ++x) {
-            float tox = sine * (x - pivot) + pivot;
-            for (int y = 0; y < buffer.BufferHt; ++y) {
-                buffer.SetPixel(tox, y, orig.GetPixel(x, y));
-            }
-        }
 
-        for (int x = pivot - 1; x >= 0; --x) {
-            float tox = -1 * sine * (pivot - x) + pivot;
-            for (int y = 0; y < buffer.BufferHt; ++y) {
-                buffer.SetPixel(tox, y, orig.GetPixel(x, y));
-            }
-        }
+        auto const from = CPURenderUtils::RotateXMap(buffer.BufferWi, settings);
+        GatherPixels(buffer, [&](int x, int y) {
+            int fx = from[x];
+            return fx < 0 ? -1 : y * buffer.BufferWi + fx;
+        });
     }
 }
 
@@ -2754,26 +2540,11 @@ void PixelBufferClass::RotateY(RenderBuffer& buffer, GPURenderUtils::RotoZoomSet
     if (yrotation != 0 && yrotation != 360) {
         GPURenderUtils::waitForRenderCompletion(&buffer);
 
-        int ypivot = settings.ypivot;
-        RenderBuffer orig(buffer);
-        buffer.Clear();
-
-        float sine = sin((yrotation + 90) * M_PI / 180);
-        float pivot = ypivot * buffer.BufferHt / 100;
-
-        for (int y = pivot; y < buffer.BufferHt; ++y) {
-            float toy = sine * (y - pivot) + pivot;
-            for (int x = 0; x < buffer.BufferWi; ++x) {
-                buffer.SetPixel(x, toy, orig.GetPixel(x, y));
-            }
-        }
-
-        for (int y = pivot - 1; y >= 0; --y) {
-            float toy = -1 * sine * (pivot - y) + pivot;
-            for (int x = 0; x < buffer.BufferWi; ++x) {
-                buffer.SetPixel(x, toy, orig.GetPixel(x, y));
-            }
-        }
+        auto const from = CPURenderUtils::RotateYMap(buffer.BufferHt, settings);
+        GatherPixels(buffer, [&](int x, int y) {
+            int fy = from[y];
+            return fy < 0 ? -1 : fy * buffer.BufferWi + x;
+        });
     }
 }
 
@@ -2782,43 +2553,13 @@ void PixelBufferClass::RotateZAndZoom(RenderBuffer& buffer, GPURenderUtils::Roto
     float zoom = settings.zoom;
     float rotation = settings.zrotation;
 
-    if (rotation != 0.0 || zoom != 1.0) {
+    if ((rotation != 0.0 || zoom != 1.0) && buffer.BufferWi > 0 && buffer.BufferHt > 0) {
         GPURenderUtils::waitForRenderCompletion(&buffer);
 
-        static const float PI_2 = 6.283185307f;
-        xlColor c;
-        RenderBuffer orig(buffer);
-        int q = settings.zoomquality;
-        int cx = settings.pivotpointx;
-        int cy = settings.pivotpointy;
-        float inc = 1.0 / (float)q;
-
-        float angle = PI_2 * -rotation;
-        float xoff = (cx * buffer.BufferWi) / 100.0;
-        float yoff = (cy * buffer.BufferHt) / 100.0;
-        float anglecos = cos(-angle);
-        float anglesin = sin(-angle);
-
-        buffer.Clear();
-        for (int x = 0; x < buffer.BufferWi; x++) {
-            for (int i = 0; i < q; i++) {
-                for (int y = 0; y < buffer.BufferHt; y++) {
-                    orig.GetPixel(x, y, c);
-                    for (int j = 0; j < q; j++) {
-                        float xx = (float)x + ((float)i * inc) - xoff;
-                        float yy = (float)y + ((float)j * inc) - yoff;
-                        float u = xoff + anglecos * xx * zoom + anglesin * yy * zoom;
-                        if (u >= 0 && u < buffer.BufferWi) {
-                            float v = yoff + -anglesin * xx * zoom + anglecos * yy * zoom;
-
-                            if (v >= 0 && v < buffer.BufferHt) {
-                                buffer.SetPixel(u, v, c);
-                            }
-                        }
-                    }
-                }
-            }
-        }
+        auto const from = CPURenderUtils::RotateZAndZoomMap(buffer.BufferWi, buffer.BufferHt, settings);
+        GatherPixels(buffer, [&](int x, int y) {
+            return from[y * buffer.BufferWi + x];
+        });
     }
 }
 
@@ -3160,6 +2901,20 @@ void PixelBufferClass::LayerInfo::clear() {
     }
 }
 
+bool PixelBufferClass::LayerInfo::MaskThresholds::Prepare(int type, int width, int height, int bufferWidth, int bufferHeight, int adjust) {
+    if (type == _type && width == _width && height == _height && bufferWidth == _bufferWidth && bufferHeight == _bufferHeight && adjust == _adjust) {
+        return false;
+    }
+    _type = type;
+    _width = width;
+    _height = height;
+    _bufferWidth = bufferWidth;
+    _bufferHeight = bufferHeight;
+    _adjust = adjust;
+    values.resize(width * height);
+    return true;
+}
+
 void PixelBufferClass::LayerInfo::createFromMiddleMask(bool out) {
     bool reverse = inTransitionReverse;
     float factor = inMaskFactor;
@@ -3206,13 +2961,18 @@ void PixelBufferClass::LayerInfo::createFromMiddleMask(bool out) {
     double len = std::max(std::max(distBR, distBL), std::max(distUR, distUL));
     double step = len * factor;
 
-    for (int x = 0; x < BufferWi; ++x) {
-        for (int y = 0; y < BufferHt; ++y) {
-            double dist = std::abs(y2_less_y1 * x - x2_less_x1 * y + offset) / p1_p2_len;
-            uint8_t c = (dist > step) ? m1 : m2;
-            mask[x * BufferHt + y] = c;
+    MaskThresholds& thresholds = out ? outMaskThresholds : inMaskThresholds;
+    if (thresholds.Prepare(3, BufferWi, BufferHt, buffer.BufferWi, buffer.BufferHt, adjust)) {
+        for (int x = 0; x < BufferWi; ++x) {
+            for (int y = 0; y < BufferHt; ++y) {
+                thresholds.values[x * BufferHt + y] = std::abs(y2_less_y1 * x - x2_less_x1 * y + offset) / p1_p2_len;
+            }
         }
     }
+    const double* dist = thresholds.values.data();
+    for (size_t i = 0; i < thresholds.values.size(); ++i) {
+        mask[i] = (dist[i] > step) ? m1 : m2;
+    }
 }
 
 void PixelBufferClass::LayerInfo::createCircleExplodeMask(bool out) {
@@ -3238,12 +2998,19 @@ void PixelBufferClass::LayerInfo::createCircleExplodeMask(bool out) {
 
     float rad = maxradius * factor;
 
-    for (int x = 0; x < BufferWi; x++) {
-        for (int y = 0; y < BufferHt; y++) {
-            float radius = sqrt((x - (BufferWi / 2)) * (x - (BufferWi / 2)) + (y - (BufferHt / 2)) * (y - (BufferHt / 2)));
-            mask[x * BufferHt + y] = radius < rad ? m2 : m1;
+    MaskThresholds& thresholds = out ? outMaskThresholds : inMaskThresholds;
+    if (thresholds.Prepare(5, BufferWi, BufferHt, 0, 0, 0)) {
+        for (int x = 0; x < BufferWi; x++) {
+            for (int y = 0; y < BufferHt; y++) {
+                float radius = sqrt((x - (BufferWi / 2)) * (x - (BufferWi / 2)) + (y - (BufferHt / 2)) * (y - (BufferHt / 2)));
+                thresholds.values[x * BufferHt + y] = radius;
+            }
         }
     }
+    const double* radius = thresholds.values.data();
+    for (size_t i = 0; i < thresholds.values.size(); ++i) {
+        mask[i] = radius[i] < rad ? m2 : m1;
+    }
 }
 void PixelBufferClass::LayerInfo::createSquareExplodeMask(bool out) {
     bool reverse = inTransitionReverse;
@@ -3381,26 +3148,36 @@ void PixelBufferClass::LayerInfo::createClockMask(bool out) {
         currentradians = startradians + currentradians;
     }
 
-    for (int x = 0; x < BufferWi; x++) {
-        for (int y = 0; y < BufferHt; y++) {
-            float radianspixel;
-            if (x - BufferWi / 2 == 0 && y - BufferHt / 2 == 0) {
-                radianspixel = 0.0;
-            } else {
-                radianspixel = atan2(x - BufferWi / 2,
-                                     y - BufferHt / 2);
-            }
-            if (radianspixel < 0) {
-                radianspixel += 2.0f * (float)M_PI;
-            }
-            if (currentradians > 2.0f * (float)M_PI && radianspixel < startradians) {
-                radianspixel += 2.0f * (float)M_PI;
+    MaskThresholds& thresholds = out ? outMaskThresholds : inMaskThresholds;
+    if (thresholds.Prepare(2, BufferWi, BufferHt, 0, 0, 0)) {
+        for (int x = 0; x < BufferWi; x++) {
+            for (int y = 0; y < BufferHt; y++) {
+                float radianspixel;
+                if (x - BufferWi / 2 == 0 && y - BufferHt / 2 == 0) {
+                    radianspixel = 0.0;
+                } else {
+                    radianspixel = atan2(x - BufferWi / 2,
+                                         y - BufferHt / 2);
+                }
+                if (radianspixel < 0) {
+                    radianspixel += 2.0f * (float)M_PI;
+                }
+                thresholds.values[x * BufferHt + y] = radianspixel;
             }
+        }
+    }
 
-            bool s_lt_p = radianspixel > startradians;
-            bool c_gt_p = radianspixel < currentradians;
-            mask[x * BufferHt + y] = (s_lt_p && c_gt_p) ? m2 : m1;
+    const double* radians = thresholds.values.data();
+    bool wraps = currentradians > 2.0f * (float)M_PI;
+    for (size_t i = 0; i < thresholds.values.size(); ++i) {
+        float radianspixel = radians[i];
+        if (wraps && radianspixel < startradians) {
+            radianspixel += 2.0f * (float)M_PI;
         }
+
+        bool s_lt_p = radianspixel > startradians;
+        bool c_gt_p = radianspixel < currentradians;
+        mask[i] = (s_lt_p && c_gt_p) ? m2 : m1;
     }
 }
 
@@ -3466,8 +3243,6 @@ void PixelBufferClass::LayerInfo::createBlendMask(bool out) {
             adjust = static_cast<int>(OutTransitionAdjustValueCurve.GetOutputValueAt(factor, buffer.GetStartTimeMS(), buffer.GetEndTimeMS()));
     }
 
-    std::minstd_rand rng(1234);
-
     int pixels = BufferWi * BufferHt;
     adjust = 10 * adjust / 100;
     if (adjust == 0) {
@@ -3487,47 +3262,35 @@ void PixelBufferClass::LayerInfo::createBlendMask(bool out) {
         ypixels++;
     }
 
-    // set all the background first
-    for (int x = 0; x < BufferWi; x++) {
-        for (int y = 0; y < BufferHt; y++) {
-            mask[x * BufferHt + y] = m1;
-        }
-    }
-
-    for (int i = 0; i < step; i++) {
-        int jy = rng() % actualpixels;
-        int jx = rng() % actualpixels;
-
-        int x = (jx % xpixels) * adjust;
-        int y = (jy % ypixels) * adjust;
-        if (mask[x * BufferHt + y] == m2) {
-            // check if there is anything left to mask
-            bool undone = false;
-            for (int tx = 0; tx < std::min(xpixels, actualpixels) && undone == false; ++tx) {
-                for (int ty = 0; ty < std::min(ypixels, actualpixels) && undone == false; ++ty) {
-                    if (mask[tx * adjust * BufferHt + ty * adjust] == m1) {
-                        undone = true;
-                    }
-                }
+    MaskThresholds& thresholds = out ? outMaskThresholds : inMaskThresholds;
+    if (thresholds.Prepare(7, BufferWi, BufferHt, 0, 0, adjust)) {
+        // Blocks are filled in the order a fixed seed random sequence first picks them so record that
+        // order once. Blocks it can never pick are never filled.
+        std::minstd_rand rng(1234);
+        std::vector<double> order(xpixels * ypixels, std::numeric_limits<double>::max());
+        int remaining = std::min(xpixels, actualpixels) * std::min(ypixels, actualpixels);
+        int filled = 0;
+        for (size_t tries = (size_t)remaining * 100 + 10000; remaining > 0 && tries > 0; tries--) {
+            int jy = rng() % actualpixels;
+            int jx = rng() % actualpixels;
+
+            double& o = order[(jx % xpixels) * ypixels + (jy % ypixels)];
+            if (o == std::numeric_limits<double>::max()) {
+                o = filled++;
+                remaining--;
             }
-
-            if (undone) {
-                i--;
-            } else {
-                break;
-            }
-        } else {
-            for (int k = 0; k < adjust; ++k) {
-                if ((x + k) < BufferWi) {
-                    for (int l = 0; l < adjust; l++) {
-                        if ((y + l) < BufferHt) {
-                            mask[(x + k) * BufferHt + y + l] = m2;
-                        }
-                    }
-                }
+        }
+        for (int x = 0; x < BufferWi; x++) {
+            for (int y = 0; y < BufferHt; y++) {
+                thresholds.values[x * BufferHt + y] = order[(x / adjust) * ypixels + (y / adjust)];
             }
         }
     }
+
+    const double* order = thresholds.values.data();
+    for (size_t i = 0; i < thresholds.values.size(); ++i) {
+        mask[i] = order[i] < step ? m2 : m1;
+    }
 }
 
 void PixelBufferClass::LayerInfo::createSlideChecksMask(bool out) {
@@ -57,6 +57,7 @@ class SettingsMap;
 class DimmingCurve;
 class ModelGroup;
 class MetalPixelBufferComputeData;
+class xLightsXmlFile;
 
 class PixelBufferClass {
 private:
@@ -201,6 +202,26 @@ private:
         size_t maskSize = 0;
         size_t maskMaxSize = 0;
 
+        // Per pixel values some mask transitions compare against each frame. They only depend on the
+        // buffer size and transition settings so are only recalculated when those change
+        class MaskThresholds {
+        public:
+            // returns true if values needs to be recalculated
+            bool Prepare(int type, int width, int height, int bufferWidth, int bufferHeight, int adjust);
+
+            std::vector<double> values;
+
+        private:
+            int _type = 0;
+            int _width = 0;
+            int _height = 0;
+            int _bufferWidth = 0;
+            int _bufferHeight = 0;
+            int _adjust = 0;
+        };
+        MaskThresholds inMaskThresholds;
+        MaskThresholds outMaskThresholds;
+
         void renderTransitions(bool isFirstFrame, RenderBuffer* prevRB);
         void calculateMask(const std::string& type, bool mode, bool isFirstFrame);
         bool isMasked(int x, int y);
@@ -258,6 +279,7 @@ private:
     Model* zbModel = nullptr;
     SingleLineModel* ssModel = nullptr;
     xLightsFrame* frame = nullptr;
+    xLightsXmlFile* sequenceFile = nullptr;
 
 public:
     static std::vector<std::string> GetMixTypes();
@@ -287,6 +309,13 @@ public:
     const Model* GetModel() const {
         return model;
     }
+    // the sequence being rendered when it is not the one open in the sequencer
+    void SetSequenceFile(xLightsXmlFile* file) {
+        sequenceFile = file;
+    }
+    xLightsXmlFile* GetSequenceFile() const {
+        return sequenceFile;
+    }
 
     RenderBuffer& BufferForLayer(int i, int idx);
     uint32_t BufferCountForLayer(int i);
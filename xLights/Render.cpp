@@ -27,6 +27,7 @@
 #include "Parallel.h"
 #include "ExternalHooks.h"
 #include "GPURenderUtils.h"
+#include "ImageCache.h"
 
 #include <log4cpp/Category.hh>
 
@@ -83,6 +84,9 @@ public:
     bool *ResetEffectState;
     int returnVal{ -1 };
     bool suppress{ false };
+    // the sequence the effect belongs to ... batch renders have several open at once besides the one in the UI
+    SequenceElements* sequenceElements{ nullptr };
+    xLightsXmlFile* sequenceFile{ nullptr };
 };
 
 class NextRenderer {
@@ -540,6 +544,20 @@ public:
         supportsModelBlending = true;
     }
 
+    // used when rendering a sequence which is not the one open in the sequencer
+    void SetSequenceFile(xLightsXmlFile *file) {
+        sequenceFile = file;
+        if (mainBuffer != nullptr) {
+            mainBuffer->SetSequenceFile(file);
+        }
+        for (const auto& it : subModelInfos) {
+            it->buffer->SetSequenceFile(file);
+        }
+        for (const auto& it : nodeBuffers) {
+            it.second->SetSequenceFile(file);
+        }
+    }
+
     int GetEffectFrame(Effect* ef, int frame, int frameTime)
     {
         return frame - (ef->GetStartTimeMS() / frameTime);
@@ -784,6 +802,10 @@ public:
         }
         SetGenericStatus("Got lock on rendering thread for %s", 0);
 
+        // value curves following the music or a timing track need the sequence we are rendering
+        ValueCurve::ThreadSequence threadSequence(sequenceFile != nullptr ? sequenceFile->GetMedia() : nullptr,
+                                                  sequenceFile != nullptr ? rowToRender->GetSequenceElements() : nullptr);
+
         rowToRender->GetAndResetDirtyRange(origChangeCount, ss, es);
         if (ss != -1) {
             //expand to cover the whole dirty range
@@ -1038,6 +1060,7 @@ private:
     std::atomic_int endFrame;
     xLightsFrame *xLights;
     SequenceData *seqData;
+    xLightsXmlFile *sequenceFile = nullptr;
     std::vector<bool> rangeRestriction;
     bool supportsModelBlending;
     RenderEvent renderEvent;
@@ -1101,7 +1124,9 @@ void xLightsFrame::RenderEffectOnMainThread(RenderEvent *ev) {
     std::unique_lock<std::mutex> lock(ev->mutex);
 
     // validate that the effect still exists as this could be being processed after the effect was deleted
-    if (_sequenceElements.IsValidEffect(ev->effect)) {
+    if (ev->sequenceElements != nullptr && ev->sequenceElements->IsValidEffect(ev->effect)) {
+        ValueCurve::ThreadSequence threadSequence(ev->sequenceFile != nullptr ? ev->sequenceFile->GetMedia() : nullptr,
+                                                  ev->sequenceFile != nullptr ? ev->sequenceElements : nullptr);
         ev->returnVal = RenderEffectFromMap(ev->suppress, ev->effect,
             ev->layer,
             ev->period,
@@ -1123,6 +1148,7 @@ public:
         jobs = nullptr;
         aggregators = nullptr;
         renderProgressDialog = nullptr;
+        abortedJobs = 0;
     };
     std::function<void(bool)> callback;
     int numRows;
@@ -1132,6 +1158,7 @@ public:
     AggregatorRenderer **aggregators;
     RenderProgressDialog *renderProgressDialog;
     std::list<Model *> restriction;
+    int abortedJobs;
 };
 
 void xLightsFrame::LogRenderStatus()
@@ -1297,7 +1324,7 @@ void xLightsFrame::UpdateRenderStatus() {
             RenderDone();
             delete []rpi->jobs;
             delete []rpi->aggregators;
-            rpi->callback(abortedRenderJobs > 0);
+            rpi->callback(rpi->abortedJobs > 0);
             delete rpi;
             rpi = nullptr;
             it = renderProgressInfo.erase(it);
@@ -1453,10 +1480,9 @@ void xLightsFrame::Render(SequenceElements& seqElements,
                           const std::list<Model *> &restrictToModels,
                           int startFrame, int endFrame,
                           bool progressDialog, bool clear,
-                          std::function<void(bool)>&& callback)
+                          std::function<void(bool)>&& callback,
+                          xLightsXmlFile* sequenceFile)
 {
-    abortedRenderJobs = 0;
-
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     static log4cpp::Category &logger_render = log4cpp::Category::getInstance(std::string("log_render"));
 
@@ -1466,6 +1492,10 @@ void xLightsFrame::Render(SequenceElements& seqElements,
     if (endFrame >= (int)seqData.NumFrames()) {
         endFrame = seqData.NumFrames() - 1;
     }
+
+    // pick up pictures edited since the last render
+    ImageCache::CheckForChanges();
+
     std::list<NodeRange> ranges;
     if (restrictToModels.empty()) {
         ranges.push_back(NodeRange(0, seqData.NumChannels()));
@@ -1512,6 +1542,9 @@ void xLightsFrame::Render(SequenceElements& seqElements,
                     if (seqElements.SupportsModelBlending()) {
                         job->SetModelBlending();
                     }
+                    if (sequenceFile != nullptr) {
+                        job->SetSequenceFile(sequenceFile);
+                    }
                     PixelBufferClass *buffer = job->getBuffer();
                     if (buffer == nullptr) {
                         delete job;
@@ -1612,7 +1645,7 @@ void xLightsFrame::Render(SequenceElements& seqElements,
         renderProgressInfo.push_back(pi);
         RenderStatusTimer.Start(100, false);
     } else {
-        callback(abortedRenderJobs > 0);
+        callback(false);
         if (progressDialog) {
             delete renderProgressDialog;
         }
@@ -1739,7 +1772,7 @@ bool xLightsFrame::AbortRender(int maxTimeMS, int* numThreadsAborted)
             if (rpi->jobs[row]) {
                 rpi->jobs[row]->AbortRender();
                 ++abortCount;
-                ++abortedRenderJobs;
+                ++rpi->abortedJobs;
             }
         }
     }
@@ -1810,15 +1843,15 @@ void xLightsFrame::RenderGridToSeqData(std::function<void(bool)>&& callback) {
 
 #ifdef DOTIMING
     wxStopWatch sw;
-    Render(_sequenceElements, _seqData, models, restricts, 0, SeqData.NumFrames() - 1, true, false, [this, models, restricts, sw, callback] {
+    Render(_sequenceElements, _seqData, models, restricts, 0, SeqData.NumFrames() - 1, true, false, [this, models, restricts, sw, callback](bool) {
         printf("%s  Render 1:  %ld ms\n", (const char *)xlightsFilename.c_str(), sw.Time());
         wxStopWatch sw2;
-        Render(_sequenceElements, _seqData, models, restricts, 0, SeqData.NumFrames() - 1, true, false, [this, models, restricts, sw2, callback] {
+        Render(_sequenceElements, _seqData, models, restricts, 0, SeqData.NumFrames() - 1, true, false, [this, models, restricts, sw2, callback](bool) {
             printf("%s  Render 2:  %ld ms\n", (const char *)xlightsFilename.c_str(), sw2.Time());
             wxStopWatch sw3;
-            Render(_sequenceElements, _seqData, models, restricts, 0, SeqData.NumFrames() - 1, true, false, [sw3, callback] {
+            Render(_sequenceElements, _seqData, models, restricts, 0, SeqData.NumFrames() - 1, true, false, [sw3, callback](bool aborted) {
                 printf("%s  Render 3:  %ld ms\n", (const char *)xlightsFilename.c_str(), sw3.Time());
-                callback(abortedRenderJobs > 0);
+                callback(aborted);
             } );
         });
     });
@@ -1827,6 +1860,31 @@ void xLightsFrame::RenderGridToSeqData(std::function<void(bool)>&& callback) {
 #endif
 }
 
+void xLightsFrame::StartParallelRender(ParallelRenderSequence* seq) {
+    seq->timer.Start();
+    RenderIseqData(true, nullptr, *seq->xmlFile, seq->data); // render ISEQ layers below the Nutcracker layer
+
+    // the sequence is not the one in the sequencer so it gets its own tree
+    RenderTree tree;
+    for (size_t row = 0; row < seq->elements.GetElementCount(MASTER_VIEW); ++row) {
+        Element *rowEl = seq->elements.GetElement(row, MASTER_VIEW);
+        if (rowEl != nullptr && rowEl->GetType() == ElementType::ELEMENT_TYPE_MODEL) {
+            Model *model = GetModel(rowEl->GetModelName());
+            if (model != nullptr) {
+                tree.Add(model);
+            }
+        }
+    }
+    std::list<Model *> models;
+    for (const auto& it : tree.data) {
+        models.push_back(it->model);
+    }
+    std::list<Model*> restricts;
+    Render(seq->elements, seq->data, models, restricts, 0, seq->data.NumFrames() - 1, false, false, [this, seq](bool aborted) {
+        ParallelRenderDone(seq, aborted);
+    }, seq->xmlFile);
+}
+
 void xLightsFrame::RenderEffectForModel(const std::string &model, int startms, int endms, bool clear) {
 
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -2202,6 +2260,8 @@ bool xLightsFrame::RenderEffectFromMap(bool suppress, Effect* effectObj, int lay
                     event->ResetEffectState = &resetEffectState;
                     event->buffer = &buffer;
                     event->suppress = suppress;
+                    event->sequenceElements = effectObj->GetParentEffectLayer()->GetParentElement()->GetSequenceElements();
+                    event->sequenceFile = buffer.GetSequenceFile();
 
                     std::unique_lock<std::mutex> lock(event->mutex);
 
@@ -2234,7 +2294,7 @@ bool xLightsFrame::RenderEffectFromMap(bool suppress, Effect* effectObj, int lay
                         wxThread::Yield();
 
                         // After yield who knows what may or may not be valid so we need to revalidate it
-                        if (!_sequenceElements.IsValidEffect(event->effect)) {
+                        if (!event->sequenceElements->IsValidEffect(event->effect)) {
                             logger_base.error("In RenderEffectFromMap after Yield() call checked the effect was still valid ... and it isnt ... this would likely have crashed.");
                         }
                     }
@@ -2245,6 +2305,11 @@ bool xLightsFrame::RenderEffectFromMap(bool suppress, Effect* effectObj, int lay
                         RenderBuffer* rb = &buffer.BufferForLayer(layer, bufn);
 
                         if (rb != nullptr) {
+                            // per model buffers render on other threads so they need to know the sequence too
+                            xLightsXmlFile* sequenceFile = buffer.GetSequenceFile();
+                            ValueCurve::ThreadSequence threadSequence(sequenceFile != nullptr ? sequenceFile->GetMedia() : nullptr,
+                                                                      sequenceFile != nullptr ? effectObj->GetParentEffectLayer()->GetParentElement()->GetSequenceElements() : nullptr);
+
                             RenderBuffer* oldBuffer = nullptr;
                             RenderBuffer* newBuffer = nullptr;
 
@@ -155,6 +155,9 @@ inline void unshare(const wxObject &o2) {
 
 AudioManager* RenderBuffer::GetMedia() const
 {
+    if (parent != nullptr && parent->GetSequenceFile() != nullptr) {
+        return parent->GetSequenceFile()->GetMedia();
+    }
 	if (xLightsFrame::CurrentSeqXmlFile == nullptr)
 	{
 		return nullptr;
@@ -174,6 +177,9 @@ const std::string &RenderBuffer::GetModelName() const
 
 const wxString &RenderBuffer::GetXmlHeaderInfo(HEADER_INFO_TYPES node_type) const
 {
+    if (parent != nullptr && parent->GetSequenceFile() != nullptr) {
+        return parent->GetSequenceFile()->GetHeaderInfo(node_type);
+    }
     if (xLightsFrame::CurrentSeqXmlFile == nullptr) {
         return xlEMPTY_WXSTRING;
     }
@@ -23,6 +23,7 @@
 #include "FileConverter.h"
 #include "FontManager.h"
 #include "HousePreviewPanel.h"
+#include "ImageCache.h"
 #include "LMSImportChannelMapDialog.h"
 #include "LOREdit.h"
 #include "ModelPreview.h"
@@ -34,6 +35,7 @@
 #include "SuperStarImportDialog.h"
 #include "UtilFunctions.h"
 #include "VSAFile.h"
+#include "VideoFrameCache.h"
 #include "ViewsModelsPanel.h"
 #include "VsaImportDialog.h"
 #include "xLightsImportChannelMapDialog.h"
@@ -641,6 +643,8 @@ bool xLightsFrame::CloseSequence()
 
     _renderCache.CleanupCache(&_sequenceElements);
     _renderCache.SetSequence(renderCacheDirectory, "");
+    VideoFrameCache::Purge();
+    ImageCache::Purge();
 
     // clear everything to prepare for new sequence
     if (displayElementsPanel != nullptr)
@@ -721,11 +725,16 @@ void xLightsFrame::ClearSequenceData()
 }
 
 void xLightsFrame::RenderIseqData(bool bottom_layers, ConvertLogDialog* plog)
+{
+    RenderIseqData(bottom_layers, plog, *CurrentSeqXmlFile, _seqData);
+}
+
+void xLightsFrame::RenderIseqData(bool bottom_layers, ConvertLogDialog* plog, xLightsXmlFile& xmlFile, SequenceData& seqData)
 {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     logger_base.debug("xLightsFrame::RenderIseqData bottom_layers %d", bottom_layers);
 
-    DataLayerSet& data_layers = CurrentSeqXmlFile->GetDataLayers();
+    DataLayerSet& data_layers = xmlFile.GetDataLayers();
     ConvertParameters::ReadMode read_mode;
     if (bottom_layers && data_layers.GetNumLayers() == 1 &&
         data_layers.GetDataLayer(0)->GetName() == "Nutcracker") {
@@ -738,7 +747,10 @@ void xLightsFrame::RenderIseqData(bool bottom_layers, ConvertLogDialog* plog)
 
     if (bottom_layers) {
         logger_base.debug("xLightsFrame::RenderIseqData clearing sequence data.");
-        ClearSequenceData();
+        wxASSERT(seqData.IsValidData());
+        for (size_t i = 0; i < seqData.NumFrames(); ++i) {
+            seqData[i].Zero();
+        }
         read_mode = ConvertParameters::READ_MODE_NORMAL;
     } else {
         read_mode = ConvertParameters::READ_MODE_IGNORE_BLACK;
@@ -756,7 +768,7 @@ void xLightsFrame::RenderIseqData(bool bottom_layers, ConvertLogDialog* plog)
                     plog->Show(true);
                 }
                 ConvertParameters read_params(data_layer->GetDataSource(), // input filename
-                                              _seqData,                    // sequence data object
+                                              seqData,                     // sequence data object
                                               &_outputManager,             // global network info
                                               read_mode,                   // file read mode
                                               this,                        // xLights main frame
@@ -0,0 +1,696 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <wx/file.h>
+#include <wx/filename.h>
+#include <wx/stopwatch.h>
+#include <wx/xml/xml.h>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#ifndef __WXMSW__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "SequenceBinaryFile.h"
+#include "ExternalHooks.h"
+#include "UtilFunctions.h"
+
+#include <log4cpp/Category.hh>
+
+std::atomic_bool SequenceBinaryFile::__enabled(false);
+
+namespace
+{
+    const char BINARY_MAGIC[4] = { 'X', 'S', 'Q', 'B' };
+    const uint32_t BINARY_VERSION = 1;
+
+    struct BinaryHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceSize;     // size of the xml file this is a copy of
+        int64_t sourceModified;  // and its modification time in ms
+        uint32_t stringCount;
+        uint32_t nodeCount;      // node 0 is the document node, the rest follow in document order
+        uint32_t attributeCount;
+        uint32_t docVersion;     // string index of the xml version
+        uint32_t docEncoding;    // string index of the xml encoding
+        uint32_t reserved;
+        uint64_t stringDataSize;
+    };
+    static_assert(sizeof(BinaryHeader) == 56, "Binary sequence header must not change size");
+
+    inline size_t Align8(size_t s)
+    {
+        return (s + 7) & ~(size_t)7;
+    }
+
+    // where each column lives in the file
+    struct BinaryLayout
+    {
+        size_t stringOffsets;  // uint32[stringCount + 1]
+        size_t stringData;     // utf8
+        size_t nodeType;       // uint8[nodeCount]
+        size_t nodeName;       // uint32[nodeCount]
+        size_t nodeContent;    // uint32[nodeCount]
+        size_t nodeChildren;   // uint32[nodeCount]
+        size_t nodeAttributes; // uint32[nodeCount]
+        size_t attributeName;  // uint32[attributeCount]
+        size_t attributeValue; // uint32[attributeCount]
+        size_t size;
+
+        BinaryLayout(const BinaryHeader& h)
+        {
+            size_t pos = Align8(sizeof(BinaryHeader));
+            stringOffsets = pos;
+            pos = Align8(pos + ((size_t)h.stringCount + 1) * sizeof(uint32_t));
+            stringData = pos;
+            pos = Align8(pos + h.stringDataSize);
+            nodeType = pos;
+            pos = Align8(pos + h.nodeCount);
+            nodeName = pos;
+            pos = Align8(pos + (size_t)h.nodeCount * sizeof(uint32_t));
+            nodeContent = pos;
+            pos = Align8(pos + (size_t)h.nodeCount * sizeof(uint32_t));
+            nodeChildren = pos;
+            pos = Align8(pos + (size_t)h.nodeCount * sizeof(uint32_t));
+            nodeAttributes = pos;
+            pos = Align8(pos + (size_t)h.nodeCount * sizeof(uint32_t));
+            attributeName = pos;
+            pos = Align8(pos + (size_t)h.attributeCount * sizeof(uint32_t));
+            attributeValue = pos;
+            pos = Align8(pos + (size_t)h.attributeCount * sizeof(uint32_t));
+            size = pos;
+        }
+    };
+
+    bool GetSourceInfo(const std::string& file, uint64_t& size, int64_t& modified)
+    {
+        wxFileName fn(file);
+        if (!fn.FileExists()) {
+            return false;
+        }
+        wxULongLong sz = fn.GetSize();
+        wxDateTime dt = fn.GetModificationTime();
+        if (sz == wxInvalidSize || !dt.IsValid()) {
+            return false;
+        }
+        size = sz.GetValue();
+        modified = dt.GetValue().GetValue();
+        return true;
+    }
+
+    class BinaryWriter
+    {
+    public:
+        std::vector<uint32_t> stringOffsets;
+        std::string stringData;
+        std::unordered_map<std::string, uint32_t> strings;
+
+        std::vector<uint8_t> nodeType;
+        std::vector<uint32_t> nodeName;
+        std::vector<uint32_t> nodeContent;
+        std::vector<uint32_t> nodeChildren;
+        std::vector<uint32_t> nodeAttributes;
+        std::vector<uint32_t> attributeName;
+        std::vector<uint32_t> attributeValue;
+
+        uint32_t Intern(const wxString& s)
+        {
+            const wxScopedCharBuffer utf8 = s.ToUTF8();
+            std::string str(utf8.data(), utf8.length());
+            auto it = strings.find(str);
+            if (it != strings.end()) {
+                return it->second;
+            }
+            uint32_t idx = stringOffsets.size();
+            stringOffsets.push_back(stringData.size());
+            stringData += str;
+            strings.emplace(std::move(str), idx);
+            return idx;
+        }
+
+        void Add(const wxXmlNode* node)
+        {
+            size_t idx = nodeType.size();
+            nodeType.push_back((uint8_t)node->GetType());
+            nodeName.push_back(Intern(node->GetName()));
+            nodeContent.push_back(Intern(node->GetContent()));
+            nodeChildren.push_back(0);
+            nodeAttributes.push_back(0);
+
+            uint32_t attributes = 0;
+            for (wxXmlAttribute* a = node->GetAttributes(); a != nullptr; a = a->GetNext()) {
+                attributeName.push_back(Intern(a->GetName()));
+                attributeValue.push_back(Intern(a->GetValue()));
+                ++attributes;
+            }
+            nodeAttributes[idx] = attributes;
+
+            uint32_t children = 0;
+            for (wxXmlNode* c = node->GetChildren(); c != nullptr; c = c->GetNext()) {
+                Add(c);
+                ++children;
+            }
+            nodeChildren[idx] = children;
+        }
+    };
+
+    template<class T>
+    void CopyColumn(std::vector<uint8_t>& buf, size_t offset, const std::vector<T>& column)
+    {
+        if (!column.empty()) {
+            memcpy(&buf[offset], column.data(), column.size() * sizeof(T));
+        }
+    }
+
+    // The whole file, mapped where we can
+    class MappedBinaryFile
+    {
+    public:
+        MappedBinaryFile(const std::string& filename)
+        {
+#ifdef __WXMSW__
+            wxFile file;
+            if (file.Open(filename) && file.Length() > 0) {
+                _buffer.resize(file.Length());
+                if (file.Read(_buffer.data(), _buffer.size()) == (ssize_t)_buffer.size()) {
+                    data = _buffer.data();
+                    size = _buffer.size();
+                }
+            }
+#else
+            int fd = open(filename.c_str(), O_RDONLY);
+            if (fd == -1) {
+                return;
+            }
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (map != MAP_FAILED) {
+                    madvise(map, st.st_size, MADV_SEQUENTIAL);
+                    data = (const uint8_t*)map;
+                    size = st.st_size;
+                }
+            }
+            close(fd);
+#endif
+        }
+        ~MappedBinaryFile()
+        {
+#ifndef __WXMSW__
+            if (data != nullptr) {
+                munmap((void*)data, size);
+            }
+#endif
+        }
+
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+
+    private:
+#ifdef __WXMSW__
+        std::vector<uint8_t> _buffer;
+#endif
+    };
+
+    // append children without walking the sibling list each time
+    class NodeAppender
+    {
+        wxXmlNode* _parent;
+        wxXmlNode* _last = nullptr;
+
+    public:
+        NodeAppender(wxXmlNode* parent) : _parent(parent) {}
+
+        wxXmlNode* Add(wxXmlNode* node)
+        {
+            node->SetParent(_parent);
+            if (_last == nullptr) {
+                _parent->SetChildren(node);
+            } else {
+                _last->SetNext(node);
+            }
+            _last = node;
+            return node;
+        }
+        wxXmlNode* Add(const wxString& name, const wxString& content = wxEmptyString)
+        {
+            wxXmlNode* node = Add(new wxXmlNode(wxXML_ELEMENT_NODE, name));
+            if (!content.empty()) {
+                node->SetChildren(new wxXmlNode(wxXML_TEXT_NODE, wxEmptyString, content));
+                node->GetChildren()->SetParent(node);
+            }
+            return node;
+        }
+    };
+
+    // something shaped like a large sequence ... models with a few layers each, effects sharing a pool
+    // of settings and palettes
+    void GenerateSequence(wxXmlDocument& doc, int effects)
+    {
+        wxXmlNode* root = new wxXmlNode(wxXML_ELEMENT_NODE, "xsequence");
+        root->AddAttribute("BaseChannel", "0");
+        root->AddAttribute("ChanCtrlBasic", "0");
+        root->AddAttribute("ChanCtrlColor", "0");
+        root->AddAttribute("FixedPointTiming", "1");
+        root->AddAttribute("ModelBlending", "true");
+        doc.SetRoot(root);
+        NodeAppender rootNodes(root);
+
+        const int frameMS = 25;
+        const int layersPerModel = 4;
+        const int effectsPerLayer = 100;
+        int models = std::max(1, effects / (layersPerModel * effectsPerLayer));
+        int settingsCount = std::max(1, effects / 8);
+        int paletteCount = 64;
+
+        wxXmlNode* head = rootNodes.Add("head");
+        NodeAppender headNodes(head);
+        headNodes.Add("version", "2022.1");
+        headNodes.Add("author", "Benchmark");
+        headNodes.Add("sequenceTiming", wxString::Format("%d ms", frameMS));
+        headNodes.Add("sequenceType", "Media");
+        headNodes.Add("mediaFile", "Benchmark.mp3");
+
+        NodeAppender palettes(rootNodes.Add("ColorPalettes"));
+        for (int i = 0; i < paletteCount; ++i) {
+            palettes.Add("ColorPalette", wxString::Format("C_BUTTON_Palette1=#%06X,C_BUTTON_Palette2=#%06X,C_BUTTON_Palette3=#0000FF,C_BUTTON_Palette4=#FFFF00,"
+                                                          "C_BUTTON_Palette5=#FFFFFF,C_BUTTON_Palette6=#000000,C_BUTTON_Palette7=#FFC800,C_BUTTON_Palette8=#00FFFF,"
+                                                          "C_CHECKBOX_Palette1=1,C_CHECKBOX_Palette2=%d,C_SLIDER_Brightness=%d",
+                                                          (i * 2654435761u) & 0xFFFFFF, (i * 40503u) & 0xFFFFFF, i % 2, 50 + i));
+        }
+
+        NodeAppender settings(rootNodes.Add("EffectDB"));
+        for (int i = 0; i < settingsCount; ++i) {
+            settings.Add("Effect", wxString::Format("E_CHECKBOX_On_Shimmer=0,E_TEXTCTRL_Eff_On_End=%d,E_TEXTCTRL_Eff_On_Start=100,E_TEXTCTRL_On_Cycles=%d.0,"
+                                                    "T_CHOICE_LayerMethod=Normal,T_SLIDER_EffectLayerMix=%d,B_CHOICE_BufferStyle=Default,B_CHOICE_BufferTransform=None,"
+                                                    "B_VALUECURVE_Blur=Active=TRUE|Id=ID_VALUECURVE_Blur|Type=Ramp|Min=1.00|Max=15.00|P1=%d.00|P2=%d.00|RV=TRUE|,"
+                                                    "T_CHOICE_In_Transition_Type=Fade,T_TEXTCTRL_Fadein=%d.%02d",
+                                                    i % 101, 1 + i % 5, i % 100, i % 15, (i * 7) % 15, i % 3, i % 100));
+        }
+
+        NodeAppender display(rootNodes.Add("DisplayElements"));
+        NodeAppender elementEffects(rootNodes.Add("ElementEffects"));
+        int remaining = effects;
+        int duration = 0;
+        for (int m = 0; m < models; ++m) {
+            wxString name = wxString::Format("Model %d", m);
+            wxXmlNode* de = display.Add("Element");
+            de->AddAttribute("collapsed", "0");
+            de->AddAttribute("type", "model");
+            de->AddAttribute("name", name);
+            de->AddAttribute("visible", "1");
+
+            wxXmlNode* ee = elementEffects.Add("Element");
+            ee->AddAttribute("type", "model");
+            ee->AddAttribute("name", name);
+            NodeAppender layers(ee);
+            for (int l = 0; l < layersPerModel; ++l) {
+                int count = remaining / ((models - m) * layersPerModel - l);
+                remaining -= count;
+                NodeAppender layer(layers.Add("EffectLayer"));
+                int start = 0;
+                for (int e = 0; e < count; ++e) {
+                    int n = (m * layersPerModel + l) * effectsPerLayer + e;
+                    int end = start + frameMS * (4 + n % 80);
+                    wxXmlNode* effect = layer.Add(new wxXmlNode(wxXML_ELEMENT_NODE, "Effect"));
+                    effect->AddAttribute("ref", wxString::Format("%d", n % settingsCount));
+                    effect->AddAttribute("name", (n % 3) == 0 ? "On" : ((n % 3) == 1 ? "Bars" : "Butterfly"));
+                    if (n % 50 == 0) {
+                        effect->AddAttribute("selected", "1");
+                    }
+                    effect->AddAttribute("id", wxString::Format("%d", n + 1));
+                    effect->AddAttribute("startTime", wxString::Format("%d", start));
+                    effect->AddAttribute("endTime", wxString::Format("%d", end));
+                    effect->AddAttribute("palette", wxString::Format("%d", n % paletteCount));
+                    start = end;
+                }
+                duration = std::max(duration, start);
+            }
+        }
+        rootNodes.Add("lastView", "0");
+        headNodes.Add("sequenceDuration", wxString::Format("%d.%03d", duration / 1000, duration % 1000));
+    }
+
+    bool SameNode(const wxXmlNode* a, const wxXmlNode* b)
+    {
+        if (a->GetType() != b->GetType() || a->GetName() != b->GetName() || a->GetContent() != b->GetContent()) {
+            return false;
+        }
+        const wxXmlAttribute* aa = a->GetAttributes();
+        const wxXmlAttribute* ba = b->GetAttributes();
+        for (; aa != nullptr && ba != nullptr; aa = aa->GetNext(), ba = ba->GetNext()) {
+            if (aa->GetName() != ba->GetName() || aa->GetValue() != ba->GetValue()) {
+                return false;
+            }
+        }
+        if (aa != ba) {
+            return false;
+        }
+        const wxXmlNode* ac = a->GetChildren();
+        const wxXmlNode* bc = b->GetChildren();
+        for (; ac != nullptr && bc != nullptr; ac = ac->GetNext(), bc = bc->GetNext()) {
+            if (!SameNode(ac, bc)) {
+                return false;
+            }
+        }
+        return ac == bc;
+    }
+
+    size_t FileSize(const std::string& file)
+    {
+        wxULongLong sz = wxFileName(file).GetSize();
+        return sz == wxInvalidSize ? 0 : (size_t)sz.GetValue();
+    }
+}
+
+std::string SequenceBinaryFile::GetCopyFileName(const std::string& xsq)
+{
+    wxFileName fn(xsq);
+    if (fn.GetExt().Lower() != "xsq") {
+        return "";
+    }
+    fn.SetExt("xsqb");
+    return fn.GetFullPath().ToStdString();
+}
+
+bool SequenceBinaryFile::IsBinarySequence(const std::string& filename)
+{
+    char magic[4];
+    wxFile file;
+    if (!file.Open(filename) || file.Read(magic, sizeof(magic)) != sizeof(magic)) {
+        return false;
+    }
+    return memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0;
+}
+
+bool SequenceBinaryFile::Save(const wxXmlDocument& doc, const std::string& filename, const std::string& sourceFile)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (doc.GetDocumentNode() == nullptr) {
+        return false;
+    }
+
+    BinaryHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, BINARY_MAGIC, sizeof(h.magic));
+    h.version = BINARY_VERSION;
+    if (!sourceFile.empty() && !GetSourceInfo(sourceFile, h.sourceSize, h.sourceModified)) {
+        logger_base.warn("SequenceBinaryFile: Unable to get the size and time of %s.", (const char*)sourceFile.c_str());
+        return false;
+    }
+
+    BinaryWriter writer;
+    h.docVersion = writer.Intern(doc.GetVersion());
+    h.docEncoding = writer.Intern(doc.GetFileEncoding());
+    writer.Add(doc.GetDocumentNode());
+    if (writer.stringData.size() > UINT32_MAX) {
+        logger_base.warn("SequenceBinaryFile: %s is too large for the binary format.", (const char*)filename.c_str());
+        return false;
+    }
+    writer.stringOffsets.push_back(writer.stringData.size());
+
+    h.stringCount = writer.stringOffsets.size() - 1;
+    h.nodeCount = writer.nodeType.size();
+    h.attributeCount = writer.attributeName.size();
+    h.stringDataSize = writer.stringData.size();
+
+    BinaryLayout layout(h);
+    std::vector<uint8_t> buf(layout.size, 0);
+    memcpy(&buf[0], &h, sizeof(h));
+    CopyColumn(buf, layout.stringOffsets, writer.stringOffsets);
+    if (!writer.stringData.empty()) {
+        memcpy(&buf[layout.stringData], writer.stringData.data(), writer.stringData.size());
+    }
+    CopyColumn(buf, layout.nodeType, writer.nodeType);
+    CopyColumn(buf, layout.nodeName, writer.nodeName);
+    CopyColumn(buf, layout.nodeContent, writer.nodeContent);
+    CopyColumn(buf, layout.nodeChildren, writer.nodeChildren);
+    CopyColumn(buf, layout.nodeAttributes, writer.nodeAttributes);
+    CopyColumn(buf, layout.attributeName, writer.attributeName);
+    CopyColumn(buf, layout.attributeValue, writer.attributeValue);
+
+    // write it to the side so a failed write never leaves a damaged file
+    std::string tmp = filename + ".tmp";
+    wxFile file;
+    if (!file.Create(tmp, true)) {
+        logger_base.warn("SequenceBinaryFile: Unable to create %s.", (const char*)tmp.c_str());
+        return false;
+    }
+    bool ok = file.Write(buf.data(), buf.size()) == buf.size();
+    ok = file.Close() && ok;
+    if (!ok || !wxRenameFile(tmp, filename, true)) {
+        logger_base.warn("SequenceBinaryFile: Unable to write %s.", (const char*)filename.c_str());
+        wxRemoveFile(tmp);
+        return false;
+    }
+    return true;
+}
+
+bool SequenceBinaryFile::Load(const std::string& filename, wxXmlDocument& doc, const std::string& sourceFile)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    MappedBinaryFile file(filename);
+    if (file.data == nullptr || file.size < sizeof(BinaryHeader)) {
+        return false;
+    }
+    BinaryHeader h;
+    memcpy(&h, file.data, sizeof(h));
+    if (memcmp(h.magic, BINARY_MAGIC, sizeof(h.magic)) != 0 || h.version != BINARY_VERSION) {
+        logger_base.warn("SequenceBinaryFile: %s is not a binary sequence this version understands.", (const char*)filename.c_str());
+        return false;
+    }
+    if (!sourceFile.empty()) {
+        uint64_t size = 0;
+        int64_t modified = 0;
+        if (!GetSourceInfo(sourceFile, size, modified) || size != h.sourceSize || modified != h.sourceModified) {
+            logger_base.debug("SequenceBinaryFile: %s is out of date with %s.", (const char*)filename.c_str(), (const char*)sourceFile.c_str());
+            return false;
+        }
+    }
+
+    BinaryLayout layout(h);
+    if (layout.size > file.size || h.nodeCount == 0 || h.docVersion >= h.stringCount || h.docEncoding >= h.stringCount) {
+        logger_base.warn("SequenceBinaryFile: %s is damaged.", (const char*)filename.c_str());
+        return false;
+    }
+    const uint32_t* stringOffsets = (const uint32_t*)(file.data + layout.stringOffsets);
+    const char* stringData = (const char*)(file.data + layout.stringData);
+    const uint8_t* nodeType = file.data + layout.nodeType;
+    const uint32_t* nodeName = (const uint32_t*)(file.data + layout.nodeName);
+    const uint32_t* nodeContent = (const uint32_t*)(file.data + layout.nodeContent);
+    const uint32_t* nodeChildren = (const uint32_t*)(file.data + layout.nodeChildren);
+    const uint32_t* nodeAttributes = (const uint32_t*)(file.data + layout.nodeAttributes);
+    const uint32_t* attributeName = (const uint32_t*)(file.data + layout.attributeName);
+    const uint32_t* attributeValue = (const uint32_t*)(file.data + layout.attributeValue);
+
+    // check everything before building so a damaged file can never produce a partial document
+    uint64_t totalChildren = 0;
+    uint64_t totalAttributes = 0;
+    for (uint32_t i = 0; i < h.nodeCount; ++i) {
+        if (nodeType[i] < wxXML_ELEMENT_NODE || nodeType[i] > wxXML_HTML_DOCUMENT_NODE ||
+            nodeName[i] >= h.stringCount || nodeContent[i] >= h.stringCount) {
+            logger_base.warn("SequenceBinaryFile: %s is damaged.", (const char*)filename.c_str());
+            return false;
+        }
+        totalChildren += nodeChildren[i];
+        totalAttributes += nodeAttributes[i];
+    }
+    bool valid = nodeType[0] == wxXML_DOCUMENT_NODE && totalChildren == h.nodeCount - 1 && totalAttributes == h.attributeCount;
+    for (uint32_t i = 0; valid && i < h.attributeCount; ++i) {
+        valid = attributeName[i] < h.stringCount && attributeValue[i] < h.stringCount;
+    }
+    for (uint32_t i = 0; valid && i < h.stringCount; ++i) {
+        valid = stringOffsets[i] <= stringOffsets[i + 1] && stringOffsets[i + 1] <= h.stringDataSize;
+    }
+    if (!valid) {
+        logger_base.warn("SequenceBinaryFile: %s is damaged.", (const char*)filename.c_str());
+        return false;
+    }
+
+    // every distinct string is converted once
+    std::vector<wxString> strings;
+    strings.reserve(h.stringCount);
+    for (uint32_t i = 0; i < h.stringCount; ++i) {
+        strings.push_back(wxString::FromUTF8Unchecked(stringData + stringOffsets[i], stringOffsets[i + 1] - stringOffsets[i]));
+    }
+
+    struct OpenNode
+    {
+        wxXmlNode* node;
+        uint32_t remaining;
+        wxXmlNode* last;
+    };
+    std::vector<OpenNode> open;
+    wxXmlNode* docNode = nullptr;
+    uint32_t attribute = 0;
+    for (uint32_t i = 0; i < h.nodeCount; ++i) {
+        wxXmlNode* node = new wxXmlNode((wxXmlNodeType)nodeType[i], strings[nodeName[i]], strings[nodeContent[i]]);
+
+        // built back to front so each attribute is simply put in front of the last
+        wxXmlAttribute* attributes = nullptr;
+        for (uint32_t a = attribute + nodeAttributes[i]; a > attribute; --a) {
+            attributes = new wxXmlAttribute(strings[attributeName[a - 1]], strings[attributeValue[a - 1]], attributes);
+        }
+        attribute += nodeAttributes[i];
+        if (attributes != nullptr) {
+            node->SetAttributes(attributes);
+        }
+
+        if (open.empty()) {
+            if (docNode != nullptr) {
+                // can't happen given the checks above
+                delete node;
+                delete docNode;
+                return false;
+            }
+            docNode = node;
+        } else {
+            OpenNode& parent = open.back();
+            node->SetParent(parent.node);
+            if (parent.last == nullptr) {
+                parent.node->SetChildren(node);
+            } else {
+                parent.last->SetNext(node);
+            }
+            parent.last = node;
+            --parent.remaining;
+        }
+        if (nodeChildren[i] > 0) {
+            open.push_back({ node, nodeChildren[i], nullptr });
+        }
+        while (!open.empty() && open.back().remaining == 0) {
+            open.pop_back();
+        }
+    }
+
+    doc.SetDocumentNode(docNode);
+    doc.SetVersion(strings[h.docVersion]);
+    doc.SetFileEncoding(strings[h.docEncoding]);
+    return true;
+}
+
+bool SequenceBinaryFile::SaveCopy(const wxXmlDocument& doc, const std::string& xsq)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::string copy = GetCopyFileName(xsq);
+    if (!IsEnabled() || copy.empty()) {
+        return false;
+    }
+    wxStopWatch sw;
+    bool res = Save(doc, copy, xsq);
+    if (res) {
+        logger_base.debug("SequenceBinaryFile: Saved %s in %ldms.", (const char*)copy.c_str(), sw.Time());
+    }
+    return res;
+}
+
+bool SequenceBinaryFile::LoadCopy(const std::string& xsq, wxXmlDocument& doc)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::string copy = GetCopyFileName(xsq);
+    if (!IsEnabled() || copy.empty() || !FileExists(copy)) {
+        return false;
+    }
+    wxStopWatch sw;
+    bool res = Load(copy, doc, xsq);
+    if (res) {
+        logger_base.info("SequenceBinaryFile: Loaded %s in %ldms.", (const char*)copy.c_str(), sw.Time());
+    }
+    return res;
+}
+
+bool SequenceBinaryFile::ConvertToBinary(const std::string& xsq, const std::string& xsqb)
+{
+    wxXmlDocument doc;
+    if (!doc.Load(xsq)) {
+        return false;
+    }
+    return Save(doc, xsqb, xsq);
+}
+
+bool SequenceBinaryFile::ConvertToXml(const std::string& xsqb, const std::string& xsq)
+{
+    wxXmlDocument doc;
+    if (!Load(xsqb, doc)) {
+        return false;
+    }
+    return doc.Save(xsq);
+}
+
+std::string SequenceBinaryFile::Benchmark(int effects)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    wxXmlDocument doc;
+    GenerateSequence(doc, effects);
+
+    std::string xsq = wxFileName(wxFileName::GetTempDir(), "xLightsSequenceBenchmark.xsq").GetFullPath().ToStdString();
+    std::string xsqb = GetCopyFileName(xsq);
+    std::string roundTrip = wxFileName(wxFileName::GetTempDir(), "xLightsSequenceBenchmark2.xsq").GetFullPath().ToStdString();
+
+    wxStopWatch sw;
+    bool ok = doc.Save(xsq);
+    long xmlSave = sw.Time();
+
+    sw.Start();
+    wxXmlDocument xmlDoc;
+    ok = xmlDoc.Load(xsq) && ok;
+    long xmlLoad = sw.Time();
+
+    sw.Start();
+    ok = ConvertToBinary(xsq, xsqb) && ok;
+    long toBinary = sw.Time();
+
+    sw.Start();
+    ok = Save(xmlDoc, xsqb, xsq) && ok;
+    long binarySave = sw.Time();
+
+    sw.Start();
+    wxXmlDocument binaryDoc;
+    ok = Load(xsqb, binaryDoc, xsq) && ok;
+    long binaryLoad = sw.Time();
+
+    sw.Start();
+    ok = ConvertToXml(xsqb, roundTrip) && ok;
+    long toXml = sw.Time();
+
+    // the binary copy must give back exactly what the xml gave and converting back must give the same xml
+    bool lossless = ok && SameNode(xmlDoc.GetDocumentNode(), binaryDoc.GetDocumentNode());
+    if (lossless) {
+        wxXmlDocument roundTripDoc;
+        lossless = roundTripDoc.Load(roundTrip) && SameNode(xmlDoc.GetDocumentNode(), roundTripDoc.GetDocumentNode());
+    }
+
+    std::string res = wxString::Format("{\"effects\":%d,\"xmlsize\":%llu,\"binarysize\":%llu,"
+                                       "\"xmlsavems\":%ld,\"xmlloadms\":%ld,\"binarysavems\":%ld,\"binaryloadms\":%ld,"
+                                       "\"converttobinaryms\":%ld,\"converttoxmlms\":%ld,\"lossless\":%s}",
+                                       effects, (unsigned long long)FileSize(xsq), (unsigned long long)FileSize(xsqb),
+                                       xmlSave, xmlLoad, binarySave, binaryLoad, toBinary, toXml, toStr(lossless))
+                          .ToStdString();
+    logger_base.info("SequenceBinaryFile: Benchmark %s", (const char*)res.c_str());
+
+    wxRemoveFile(xsq);
+    wxRemoveFile(xsqb);
+    wxRemoveFile(roundTrip);
+    return res;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <string>
+
+class wxXmlDocument;
+
+// Binary form of a sequence's xml document (.xsqb)
+//
+// Every string in the document (element and attribute names, attribute values, text) is stored once
+// in a string pool and the nodes are stored as fixed width columns in document order ... type, name,
+// content, number of children and number of attributes ... followed by the attribute name and value
+// columns. The effects in a layer are therefore consecutive rows referring to pooled settings,
+// palette, name and time strings. All sections are 8 byte aligned little endian arrays so the file is
+// memory mapped and read in place.
+//
+// Conversion to and from the xml is lossless so the .xsq remains the sequence. When enabled a copy is
+// written beside the .xsq each time it is saved and used in its place when the sequence is opened,
+// provided the .xsq has the same size and modification time it had when the copy was written.
+class SequenceBinaryFile
+{
+    static std::atomic_bool __enabled;
+
+public:
+
+    static bool IsEnabled() { return __enabled; }
+    static void SetEnabled(bool enabled) { __enabled = enabled; }
+
+    // foo.xsq -> foo.xsqb. Empty for anything which is not a .xsq
+    static std::string GetCopyFileName(const std::string& xsq);
+    static bool IsBinarySequence(const std::string& filename);
+
+    // sourceFile is the xml file the document was saved to, if any, so a copy can be checked for being current
+    static bool Save(const wxXmlDocument& doc, const std::string& filename, const std::string& sourceFile = "");
+    // fails if sourceFile is given and has changed since the file was written
+    static bool Load(const std::string& filename, wxXmlDocument& doc, const std::string& sourceFile = "");
+
+    // write/read the copy kept beside a .xsq. These do nothing unless enabled
+    static bool SaveCopy(const wxXmlDocument& doc, const std::string& xsq);
+    static bool LoadCopy(const std::string& xsq, wxXmlDocument& doc);
+
+    static bool ConvertToBinary(const std::string& xsq, const std::string& xsqb);
+    static bool ConvertToXml(const std::string& xsqb, const std::string& xsq);
+
+    // times xml and binary save/load of a generated sequence with this many effects and checks the
+    // round trip. Returns the results as json
+    static std::string Benchmark(int effects);
+};
@@ -0,0 +1,382 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <wx/xml/xml.h>
+
+#include <string_view>
+#include <unordered_map>
+
+#include "SequenceSnapshot.h"
+#include "DataLayer.h"
+#include "UtilFunctions.h"
+#include "sequencer/SequenceElements.h"
+#include "sequencer/Element.h"
+#include "sequencer/EffectLayer.h"
+#include "sequencer/Effect.h"
+#include "sequencer/TimeLine.h"
+
+namespace
+{
+    // wxXmlNode::AddChild walks every existing child to find the end which makes a layer with
+    // thousands of effects quadratic to build. This remembers the last child instead
+    class ChildAppender
+    {
+    public:
+        explicit ChildAppender(wxXmlNode* parent) :
+            _parent(parent)
+        {
+            _last = parent->GetChildren();
+            while (_last != nullptr && _last->GetNext() != nullptr) {
+                _last = _last->GetNext();
+            }
+        }
+
+        wxXmlNode* Add(const wxString& name)
+        {
+            wxXmlNode* node = new wxXmlNode(wxXML_ELEMENT_NODE, name);
+            if (_last == nullptr) {
+                _parent->AddChild(node);
+            } else {
+                _parent->InsertChildAfter(node, _last);
+            }
+            _last = node;
+            return node;
+        }
+
+        wxXmlNode* Add(const wxString& name, const wxString& content)
+        {
+            wxXmlNode* node = Add(name);
+            node->AddChild(new wxXmlNode(wxXML_TEXT_NODE, "", content));
+            return node;
+        }
+
+    private:
+        wxXmlNode* _parent = nullptr;
+        wxXmlNode* _last = nullptr;
+    };
+
+    void AddAttributes(wxXmlNode* node, const SequenceSnapshot::Attributes& attributes)
+    {
+        for (const auto& it : attributes) {
+            node->AddAttribute(it.first, it.second);
+        }
+    }
+
+    // index of s in the pool, adding it as a new node if it has not been seen. Indexes are 0 based
+    int PoolIndex(std::unordered_map<std::string_view, int>& pool, ChildAppender& poolNode, const wxString& nodeName, const std::string& s)
+    {
+        auto it = pool.find(s);
+        if (it != pool.end()) {
+            return it->second;
+        }
+        int ref = (int)pool.size();
+        pool[s] = ref;
+        poolNode.Add(nodeName, ToWXString(s));
+        return ref;
+    }
+}
+
+class SequenceSnapshot::Capture
+{
+public:
+    Capture(const Cache::ElementStrings* previous, Cache::ElementStrings& next) :
+        _previous(previous), _next(next)
+    {
+    }
+
+    void AddEffects(EffectLayer* layer, std::vector<EffectData>& effects, bool timing)
+    {
+        int num_effects = layer->GetEffectCount();
+        effects.reserve(num_effects);
+        for (int k = 0; k < num_effects; ++k) {
+            Effect* effect = layer->GetEffect(k);
+
+            Cache::EffectStrings strings;
+            size_t pos = _next.effects.size();
+            // settings can change without the element's change count moving (timing track renames, file location
+            // cleanups) and a freed effect's address can be reused so the cached strings must still match the effect
+            if (_previous != nullptr && pos < _previous->effects.size() && _previous->effects[pos].effect == effect &&
+                effect->SettingsMatch(*_previous->effects[pos].settings) &&
+                (timing || (_previous->effects[pos].palette != nullptr && effect->PaletteMatches(*_previous->effects[pos].palette)))) {
+                strings = _previous->effects[pos];
+            } else {
+                strings.effect = effect;
+                strings.settings = std::make_shared<const std::string>(effect->GetSettingsAsString());
+                if (!timing) {
+                    strings.palette = std::make_shared<const std::string>(effect->GetPaletteAsString());
+                }
+                _reused = false;
+            }
+
+            EffectData data;
+            data.name = effect->GetEffectName();
+            data.settings = strings.settings;
+            data.palette = strings.palette;
+            data.startTime = effect->GetStartTimeMS();
+            data.endTime = effect->GetEndTimeMS();
+            data.id = effect->GetID();
+            data.selected = effect->GetSelected() != 0;
+            data.isProtected = effect->GetProtected();
+            effects.push_back(std::move(data));
+
+            _next.effects.push_back(std::move(strings));
+        }
+    }
+
+    bool Reused() const { return _previous != nullptr && _reused && _previous->effects.size() == _next.effects.size(); }
+
+private:
+    const Cache::ElementStrings* _previous = nullptr;
+    Cache::ElementStrings& _next;
+    bool _reused = true;
+};
+
+SequenceSnapshot::SequenceSnapshot(SequenceElements& seq_elements, DataLayerSet& dataLayers, Cache& cache)
+{
+    _modelBlending = seq_elements.SupportsModelBlending();
+    _currentView = seq_elements.GetCurrentView();
+
+    int num_data_layers = dataLayers.GetNumLayers();
+    for (int i = 0; i < num_data_layers; ++i) {
+        DataLayer* layer = dataLayers.GetDataLayer(i);
+        _dataLayers.push_back({ { "lor_params", wxString::Format("%d", layer->GetLORConvertParams()) },
+                                { "channel_offset", wxString::Format("%d", layer->GetChannelOffset()) },
+                                { "num_channels", wxString::Format("%d", layer->GetNumChannels()) },
+                                { "num_frames", wxString::Format("%d", layer->GetNumFrames()) },
+                                { "data", layer->GetDataSource() },
+                                { "source", layer->GetSource() },
+                                { "name", layer->GetName() } });
+    }
+
+    if (seq_elements.GetTimeLine() != nullptr) {
+        for (int i = 0; i < 10; ++i) {
+            _tagPositions.push_back(seq_elements.GetTimeLine()->GetTagPosition(i));
+        }
+    }
+
+    // elements no longer in the sequence drop out of the cache
+    std::map<const Element*, Cache::ElementStrings> nextCache;
+
+    int num_elements = seq_elements.GetElementCount();
+    _elements.resize(num_elements);
+    for (int i = 0; i < num_elements; ++i) {
+        Element* element = seq_elements.GetElement(i);
+        ElementData& data = _elements[i];
+
+        Cache::ElementStrings& next = nextCache[element];
+        const Cache::ElementStrings* previous = nullptr;
+        auto cached = cache._elements.find(element);
+        if (cached != cache._elements.end()) {
+            previous = &cached->second;
+        }
+        Capture capture(previous, next);
+
+        data.timing = element->GetType() == ElementType::ELEMENT_TYPE_TIMING;
+        wxString type = data.timing ? "timing" : "model";
+
+        data.displayAttributes.push_back({ "collapsed", wxString::Format("%d", element->GetCollapsed()) });
+        if (element->IsRenderDisabled()) {
+            data.displayAttributes.push_back({ "RenderDisabled", "1" });
+        }
+        data.displayAttributes.push_back({ "type", type });
+        data.displayAttributes.push_back({ "name", element->GetName() });
+
+        data.attributes.push_back({ "type", type });
+        data.attributes.push_back({ "name", element->GetName() });
+
+        if (data.timing) {
+            TimingElement* tm = dynamic_cast<TimingElement*>(element);
+            data.displayAttributes.push_back({ "visible", wxString::Format("%d", tm->GetMasterVisible()) });
+            data.displayAttributes.push_back({ "views", tm->GetViews() });
+            data.displayAttributes.push_back({ "active", wxString::Format("%d", tm->GetActive()) });
+            if (tm->GetSubType() != "") {
+                data.displayAttributes.push_back({ "subType", tm->GetSubType() });
+            }
+            if (tm->GetFixedTiming()) {
+                data.attributes.push_back({ "fixed", wxString::Format("%d", tm->GetFixedTiming()) });
+                data.layers.push_back({ "EffectLayer" });
+            } else {
+                int num_layers = tm->GetEffectLayerCount();
+                for (int j = 0; j < num_layers; ++j) {
+                    LayerData layer{ "EffectLayer" };
+                    capture.AddEffects(tm->GetEffectLayer(j), layer.effects, true);
+                    data.layers.push_back(std::move(layer));
+                }
+            }
+        } else {
+            data.displayAttributes.push_back({ "visible", wxString::Format("%d", element->GetVisible()) });
+        }
+
+        if (element->GetType() == ElementType::ELEMENT_TYPE_MODEL) {
+            ModelElement* me = dynamic_cast<ModelElement*>(element);
+            int num_layers = me->GetEffectLayerCount();
+            for (int j = 0; j < num_layers; ++j) {
+                EffectLayer* el = me->GetEffectLayer(j);
+                LayerData layer{ "EffectLayer" };
+                if (!el->GetLayerName().empty()) {
+                    layer.attributes.push_back({ "layerName", el->GetLayerName() });
+                }
+                capture.AddEffects(el, layer.effects, false);
+                data.layers.push_back(std::move(layer));
+            }
+
+            int num_strands = me->GetSubModelAndStrandCount();
+            for (int strand = 0; strand < num_strands; strand++) {
+                SubModelElement* se = me->GetSubModel(strand);
+                num_layers = se->GetEffectLayerCount();
+                // the strand node the node layers go in, by position as data.layers may grow
+                int effect_layer_node = -1;
+
+                StrandElement* strEl = dynamic_cast<StrandElement*>(se);
+                for (int j = 0; j < num_layers; ++j) {
+                    EffectLayer* el = se->GetEffectLayer(j);
+
+                    if (el->GetEffectCount() != 0 || !el->GetLayerName().empty()) {
+                        LayerData layer{ strEl == nullptr ? "SubModelEffectLayer" : "Strand" };
+                        if (strEl != nullptr) {
+                            layer.attributes.push_back({ "index", wxString::Format("%d", strEl->GetStrand()) });
+                            if (j == 0) {
+                                effect_layer_node = (int)data.layers.size();
+                            }
+                        }
+                        if (!el->GetLayerName().empty()) {
+                            layer.attributes.push_back({ "layerName", el->GetLayerName() });
+                        }
+                        if (j > 0) {
+                            layer.attributes.push_back({ "layer", wxString::Format("%d", j) });
+                        }
+                        if (se->GetName() != "") {
+                            layer.attributes.push_back({ "name", se->GetName() });
+                        }
+                        capture.AddEffects(el, layer.effects, false);
+                        data.layers.push_back(std::move(layer));
+                    }
+                }
+                if (strEl != nullptr) {
+                    for (int n = 0; n < strEl->GetNodeLayerCount(); n++) {
+                        NodeLayer* nlayer = strEl->GetNodeLayer(n);
+                        if (nlayer->GetEffectCount() == 0) {
+                            continue;
+                        }
+                        if (effect_layer_node == -1) {
+                            LayerData layer{ "Strand" };
+                            layer.attributes.push_back({ "index", wxString::Format("%d", strEl->GetStrand()) });
+                            if (se->GetName() != "") {
+                                layer.attributes.push_back({ "name", se->GetName() });
+                            }
+                            effect_layer_node = (int)data.layers.size();
+                            data.layers.push_back(std::move(layer));
+                        }
+                        LayerData node{ "Node" };
+                        node.attributes.push_back({ "index", wxString::Format("%d", n) });
+                        if (nlayer->GetNodeName() != "") {
+                            node.attributes.push_back({ "name", nlayer->GetNodeName() });
+                        }
+                        capture.AddEffects(nlayer, node.effects, false);
+                        data.layers[effect_layer_node].children.push_back(std::move(node));
+                    }
+                }
+            }
+        }
+
+        if (capture.Reused()) {
+            ++_reusedElements;
+        }
+    }
+    cache._elements.swap(nextCache);
+}
+
+void SequenceSnapshot::AddToDocument(wxXmlNode* root) const
+{
+    root->DeleteAttribute("ModelBlending");
+    root->AddAttribute("ModelBlending", _modelBlending ? "true" : "false");
+
+    ChildAppender rootChildren(root);
+    wxXmlNode* colorPalette_node = rootChildren.Add("ColorPalettes");
+    wxXmlNode* effectDB_Node = rootChildren.Add("EffectDB");
+    wxXmlNode* data_layer = rootChildren.Add("DataLayers");
+    wxXmlNode* display_node = rootChildren.Add("DisplayElements");
+    wxXmlNode* elements_node = rootChildren.Add("ElementEffects");
+    rootChildren.Add("lastView", wxString::Format("%d", _currentView));
+    wxXmlNode* timing_tags_node = rootChildren.Add("TimingTags");
+
+    ChildAppender colorPalettes(colorPalette_node);
+    ChildAppender effectDB(effectDB_Node);
+    std::unordered_map<std::string_view, int> paletteRefs;
+    std::unordered_map<std::string_view, int> effectRefs;
+
+    ChildAppender dataLayers(data_layer);
+    for (const auto& it : _dataLayers) {
+        AddAttributes(dataLayers.Add("DataLayer"), it);
+    }
+
+    ChildAppender tags(timing_tags_node);
+    for (size_t i = 0; i < _tagPositions.size(); ++i) {
+        wxXmlNode* tag_node = tags.Add("Tag");
+        tag_node->AddAttribute("number", wxString::Format("%d", (int)i));
+        tag_node->AddAttribute("position", wxString::Format("%d", _tagPositions[i]));
+    }
+
+    auto addEffects = [&](wxXmlNode* layer_node, const LayerData& layer, bool timing) {
+        ChildAppender effects(layer_node);
+        for (const auto& effect : layer.effects) {
+            wxXmlNode* effect_node;
+            if (timing) {
+                effect_node = effects.Add("Effect", *effect.settings);
+                effect_node->AddAttribute("label", effect.name);
+            } else {
+                int ref = PoolIndex(effectRefs, effectDB, "Effect", *effect.settings);
+                effect_node = effects.Add("Effect");
+                effect_node->AddAttribute("ref", wxString::Format("%d", ref));
+                effect_node->AddAttribute("name", XmlSafe(effect.name));
+            }
+            if (effect.isProtected) {
+                effect_node->AddAttribute("protected", "1");
+            }
+            if (effect.selected) {
+                effect_node->AddAttribute("selected", "1");
+            }
+            if (!timing && effect.id) {
+                effect_node->AddAttribute("id", wxString::Format("%d", effect.id));
+            }
+            effect_node->AddAttribute("startTime", wxString::Format("%d", effect.startTime));
+            effect_node->AddAttribute("endTime", wxString::Format("%d", effect.endTime));
+            if (!timing && effect.palette != nullptr && !effect.palette->empty()) {
+                int pref = PoolIndex(paletteRefs, colorPalettes, "ColorPalette", *effect.palette);
+                effect_node->AddAttribute("palette", wxString::Format("%d", pref));
+            }
+        }
+    };
+
+    ChildAppender displayElements(display_node);
+    ChildAppender elementEffects(elements_node);
+    for (const auto& element : _elements) {
+        AddAttributes(displayElements.Add("Element"), element.displayAttributes);
+
+        wxXmlNode* element_effects_node = elementEffects.Add("Element");
+        AddAttributes(element_effects_node, element.attributes);
+
+        ChildAppender layers(element_effects_node);
+        for (const auto& layer : element.layers) {
+            wxXmlNode* layer_node = layers.Add(layer.tag);
+            AddAttributes(layer_node, layer.attributes);
+            addEffects(layer_node, layer, element.timing);
+
+            if (!layer.children.empty()) {
+                ChildAppender nodes(layer_node);
+                for (const auto& node : layer.children) {
+                    wxXmlNode* node_node = nodes.Add(node.tag);
+                    AddAttributes(node_node, node.attributes);
+                    addEffects(node_node, node, false);
+                }
+            }
+        }
+    }
+}
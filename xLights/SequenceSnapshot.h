@@ -0,0 +1,105 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <wx/string.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class wxXmlNode;
+class DataLayerSet;
+class Effect;
+class Element;
+class EffectLayer;
+class SequenceElements;
+
+// A copy of everything xLightsXmlFile::Save writes for the elements and effects of a sequence.
+//
+// It is taken on the UI thread and owns nothing from the sequencer so it can be turned into xml
+// on another thread while editing continues. The settings and palette strings are the costly part
+// of taking it so they are shared with the Cache kept by the sequence file ... an effect whose settings
+// and palette still match the strings captured by the previous snapshot reuses them rather than
+// building them again. Checking a match walks the settings but allocates nothing. The strings are
+// never modified once captured so a snapshot still being written holds the old strings while the
+// cache moves on to new ones.
+class SequenceSnapshot
+{
+public:
+    typedef std::shared_ptr<const std::string> SharedString;
+    typedef std::vector<std::pair<wxString, wxString>> Attributes;
+
+    class Cache
+    {
+    public:
+        void Clear() { _elements.clear(); }
+
+    private:
+        friend class SequenceSnapshot;
+
+        struct EffectStrings {
+            const Effect* effect = nullptr;
+            SharedString settings;
+            SharedString palette;
+        };
+        struct ElementStrings {
+            std::vector<EffectStrings> effects; // in the order the snapshot visits them
+        };
+        std::map<const Element*, ElementStrings> _elements;
+    };
+
+    // must be called on the UI thread
+    SequenceSnapshot(SequenceElements& elements, DataLayerSet& dataLayers, Cache& cache);
+
+    // replaces the ModelBlending attribute and appends the ColorPalettes, EffectDB, DataLayers,
+    // DisplayElements, ElementEffects, lastView and TimingTags nodes. Safe on any thread provided
+    // root belongs to a document nothing else is using
+    void AddToDocument(wxXmlNode* root) const;
+
+    size_t GetElementCount() const { return _elements.size(); }
+    size_t GetReusedElementCount() const { return _reusedElements; }
+
+private:
+    struct EffectData {
+        std::string name;
+        SharedString settings;
+        SharedString palette;
+        int startTime = 0;
+        int endTime = 0;
+        int id = 0;
+        bool selected = false;
+        bool isProtected = false;
+    };
+    struct LayerData {
+        wxString tag;
+        Attributes attributes;
+        std::vector<EffectData> effects;
+        std::vector<LayerData> children;
+    };
+    struct ElementData {
+        bool timing = false;
+        Attributes displayAttributes;
+        Attributes attributes;
+        std::vector<LayerData> layers;
+    };
+
+    class Capture;
+
+    bool _modelBlending = true;
+    int _currentView = 0;
+    std::vector<int> _tagPositions;
+    std::vector<Attributes> _dataLayers;
+    std::vector<ElementData> _elements;
+    size_t _reusedElements = 0;
+};
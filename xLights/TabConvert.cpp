@@ -1432,25 +1432,30 @@ static void addRanges(Model* m, std::map<uint32_t, uint32_t>& ranges)
 }
 
 void xLightsFrame::WriteFalconPiFile(const wxString& filename, bool allowSparse)
+{
+    WriteFalconPiFile(filename, _seqData, _sequenceElements, mediaFilename, allowSparse);
+}
+
+void xLightsFrame::WriteFalconPiFile(const wxString& filename, SequenceData& seqData, SequenceElements& sequenceElements, std::string& media, bool allowSparse)
 {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     ConvertParameters write_params(filename,                               // filename
-                                   _seqData,                               // sequence data object
+                                   seqData,                                // sequence data object
                                    &_outputManager,                        // global network info
                                    ConvertParameters::READ_MODE_LOAD_MAIN, // file read mode
                                    this,                                   // xLights main frame
                                    nullptr,
                                    nullptr,
-                                   &mediaFilename, // media filename
+                                   &media, // media filename
                                    nullptr,
                                    filename);
-    write_params.elements = &_sequenceElements;
+    write_params.elements = &sequenceElements;
     if (allowSparse) {
         std::map<uint32_t, uint32_t> ranges;
-        int numElements = _sequenceElements.GetElementCount();
+        int numElements = sequenceElements.GetElementCount();
         for (int i = 0; i < numElements; ++i) {
-            Element* element = _sequenceElements.GetElement(i);
+            Element* element = sequenceElements.GetElement(i);
             if (element == nullptr)
                 logger_base.crit("Element %d returns as null.", i);
             if (element->GetType() == ElementType::ELEMENT_TYPE_MODEL) {
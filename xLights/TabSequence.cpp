@@ -1294,6 +1294,166 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
     } );
 }
 
+void xLightsFrame::ParallelRenderAndSaveSequences(const wxArrayString& filenames, int maxConcurrent, bool exitOnDone)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (maxConcurrent <= 1 || filenames.size() <= 1) {
+        OpenRenderAndSaveSequences(filenames, exitOnDone);
+        return;
+    }
+
+    // everything is rendered off to the side so there must be nothing in the sequencer
+    if (CurrentSeqXmlFile != nullptr && !CloseSequence()) {
+        OpenRenderAndSaveSequences(wxArrayString(), exitOnDone);
+        return;
+    }
+
+    logger_base.debug("Batch rendering %d sequences, %d at a time sharing %d render threads.", (int)filenames.size(), maxConcurrent, jobPool.maxSize());
+    EnableSequenceControls(false);
+
+    _parallelRenderPending = filenames;
+    _parallelRenderSerial.Clear();
+    _parallelRenderMax = maxConcurrent;
+    _parallelRenderExitOnDone = exitOnDone;
+    _parallelRenderCancelled = false;
+    _parallelRenderTimer.Start();
+
+    // the render cache follows the open sequence so it cant be used by sequences rendering side by side
+    _renderCache.Enable("Disabled");
+
+    StartParallelRenders();
+}
+
+ParallelRenderSequence* xLightsFrame::LoadParallelRenderSequence(const wxString& filename)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    // fseq files, backups and anything missing go through the sequencer as before
+    wxFileName xml_file(filename);
+    wxString ext = xml_file.GetExt().Lower();
+    if ((ext != "xsq" && ext != "xml") || !FileExists(xml_file)) {
+        return nullptr;
+    }
+
+    ParallelRenderSequence* seq = new ParallelRenderSequence(this, filename);
+    seq->xmlFile = new xLightsXmlFile(xml_file);
+    seq->xmlFile->Open(GetShowDirectory(), false, xml_file);
+
+    // old files need their settings checked and missing media needs searching for
+    if (!seq->xmlFile->IsOpen() || seq->xmlFile->WasConverted() ||
+        (seq->xmlFile->GetSequenceType() == "Media" && seq->xmlFile->GetMedia() == nullptr)) {
+        logger_base.debug("    %s needs the sequencer to render.", (const char*)filename.c_str());
+        delete seq;
+        return nullptr;
+    }
+
+    seq->elements.SetFrequency(seq->xmlFile->GetFrequency());
+    seq->elements.SetViewsManager(GetViewsManager()); // This must come first before LoadSequencerFile.
+    seq->elements.LoadSequencerFile(*seq->xmlFile, GetShowDirectory());
+    seq->xmlFile->AdjustEffectSettingsForVersion(seq->elements, this);
+    seq->elements.SetSequenceEnd(seq->xmlFile->GetSequenceDurationMS());
+
+    int frameMS = seq->xmlFile->GetFrameMS();
+    int lengthMS = seq->xmlFile->GetSequenceDurationMS();
+    if (lengthMS == 0 && seq->xmlFile->GetMedia() != nullptr) {
+        lengthMS = seq->xmlFile->GetMedia()->LengthMS();
+    }
+    seq->data.init(GetMaxNumChannels(), lengthMS / frameMS, frameMS);
+    if (seq->xmlFile->GetSequenceType() == "Media") {
+        seq->media = seq->xmlFile->GetMediaFile().ToStdString();
+    }
+
+    wxFileName fseq_file(filename);
+    fseq_file.SetExt("fseq");
+    if (fseqDirectory != showDirectory) {
+        ObtainAccessToURL(fseqDirectory);
+        fseq_file.SetPath(fseqDirectory);
+    }
+    seq->fseqFilename = fseq_file.GetFullPath();
+    return seq;
+}
+
+void xLightsFrame::StartParallelRenders()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (!_parallelRenderCancelled && wxGetKeyState(WXK_ESCAPE)) {
+        logger_base.debug("Batch render cancelled.");
+        printf("Batch render cancelled.\n");
+        _parallelRenderCancelled = true;
+        _parallelRenderPending.Clear();
+        _parallelRenderSerial.Clear();
+        AbortRender();
+    }
+
+    while ((int)_parallelRenders.size() < _parallelRenderMax && !_parallelRenderPending.IsEmpty()) {
+        wxString seq = _parallelRenderPending[0];
+        _parallelRenderPending.RemoveAt(0);
+
+        printf("Processing file %s\n", (const char*)seq.c_str());
+        logger_base.debug("Batch Render Processing file %s", (const char*)seq.c_str());
+        wxStopWatch sw;
+        ParallelRenderSequence* prs = LoadParallelRenderSequence(seq);
+        if (prs == nullptr) {
+            _parallelRenderSerial.push_back(seq);
+            continue;
+        }
+        prs->loadMS = sw.Time();
+        _parallelRenders.push_back(prs);
+        // prs may be gone once this returns if there was nothing to render
+        StartParallelRender(prs);
+    }
+
+    if (!_parallelRenders.empty() || !_parallelRenderPending.IsEmpty()) {
+        SetStatusText(wxString::Format("Batch Rendering %d sequences. %d sequences left to start.", (int)_parallelRenders.size(), (int)_parallelRenderPending.size()));
+        return;
+    }
+
+    float elapsedTime = _parallelRenderTimer.Time() / 1000.0;
+    logger_base.info("Parallel batch render finished in %7.3f seconds.", elapsedTime);
+    printf("Parallel batch render finished in %7.3f seconds.\n", elapsedTime);
+    _renderCache.Enable(_enableRenderCache);
+
+    // anything which needed the sequencer is done the old way, which also finishes off the batch
+    wxArrayString serial = _parallelRenderSerial;
+    _parallelRenderSerial.Clear();
+    if (!serial.IsEmpty()) {
+        logger_base.info("Rendering %d sequences which needed the sequencer.", (int)serial.size());
+    }
+    OpenRenderAndSaveSequences(serial, _parallelRenderExitOnDone);
+}
+
+void xLightsFrame::ParallelRenderDone(ParallelRenderSequence* seq, bool aborted)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (aborted && !seq->retried && !_parallelRenderCancelled) {
+        logger_base.info("Render of %s was aborted, retrying.", (const char*)seq->filename.c_str());
+        seq->retried = true;
+        StartParallelRender(seq);
+        return;
+    }
+    seq->renderMS = seq->timer.Time();
+
+    if (!_parallelRenderCancelled) {
+        RenderIseqData(false, nullptr, *seq->xmlFile, seq->data); // render ISEQ layers above the Nutcracker layer
+
+        wxStopWatch sw;
+        logger_base.info("Saving fseq file %s.", (const char*)seq->fseqFilename.c_str());
+        WriteFalconPiFile(seq->fseqFilename, seq->data, seq->elements, seq->media);
+        wxString displayBuff = wxString::Format(_("%s     Load %7.3f Render %7.3f Save %7.3f seconds"), seq->fseqFilename,
+                                                seq->loadMS / 1000.0, seq->renderMS / 1000.0, sw.Time() / 1000.0);
+        logger_base.info("%s", (const char*)displayBuff.c_str());
+        printf("%s\n", (const char*)displayBuff.c_str());
+        SetStatusText(displayBuff, 0);
+    }
+
+    _parallelRenders.remove(seq);
+    delete seq;
+    CallAfter(&xLightsFrame::StartParallelRenders);
+}
+
 void xLightsFrame::SaveSequence()
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -2401,7 +2401,7 @@ void xLightsFrame::OnButtonUploadOutputClick(wxCommandEvent& event)
     SetCursor(wxCURSOR_ARROW);
 }
 
-bool xLightsFrame::UploadInputToController(Controller* controller, wxString &message) {
+bool xLightsFrame::UploadInputToController(Controller* controller, wxString &message, BaseController* connected) {
     message.clear();
     bool res = false;
 
@@ -2417,18 +2417,21 @@ bool xLightsFrame::UploadInputToController(Controller* controller, wxString &mes
         if (caps->SupportsInputOnlyUpload()) {
             auto vendor = controller->GetVendor();
             auto model = controller->GetModel();
-            auto ip = controller->GetResolvedIP(true);
-            if (ip == "MULTICAST" || ip == "") {
-                wxTextEntryDialog dlg(this, "Controller IP Address", "IP Address", ip);
-                if (dlg.ShowModal() != wxID_OK) {
-                    SetCursor(wxCURSOR_ARROW);
-                    return res;
+            BaseController* bc = connected;
+            if (bc == nullptr) {
+                auto ip = controller->GetResolvedIP(true);
+                if (ip == "MULTICAST" || ip == "") {
+                    wxTextEntryDialog dlg(this, "Controller IP Address", "IP Address", ip);
+                    if (dlg.ShowModal() != wxID_OK) {
+                        SetCursor(wxCURSOR_ARROW);
+                        return res;
+                    }
+                    ip = dlg.GetValue();
                 }
-                ip = dlg.GetValue();
-            }
-            RecalcModels();
+                RecalcModels();
 
-            BaseController* bc = BaseController::CreateBaseController(controller, ip);
+                bc = BaseController::CreateBaseController(controller, ip);
+            }
             if (bc != nullptr) {
                 if (bc->IsConnected()) {
                     if (bc->SetInputUniverses(controller, this)) {
@@ -2444,7 +2447,9 @@ bool xLightsFrame::UploadInputToController(Controller* controller, wxString &mes
                 else {
                     message = vendor + " Input Upload Failed. Unable to connect";
                 }
-                delete bc;
+                if (bc != connected) {
+                    delete bc;
+                }
             }
             else {
                 logger_base.error("Unable to create base controller %s:%s:%s", (const char*)controller->GetVendor().c_str(), (const char*)controller->GetModel().c_str(), (const char*)controller->GetVariant().c_str());
@@ -2466,7 +2471,7 @@ bool xLightsFrame::UploadInputToController(Controller* controller, wxString &mes
     return res;
 }
 
-bool xLightsFrame::UploadOutputToController(Controller* controller, wxString& message) {
+bool xLightsFrame::UploadOutputToController(Controller* controller, wxString& message, BaseController* connected) {
     message.clear();
     bool res = false;
 
@@ -2482,19 +2487,22 @@ bool xLightsFrame::UploadOutputToController(Controller* controller, wxString& me
         if (caps->SupportsUpload()) {
             auto vendor = controller->GetVendor();
             auto model = controller->GetModel();
-            auto ip = controller->GetResolvedIP(true);
-            if (ip == "MULTICAST") {
-                wxTextEntryDialog dlg(this, "Controller IP Address", "IP Address", ip);
-                if (dlg.ShowModal() != wxID_OK) {
-                    SetCursor(wxCURSOR_ARROW);
-                    return res;
+            BaseController* bc = connected;
+            if (bc == nullptr) {
+                auto ip = controller->GetResolvedIP(true);
+                if (ip == "MULTICAST") {
+                    wxTextEntryDialog dlg(this, "Controller IP Address", "IP Address", ip);
+                    if (dlg.ShowModal() != wxID_OK) {
+                        SetCursor(wxCURSOR_ARROW);
+                        return res;
+                    }
+                    ip = dlg.GetValue();
                 }
-                ip = dlg.GetValue();
-            }
-            //auto proxy = controller->GetFPPProxy();
-            RecalcModels();
+                //auto proxy = controller->GetFPPProxy();
+                RecalcModels();
 
-            BaseController* bc = BaseController::CreateBaseController(controller, ip);
+                bc = BaseController::CreateBaseController(controller, ip);
+            }
             if (bc != nullptr) {
                 if (bc->IsConnected()) {
                     if (bc->SetOutputs(&AllModels, &_outputManager, controller, this)) {
@@ -2506,7 +2514,9 @@ bool xLightsFrame::UploadOutputToController(Controller* controller, wxString& me
                 } else {
                     message = vendor + " Output Upload Failed. Unable to connect";
                 }
-                delete bc;
+                if (bc != connected) {
+                    delete bc;
+                }
             } else {
                 message = vendor + " Output Upload Failed.";
             }
@@ -191,6 +191,32 @@ public:
         ret.append("}");
         return ret;
     }
+    // true if AsString() would return str ... without building the string
+    [[nodiscard]] bool MatchesString(const std::string& str) const
+    {
+        size_t pos = 0;
+        auto match = [&str, &pos](const char* s, size_t len) {
+            if (str.compare(pos, len, s, len) != 0) return false;
+            pos += len;
+            return true;
+        };
+        for (std::map<std::string, std::string>::const_iterator it = begin(); it != end(); ++it) {
+            if (pos != 0 && !match(",", 1)) return false;
+            if (!match(it->first.c_str(), it->first.size()) || !match("=", 1)) return false;
+            for (char c : it->second) {
+                bool ok;
+                if (c == '&') {
+                    ok = match("&amp;", 5);
+                } else if (c == ',') {
+                    ok = match("&comma;", 7);
+                } else {
+                    ok = match(&c, 1);
+                }
+                if (!ok) return false;
+            }
+        }
+        return pos == str.size();
+    }
 
 private:
 
@@ -8,6 +8,7 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <wx/app.h>
 #include <wx/config.h>
 #include <wx/dir.h>
 #include <wx/display.h>
@@ -19,6 +20,7 @@
 #include <wx/socket.h>
 #include <wx/sstream.h>
 #include <wx/stdpaths.h>
+#include <wx/thread.h>
 
 #include <random>
 #include <thread>
@@ -63,32 +65,44 @@
 #define thread_local __thread
 #endif
 
+// message boxes can only be shown from the UI thread. Controller drivers report problems while connecting
+// which may happen on a background thread so those are queued for the UI thread to show
+static void ShowMessageBox(const std::string& msg, const std::string& caption, long style, wxWindow* win) {
+    if (wxThread::IsMain()) {
+        wxMessageBox(msg, caption, style, win);
+    } else if (wxTheApp != nullptr) {
+        wxTheApp->CallAfter([msg, caption, style]() {
+            wxMessageBox(msg, caption, style);
+        });
+    }
+}
+
 void DisplayError(const std::string& err, wxWindow* win) {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     logger_base.error("DisplayError: %s", (const char*)err.c_str());
-    wxMessageBox(err, "Error", wxICON_ERROR | wxOK, win);
+    ShowMessageBox(err, "Error", wxICON_ERROR | wxOK, win);
 }
 
 void DisplayWarning(const std::string& warn, wxWindow* win) {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     logger_base.warn("DisplayWarning: %s", (const char*)warn.c_str());
-    wxMessageBox(warn, "Warning", wxICON_WARNING | wxOK, win);
+    ShowMessageBox(warn, "Warning", wxICON_WARNING | wxOK, win);
 }
 
 void DisplayInfo(const std::string& info, wxWindow* win) {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     logger_base.info("DisplayInfo: %s", (const char*)info.c_str());
-    wxMessageBox(info, "Information", wxICON_INFORMATION | wxOK, win);
+    ShowMessageBox(info, "Information", wxICON_INFORMATION | wxOK, win);
 }
 
 void DisplayCrit(const std::string& crit, wxWindow* win) {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     logger_base.crit("DisplayCrit: %s", (const char*)crit.c_str());
-    wxMessageBox(crit, "CRITICAL", wxICON_ERROR | wxOK, win);
+    ShowMessageBox(crit, "CRITICAL", wxICON_ERROR | wxOK, win);
 }
 
 std::string DecodeIPError(wxSocketError err) {
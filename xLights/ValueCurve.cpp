@@ -27,6 +27,8 @@
 
 AudioManager* ValueCurve::__audioManager = nullptr;
 SequenceElements* ValueCurve::__sequenceElements = nullptr;
+thread_local AudioManager* ValueCurve::__threadAudioManager = nullptr;
+thread_local SequenceElements* ValueCurve::__threadSequenceElements = nullptr;
 
 float ValueCurve::SafeParameter(size_t p, float v)
 {
@@ -1716,7 +1718,7 @@ float ValueCurve::ApplyGain(float value, int gain) const
 }
 
 int ValueCurve::GetPriorTimingMark(const std::string& timingTrack, int time, bool startsOnly, const std::string& filterLabelText, bool isFilterLabelRegex) {
-    auto te = __sequenceElements->GetTimingElement(timingTrack);
+    auto te = GetSequenceElements()->GetTimingElement(timingTrack);
     if (te != nullptr) {
         auto el = te->GetEffectLayer(0);
         if (el != nullptr) {
@@ -1744,7 +1746,7 @@ int ValueCurve::GetPriorTimingMark(const std::string& timingTrack, int time, boo
 }
 
 int ValueCurve::GetSubsequentTimingMark(const std::string& timingTrack, int time, bool startsOnly, const std::string& filterLabelText, bool isFilterLabelRegex) {
-    auto te = __sequenceElements->GetTimingElement(timingTrack);
+    auto te = GetSequenceElements()->GetTimingElement(timingTrack);
     if (te != nullptr) {
         auto el = te->GetEffectLayer(0);
         if (el != nullptr) {
@@ -1778,10 +1780,11 @@ float ValueCurve::GetValueAt(float offset, long startMS, long endMS)
     // If we are music trigger fade and we dont have values ... calculate them on the fly
     if (_type == "Music Trigger Fade") {
         // Just generate what we need on the fly
-        if (__audioManager != nullptr && _values.size() == 0) {
+        AudioManager* audioManager = GetAudio();
+        if (audioManager != nullptr && _values.size() == 0) {
             float min = (GetParameter1() - _min) / (_max - _min);
             float max = (GetParameter2() - _min) / (_max - _min);
-            int frameMS = __audioManager->GetFrameInterval();
+            int frameMS = audioManager->GetFrameInterval();
             int fadeFrames = GetParameter4();
             float yperFrame = (max - min) / fadeFrames;
             float perPoint = vcSortablePoint::perPoint();
@@ -1805,7 +1808,7 @@ float ValueCurve::GetValueAt(float offset, long startMS, long endMS)
                 // find the maximum of any intervening frames
                 float f = 0.0;
                 for (long ms = time; ms < time + msperPoint; ms += frameMS) {
-                    auto pf = __audioManager->GetFrameData("", ms + frameMS);
+                    auto pf = audioManager->GetFrameData("", ms + frameMS);
                     if (pf != nullptr) {
                         if (pf->max > f) {
                             f = pf->max;
@@ -1877,7 +1880,7 @@ float ValueCurve::GetValueAt(float offset, long startMS, long endMS)
             res = min;
         }
         else {
-            int frame = (time - prior) / __sequenceElements->GetFrameMS();
+            int frame = (time - prior) / GetSequenceElements()->GetFrameMS();
             int fadeFrames = GetParameter3();
             if (frame < fadeFrames) {
                 res = min + (max - min) * (((float)fadeFrames - (float)frame) / (float)fadeFrames);
@@ -1901,8 +1904,8 @@ float ValueCurve::GetValueAt(float offset, long startMS, long endMS)
                 res = min;
             }
             else {
-                int frame = (time - prior) / __sequenceElements->GetFrameMS();
-                int fadeFrames = (((next - prior) / __sequenceElements->GetFrameMS()) * GetParameter3()) / 100;
+                int frame = (time - prior) / GetSequenceElements()->GetFrameMS();
+                int fadeFrames = (((next - prior) / GetSequenceElements()->GetFrameMS()) * GetParameter3()) / 100;
                 if (frame < fadeFrames) {
                     res = min + (max - min) * (((float)fadeFrames - (float)frame) / (float)fadeFrames);
                 }
@@ -1913,10 +1916,11 @@ float ValueCurve::GetValueAt(float offset, long startMS, long endMS)
         }
     }
     else if (_type == "Music" || _type == "Inverted Music") {
-        if (__audioManager != nullptr) {
+        AudioManager* audioManager = GetAudio();
+        if (audioManager != nullptr) {
             long time = (float)startMS + offset * (endMS - startMS);
             float f = 0.0;
-            auto pf = __audioManager->GetFrameData("", time);
+            auto pf = audioManager->GetFrameData("", time);
             if (pf != nullptr) {
                 f = ApplyGain(pf->max, GetParameter3());
                 if (_type == "Inverted Music") {
@@ -103,6 +103,9 @@ class ValueCurve
     bool _realValues;
     static AudioManager* __audioManager;
     static SequenceElements* __sequenceElements;
+    // set while a thread renders a sequence other than the open one
+    static thread_local AudioManager* __threadAudioManager;
+    static thread_local SequenceElements* __threadSequenceElements;
 
     void RenderType();
     void SetSerialisedValue(const std::string &k, const std::string &s);
@@ -119,7 +122,31 @@ public:
 
     static void SetAudio(AudioManager* am) { __audioManager = am; }
     static void SetSequenceElements(SequenceElements* se) { __sequenceElements = se; }
-    static SequenceElements* GetSequenceElements() { return __sequenceElements; }
+    static SequenceElements* GetSequenceElements() { return __threadSequenceElements != nullptr ? __threadSequenceElements : __sequenceElements; }
+    static AudioManager* GetAudio() { return __threadSequenceElements != nullptr ? __threadAudioManager : __audioManager; }
+    // the sequence set on this thread by ThreadSequence or open if it is rendering the open one
+    static SequenceElements* GetRenderSequenceElements(SequenceElements* open) { return __threadSequenceElements != nullptr ? __threadSequenceElements : open; }
+
+    // While in scope curves evaluated on this thread use the audio and timing tracks of the given
+    // sequence rather than the open one. A null sequence means the open one.
+    class ThreadSequence
+    {
+        AudioManager* _priorAudioManager;
+        SequenceElements* _priorSequenceElements;
+
+    public:
+        ThreadSequence(AudioManager* am, SequenceElements* se) :
+            _priorAudioManager(__threadAudioManager), _priorSequenceElements(__threadSequenceElements)
+        {
+            __threadAudioManager = am;
+            __threadSequenceElements = se;
+        }
+        ~ThreadSequence()
+        {
+            __threadAudioManager = _priorAudioManager;
+            __threadSequenceElements = _priorSequenceElements;
+        }
+    };
     static std::string GetValueCurveFolder(const std::string& showFolder);
 
     ValueCurve() { _divisor = 1; _min = MINVOIDF; _max = MAXVOIDF; SetDefault(); }
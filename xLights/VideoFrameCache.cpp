@@ -0,0 +1,398 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "VideoFrameCache.h"
+#include "VideoReader.h"
+#include "UtilFunctions.h"
+
+#include <wx/filefn.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <log4cpp/Category.hh>
+
+// how many frames each reader is decoded ahead of
+#define VIDEOFRAMECACHE_AHEAD 20
+
+std::mutex VideoFrameCache::__lock;
+std::map<std::string, std::shared_ptr<VideoFrameCacheStream>> VideoFrameCache::__streams;
+std::atomic<size_t> VideoFrameCache::__budget = 0;
+
+static std::atomic<size_t> __used = 0;
+static std::atomic<uint64_t> __clock = 0;
+
+#pragma region VideoFrameCache
+std::shared_ptr<VideoFrameCacheStream> VideoFrameCache::GetStream(const std::string& filename, int width, int height, bool keepAspectRatio, bool useNativeResolution)
+{
+    // include the modified time so replacing the video on disk is picked up
+    std::string key = filename + "|" + std::to_string(wxFileModificationTime(filename)) + "|" + std::to_string(width) + "x" + std::to_string(height) +
+                      "|" + (keepAspectRatio ? "A" : "S") + (useNativeResolution ? "N" : "");
+
+    {
+        std::unique_lock<std::mutex> lock(__lock);
+        auto it = __streams.find(key);
+        if (it != __streams.end()) return it->second;
+    }
+
+    // opening the video can take a while so dont hold everyone else up while we do it
+    auto stream = std::make_shared<VideoFrameCacheStream>(filename, width, height, keepAspectRatio, useNativeResolution);
+
+    std::unique_lock<std::mutex> lock(__lock);
+    auto it = __streams.find(key);
+    if (it != __streams.end()) return it->second;
+    __streams[key] = stream;
+    return stream;
+}
+
+void VideoFrameCache::Added(size_t bytes)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    size_t budget = GetMemoryBudget();
+    __used += bytes;
+    if (__used <= budget) return;
+
+    std::unique_lock<std::mutex> lock(__lock);
+    if (__used <= budget) return;
+
+    // free down to 3/4 of the budget so we are not doing this on every frame
+    std::vector<std::pair<uint64_t, size_t>> ages;
+    for (auto& it : __streams) {
+        std::unique_lock<std::mutex> slock(it.second->_lock);
+        for (const auto& f : it.second->_frames) {
+            ages.push_back({ f.second._lastUsed, f.second._frame == nullptr ? 0 : f.second._frame->_data.size() });
+        }
+    }
+    std::sort(ages.begin(), ages.end());
+
+    size_t target = __used - budget * 3 / 4;
+    size_t total = 0;
+    uint64_t cutoff = 0;
+    for (const auto& it : ages) {
+        total += it.second;
+        cutoff = it.first;
+        if (total >= target) break;
+    }
+
+    size_t freed = 0;
+    for (auto it = __streams.begin(); it != __streams.end();) {
+        if (it->second->Evict(cutoff, freed) && it->second->IsIdle()) {
+            it = __streams.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    __used -= freed;
+
+    logger_base.debug("VideoFrameCache: Over budget %dMB ... released %dMB.", (int)(budget / (1024 * 1024)), (int)(freed / (1024 * 1024)));
+}
+
+size_t VideoFrameCache::GetMemoryBudget()
+{
+    if (__budget == 0) {
+        // 1/16th of the machine's memory ... at least 256MB and at most 4GB, or 512MB on 32 bit
+        uint64_t mb = std::clamp(GetPhysicalMemorySizeMB() / 16, (uint64_t)256, (uint64_t)(sizeof(size_t) == 8 ? 4096 : 512));
+        __budget = (size_t)mb * 1024 * 1024;
+    }
+    return __budget;
+}
+
+void VideoFrameCache::Purge()
+{
+    std::unique_lock<std::mutex> lock(__lock);
+    size_t freed = 0;
+    for (auto it = __streams.begin(); it != __streams.end();) {
+        if (it->second->IsIdle()) {
+            it->second->Evict(UINT64_MAX, freed);
+            it = __streams.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    __used -= freed;
+}
+
+size_t VideoFrameCache::GetMemoryUsed()
+{
+    return __used;
+}
+#pragma endregion
+
+#pragma region VideoFrameCacheStream
+VideoFrameCacheStream::VideoFrameCacheStream(const std::string& filename, int width, int height, bool keepAspectRatio, bool useNativeResolution) :
+    _filename(filename), _requestWidth(width), _requestHeight(height), _keepAspectRatio(keepAspectRatio), _useNativeResolution(useNativeResolution)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    _videoReader = new VideoReader(filename, width, height, keepAspectRatio, useNativeResolution, true);
+    _valid = _videoReader->IsValid();
+    _lengthMS = _videoReader->GetLengthMS();
+    _videoReader->GetFrameDurationMS(_frameDurationNum, _frameDurationDen);
+    _width = _videoReader->GetWidth();
+    _height = _videoReader->GetHeight();
+
+    if (!_valid || _videoReader->GetFrameMS() <= 0 || _frameDurationNum <= 0 || _frameDurationDen <= 0) {
+        logger_base.warn("VideoFrameCache: Unable to cache video %s.", (const char*)filename.c_str());
+        _valid = false;
+        delete _videoReader;
+        _videoReader = nullptr;
+    }
+}
+
+VideoFrameCacheStream::~VideoFrameCacheStream()
+{
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _stop = true;
+        _signal.notify_all();
+    }
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    if (_videoReader != nullptr) {
+        delete _videoReader;
+        _videoReader = nullptr;
+    }
+}
+
+size_t VideoFrameCacheStream::GetBytes()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    return _bytes;
+}
+
+bool VideoFrameCacheStream::IsIdle()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    return _readers.empty() && !_threadRunning;
+}
+
+// Drop frames not used since olderThan other than those a reader wants next. Returns true if the stream is now empty.
+// Caller must hold the cache lock.
+bool VideoFrameCacheStream::Evict(uint64_t olderThan, size_t& freed)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    for (auto it = _frames.begin(); it != _frames.end();) {
+        bool wanted = false;
+        for (const auto& r : _readers) {
+            if (r.second == it->first) wanted = true;
+        }
+        if (it->second._lastUsed <= olderThan && !wanted) {
+            size_t bytes = it->second._frame == nullptr ? 0 : it->second._frame->_data.size();
+            _bytes -= bytes;
+            freed += bytes;
+            it = _frames.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return _frames.empty();
+}
+
+// Called with the lock held
+bool VideoFrameCacheStream::FindWork(long& frame)
+{
+    // frames past the end are still attempted so the decoder can tell us where the end really is
+    long lastFrame = GetLastFrame();
+    if (_endFrame != -1) lastFrame = std::min(lastFrame, _endFrame - 1);
+
+    // anyone blocked waiting comes first ... they take turns so a reader waiting on a late frame is not
+    // held up for as long as others keep asking for earlier ones
+    frame = -1;
+    int served = -1;
+    for (const auto& it : _waiting) {
+        if (!it.second) continue;
+        long f = _readers[it.first];
+        if (f > lastFrame || _frames.find(f) != _frames.end()) continue;
+
+        // the first waiting reader after the one served last, wrapping round to the first
+        if (served == -1 || (served <= _lastServed && it.first > _lastServed)) {
+            served = it.first;
+            frame = f;
+        }
+    }
+    if (frame != -1) {
+        _lastServed = served;
+        return true;
+    }
+
+    // then whoever has the least decoded ahead
+    long bestLead = VIDEOFRAMECACHE_AHEAD;
+    for (const auto& it : _readers) {
+        for (long f = it.second; f <= lastFrame && f < it.second + bestLead; f++) {
+            if (_frames.find(f) == _frames.end()) {
+                bestLead = f - it.second;
+                frame = f;
+                break;
+            }
+        }
+    }
+    return frame != -1;
+}
+
+void VideoFrameCacheStream::EnsureThread()
+{
+    if (_threadRunning || _stop || !_valid) return;
+
+    if (_thread.joinable()) {
+        // the last thread has finished ... it just needs cleaning up
+        _thread.join();
+    }
+    _threadRunning = true;
+    _thread = std::thread(&VideoFrameCacheStream::Run, this);
+}
+
+void VideoFrameCacheStream::Run()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (_videoReader == nullptr) {
+        _videoReader = new VideoReader(_filename, _requestWidth, _requestHeight, _keepAspectRatio, _useNativeResolution, true);
+    }
+
+    std::unique_lock<std::mutex> lock(_lock);
+    while (!_stop) {
+        long frame = -1;
+        if (!FindWork(frame)) {
+            // nobody needs anything so let the thread go ... it is restarted when someone does
+            if (_readers.empty()) break;
+            _signal.wait(lock);
+            continue;
+        }
+
+        lock.unlock();
+
+        AVFrame* image = _videoReader->GetNextFrame(FrameTimeMS(frame, _frameDurationNum, _frameDurationDen));
+        bool atEnd = _videoReader->AtEnd();
+
+        std::shared_ptr<VideoFrame> vf;
+        if (image != nullptr) {
+            // VideoReader reuses its frames so take a copy with the rows packed
+            vf = std::make_shared<VideoFrame>();
+            vf->_width = image->width;
+            vf->_height = image->height;
+            int rowBytes = image->width * 4;
+            vf->_data.resize(rowBytes * image->height);
+            for (int y = 0; y < image->height; y++) {
+                memcpy(vf->_data.data() + y * rowBytes, image->data[0] + y * image->linesize[0], rowBytes);
+            }
+        }
+        size_t bytes = vf == nullptr ? 0 : vf->_data.size();
+
+        lock.lock();
+        if (image == nullptr && atEnd) {
+            if (_endFrame == -1 || frame < _endFrame) _endFrame = frame;
+        } else {
+            auto& e = _frames[frame];
+            if (e._frame == nullptr) {
+                _bytes += bytes;
+                e._frame = vf;
+                e._lastUsed = ++__clock;
+            } else {
+                bytes = 0;
+            }
+        }
+        _signal.notify_all();
+
+        if (bytes > 0) {
+            lock.unlock();
+            VideoFrameCache::Added(bytes);
+            lock.lock();
+        }
+    }
+
+    // free up the decoder while nobody is reading
+    if (_videoReader != nullptr) {
+        delete _videoReader;
+        _videoReader = nullptr;
+    }
+    _threadRunning = false;
+    _signal.notify_all();
+
+    logger_base.debug("VideoFrameCache: Decode thread for %s (%dx%d) idle with %d frames cached.", (const char*)_filename.c_str(), _width, _height, (int)_frames.size());
+}
+#pragma endregion
+
+#pragma region CachedVideoFrameReader
+CachedVideoFrameReader::CachedVideoFrameReader(const std::string& filename, int width, int height, bool keepAspectRatio, bool useNativeResolution)
+{
+    _stream = VideoFrameCache::GetStream(filename, width, height, keepAspectRatio, useNativeResolution);
+
+    std::unique_lock<std::mutex> lock(_stream->_lock);
+    _id = _stream->_nextReaderId++;
+    _stream->_readers[_id] = 0;
+}
+
+CachedVideoFrameReader::~CachedVideoFrameReader()
+{
+    _current = nullptr;
+
+    std::unique_lock<std::mutex> lock(_stream->_lock);
+    _stream->_readers.erase(_id);
+    _stream->_waiting.erase(_id);
+    _stream->_signal.notify_all();
+}
+
+void CachedVideoFrameReader::Seek(int timestampMS)
+{
+    _atEnd = false;
+
+    // start decoding from here before we are asked for it
+    std::unique_lock<std::mutex> lock(_stream->_lock);
+    _stream->_readers[_id] = _stream->GetFrameIndex(timestampMS);
+    _stream->EnsureThread();
+    _stream->_signal.notify_all();
+}
+
+const VideoFrame* CachedVideoFrameReader::GetNextFrame(int timestampMS)
+{
+    _current = nullptr;
+    _atEnd = false;
+
+    if (!_stream->IsValid()) return nullptr;
+
+    if (timestampMS > _stream->GetLengthMS()) {
+        _atEnd = true;
+        return nullptr;
+    }
+
+    long frame = _stream->GetFrameIndex(timestampMS);
+
+    std::unique_lock<std::mutex> lock(_stream->_lock);
+    _stream->_readers[_id] = frame;
+    while (true) {
+        if (_stream->_endFrame != -1 && frame >= _stream->_endFrame) {
+            _atEnd = true;
+            break;
+        }
+
+        auto it = _stream->_frames.find(frame);
+        if (it != _stream->_frames.end()) {
+            it->second._lastUsed = ++__clock;
+            _current = it->second._frame;
+            break;
+        }
+
+        _stream->_waiting[_id] = true;
+        _stream->EnsureThread();
+        _stream->_signal.notify_all();
+        _stream->_signal.wait(lock);
+    }
+    _stream->_waiting[_id] = false;
+
+    // let the decoder get on with what we will want next
+    _stream->_readers[_id] = frame + 1;
+    _stream->EnsureThread();
+    _stream->_signal.notify_all();
+
+    return _current.get();
+}
+#pragma endregion
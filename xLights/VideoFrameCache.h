@@ -0,0 +1,166 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+class VideoReader;
+class VideoFrameCacheStream;
+
+// A decoded video frame. Pixels are RGBA, rows bottom up exactly as VideoReader delivers them
+struct VideoFrame
+{
+    int _width = 0;
+    int _height = 0;
+    std::vector<uint8_t> _data;
+
+    const uint8_t* GetData() const { return _data.data(); }
+};
+
+// Decoded video frames shared across every render using the same video at the same size.
+//
+// Frames are keyed by file, target size, aspect ratio and native resolution and then by video frame
+// so the same clip on several models, or re-rendered after an edit, is only decoded once. Each stream
+// has a background thread decoding ahead of everyone reading it. All cached frames share one memory
+// budget, sized from the machine's memory, and the least recently used are dropped first.
+class VideoFrameCache
+{
+    friend class VideoFrameCacheStream;
+
+    static std::mutex __lock;
+    static std::map<std::string, std::shared_ptr<VideoFrameCacheStream>> __streams;
+    static std::atomic<size_t> __budget;
+
+    static void Added(size_t bytes);
+
+public:
+
+    static std::shared_ptr<VideoFrameCacheStream> GetStream(const std::string& filename, int width, int height, bool keepAspectRatio, bool useNativeResolution);
+
+    // drop everything not currently being read
+    static void Purge();
+    // the budget is sized from the machine's memory unless it has been set
+    static void SetMemoryBudget(size_t bytes) { __budget = bytes; }
+    static size_t GetMemoryBudget();
+    static size_t GetMemoryUsed();
+};
+
+// One video at one size
+class VideoFrameCacheStream
+{
+    friend class VideoFrameCache;
+    friend class CachedVideoFrameReader;
+
+    struct Entry
+    {
+        std::shared_ptr<const VideoFrame> _frame;
+        uint64_t _lastUsed = 0;
+    };
+
+    std::string _filename;
+    int _requestWidth = 0;
+    int _requestHeight = 0;
+    int _width = 0;
+    int _height = 0;
+    bool _keepAspectRatio = false;
+    bool _useNativeResolution = false;
+    bool _valid = false;
+    int _lengthMS = 0;
+    // frames are _frameDurationNum / _frameDurationDen ms long ... not a whole number of ms at 29.97 or 23.976fps
+    int64_t _frameDurationNum = 0;
+    int64_t _frameDurationDen = 1;
+    long _endFrame = -1; // first frame the decoder failed to produce once we have hit the end
+
+    std::mutex _lock;
+    std::condition_variable _signal;
+    std::map<long, Entry> _frames;
+    size_t _bytes = 0;
+    std::map<int, long> _readers; // reader id -> frame it wants next
+    std::map<int, bool> _waiting; // reader id -> blocked waiting on its frame
+    int _nextReaderId = 0;
+    int _lastServed = -1; // the waiting reader whose frame was decoded last
+    VideoReader* _videoReader = nullptr; // owned by the decode thread once it is running
+    std::thread _thread;
+    bool _threadRunning = false;
+    bool _stop = false;
+
+    long GetLastFrame() const { return GetFrameIndex(_lengthMS); }
+    bool FindWork(long& frame);
+    void Run();
+    void EnsureThread();
+    bool Evict(uint64_t olderThan, size_t& freed);
+
+public:
+
+    VideoFrameCacheStream(const std::string& filename, int width, int height, bool keepAspectRatio, bool useNativeResolution);
+    virtual ~VideoFrameCacheStream();
+
+    bool IsValid() const { return _valid; }
+    int GetLengthMS() const { return _lengthMS; }
+    int GetWidth() const { return _width; }
+    int GetHeight() const { return _height; }
+    size_t GetBytes();
+    bool IsIdle();
+
+    // the video frame VideoReader::GetNextFrame would return for this time
+    long GetFrameIndex(int timestampMS) const { return FrameIndex(timestampMS, _frameDurationNum, _frameDurationDen); }
+
+    // the frame nearest the time ... the first of two equally near. Frames are num / den ms long
+    static long FrameIndex(int timestampMS, int64_t num, int64_t den)
+    {
+        if (timestampMS <= 0 || num <= 0 || den <= 0) return 0;
+        int64_t const halfFramesPast = 2 * (int64_t)timestampMS * den - num;
+        if (halfFramesPast <= 0) return 0;
+        return (long)((halfFramesPast + 2 * num - 1) / (2 * num));
+    }
+
+    // the time of the frame to the nearest ms
+    static int FrameTimeMS(long frame, int64_t num, int64_t den)
+    {
+        if (frame <= 0 || num <= 0 || den <= 0) return 0;
+        return (int)((2 * (int64_t)frame * num + den) / (2 * den));
+    }
+};
+
+// Drop in for the subset of VideoReader the effects use, backed by the shared cache
+class CachedVideoFrameReader
+{
+    std::shared_ptr<VideoFrameCacheStream> _stream;
+    std::shared_ptr<const VideoFrame> _current;
+    int _id = 0;
+    bool _atEnd = false;
+
+public:
+
+    CachedVideoFrameReader(const std::string& filename, int width, int height, bool keepAspectRatio, bool useNativeResolution = false);
+    virtual ~CachedVideoFrameReader();
+
+    bool IsValid() const { return _stream->IsValid(); }
+    int GetLengthMS() const { return _stream->GetLengthMS(); }
+    int GetWidth() const { return _stream->GetWidth(); }
+    int GetHeight() const { return _stream->GetHeight(); }
+    int GetPixelChannels() const { return 4; }
+    bool AtEnd() const { return _atEnd; }
+    void Seek(int timestampMS);
+
+    // The returned frame remains valid until the next call or the reader is destroyed
+    const VideoFrame* GetNextFrame(int timestampMS);
+};
@@ -129,6 +129,8 @@ VideoReader::VideoReader(const std::string& filename, int maxwidth, int maxheigh
             _height = _windowsHardwareVideoReader->GetHeight();
             _width = _windowsHardwareVideoReader->GetWidth();
             _frameMS = _windowsHardwareVideoReader->GetFrameMS();
+            _frameDurationNum = _frameMS;
+            _frameDurationDen = 1;
             _valid = true;
 
             logger_base.info("Video loaded: " + filename);
@@ -336,6 +338,21 @@ VideoReader::VideoReader(const std::string& filename, int maxwidth, int maxheigh
         logger_base.warn("      Frame ms <unknown as _frames is 0>");
         _frameMS = 0;
     }
+    // 29.97 and 23.976fps frames are not a whole number of ms so keep the exact frame length too
+    if (_videoStream->r_frame_rate.num != 0 && _videoStream->r_frame_rate.den != 0) {
+        _frameDurationNum = (int64_t)_videoStream->r_frame_rate.den * 1000;
+        _frameDurationDen = _videoStream->r_frame_rate.num;
+    } else if (_videoStream->avg_frame_rate.num != 0 && _videoStream->avg_frame_rate.den != 0) {
+        _frameDurationNum = (int64_t)_videoStream->avg_frame_rate.den * 1000;
+        _frameDurationDen = _videoStream->avg_frame_rate.num;
+    } else if (_frames != 0) {
+        _frameDurationNum = (int64_t)(_lengthMS * 1000.0);
+        _frameDurationDen = (int64_t)_frames * 1000;
+    } else {
+        _frameDurationNum = _frameMS;
+        _frameDurationDen = 1;
+    }
+    logger_base.info("      Frame duration %lld/%lld ms", (long long)_frameDurationNum, (long long)_frameDurationDen);
     
     _firstFramePos = -1;
 }
@@ -43,6 +43,9 @@ public:
                 bool wantAlpha = false, bool bgr = false, bool wantsHardwareDecoderType = false);
 	~VideoReader();
 	int GetLengthMS() const { return (int)_lengthMS; };
+    int GetFrameMS() const { return _frameMS; }
+    // the exact length of a frame in ms is num / den ... GetFrameMS is this rounded down
+    void GetFrameDurationMS(int64_t& num, int64_t& den) const { num = _frameDurationNum; den = _frameDurationDen; }
 	void Seek(int timestampMS, bool readFrame = true);
 	AVFrame* GetNextFrame(int timestampMS, int gracetime = 0); // grace time is the minimum the video must be ahead before we bother to seek back to a frame
 	bool IsValid() const { return _valid; };
@@ -71,6 +74,8 @@ private:
     double _dtspersec = 0;
     long _frames = 0;
     int _frameMS = 50;
+    int64_t _frameDurationNum = 50;
+    int64_t _frameDurationDen = 1;
     int _keyFrameCount = 20;
     bool _wantAlpha = false;
 	AVFormatContext* _formatContext = nullptr;
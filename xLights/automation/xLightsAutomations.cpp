@@ -29,6 +29,7 @@
 #include "../../xSchedule/wxHTTPServer/wxhttpserver.h"
 #include "../sequencer/MainSequencer.h"
 #include "../ModelPreview.h"
+#include "../SequenceBinaryFile.h"
 #include <wx/uri.h>
 
 #include "LuaRunner.h"
@@ -279,9 +280,11 @@ bool xLightsFrame::ProcessAutomation(std::vector<std::string> &paths,
         auto oldPrompt = _promptBatchRenderIssues;
         _promptBatchRenderIssues = ReadBool(params["promptIssues"]);
 
+        int parallel = wxAtoi(params["parallel"]); // 0 if not specified which renders one at a time
+
         _renderMode = true;
         _saveLowDefinitionRender = _lowDefinitionRender;
-        OpenRenderAndSaveSequences(files, false);
+        ParallelRenderAndSaveSequences(files, parallel, false);
 
         while (_renderMode) {
             wxYield();
@@ -430,32 +433,8 @@ bool xLightsFrame::ProcessAutomation(std::vector<std::string> &paths,
         FSEQFile* seq = FSEQFile::openFSEQFile(fseq);
         if (seq) {
             fpp->PrepareUploadSequence(seq, fseq, m2, fseqType);
-            static const int FRAMES_TO_BUFFER = 50;
-            std::vector<std::vector<uint8_t>> frames(FRAMES_TO_BUFFER);
-            for (size_t x = 0; x < frames.size(); x++) {
-                frames[x].resize(seq->getMaxChannel() + 1);
-            }
-
-            for (size_t frame = 0; frame < seq->getNumFrames(); frame++) {
-                int lastBuffered = 0;
-                size_t startFrame = frame;
-                //Read a bunch of frames so each parallel thread has more info to work with before returning out here
-                while (lastBuffered < FRAMES_TO_BUFFER && frame < seq->getNumFrames()) {
-                    FSEQFile::FrameData* f = seq->getFrame(frame);
-                    if (f != nullptr) {
-                        if (!f->readFrame(&frames[lastBuffered][0], frames[lastBuffered].size())) {
-                            //logger_base.error("FPPConnect FSEQ file corrupt.");
-                            res = false;
-                        }
-                        delete f;
-                    }
-                    lastBuffered++;
-                    frame++;
-                }
-                frame--;
-                for (int x = 0; x < lastBuffered; x++) {
-                    fpp->AddFrameToUpload(startFrame + x, &frames[x][0]);
-                }
+            if (!FPP::AddFramesToUploads({ fpp }, seq, nullptr)) {
+                res = false;
             }
             fpp->FinalizeUploadSequence();
 
@@ -1122,6 +1101,12 @@ bool xLightsFrame::ProcessAutomation(std::vector<std::string> &paths,
     } else if (cmd == "getfseqdirectory") {
         std::string json =  wxString::Format("{\"folder\":\"%s\"}", JSONSafe(GetFseqDirectory()));
         return sendResponse(json, "", 200, true);
+    } else if (cmd == "benchmarkSequenceFile") {
+        int effects = wxAtoi(params["effects"]);
+        if (effects <= 0) {
+            effects = 200000;
+        }
+        return sendResponse(SequenceBinaryFile::Benchmark(effects), "", 200, true);
     }
     return false;
 }
@@ -102,6 +102,17 @@ BaseController *BaseController::CreateBaseController(Controller *controller, con
     }
     return bc;
 }
+
+// Only these drivers talk to the controller through CurlManager alone while connecting. The others
+// probe it with wxHTTP or shared wxRegEx objects or report a failure in a dialog.
+bool BaseController::CanConnectOnBackgroundThread(Controller *controller) {
+    ControllerCaps *caps = controller->GetControllerCaps();
+    if (!caps) {
+        return false;
+    }
+    std::string const driver = caps->GetConfigDriver();
+    return driver == "FPP" || driver == "WLED";
+}
 #endif
 
 #pragma endregion
@@ -49,6 +49,8 @@ public:
     
 #ifndef DISCOVERYONLY
     static BaseController *CreateBaseController(Controller *controller, const std::string &ip = "");
+    // true if CreateBaseController can be called for the controller off the UI thread
+    static bool CanConnectOnBackgroundThread(Controller *controller);
 #endif
 
     #pragma endregion
@@ -0,0 +1,268 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "ControllerUploadScheduler.h"
+#include "BaseController.h"
+#include "../outputs/Controller.h"
+#include "../Parallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <thread>
+
+#include <log4cpp/Category.hh>
+
+class ControllerUploadScheduler::HostJob : public Job
+{
+    ControllerUploadScheduler* _scheduler;
+
+public:
+    HostJob(ControllerUploadScheduler* scheduler) :
+        _scheduler(scheduler) {}
+    virtual ~HostJob() {}
+
+    virtual bool DeleteWhenComplete() override { return true; }
+    virtual const std::string GetName() const override { return "ControllerUploadConnect"; }
+
+    virtual void Process() override {
+        Host* host = _scheduler->GetNextHost();
+        while (host != nullptr) {
+            _scheduler->ProcessHost(host);
+            host = _scheduler->GetNextHost();
+        }
+    }
+};
+
+ControllerUploadScheduler::ControllerUploadScheduler(Connector connector, BackgroundCheck background, int maxParallel, int retries) :
+    _maxParallel(std::max(1, maxParallel)), _retries(std::max(0, retries)), _connector(connector), _background(background) {
+}
+
+ControllerUploadScheduler::~ControllerUploadScheduler() {
+    Cancel();
+    std::unique_lock<std::mutex> l(_lock);
+    _signal.wait(l, [this] { return _runningJobs == 0; });
+}
+
+std::string ControllerUploadScheduler::GetHostKey(Controller* controller) {
+    std::string const proxy = controller->GetFPPProxy();
+    return proxy.empty() ? controller->GetIP() : proxy;
+}
+
+void ControllerUploadScheduler::Add(Controller* controller) {
+    std::unique_lock<std::mutex> l(_lock);
+    Entry* e = new Entry();
+    e->controller = controller;
+    e->name = controller->GetName();
+    _entries.emplace_back(e);
+
+    if (!_background(controller)) {
+        _foreground.push_back(e);
+        return;
+    }
+
+    std::string const key = GetHostKey(controller);
+    for (auto& h : _hosts) {
+        if (h->host == key) {
+            h->entries.push_back(e);
+            return;
+        }
+    }
+    Host* h = new Host();
+    h->host = key;
+    h->entries.push_back(e);
+    _hosts.emplace_back(h);
+}
+
+void ControllerUploadScheduler::Start() {
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::list<Job*> jobs;
+    {
+        std::unique_lock<std::mutex> l(_lock);
+        if (_started) {
+            return;
+        }
+        _started = true;
+        _runningJobs = std::min(_maxParallel, (int)_hosts.size());
+        for (int i = 0; i < _runningJobs; i++) {
+            jobs.push_back(new HostJob(this));
+        }
+    }
+    logger_base.debug("Connecting to %d controllers on %d hosts, %d at a time, %d on the UI thread.",
+                      (int)_entries.size(), (int)_hosts.size(), (int)jobs.size(), (int)_foreground.size());
+    if (!jobs.empty()) {
+        ParallelJobPool::POOL.PushJobs(jobs);
+    }
+}
+
+void ControllerUploadScheduler::Cancel() {
+    std::unique_lock<std::mutex> l(_lock);
+    _cancelled = true;
+    if (!_foregroundBusy) {
+        CancelForeground();
+    }
+    _signal.notify_all();
+}
+
+ControllerUploadScheduler::Host* ControllerUploadScheduler::GetNextHost() {
+    std::unique_lock<std::mutex> l(_lock);
+    if (_nextHost < _hosts.size() && !_cancelled) {
+        return _hosts[_nextHost++].get();
+    }
+    // nothing left for this job to do
+    for (; _nextHost < _hosts.size(); _nextHost++) {
+        for (auto* e : _hosts[_nextHost]->entries) {
+            e->state = State::CANCELLED;
+        }
+    }
+    --_runningJobs;
+    _signal.notify_all();
+    return nullptr;
+}
+
+void ControllerUploadScheduler::ProcessHost(Host* host) {
+    for (auto* e : host->entries) {
+        Connect(e, host->host);
+    }
+}
+
+void ControllerUploadScheduler::Connect(Entry* e, const std::string& host) {
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    {
+        std::unique_lock<std::mutex> l(_lock);
+        if (_cancelled) {
+            e->state = State::CANCELLED;
+            return;
+        }
+        e->state = State::CONNECTING;
+    }
+
+    BaseController* bc = nullptr;
+    int attempts = 0;
+    while (!_cancelled) {
+        if (attempts > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500 * attempts));
+        }
+        attempts++;
+        bc = _connector(e->controller);
+        // a driver which cannot handle the controller at all will not do any better next time
+        if (bc == nullptr || bc->IsConnected()) {
+            break;
+        }
+        logger_base.warn("Unable to connect to controller %s on %s, attempt %d.", (const char*)e->name.c_str(), (const char*)host.c_str(), attempts);
+        delete bc;
+        bc = nullptr;
+        if (attempts > _retries) {
+            break;
+        }
+    }
+
+    std::unique_lock<std::mutex> l(_lock);
+    e->attempts = attempts;
+    if (bc != nullptr) {
+        e->bc.reset(bc);
+        e->state = State::CONNECTED;
+    } else {
+        e->state = _cancelled ? State::CANCELLED : State::FAILED;
+    }
+    _signal.notify_all();
+}
+
+void ControllerUploadScheduler::CancelForeground() {
+    for (; _nextForeground < _foreground.size(); _nextForeground++) {
+        _foreground[_nextForeground]->state = State::CANCELLED;
+    }
+}
+
+bool ControllerUploadScheduler::IsDone() const {
+    return _started && _runningJobs == 0 && !_foregroundBusy && _nextForeground == _foreground.size();
+}
+
+bool ControllerUploadScheduler::IsComplete() const {
+    std::unique_lock<std::mutex> l(_lock);
+    return IsDone();
+}
+
+bool ControllerUploadScheduler::Process(int ms) {
+    Entry* e = nullptr;
+    {
+        std::unique_lock<std::mutex> l(_lock);
+        if (_started && !_foregroundBusy && _nextForeground < _foreground.size()) {
+            e = _foreground[_nextForeground++];
+            _foregroundBusy = true;
+        }
+    }
+    if (e != nullptr) {
+        Connect(e, GetHostKey(e->controller));
+        std::unique_lock<std::mutex> l(_lock);
+        _foregroundBusy = false;
+        if (_cancelled) {
+            CancelForeground();
+        }
+        return IsDone();
+    }
+    std::unique_lock<std::mutex> l(_lock);
+    return _signal.wait_for(l, std::chrono::milliseconds(ms), [this] { return IsDone(); });
+}
+
+ControllerUploadScheduler::Progress ControllerUploadScheduler::GetProgress() const {
+    std::unique_lock<std::mutex> l(_lock);
+    Progress p;
+    p.total = _entries.size();
+    for (const auto& e : _entries) {
+        switch (e->state) {
+        case State::CONNECTED:
+            p.connected++;
+            break;
+        case State::FAILED:
+            p.failed++;
+            break;
+        case State::CANCELLED:
+            p.cancelled++;
+            break;
+        case State::CONNECTING:
+            p.connecting++;
+            p.current = e->name;
+            break;
+        case State::WAITING:
+            break;
+        }
+    }
+    return p;
+}
+
+const ControllerUploadScheduler::Entry* ControllerUploadScheduler::Find(Controller* controller) const {
+    for (const auto& e : _entries) {
+        if (e->controller == controller) {
+            return e.get();
+        }
+    }
+    return nullptr;
+}
+
+ControllerUploadScheduler::State ControllerUploadScheduler::GetState(Controller* controller) const {
+    std::unique_lock<std::mutex> l(_lock);
+    auto e = Find(controller);
+    return e == nullptr ? State::CANCELLED : e->state;
+}
+
+BaseController* ControllerUploadScheduler::GetBaseController(Controller* controller) const {
+    std::unique_lock<std::mutex> l(_lock);
+    auto e = Find(controller);
+    return (e == nullptr || e->state != State::CONNECTED) ? nullptr : e->bc.get();
+}
+
+int ControllerUploadScheduler::GetAttempts(Controller* controller) const {
+    std::unique_lock<std::mutex> l(_lock);
+    auto e = Find(controller);
+    return e == nullptr ? 0 : e->attempts;
+}
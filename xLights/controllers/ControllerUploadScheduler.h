@@ -0,0 +1,130 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class BaseController;
+class Controller;
+
+// Connects to a set of controllers ahead of uploading to them.
+//
+// Creating a BaseController is where a driver probes the controller over the network (status
+// pages, firmware version, mode) and where an unreachable controller costs a full connect
+// timeout. For drivers which do that without touching the UI or any shared state it is done for
+// many controllers at once on the parallel job pool. The rest are connected one at a time on the
+// UI thread by Process, between waits for the others.
+//
+// Only connecting is scheduled. The upload itself is done afterwards one controller at a time on
+// the UI thread using the already connected BaseControllers because no driver's SetOutputs can run
+// anywhere else: FPP asks for confirmation with wxMessageBox when the pinout does not match, WLED
+// and most others show a wxProgressDialog and report errors with DisplayError, and all of them
+// walk the shared ModelManager through UDController. What is saved is the connect time, which is
+// most of the wait for a controller that is slow to answer or not there at all.
+//
+// Controllers sharing a host (those behind the same FPP proxy) are probed one after another so
+// the host sees a single keep-alive connection rather than several competing ones. A controller
+// which fails to connect is tried again after a short delay.
+class ControllerUploadScheduler
+{
+public:
+    static const int DEFAULT_PARALLEL = 8;
+    static const int DEFAULT_RETRIES = 1;
+
+    typedef std::function<BaseController*(Controller*)> Connector;
+    // true if the connector can be called for the controller off the UI thread
+    typedef std::function<bool(Controller*)> BackgroundCheck;
+
+    enum class State {
+        WAITING,
+        CONNECTING,
+        CONNECTED,
+        FAILED,
+        CANCELLED
+    };
+
+    struct Progress {
+        int total = 0;
+        int connected = 0;
+        int failed = 0;
+        int cancelled = 0;
+        int connecting = 0;
+        std::string current; // name of a controller being connected to
+
+        int GetDone() const { return connected + failed + cancelled; }
+    };
+
+    // normally BaseController::CreateBaseController and BaseController::CanConnectOnBackgroundThread
+    ControllerUploadScheduler(Connector connector, BackgroundCheck background, int maxParallel = DEFAULT_PARALLEL, int retries = DEFAULT_RETRIES);
+    // waits for any connection still in progress
+    virtual ~ControllerUploadScheduler();
+
+    void Add(Controller* controller);
+    void Start();
+    // controllers not yet being connected to are skipped
+    void Cancel();
+    bool IsComplete() const;
+    // call on the UI thread until it returns true. Connects the next controller which must be
+    // connected there, if any, otherwise waits up to ms for the others
+    bool Process(int ms);
+    Progress GetProgress() const;
+
+    State GetState(Controller* controller) const;
+    // the connected BaseController, owned by the scheduler. nullptr unless CONNECTED
+    BaseController* GetBaseController(Controller* controller) const;
+    int GetAttempts(Controller* controller) const;
+
+private:
+    struct Entry {
+        Controller* controller = nullptr;
+        std::string name;
+        State state = State::WAITING;
+        int attempts = 0;
+        std::unique_ptr<BaseController> bc;
+    };
+    struct Host {
+        std::string host;
+        std::vector<Entry*> entries;
+    };
+    class HostJob;
+
+    static std::string GetHostKey(Controller* controller);
+    void ProcessHost(Host* host);
+    void Connect(Entry* e, const std::string& host);
+    Host* GetNextHost();
+    // _lock must be held
+    void CancelForeground();
+    bool IsDone() const;
+    const Entry* Find(Controller* controller) const;
+
+    int _maxParallel;
+    int _retries;
+    Connector _connector;
+    BackgroundCheck _background;
+    std::vector<std::unique_ptr<Entry>> _entries;
+    std::vector<std::unique_ptr<Host>> _hosts;
+    size_t _nextHost = 0;
+    std::vector<Entry*> _foreground; // connected on the UI thread
+    size_t _nextForeground = 0;
+    bool _foregroundBusy = false;
+    int _runningJobs = 0;
+    bool _started = false;
+    std::atomic_bool _cancelled = false;
+    mutable std::mutex _lock;
+    mutable std::condition_variable _signal;
+};
@@ -17,6 +17,10 @@
 #include <cctype>
 #include <thread>
 #include <cinttypes>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 
 #include <curl/curl.h>
 
@@ -34,6 +38,7 @@
 #include <wx/secretstore.h>
 #include <wx/progdlg.h>
 #include <wx/gauge.h>
+#include <wx/stopwatch.h>
 #include <zstd.h>
 
 #include "../xSchedule/wxJSON/jsonreader.h"
@@ -62,6 +67,7 @@
 #include <log4cpp/Category.hh>
 #include "ControllerUploadData.h"
 #include "FPPUploadProgressDialog.h"
+#include "FPPSequenceDelta.h"
 #include "../FSEQFile.h"
 #include "../Discovery.h"
 #include "../utils/CurlManager.h"
@@ -73,6 +79,7 @@
 #include "J1Sys.h"
 
 #include "../TraceLog.h"
+
 using namespace TraceLog;
 
 static const std::string LEDPANELS("LED Panels");
@@ -944,6 +951,14 @@ bool FPP::uploadFileV7(const std::string &filename,
     return cancelled;
 }
 
+#ifndef DISCOVERYONLY
+bool FPP::uploadSequenceDelta(const std::string &filename, const std::string &file) {
+    return FPPSequenceDelta::Upload(ipAddress, filename, file, "/api/sequence/" + URLEncode(filename) + "/delta",
+                                    [this](const std::string& url, wxJSONValue& val) { return GetURLAsJSON(url, val, false); },
+                                    [this](const std::string& url, const std::vector<uint8_t>& body) { return PostToURL(url, body); });
+}
+#endif
+
 bool FPP::uploadOrCopyFile(const std::string &filename,
                            const std::string &file,
                            const std::string &dir) {
@@ -1275,7 +1290,12 @@ bool FPP::FinalizeUploadSequence() {
             if (EndsWith(baseSeqName, ".eseq")) {
                 directory = "effects";
             }
-            cancelled = uploadOrCopyFile(baseSeqName, tempFileName, directory);
+            if (directory == "sequences" && fppType == FPP_TYPE::FPP && IsVersionAtLeast(6, 3, 2) &&
+                uploadSequenceDelta(baseSeqName, tempFileName)) {
+                cancelled = updateProgress(1000, false);
+            } else {
+                cancelled = uploadOrCopyFile(baseSeqName, tempFileName, directory);
+            }
             if (!outputFileIsOriginal) {
                 ::wxRemoveFile(tempFileName);
             }
@@ -1288,6 +1308,173 @@ bool FPP::FinalizeUploadSequence() {
     return cancelled;
 }
 
+namespace {
+    // frames decoded from the master FSEQ, shared by every output encoding them
+    struct UploadFrameBlock {
+        uint32_t startFrame = 0;
+        int count = 0;
+        std::vector<std::vector<uint8_t>> frames;
+    };
+
+    struct UploadOutput {
+        FPP* inst = nullptr;
+        uint64_t nextBlock = 0;
+        bool scheduled = false;
+        long encodeMS = 0;
+    };
+
+    struct UploadFanOut {
+        std::mutex lock;
+        std::condition_variable signal;
+        std::deque<std::shared_ptr<UploadFrameBlock>> blocks;
+        std::vector<std::shared_ptr<UploadFrameBlock>> spare;
+        uint64_t firstBlock = 0; // number of blocks every output has finished with
+        std::vector<UploadOutput> outputs;
+
+        uint64_t endBlock() const { return firstBlock + blocks.size(); }
+
+        // called with the lock held
+        void releaseBlocks() {
+            uint64_t done = endBlock();
+            for (const auto& o : outputs) {
+                done = std::min(done, o.nextBlock);
+            }
+            while (firstBlock < done) {
+                spare.push_back(blocks.front());
+                blocks.pop_front();
+                firstBlock++;
+            }
+        }
+    };
+
+    // encodes the blocks available for one output in order and then returns its pool thread. It is
+    // scheduled again when the next block is read so no more than one runs for an output at a time
+    class UploadEncodeJob : public Job {
+        UploadFanOut& fanOut;
+        size_t output;
+    public:
+        UploadEncodeJob(UploadFanOut& f, size_t o) : Job(), fanOut(f), output(o) {}
+        virtual bool DeleteWhenComplete() override { return true; }
+        virtual const std::string GetName() const override { return "FPP Upload Encode"; }
+        virtual void Process() override {
+            UploadOutput& o = fanOut.outputs[output];
+            std::unique_lock<std::mutex> lk(fanOut.lock);
+            while (o.nextBlock < fanOut.endBlock()) {
+                std::shared_ptr<UploadFrameBlock> block = fanOut.blocks[o.nextBlock - fanOut.firstBlock];
+                lk.unlock();
+                wxStopWatch sw;
+                for (int x = 0; x < block->count; x++) {
+                    o.inst->AddFrameToUpload(block->startFrame + x, &block->frames[x][0]);
+                }
+                lk.lock();
+                o.encodeMS += sw.Time();
+                o.nextBlock++;
+                fanOut.releaseBlocks();
+                fanOut.signal.notify_all();
+            }
+            o.scheduled = false;
+            fanOut.signal.notify_all();
+        }
+    };
+}
+
+bool FPP::AddFramesToUploads(const std::list<FPP*>& instances, FSEQFile* file, std::function<void(int)> progress) {
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    static const int FRAMES_PER_BLOCK = 50;
+    // enough that the reader is rarely waiting on the slowest output without holding the whole sequence
+    static const size_t MAX_BLOCKS = 8;
+
+    UploadFanOut fanOut;
+    for (const auto& inst : instances) {
+        if (inst->NeedCustomSequence()) {
+            UploadOutput o;
+            o.inst = inst;
+            fanOut.outputs.push_back(o);
+        }
+    }
+    if (fanOut.outputs.empty()) {
+        return true;
+    }
+
+    bool ok = true;
+    wxStopWatch total;
+    long readMS = 0;
+    uint32_t numFrames = file->getNumFrames();
+    int lastDone = -1;
+    for (uint32_t frame = 0; frame < numFrames;) {
+        int donePct = (int)((uint64_t)frame * 1000 / numFrames);
+        if (donePct != lastDone && progress) {
+            lastDone = donePct;
+            progress(donePct);
+        }
+
+        std::shared_ptr<UploadFrameBlock> block;
+        {
+            std::unique_lock<std::mutex> lk(fanOut.lock);
+            fanOut.signal.wait(lk, [&fanOut]() { return fanOut.blocks.size() < MAX_BLOCKS; });
+            if (!fanOut.spare.empty()) {
+                block = fanOut.spare.back();
+                fanOut.spare.pop_back();
+            }
+        }
+        if (block == nullptr) {
+            block = std::make_shared<UploadFrameBlock>();
+            block->frames.resize(FRAMES_PER_BLOCK);
+            for (auto& f : block->frames) {
+                f.resize(file->getMaxChannel() + 1);
+            }
+        }
+
+        wxStopWatch sw;
+        block->startFrame = frame;
+        block->count = 0;
+        while (block->count < FRAMES_PER_BLOCK && frame < numFrames) {
+            FSEQFile::FrameData* f = file->getFrame(frame);
+            if (f != nullptr) {
+                if (!f->readFrame(&block->frames[block->count][0], block->frames[block->count].size())) {
+                    logger_base.error("FPPConnect FSEQ file corrupt.");
+                    ok = false;
+                }
+                delete f;
+            }
+            block->count++;
+            frame++;
+        }
+        readMS += sw.Time();
+
+        std::unique_lock<std::mutex> lk(fanOut.lock);
+        fanOut.blocks.push_back(block);
+        for (size_t x = 0; x < fanOut.outputs.size(); x++) {
+            if (!fanOut.outputs[x].scheduled) {
+                fanOut.outputs[x].scheduled = true;
+                ParallelJobPool::POOL.PushJob(new UploadEncodeJob(fanOut, x));
+            }
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lk(fanOut.lock);
+        fanOut.signal.wait(lk, [&fanOut]() {
+            for (const auto& o : fanOut.outputs) {
+                if (o.scheduled) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+    if (progress) {
+        progress(1000);
+    }
+
+    logger_base.info("FPP upload sequence %s: %u frames read once in %ldms for %d outputs, %ldms overall.",
+                     (const char*)file->getFilename().c_str(), numFrames, readMS, (int)fanOut.outputs.size(), total.Time());
+    for (const auto& o : fanOut.outputs) {
+        logger_base.debug("    %s encoded in %ldms.", (const char*)o.inst->ipAddress.c_str(), o.encodeMS);
+    }
+    return ok;
+}
+
 static bool PlaylistContainsEntry(wxJSONValue &pl, const std::string &media, const std::string &seq) {
     for (int x = 0; x < pl.Size(); x++) {
         wxJSONValue entry = pl[x];
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <list>
 #include <map>
 #include <set>
@@ -96,6 +97,10 @@ class FPP : public BaseController
     bool WillUploadSequence() const;
     bool NeedCustomSequence() const;
     bool AddFrameToUpload(uint32_t frame, uint8_t *data);
+    // reads every frame of file once and encodes it for each of the instances needing a custom sequence,
+    // each instance on a pool thread of its own so they compress concurrently. progress is given 0-1000
+    // on the calling thread. Returns false if the file could not be read cleanly
+    static bool AddFramesToUploads(const std::list<FPP*>& instances, FSEQFile* file, std::function<void(int)> progress);
     bool FinalizeUploadSequence();
     std::string GetTempFile() const { return tempFileName; }
     void ClearTempFile() { tempFileName = ""; }
@@ -189,6 +194,10 @@ private:
                       const std::string &file,
                       const std::string &dir);
     bool callMoveFile(const std::string &filename);
+#ifndef DISCOVERYONLY
+    // sends only what changed since the last upload of the sequence to this player, if it can apply it
+    bool uploadSequenceDelta(const std::string &filename, const std::string &file);
+#endif
 
     bool parseSysInfo(wxJSONValue& v);
     void parseControllerType(wxJSONValue& v);
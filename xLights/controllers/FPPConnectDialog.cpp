@@ -1255,47 +1255,20 @@ void FPPConnectDialog::doUpload(FPPUploadProgressDialog *prgs, std::vector<bool>
                             inst->updateProgress(0, false);
                         }
                         wxYield();
-                        int lastDone = 0;
-                        static const int FRAMES_TO_BUFFER = 50;
-                        std::vector<std::vector<uint8_t>> frames(FRAMES_TO_BUFFER);
-                        for (size_t x = 0; x < frames.size(); x++) {
-                            frames[x].resize(seq->getMaxChannel() + 1);
-                        }
-
-                        for (size_t frame = 0; frame < seq->getNumFrames() && !cancelled; frame++) {
-                            int donePct = frame * 1000 / seq->getNumFrames();
-                            if (donePct != lastDone) {
-                                lastDone = donePct;
-                                for (const auto& inst : instances) {
-                                    inst->updateProgress(donePct, false);
-                                }
-                                wxYield();
-                            }
-
-                            int lastBuffered = 0;
-                            size_t startFrame = frame;
-                            //Read a bunch of frames so each parallel thread has more info to work with before returning out here
-                            while (lastBuffered < FRAMES_TO_BUFFER && frame < seq->getNumFrames()) {
-                                FSEQFile::FrameData *f = seq->getFrame(frame);
-                                if (f != nullptr) {
-                                    if (!f->readFrame(&frames[lastBuffered][0], frames[lastBuffered].size())) {
-                                        logger_base.error("FPPConnect FSEQ file corrupt.");
-                                    }
-                                    delete f;
-                                }
-                                lastBuffered++;
-                                frame++;
+                        std::list<FPP*> toPrepare;
+                        row = 0;
+                        for (const auto& inst : instances) {
+                            if (doUpload[row]) {
+                                toPrepare.push_back(inst);
                             }
-                            frame--;
-                            std::function<void(FPP * &, int)> func = [startFrame, lastBuffered, &frames, &doUpload](FPP* &inst, int row) {
-                                if (doUpload[row]) {
-                                    for (int x = 0; x < lastBuffered; x++) {
-                                        inst->AddFrameToUpload(startFrame + x, &frames[x][0]);
-                                    }
-                                }
-                            };
-                            parallel_for(instances, func);
+                            row++;
                         }
+                        FPP::AddFramesToUploads(toPrepare, seq, [&instances](int donePct) {
+                            for (const auto& inst : instances) {
+                                inst->updateProgress(donePct, false);
+                            }
+                            wxYield();
+                        });
                     }
                     row = 0;
                     prgs->setActionLabel("Uploading " + wxFileName(ToWXString(fseq)).GetFullName() + " (" + std::to_string(seqCountUploaded) + "/" + std::to_string(seqCountToUpload) + ")");
@@ -0,0 +1,298 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+
+#include <wx/file.h>
+#include <wx/filename.h>
+#include <wx/stopwatch.h>
+#include <wx/wfstream.h>
+
+#include "../xSchedule/wxJSON/jsonreader.h"
+#include "../xSchedule/wxJSON/jsonwriter.h"
+
+#include "FPPSequenceDelta.h"
+#include "../ExternalHooks.h"
+#include "../UtilFunctions.h"
+
+#include <log4cpp/Category.hh>
+
+extern "C" {
+#include <libavutil/md5.h>
+}
+
+namespace {
+    static const uint64_t DELTA_CHUNK_SIZE = 64 * 1024;
+
+    struct SequencePiece {
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        std::string md5;
+    };
+
+    struct SequenceManifest {
+        std::string id;
+        uint64_t length = 0;
+        std::string md5;
+        std::vector<SequencePiece> pieces;
+    };
+
+    std::string MD5Hex(const uint8_t* sum) {
+        static const char* hex = "0123456789abcdef";
+        std::string s(32, '0');
+        for (int x = 0; x < 16; x++) {
+            s[x * 2] = hex[sum[x] >> 4];
+            s[x * 2 + 1] = hex[sum[x] & 0xF];
+        }
+        return s;
+    }
+
+    std::string MD5String(const uint8_t* data, size_t len) {
+        uint8_t sum[16];
+        av_md5_sum(sum, data, len);
+        return MD5Hex(sum);
+    }
+
+    uint32_t ReadLE32(const uint8_t* p) {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    // splits a V2 file into the pieces which are compared between uploads
+    bool BuildSequenceManifest(const std::string& file, SequenceManifest& manifest) {
+        wxFile in;
+        if (!in.Open(ToWXString(file))) {
+            return false;
+        }
+        uint64_t fileLength = in.Length();
+        std::vector<uint8_t> header(32);
+        if (fileLength < header.size() || in.Read(header.data(), header.size()) != (ssize_t)header.size()) {
+            return false;
+        }
+        if (header[0] != 'P' || header[7] != 2) {
+            return false;
+        }
+        uint64_t dataOffset = header[4] | (header[5] << 8);
+        if (dataOffset < header.size() || dataOffset > fileLength) {
+            return false;
+        }
+        header.resize(dataOffset);
+        if (dataOffset > 32 && in.Read(&header[32], dataOffset - 32) != (ssize_t)(dataOffset - 32)) {
+            return false;
+        }
+
+        uint64_t id = 0;
+        memcpy(&id, &header[24], sizeof(id));
+        manifest.id = std::to_string(id);
+        manifest.length = fileLength;
+        manifest.pieces.clear();
+
+        std::unique_ptr<AVMD5, decltype(&av_free)> md5(av_md5_alloc(), &av_free);
+        av_md5_init(md5.get());
+        av_md5_update(md5.get(), header.data(), header.size());
+        manifest.pieces.push_back({ 0, dataOffset, MD5String(header.data(), header.size()) });
+
+        std::vector<std::pair<uint64_t, uint64_t>> pieces;
+        uint64_t pos = dataOffset;
+        if ((header[20] & 0x0F) != 0) {
+            int blocks = header[21] + ((header[20] & 0xF0) << 4);
+            for (int b = 0; b < blocks && 32 + b * 8 + 8 <= dataOffset; b++) {
+                uint64_t len = ReadLE32(&header[32 + b * 8 + 4]);
+                if (len != 0) {
+                    pieces.push_back({ pos, len });
+                    pos += len;
+                }
+            }
+        }
+        while (pos < fileLength) {
+            uint64_t len = std::min(DELTA_CHUNK_SIZE, fileLength - pos);
+            pieces.push_back({ pos, len });
+            pos += len;
+        }
+        if (pos != fileLength) {
+            return false;
+        }
+
+        std::vector<uint8_t> buf;
+        for (const auto& p : pieces) {
+            buf.resize(p.second);
+            if (in.Read(buf.data(), p.second) != (ssize_t)p.second) {
+                return false;
+            }
+            av_md5_update(md5.get(), buf.data(), buf.size());
+            manifest.pieces.push_back({ p.first, p.second, MD5String(buf.data(), buf.size()) });
+        }
+        uint8_t sum[16];
+        av_md5_final(md5.get(), sum);
+        manifest.md5 = MD5Hex(sum);
+        return true;
+    }
+
+    bool LoadSequenceManifest(const std::string& filename, SequenceManifest& manifest) {
+        if (!FileExists(filename)) {
+            return false;
+        }
+        wxFileInputStream in(ToWXString(filename));
+        wxJSONValue root;
+        wxJSONReader reader;
+        if (!in.IsOk() || reader.Parse(in, &root) > 0) {
+            return false;
+        }
+        manifest.id = ToStdString(root["ID"].AsString());
+        manifest.length = root["length"].AsUInt64();
+        manifest.md5 = ToStdString(root["md5"].AsString());
+        wxJSONValue& pieces = root["pieces"];
+        for (int x = 0; x < pieces.Size(); x++) {
+            manifest.pieces.push_back({ pieces[x]["offset"].AsUInt64(), pieces[x]["length"].AsUInt64(), ToStdString(pieces[x]["md5"].AsString()) });
+        }
+        return !manifest.pieces.empty();
+    }
+
+    void SaveSequenceManifest(const std::string& filename, const SequenceManifest& manifest) {
+        wxFileName fn(ToWXString(filename));
+        if (!wxFileName::DirExists(fn.GetPath())) {
+            wxFileName::Mkdir(fn.GetPath(), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+        }
+        wxJSONValue root;
+        root["ID"] = manifest.id;
+        root["length"] = (wxUint64)manifest.length;
+        root["md5"] = manifest.md5;
+        root["pieces"].SetType(wxJSONTYPE_ARRAY);
+        for (const auto& p : manifest.pieces) {
+            wxJSONValue piece;
+            piece["offset"] = (wxUint64)p.offset;
+            piece["length"] = (wxUint64)p.length;
+            piece["md5"] = p.md5;
+            root["pieces"].Append(piece);
+        }
+        wxFileOutputStream out(fn.GetFullPath());
+        if (out.IsOk()) {
+            wxJSONWriter writer(wxJSONWRITER_NONE, 0, 0);
+            writer.Write(root, out);
+        }
+    }
+}
+
+std::string FPPSequenceDelta::ManifestFile(const std::string& host, const std::string& filename) {
+    wxString name = ToWXString(host + "_" + filename);
+    for (auto it = name.begin(); it != name.end(); ++it) {
+        if (!wxIsalnum(*it) && *it != '.' && *it != '-') {
+            *it = '_';
+        }
+    }
+    wxFileName fn(wxFileName::GetTempDir(), name + ".json");
+    fn.AppendDir("xLightsFPPDelta");
+    return ToStdString(fn.GetFullPath());
+}
+
+bool FPPSequenceDelta::Upload(const std::string& host, const std::string& filename, const std::string& file, const std::string& url,
+                              const GetJSON& get, const Post& post) {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    SequenceManifest manifest;
+    if (!BuildSequenceManifest(file, manifest)) {
+        return false;
+    }
+    std::string manifestFile = ManifestFile(host, filename);
+    SequenceManifest base;
+    bool haveBase = LoadSequenceManifest(manifestFile, base);
+    // whatever happens next this is what the player should end up with
+    SaveSequenceManifest(manifestFile, manifest);
+    if (!haveBase) {
+        return false;
+    }
+
+    wxJSONValue remote;
+    if (!get(url, remote) || ToStdString(remote["ID"].AsString()) != base.id) {
+        return false;
+    }
+    if (base.md5 == manifest.md5) {
+        logger_base.info("FPPConnect %s already has %s.", host.c_str(), filename.c_str());
+        return true;
+    }
+
+    std::map<std::string, const SequencePiece*> basePieces;
+    for (const auto& p : base.pieces) {
+        basePieces[p.md5] = &p;
+    }
+
+    wxFile in;
+    if (!in.Open(ToWXString(file))) {
+        return false;
+    }
+    std::vector<uint8_t> newData;
+    wxJSONValue segments;
+    segments.SetType(wxJSONTYPE_ARRAY);
+    std::string lastSource;
+    uint64_t lastEnd = 0;
+    for (const auto& p : manifest.pieces) {
+        auto it = basePieces.find(p.md5);
+        bool fromBase = it != basePieces.end() && it->second->length == p.length;
+        std::string source = fromBase ? "base" : "data";
+        uint64_t offset = fromBase ? it->second->offset : newData.size();
+        if (!fromBase) {
+            size_t pos = newData.size();
+            newData.resize(pos + p.length);
+            in.Seek(p.offset);
+            if (in.Read(&newData[pos], p.length) != (ssize_t)p.length) {
+                return false;
+            }
+        }
+        int last = segments.Size() - 1;
+        if (last >= 0 && source == lastSource && offset == lastEnd) {
+            segments[last]["length"] = (wxUint64)(segments[last]["length"].AsUInt64() + p.length);
+        } else {
+            wxJSONValue seg;
+            seg["source"] = source;
+            seg["offset"] = (wxUint64)offset;
+            seg["length"] = (wxUint64)p.length;
+            segments.Append(seg);
+        }
+        lastSource = source;
+        lastEnd = offset + p.length;
+    }
+
+    // when most of it has changed the plain upload is as good and works everywhere
+    if (newData.size() > manifest.length / 2) {
+        logger_base.info("FPPConnect %s: %zu of %llu bytes of %s changed, sending all of it.",
+                         host.c_str(), newData.size(), (unsigned long long)manifest.length, filename.c_str());
+        return false;
+    }
+
+    wxJSONValue descriptor;
+    descriptor["baseID"] = base.id;
+    descriptor["ID"] = manifest.id;
+    descriptor["length"] = (wxUint64)manifest.length;
+    descriptor["md5"] = manifest.md5;
+    descriptor["segments"] = segments;
+    wxString json;
+    wxJSONWriter writer(wxJSONWRITER_NONE, 0, 0);
+    writer.Write(descriptor, json);
+    std::string desc = ToUTF8(json);
+
+    std::vector<uint8_t> body(4 + desc.size() + newData.size());
+    uint32_t dlen = desc.size();
+    body[0] = dlen & 0xFF;
+    body[1] = (dlen >> 8) & 0xFF;
+    body[2] = (dlen >> 16) & 0xFF;
+    body[3] = (dlen >> 24) & 0xFF;
+    memcpy(&body[4], desc.data(), desc.size());
+    if (!newData.empty()) {
+        memcpy(&body[4 + desc.size()], newData.data(), newData.size());
+    }
+
+    wxStopWatch sw;
+    int rc = post(url, body);
+    logger_base.info("FPPConnect %s delta upload of %s: %zu of %llu bytes sent in %ldms, rc %d.",
+                     host.c_str(), filename.c_str(), body.size(), (unsigned long long)manifest.length, sw.Time(), rc);
+    return rc == 200;
+}
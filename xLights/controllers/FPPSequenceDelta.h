@@ -0,0 +1,50 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class wxJSONValue;
+
+// Delta sequence uploads
+//
+// A sequence file is described by a manifest of the md5 of its pieces ... the header, then each
+// compressed block of a V2 file or each 64KB of frame data otherwise. Compressed blocks are
+// independent so re-rendering a few seconds of a few models only changes a handful of them.
+//
+// The manifest of the last file sent to a player is kept locally. If the player reports it
+// still has that file (GET /api/sequence/<name>/delta returns its ID) only the pieces which are
+// not in it are sent, along with a descriptor of how to assemble the new file from the old one:
+//
+//     POST /api/sequence/<name>/delta
+//     4 bytes little endian descriptor length, descriptor json, then the new data
+//     { "baseID", "ID", "length", "md5", "segments": [ { "source": "base"|"data", "offset", "length" } ] }
+//
+// Only V2 files are sent this way. Anything else, including a player without the endpoint, gets the full upload.
+// The requests go through the caller so FPP can add its proxy and authentication.
+class FPPSequenceDelta {
+public:
+    // returns false if the GET failed
+    typedef std::function<bool(const std::string& url, wxJSONValue& val)> GetJSON;
+    // returns the http response code
+    typedef std::function<int(const std::string& url, const std::vector<uint8_t>& body)> Post;
+
+    // sends only what changed in file since the last upload of the sequence to host. url is the delta
+    // endpoint of the sequence. Returns false if the player still needs the full upload
+    static bool Upload(const std::string& host, const std::string& filename, const std::string& file, const std::string& url,
+                       const GetJSON& get, const Post& post);
+
+    // where the manifest of the last file sent to host is kept
+    static std::string ManifestFile(const std::string& host, const std::string& filename);
+};
@@ -40,10 +40,16 @@ std::list<std::string> DuplicateEffect::CheckEffectSettings(const SettingsMap& s
 {
     std::list<std::string> res = RenderableEffect::CheckEffectSettings(settings, media, model, eff, renderCache);
 
-    // get the sequence elements
-    auto& se = model->GetModelManager().GetXLightsFrame()->GetSequenceElements();
+    // get the sequence elements the effect belongs to ... a batch render checks sequences other than the open one
+    SequenceElements* se = nullptr;
+    if (eff != nullptr && eff->GetParentEffectLayer() != nullptr && eff->GetParentEffectLayer()->GetParentElement() != nullptr) {
+        se = eff->GetParentEffectLayer()->GetParentElement()->GetSequenceElements();
+    }
+    if (se == nullptr) {
+        se = &model->GetModelManager().GetXLightsFrame()->GetSequenceElements();
+    }
 
-    auto element = se.GetElement(settings.Get("E_CHOICE_Duplicate_Model", ""));
+    auto element = se->GetElement(settings.Get("E_CHOICE_Duplicate_Model", ""));
 
     if (element == nullptr)
     {
@@ -428,7 +428,7 @@ void FireworksEffect::Render(Effect *effect, const SettingsMap &SettingsMap, Ren
 
     if (useTiming)
     {
-        if (mSequenceElements == nullptr)
+        if (GetRenderSequenceElements() == nullptr)
         {
             // no timing tracks ... this shouldnt happen
         }
@@ -57,7 +57,7 @@ int GIFImage::GetMSUntilNextFrame(int msec, bool loop)
     return -1; // we shouldn't get here
 }
 
-int GIFImage::CalcFrameForTime(int msec, bool loop)
+int GIFImage::CalcFrameForTime(int msec, bool loop) const
 {
     if (_totalTime == 0) return 0;
 
@@ -299,3 +299,12 @@ const wxImage& GIFImage::GetFrame(int frame)
     }
     return _frameImages[frame];
 }
+
+void GIFImage::ReleaseFrames(int keep)
+{
+    for (int i = 0; i < (int)_frameImages.size(); i++) {
+        if (i != keep) {
+            _frameImages[i] = wxImage();
+        }
+    }
+}
@@ -34,7 +34,6 @@ class GIFImage
     bool _ok = false;
 	
 	void ReadFrameProperties();
-    int CalcFrameForTime(int msec, bool loop);
     wxPoint LoadRawImageFrame(wxImage& image, int frame, wxAnimationDisposal& disposal);
     void CopyImageToImage(wxImage& to, wxImage& from, wxPoint offset, bool overlay, bool dontaddtransparency = false);
     void DoCreate(const std::string& filename);
@@ -43,10 +42,15 @@ class GIFImage
 		GIFImage(const std::string& filename, bool suppressBackground = true);
 		virtual ~GIFImage();
 		const wxImage &GetFrame(int frame);
+        // frames are composed on top of the one before so each is kept once composed ... drops all but keep
+        void ReleaseFrames(int keep);
 		const wxImage &GetFrameForTime(int msec, bool loop);
+        // -1 once past the end when not looping
+        int CalcFrameForTime(int msec, bool loop) const;
         int GetMSUntilNextFrame(int msec, bool loop);
         std::string GetFilename() const { return _filename; }
         bool IsOk() const { return _ok; }
+        wxSize GetImageSize() const { return _gifSize; }
 
 		static bool IsGIF(const std::string& filename);
 };
@@ -1158,7 +1158,7 @@ std::list<NoteTiming*> GuitarEffect::LoadTimingTrack(const std::string& track, i
 
     logger_Guitardata.debug("Loading timings from timing track " + track);
 
-    if (mSequenceElements == nullptr) {
+    if (GetRenderSequenceElements() == nullptr) {
         logger_Guitardata.debug("No timing tracks found.");
         return res;
     }
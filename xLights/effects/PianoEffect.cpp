@@ -653,7 +653,7 @@ std::map<int, std::list<std::pair<float, float>>> PianoEffect::LoadTimingTrack(c
 
     logger_pianodata.debug("Loading timings from timing track " + track);
 
-    if (mSequenceElements == nullptr) {
+    if (GetRenderSequenceElements() == nullptr) {
         logger_pianodata.debug("No timing tracks found.");
         return res;
     }
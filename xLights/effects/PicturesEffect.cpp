@@ -30,7 +30,7 @@
 #include "../models/Model.h"
 #include "../UtilFunctions.h"
 #include "../ExternalHooks.h"
-#include "GIFImage.h"
+#include "../ImageCache.h"
 #include "../xLightsMain.h" 
 
 #include <log4cpp/Category.hh>
@@ -240,25 +240,29 @@ typedef std::vector< std::pair<wxPoint, xlColor> > PixelVector;
 
 class PicturesRenderCache : public EffectRenderCache {
 public:
-    PicturesRenderCache() : imageCount(0), frame(0),  gifImage(nullptr), maxmovieframes(0) {};
-    virtual ~PicturesRenderCache()
-    {
-        if (gifImage != nullptr) {
-            delete gifImage;
-            gifImage = nullptr;
-        }
-    };
+    PicturesRenderCache() : imageCount(0), frame(0), imageFrame(0), maxmovieframes(0) {};
+    virtual ~PicturesRenderCache() {};
 
-    wxImage image;
-    wxImage rawimage;
+    // both shared with every other effect showing the same picture, see ImageCache
+    std::shared_ptr<const CachedImage> image;
+    std::shared_ptr<const CachedImage> rawimage;
+    std::shared_ptr<const CachedImage> scaledFrom; // the rawimage image was scaled from
     int imageCount;
     int frame;
+    int imageFrame; // frame of an animated image rawimage holds
     int maxmovieframes;
     wxString PictureName;
-    GIFImage* gifImage;
     std::vector<PixelVector> PixelsByFrame;
 };
 
+// image becomes the current frame at the given size
+static void ScaleImage(PicturesRenderCache* cache, const wxString& name, bool suppressGIFBackground, int width, int height)
+{
+    if (cache->image != nullptr && cache->scaledFrom == cache->rawimage && cache->image->_width == width && cache->image->_height == height) return;
+    cache->image = ImageCache::GetImage(name.ToStdString(), suppressGIFBackground, cache->imageFrame, width, height);
+    cache->scaledFrom = cache->rawimage;
+}
+
 static PicturesRenderCache *GetCache(RenderBuffer &buf) {
     PicturesRenderCache *cache = (PicturesRenderCache*)buf.infoCache[PicturesEffectId];
     if (cache == nullptr) {
@@ -286,12 +290,10 @@ void PicturesEffect::LoadPixelsFromTextFile(RenderBuffer &buffer, wxFile& debug,
     wxByte rgb[3] = { 0,0,0 };
     PicturesRenderCache *cache = GetCache(buffer);
     cache->imageCount = 0;
-    wxImage &image = cache->image;
-    wxImage &rawimage = cache->rawimage;
     std::vector<PixelVector> &PixelsByFrame = cache->PixelsByFrame;
 
-    if (image.GetWidth() && image.GetHeight()) image.Clear(); //CAUTION: image must be non-empty to clear it (memory error otherwise)
-    if (rawimage.GetWidth() && rawimage.GetHeight()) rawimage.Clear(); //CAUTION: image must be non-empty to clear it (memory error otherwise)
+    cache->image.reset();
+    cache->rawimage.reset();
 
     if (!cache->PictureName.CmpNoCase(filename)) { wrdebug("no change: " + filename); return; }
     if (!FileExists(filename)) { wrdebug("not found: " + filename); return; }
@@ -499,8 +501,6 @@ void PicturesEffect::Render(RenderBuffer& buffer,
     bool pixelOffsets, bool wrap_x, bool shimmer, bool loopGIF, bool suppressGIFBackground,
     bool transparentBlack, int transparentBlackLevel)
 {
-
-    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     int dir = GetPicturesDirection(dirstr);
     double position = buffer.GetEffectTimeIntervalPosition(movementSpeed);
 
@@ -512,8 +512,6 @@ void PicturesEffect::Render(RenderBuffer& buffer,
     bool noImageFile = false;
 
     PicturesRenderCache* cache = GetCache(buffer);
-    wxImage& image = cache->image;
-    wxImage& rawimage = cache->rawimage;
 
     if (NewPictureName2.length() == 0) {
         noImageFile = true;
@@ -527,7 +525,6 @@ void PicturesEffect::Render(RenderBuffer& buffer,
         //      ffmpeg -i XXXX.mts -s 16x50 XXXX-%d.jpg
 
         wxFile f;
-        GIFImage*& gifImage = cache->gifImage;
         std::vector<PixelVector>& PixelsByFrame = cache->PixelsByFrame;
         int& frame = cache->frame;
 
@@ -595,57 +592,14 @@ void PicturesEffect::Render(RenderBuffer& buffer,
             if (!FileExists(NewPictureName)) {
                 noImageFile = true;
             } else {
-                wxLogNull logNo;  // suppress popups from png images. See http://trac.wxwidgets.org/ticket/15331
-
-                // There seems to be a bug on linux where this function crashes occasionally
-#ifdef LINUX
-                logger_base.debug("About to count images in bitmap %s.", (const char*)NewPictureName.c_str());
-#endif
-                cache->imageCount = wxImage::GetImageCount(NewPictureName);
-                if (cache->imageCount <= 0) {
-                    logger_base.error("Image %s reports %d frames which is invalid. Overriding it to be 1.", (const char*)NewPictureName.c_str(), cache->imageCount);
-
-                    // override it to 1
-                    cache->imageCount = 1;
-                }
-                
+                cache->imageCount = ImageCache::GetFrameCount(NewPictureName.ToStdString(), suppressGIFBackground);
                 cache->PictureName = NewPictureName;
-
-                if (cache->imageCount > 1) {
-#ifdef DEBUG_GIF
-                    logger_base.debug("Preparing GIF file for reading: %s", (const char*)NewPictureName.c_str());
-#endif
-                    if (gifImage != nullptr && gifImage->GetFilename() != NewPictureName) {
-                        delete gifImage;
-                        gifImage = nullptr;
-                    }
-                    if (gifImage == nullptr) {
-                        gifImage = new GIFImage(NewPictureName.ToStdString(), suppressGIFBackground);
-                    }
-
-                    if (!gifImage->IsOk()) {
-                        delete gifImage;
-                        gifImage = nullptr;
-                        cache->imageCount = 1;
-                        if (!image.LoadFile(NewPictureName, wxBITMAP_TYPE_ANY, 0)) {
-                            logger_base.error("Error loading image file: %s.", (const char*)NewPictureName.c_str());
-                            image.Create(5, 5, true);
-                        }
-                        rawimage = image;
-                    } else {
-                        image = gifImage->GetFrame(0);
-                        rawimage = image;
-                    }
-                } else {
-                    if (!image.LoadFile(NewPictureName, wxBITMAP_TYPE_ANY, 0)) {
-                        logger_base.error("Error loading image file: %s.", (const char*)NewPictureName.c_str());
-                        image.Create(5, 5, true);
-                    }
-                    rawimage = image;
-                }
+                cache->imageFrame = 0;
+                cache->rawimage = ImageCache::GetImage(NewPictureName.ToStdString(), suppressGIFBackground);
+                cache->image = cache->rawimage;
             }
         }
-        if (!noImageFile && !image.IsOk()) {
+        if (!noImageFile && cache->image == nullptr) {
             noImageFile = true;
         }
         if (!noImageFile && cache->imageCount > 1) {
@@ -654,16 +608,16 @@ void PicturesEffect::Render(RenderBuffer& buffer,
             scale_image = true;
 
             if (loopGIF) {
-                image = gifImage->GetFrameForTime((buffer.curPeriod - buffer.curEffStartPer) * buffer.frameTimeInMs * frameRateAdj, true);
+                cache->imageFrame = ImageCache::GetFrameForTime(NewPictureName.ToStdString(), suppressGIFBackground, (buffer.curPeriod - buffer.curEffStartPer) * buffer.frameTimeInMs * frameRateAdj, true);
             }
             else {
-                int ii = cache->imageCount * buffer.GetEffectTimeIntervalPosition(frameRateAdj) * 0.99;
-                image = gifImage->GetFrame(ii);
+                cache->imageFrame = cache->imageCount * buffer.GetEffectTimeIntervalPosition(frameRateAdj) * 0.99;
             }
 
-            rawimage = image;
+            cache->rawimage = ImageCache::GetImage(NewPictureName.ToStdString(), suppressGIFBackground, cache->imageFrame);
+            cache->image = cache->rawimage;
 
-            if (!rawimage.IsOk()) {
+            if (cache->rawimage->_width == 0) {
                 noImageFile = true;
             }
         }
@@ -679,43 +633,33 @@ void PicturesEffect::Render(RenderBuffer& buffer,
     }
 
     if (scale_to_fit == "No Scaling" && (start_scale != end_scale)) {
-        image = rawimage;
+        cache->image = cache->rawimage;
         scale_image = true;
     }
 
-    int imgwidth = image.GetWidth();
-    int imght = image.GetHeight();
+    const wxString& PictureName = cache->PictureName;
+    const CachedImage* rawimage = cache->rawimage.get();
+    int imgwidth = cache->image->_width;
+    int imght = cache->image->_height;
     int yoffset = (BufferHt + imght) / 2; //centered if sizes don't match
     int xoffset = (imgwidth - BufferWi) / 2; //centered if sizes don't match
 
     if (scale_to_fit == "Scale To Fit" && (BufferWi != imgwidth || BufferHt != imght)) {
-        image = rawimage;
-// work around wxWidgets image rescaling bug on windows in VS release builds
-//#ifdef __WXMSW__
-//        image.Rescale(BufferWi, BufferHt, wxIMAGE_QUALITY_BILINEAR); // I tried bicubic but it creates visual artefacts
-//#else
-        image.Rescale(BufferWi, BufferHt);
-//#endif
-        imgwidth = image.GetWidth();
-        imght = image.GetHeight();
+        ScaleImage(cache, PictureName, suppressGIFBackground, BufferWi, BufferHt);
+        imgwidth = BufferWi;
+        imght = BufferHt;
         yoffset = (BufferHt + imght) / 2; //centered if sizes don't match
         xoffset = (imgwidth - BufferWi) / 2; //centered if sizes don't match
     }
     else if (scale_to_fit == "Scale Keep Aspect Ratio" || scale_to_fit == "Scale Keep Aspect Ratio Crop") {
-        image = rawimage;
-        float xr = (float)BufferWi / (float)image.GetWidth();
-        float yr = (float)BufferHt / (float)image.GetHeight();
+        float xr = (float)BufferWi / (float)rawimage->_width;
+        float yr = (float)BufferHt / (float)rawimage->_height;
         float sc = std::min(xr, yr);
         if(scale_to_fit.find("Crop") != std::string::npos)
             sc = std::max(xr, yr);
-// work around wxWidgets image rescaling bug on windows in VS release builds
-//#ifdef __WXMSW__
-//        image.Rescale(image.GetWidth() * sc, image.GetHeight() * sc, wxIMAGE_QUALITY_BILINEAR); // I tried bicubic but it creates visual artefacts
-//#else
-        image.Rescale(image.GetWidth() * sc, image.GetHeight() * sc);
-//#endif
-        imgwidth = image.GetWidth();
-        imght = image.GetHeight();
+        ScaleImage(cache, PictureName, suppressGIFBackground, (int)(rawimage->_width * sc), (int)(rawimage->_height * sc));
+        imgwidth = cache->image == nullptr ? 0 : cache->image->_width;
+        imght = cache->image == nullptr ? 0 : cache->image->_height;
         yoffset = (BufferHt + imght) / 2; //centered if sizes don't match
         xoffset = (imgwidth - BufferWi) / 2; //centered if sizes don't match
     }
@@ -723,15 +667,11 @@ void PicturesEffect::Render(RenderBuffer& buffer,
         if ((start_scale != 100 || end_scale != 100) && scale_image) {
             int delta_scale = end_scale - start_scale;
             int current_scale = start_scale + delta_scale * position;
-            imgwidth = (image.GetWidth() * current_scale) / 100;
-            imght = (image.GetHeight() * current_scale) / 100;
+            imgwidth = (rawimage->_width * current_scale) / 100;
+            imght = (rawimage->_height * current_scale) / 100;
             imgwidth = std::max(imgwidth, 1);
             imght = std::max(imght, 1);
-//#ifdef __WXMSW__
-//            image.Rescale(imgwidth, imght, wxIMAGE_QUALITY_BILINEAR); // I tried bicubic but it creates visual artefacts
-//#else
-            image.Rescale(imgwidth, imght);
-//#endif
+            ScaleImage(cache, PictureName, suppressGIFBackground, imgwidth, imght);
             yoffset = (BufferHt + imght) / 2; //centered if sizes don't match
             xoffset = (imgwidth - BufferWi) / 2; //centered if sizes don't match
         }
@@ -802,16 +742,17 @@ void PicturesEffect::Render(RenderBuffer& buffer,
     }
     // copy image to buffer
     xlColor c;
-    bool hasAlpha = image.HasAlpha();
+    const CachedImage* image = cache->image.get();
 
     int calc_position_wi = (imgwidth + BufferWi) * position;
     int calc_position_ht = (imght + BufferHt) * position;
 
     for (int x = 0; x < imgwidth; x++) {
         for (int y = 0; y < imght; y++) {
-            if (!image.IsTransparent(x, y)) {
-                unsigned char alpha = hasAlpha ? image.GetAlpha(x, y) : 255;
-                c.Set(image.GetRed(x, y), image.GetGreen(x, y), image.GetBlue(x, y), alpha);
+            const uint8_t* px = image->GetPixel(x, y);
+            if (px[3] != 0) {
+                unsigned char alpha = px[3];
+                c.Set(px[0], px[1], px[2], alpha);
                 if (!buffer.allowAlpha && alpha < 64) {
                     //almost transparent, but this mix doesn't support transparent unless it's black;
                     c = xlBLACK;
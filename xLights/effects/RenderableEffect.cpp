@@ -1001,12 +1001,20 @@ int RenderableEffect::GetValueCurveInt(const std::string &name, int def, const S
     return res;
 }
 
+SequenceElements* RenderableEffect::GetRenderSequenceElements() const
+{
+    return ValueCurve::GetRenderSequenceElements(mSequenceElements);
+}
+
 EffectLayer* RenderableEffect::GetTiming(const std::string& timingtrack) const
 {
     if (timingtrack == "") return nullptr;
 
-    for (int i = 0; i < mSequenceElements->GetElementCount(); i++) {
-        Element* e = mSequenceElements->GetElement(i);
+    SequenceElements* se = GetRenderSequenceElements();
+    if (se == nullptr) return nullptr;
+
+    for (int i = 0; i < se->GetElementCount(); i++) {
+        Element* e = se->GetElement(i);
         if (e->GetType() == ElementType::ELEMENT_TYPE_TIMING && e->GetName() == timingtrack) {
             return e->GetEffectLayer(0);
         }
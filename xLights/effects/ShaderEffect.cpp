@@ -91,6 +91,16 @@
 #include <set>
 #include <mutex>
 #include <string>
+#include <cstring>
+#include <queue>
+
+#if defined(LINUX)
+    // keep X11 out of it, its macros collide with wx
+    #define EGL_NO_X11
+    #define MESA_EGL_NO_X11_HEADERS
+    #include <EGL/egl.h>
+    #include <EGL/eglext.h>
+#endif
 
 
 
@@ -541,6 +551,190 @@ private:
 } GL_CONTEXT_POOL;
 #endif /* __WXMSW__*/
 
+#if defined(LINUX)
+// Offscreen EGL contexts with no surface at all, so shaders can render on the render threads and on
+// machines without a display (Mesa's llvmpipe is fine). Every context shares objects with a root
+// context so compiled programs in ShaderRenderCache::shaderMap can be used from any of them.
+class EGLContextInfo {
+public:
+    EGLContextInfo(EGLContext context) : _context(context) {}
+    ~EGLContextInfo() {
+        eglDestroyContext(__display, _context);
+    }
+
+    // true if offscreen contexts can be created ... set up on the first call
+    static bool IsAvailable() {
+        std::unique_lock<std::mutex> lock(__lock);
+        if (__state == 0) {
+            __state = Initialise() ? 1 : -1;
+        }
+        return __state == 1;
+    }
+
+    static EGLContextInfo* Create() {
+        static log4cpp::Category& logger_opengl = log4cpp::Category::getInstance(std::string("log_opengl"));
+        EGLContext context = CreateContext(__root);
+        if (context == EGL_NO_CONTEXT) {
+            logger_opengl.error("ShaderEffect unable to create EGL context 0x%x.", eglGetError());
+            return nullptr;
+        }
+        logger_opengl.debug("ShaderEffect Thread %d created EGL context 0x%llx.", wxThread::GetCurrentId(), (uint64_t)context);
+        return new EGLContextInfo(context);
+    }
+
+    bool SetCurrent() {
+        static log4cpp::Category& logger_opengl = log4cpp::Category::getInstance(std::string("log_opengl"));
+        // the bound API is per thread
+        eglBindAPI(EGL_OPENGL_API);
+        if (!eglMakeCurrent(__display, EGL_NO_SURFACE, EGL_NO_SURFACE, _context)) {
+            logger_opengl.error("ShaderEffect unable to give thread %d EGL context 0x%llx: 0x%x.", wxThread::GetCurrentId(), (uint64_t)_context, eglGetError());
+            return false;
+        }
+        return true;
+    }
+    void UnsetCurrent() {
+        eglMakeCurrent(__display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+private:
+    static EGLContext CreateContext(EGLContext shared) {
+        // shaders are #version 330 core, try 3.1 if that is all we can get just like windows
+        EGLint attrs33[] = { EGL_CONTEXT_MAJOR_VERSION_KHR, 3, EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+                             EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR, EGL_NONE };
+        EGLint attrs31[] = { EGL_CONTEXT_MAJOR_VERSION_KHR, 3, EGL_CONTEXT_MINOR_VERSION_KHR, 1, EGL_NONE };
+        eglBindAPI(EGL_OPENGL_API);
+        EGLContext context = eglCreateContext(__display, __config, shared, attrs33);
+        if (context == EGL_NO_CONTEXT) {
+            context = eglCreateContext(__display, __config, shared, attrs31);
+        }
+        return context;
+    }
+
+    static bool Initialise() {
+        static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+        // prefer the surfaceless platform so no X server or wayland compositor is needed
+        const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        if (clientExtensions != nullptr && strstr(clientExtensions, "EGL_MESA_platform_surfaceless") != nullptr) {
+            auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+            if (getPlatformDisplay != nullptr) {
+                __display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            }
+        }
+        if (__display == EGL_NO_DISPLAY) {
+            __display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+        EGLint major = 0;
+        EGLint minor = 0;
+        if (__display == EGL_NO_DISPLAY || !eglInitialize(__display, &major, &minor)) {
+            logger_base.info("ShaderEffect - EGL not available, shaders will render on the main thread.");
+            __display = EGL_NO_DISPLAY;
+            return false;
+        }
+        const char* extensions = eglQueryString(__display, EGL_EXTENSIONS);
+        if (extensions == nullptr || strstr(extensions, "EGL_KHR_surfaceless_context") == nullptr || strstr(extensions, "EGL_KHR_create_context") == nullptr) {
+            logger_base.info("ShaderEffect - EGL %d.%d does not support surfaceless contexts, shaders will render on the main thread.", major, minor);
+            eglTerminate(__display);
+            __display = EGL_NO_DISPLAY;
+            return false;
+        }
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            logger_base.info("ShaderEffect - EGL %d.%d does not support desktop OpenGL, shaders will render on the main thread.", major, minor);
+            eglTerminate(__display);
+            __display = EGL_NO_DISPLAY;
+            return false;
+        }
+
+        // we render into our own framebuffer objects so the config barely matters
+        EGLint configAttrs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                 EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+                                 EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_NONE };
+        EGLint count = 0;
+        if (!eglChooseConfig(__display, configAttrs, &__config, 1, &count) || count == 0) {
+            configAttrs[10] = EGL_NONE; // drop the surface type
+            if (!eglChooseConfig(__display, configAttrs, &__config, 1, &count) || count == 0) {
+                logger_base.info("ShaderEffect - no suitable EGL config, shaders will render on the main thread.");
+                eglTerminate(__display);
+                __display = EGL_NO_DISPLAY;
+                return false;
+            }
+        }
+
+        __root = CreateContext(EGL_NO_CONTEXT);
+        if (__root == EGL_NO_CONTEXT || !eglMakeCurrent(__display, EGL_NO_SURFACE, EGL_NO_SURFACE, __root)) {
+            logger_base.info("ShaderEffect - unable to create an OpenGL 3 EGL context 0x%x, shaders will render on the main thread.", eglGetError());
+            if (__root != EGL_NO_CONTEXT) {
+                eglDestroyContext(__display, __root);
+                __root = EGL_NO_CONTEXT;
+            }
+            eglTerminate(__display);
+            __display = EGL_NO_DISPLAY;
+            return false;
+        }
+
+        // headless there is no canvas which would have loaded these
+        if (glUseProgram == nullptr) {
+            DrawGLUtils::LoadGLFunctions();
+        }
+
+        const GLubyte* str = glGetString(GL_VERSION);
+        const GLubyte* rend = glGetString(GL_RENDERER);
+        const GLubyte* vend = glGetString(GL_VENDOR);
+        logger_base.info("ShaderEffect - EGL %d.%d glVer:  %s  (%s)(%s)", major, minor, (const char*)str, (const char*)rend, (const char*)vend);
+        eglMakeCurrent(__display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        return true;
+    }
+
+    EGLContext _context;
+
+    static std::mutex __lock;
+    static int __state; // 0 - not tried, 1 - available, -1 - not available
+    static EGLDisplay __display;
+    static EGLConfig __config;
+    static EGLContext __root;
+};
+std::mutex EGLContextInfo::__lock;
+int EGLContextInfo::__state = 0;
+EGLDisplay EGLContextInfo::__display = EGL_NO_DISPLAY;
+EGLConfig EGLContextInfo::__config = nullptr;
+EGLContext EGLContextInfo::__root = EGL_NO_CONTEXT;
+
+class EGLContextPool {
+public:
+    ~EGLContextPool() {
+        while (!contexts.empty()) {
+            delete contexts.front();
+            contexts.pop();
+        }
+    }
+
+    EGLContextInfo* GetContext() {
+        static log4cpp::Category& logger_opengl = log4cpp::Category::getInstance(std::string("log_opengl"));
+        {
+            std::unique_lock<std::mutex> locker(lock);
+            if (!contexts.empty()) {
+                EGLContextInfo* ret = contexts.front();
+                contexts.pop();
+                logger_opengl.debug("Shader EGL context taken from pool 0x%llx", (uint64_t)ret);
+                return ret;
+            }
+        }
+        // unlike windows these can be created on any thread
+        return EGLContextInfo::Create();
+    }
+    void ReleaseContext(EGLContextInfo* pctx) {
+        static log4cpp::Category& logger_opengl = log4cpp::Category::getInstance(std::string("log_opengl"));
+        std::unique_lock<std::mutex> locker(lock);
+        contexts.push(pctx);
+        logger_opengl.debug("Shader EGL context released 0x%llx", (uint64_t)pctx);
+    }
+
+private:
+    std::mutex lock;
+    std::queue<EGLContextInfo*> contexts;
+} EGL_CONTEXT_POOL;
+#endif /* LINUX */
+
 
 #if defined(__WXOSX__)
 constexpr int osxMaxSharedContextCount = 24;
@@ -659,6 +853,16 @@ public:
             }
         }
 #else
+#if defined(LINUX)
+        if (eglContextInfo != nullptr) {
+            if (eglContextInfo->SetCurrent()) {
+                DestroyResources();
+                eglContextInfo->UnsetCurrent();
+            }
+            EGL_CONTEXT_POOL.ReleaseContext(eglContextInfo);
+            eglContextInfo = nullptr;
+        }
+#endif
         if (preview) {
             unsigned vertexArrayId = s_vertexArrayId;
             unsigned vertexBufferId = s_vertexBufferId;
@@ -798,7 +1002,10 @@ public:
 #elif defined(__WXMSW__)
     GLContextInfo *glContextInfo = nullptr;
 #else
-    xlGLCanvas *preview;
+    xlGLCanvas *preview = nullptr;
+#if defined(LINUX)
+    EGLContextInfo *eglContextInfo = nullptr;
+#endif
 #endif
 };
 std::map<std::string, ShaderRenderCache::ShaderInfo*> ShaderRenderCache::shaderMap;
@@ -828,6 +1035,9 @@ bool ShaderEffect::CanRenderOnBackgroundThread(Effect* effect, const SettingsMap
     return true;
 #elif defined(__WXMSW__)
     return useBackgroundRender;
+#elif defined(LINUX)
+    // each render thread gets its own offscreen context
+    return EGLContextInfo::IsAvailable();
 #else
     return false;
 #endif
@@ -847,6 +1057,11 @@ void ShaderEffect::UnsetGLContext(ShaderRenderCache* cache) {
         // release it from the thread every time so we never find ourselves in a situation where it has not been released by a thread
         cache->glContextInfo->UnsetCurrent();
     }
+#elif defined(LINUX)
+    if (cache->eglContextInfo != nullptr) {
+        // the next frame may be rendered on a different thread
+        cache->eglContextInfo->UnsetCurrent();
+    }
 #endif
 }
 
@@ -1028,6 +1243,15 @@ bool ShaderEffect::SetGLContext(ShaderRenderCache *cache) {
     }
     return true;
 #else
+#if defined(LINUX)
+    if (EGLContextInfo::IsAvailable()) {
+        if (cache->eglContextInfo == nullptr) {
+            // we grab it here and release it when the cache is deleted
+            cache->eglContextInfo = EGL_CONTEXT_POOL.GetContext();
+        }
+        return cache->eglContextInfo != nullptr && cache->eglContextInfo->SetCurrent();
+    }
+#endif
     ShaderPanel *p = (ShaderPanel *)panel;
     cache->preview = p->_preview;
     p->_preview->SetCurrentGLContext();
@@ -1040,6 +1264,11 @@ void ShaderEffect::Render(Effect* eff, const SettingsMap& SettingsMap, RenderBuf
 {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
+#if defined(LINUX)
+    // sets up EGL, and loads the OpenGL functions when there is no canvas to have done it
+    EGLContextInfo::IsAvailable();
+#endif
+
     // Bail out right away if we don't have the necessary OpenGL support
     if (!OpenGLShaders::HasFramebufferObjects() || !OpenGLShaders::HasShaderSupport()) {
         setRenderBufferAll(buffer, xlCYAN);
@@ -1095,7 +1324,7 @@ void ShaderEffect::Render(Effect* eff, const SettingsMap& SettingsMap, RenderBuf
         buffer.needToInit = false;
         _timeMS = SettingsMap.GetInt("TEXTCTRL_Shader_LeadIn", 0) * buffer.frameTimeInMs;
         if (contextSet) {
-            cache->InitialiseShaderConfig(SettingsMap.Get("0FILEPICKERCTRL_IFS", ""), mSequenceElements);
+            cache->InitialiseShaderConfig(SettingsMap.Get("0FILEPICKERCTRL_IFS", ""), GetRenderSequenceElements());
             programId = programIdForShaderCode(_shaderConfig, cache);
         } else {
             logger_base.warn("Could not create/set OpenGL Context for ShaderEffect.  ShaderEffect disabled.");
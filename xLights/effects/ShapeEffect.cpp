@@ -543,15 +543,16 @@ void ShapeEffect::Render(Effect *effect, const SettingsMap &SettingsMap, RenderB
     }
 
     // create missing shapes
+    SequenceElements* sequenceElements = GetRenderSequenceElements();
     if (useTiming) {
-        if (mSequenceElements == nullptr) {
+        if (sequenceElements == nullptr) {
             // no timing tracks ... this shouldnt happen
         } else {
             // Load the names of the timing tracks
             Element* t = nullptr;
-            for (size_t l = 0; l < mSequenceElements->GetElementCount(); l++)
+            for (size_t l = 0; l < sequenceElements->GetElementCount(); l++)
             {
-                Element* e = mSequenceElements->GetElement(l);
+                Element* e = sequenceElements->GetElement(l);
                 if (e->GetEffectLayerCount() == 1 && e->GetType() == ElementType::ELEMENT_TYPE_TIMING)
                 {
                     if (e->GetName() == timing)
@@ -10,6 +10,7 @@
 
 #include "TextEffect.h"
 
+#include <algorithm>
 #include <mutex>
 #include <array>
 #include <unordered_map>
@@ -25,6 +26,7 @@
 #include "../models/Model.h"
 #include "../UtilFunctions.h"
 #include "../FontManager.h"
+#include "../ImageCache.h"
 #include "../xLightsMain.h"
 #include "../ExternalHooks.h"
 #include "../xLightsXmlFile.h"
@@ -477,14 +479,15 @@ void TextEffect::Render(Effect *effect, const SettingsMap &SettingsMap, RenderBu
         }
         else
         {
-            if (!lyricTrack.IsEmpty())
+            SequenceElements* sequenceElements = GetRenderSequenceElements();
+            if (!lyricTrack.IsEmpty() && sequenceElements != nullptr)
             {
                 Element* t = nullptr;
-                for (int i = 0; i < mSequenceElements->GetElementCount(); i++)
+                for (int i = 0; i < sequenceElements->GetElementCount(); i++)
                 {
                     auto lt = lyricTrack.BeforeLast('-');
                     lt = lt.Left(lt.size() - 1);
-                    Element* e = mSequenceElements->GetElement(i);
+                    Element* e = sequenceElements->GetElement(i);
                     if (e->GetEffectLayerCount() > 1 && e->GetType() == ElementType::ELEMENT_TYPE_TIMING && e->GetName() == lt)
                     {
                         t = e;
@@ -533,7 +536,7 @@ void TextEffect::Render(Effect *effect, const SettingsMap &SettingsMap, RenderBu
         bool pixelOffsets = wxAtoi(SettingsMap.Get("CHECKBOX_Text_PixelOffsets", "0"));
         bool perWord = wxAtoi(SettingsMap.Get("CHECKBOX_Text_Color_PerWord", "0"));
 
-        wxImage * i = RenderTextLine(buffer,
+        RenderTextLine(buffer,
                        buffer.GetTextDrawingContext(),
                        text,
                        SettingsMap["FONTPICKER_Text_Font"],
@@ -544,34 +547,6 @@ void TextEffect::Render(Effect *effect, const SettingsMap &SettingsMap, RenderBu
                        TextCountDownIndex(SettingsMap["CHOICE_Text_Count"]),
                        wxAtoi(SettingsMap.Get("TEXTCTRL_Text_Speed", "10")),
                        startx, starty, endx, endy, pixelOffsets, perWord);
-        
-        if (i == nullptr) {
-            return;
-        }
-        xlColor c;
-        bool ha = i->HasAlpha();
-        unsigned char* data = i->GetData();
-        unsigned char* alpha = ha ? i->GetAlpha() : nullptr;
-        int w = i->GetWidth();
-        int h = i->GetHeight();
-        int cur = 0;
-        int cura = 0;
-        for(int y = h - 1; y >= 0; y--)
-        {
-            for(int x=0; x < w; x++)
-            {
-                if (ha) {
-                    c.Set(data[cur], data[cur + 1], data[cur + 2], alpha[cura++]);
-                } else {
-                    c.Set(data[cur], data[cur + 1], data[cur + 2]);
-                    if (c == xlBLACK) {
-                        c.alpha = 0;
-                    }
-                }
-                cur += 3;
-                buffer.SetPixel(x, y, c);
-            }
-        }
     }
 }
 
@@ -641,21 +616,21 @@ wxSize GetMultiLineTextExtent(TextDrawingContext *dc,
 class CachedTextInfo {
 public:
     CachedTextInfo() {}
-    CachedTextInfo(const std::string &txt, const std::string font, const std::vector<xlColor> &c, const wxRect &r)
-    : text(txt), rect(r), color(c), fontString(font) {}
+    CachedTextInfo(const std::string &txt, const std::string font, const std::vector<xlColor> &c, bool pw)
+    : text(txt), color(c), fontString(font), perWord(pw) {}
     ~CachedTextInfo() {}
     
     bool operator==(const CachedTextInfo &i) const {
         return (text == i.text)
             && (fontString == i.fontString)
-            && (rect == i.rect)
+            && (perWord == i.perWord)
             && (color == i.color);
     }
     
-    std::string text;
-    wxRect rect;
+    std::string text; // utf8
     std::vector<xlColor> color;
     std::string fontString;
+    bool perWord = false;
 };
 
 struct CachedTextInfoHasher {
@@ -666,7 +641,7 @@ struct CachedTextInfoHasher {
         for (auto a : t.color) {
             h1 ^= a.GetRGB() << 3;
         }
-        h1 ^= (std::abs(t.rect.x) << 8) + (std::abs(t.rect.y) << 16);
+        h1 ^= t.perWord ? 0x5555 : 0;
         return h1;
     }
 };
@@ -674,21 +649,10 @@ struct CachedTextInfoHasher {
 class TextRenderCache : public EffectRenderCache {
 public:
     TextRenderCache() : timer_countdown(0), synced_textsize(wxSize(0,0)) {};
-    virtual ~TextRenderCache() {
-        for (const auto& it : textCache) {
-            delete it.second;
-        }
-    };
+    virtual ~TextRenderCache() {};
     int timer_countdown;
     wxSize synced_textsize;
     
-    wxImage *GetImage(const CachedTextInfo &inf) {
-        return textCache[inf];
-    }
-    void PutImage(const CachedTextInfo &inf, wxImage *img) {
-        textCache[inf] = img;
-    }
-    
     wxSize GetMultiLineTextExtent(const std::string &font, const wxString &msg) {
         std::pair<std::string, wxString> key(font, msg);
         auto i = textExtentCache.find(key);
@@ -702,10 +666,118 @@ public:
         textExtentCache[key] = sz;
     }
     
-    std::unordered_map<CachedTextInfo, wxImage*, CachedTextInfoHasher> textCache;
     std::map<std::pair<std::string, wxString>, wxSize> textExtentCache;
 };
 
+// Unrotated text drawn once with a margin around its extent. Scrolling the text, or showing it on
+// other models, is then only a change in where the block is copied to.
+struct TextBlock {
+    CachedImage image; // exactly what the drawing context held ... transparent where there is no text
+    int margin = 0;
+};
+
+// Text blocks shared by every buffer and render thread showing the same text in the same font and colours
+class TextBlockCache {
+    struct Entry {
+        std::shared_ptr<const TextBlock> block;
+        uint64_t lastUsed = 0;
+    };
+
+    static std::mutex __lock;
+    static std::unordered_map<CachedTextInfo, Entry, CachedTextInfoHasher> __blocks;
+    static size_t __used;
+    static uint64_t __clock;
+
+public:
+    static const size_t BUDGET = 64 * 1024 * 1024;
+
+    static std::shared_ptr<const TextBlock> Find(const CachedTextInfo& inf) {
+        std::unique_lock<std::mutex> lock(__lock);
+        auto it = __blocks.find(inf);
+        if (it == __blocks.end()) return nullptr;
+        it->second.lastUsed = ++__clock;
+        return it->second.block;
+    }
+
+    static std::shared_ptr<const TextBlock> Add(const CachedTextInfo& inf, std::shared_ptr<const TextBlock> block) {
+        std::unique_lock<std::mutex> lock(__lock);
+        auto it = __blocks.find(inf);
+        if (it != __blocks.end()) return it->second.block;
+
+        __blocks[inf] = { block, ++__clock };
+        __used += block->image._data.size();
+        if (__used > BUDGET) {
+            // free down to 3/4 of the budget so we are not doing this for every new string
+            std::vector<std::pair<uint64_t, const CachedTextInfo*>> ages;
+            for (const auto& b : __blocks) {
+                ages.push_back({ b.second.lastUsed, &b.first });
+            }
+            std::sort(ages.begin(), ages.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            std::vector<CachedTextInfo> drop;
+            size_t used = __used;
+            for (const auto& a : ages) {
+                if (used <= BUDGET * 3 / 4) break;
+                used -= __blocks[*a.second].block->image._data.size();
+                drop.push_back(*a.second);
+            }
+            for (const auto& d : drop) {
+                __blocks.erase(d);
+            }
+            __used = used;
+        }
+        return block;
+    }
+};
+
+std::mutex TextBlockCache::__lock;
+std::unordered_map<CachedTextInfo, TextBlockCache::Entry, CachedTextInfoHasher> TextBlockCache::__blocks;
+size_t TextBlockCache::__used = 0;
+uint64_t TextBlockCache::__clock = 0;
+
+// the drawing context image as it is copied into the buffer ... without an alpha channel black is transparent
+static void CopyTextImage(const wxImage& i, CachedImage& to)
+{
+    bool ha = i.HasAlpha();
+    const unsigned char* data = i.GetData();
+    const unsigned char* alpha = ha ? i.GetAlpha() : nullptr;
+    to._width = i.GetWidth();
+    to._height = i.GetHeight();
+    size_t pixels = (size_t)to._width * to._height;
+    to._data.resize(pixels * 4);
+    uint8_t* d = to._data.data();
+    for (size_t p = 0; p < pixels; ++p, data += 3, d += 4) {
+        d[0] = data[0];
+        d[1] = data[1];
+        d[2] = data[2];
+        if (ha) {
+            d[3] = alpha[p];
+        } else {
+            d[3] = (data[0] == 0 && data[1] == 0 && data[2] == 0) ? 0 : 255;
+        }
+    }
+}
+
+// Copy an image the size of the buffer, or a block with its top left at x, y in drawing context
+// coordinates, into the buffer. Every pixel is written, those outside the block as transparent
+static void DrawTextImage(RenderBuffer& buffer, const CachedImage& image, int x, int y)
+{
+    xlColor c;
+    for (int by = 0; by < buffer.BufferHt; by++) {
+        // drawing contexts are top down
+        int iy = buffer.BufferHt - 1 - by - y;
+        for (int bx = 0; bx < buffer.BufferWi; bx++) {
+            int ix = bx - x;
+            if (iy >= 0 && iy < image._height && ix >= 0 && ix < image._width) {
+                const uint8_t* p = image.GetPixel(ix, iy);
+                c.Set(p[0], p[1], p[2], p[3]);
+            } else {
+                c.Set(0, 0, 0, 0);
+            }
+            buffer.SetPixel(bx, by, c);
+        }
+    }
+}
+
 wxSize GetMultiLineTextExtent(TextDrawingContext *dc,
                               const wxString& text,
                               TextRenderCache *cache,
@@ -890,7 +962,7 @@ TextRenderCache *GetCache(RenderBuffer &buffer, int id) {
 }
 
 //jwylie - 2016-11-01  -- enhancement: add minute seconds countdown
-wxImage *TextEffect::RenderTextLine(RenderBuffer &buffer,
+void TextEffect::RenderTextLine(RenderBuffer &buffer,
                                     TextDrawingContext* dc,
                                     const wxString& Line_orig,
                                     const std::string &fontString,
@@ -903,7 +975,7 @@ wxImage *TextEffect::RenderTextLine(RenderBuffer &buffer,
     wxString Line = Line_orig;
     wxString msg, tempmsg;
 
-    if (Line.IsEmpty()) return nullptr;
+    if (Line.IsEmpty()) return;
 
     int state = (buffer.curPeriod - buffer.curEffStartPer) * tspeed * buffer.frameTimeInMs / 50;
 
@@ -1096,18 +1168,29 @@ wxImage *TextEffect::RenderTextLine(RenderBuffer &buffer,
         if (colors.size() == 0) {
             colors.push_back(xlWHITE);
         }
-        CachedTextInfo inf(msg.ToStdString(), fontString, colors, rect);
-        wxImage *img = GetCache(buffer,id)->GetImage(inf);
-        if (img == nullptr) {
-            dc->Clear();
-            SetFont(dc, fontString, colors[0]);
-            DrawLabel(dc, msg, rect, wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, GetCache(buffer,id), fontString, colors, perWord);
-            wxImage *i2 = dc->FlushAndGetImage();
-            img = new wxImage(i2->GetSize());
-            *img = i2->Copy();
-            GetCache(buffer,id)->PutImage(inf, img);
+        CachedTextInfo inf(std::string(msg.utf8_str()), fontString, colors, perWord);
+        auto block = TextBlockCache::Find(inf);
+        if (block == nullptr) {
+            // draw it centred in a context just big enough for it, and the margin
+            auto b = std::make_shared<TextBlock>();
+            b->margin = std::max(TextDrawingContext::GetTextFont(fontString).GetPixelSize().y, 1);
+            TextDrawingContext* tdc = TextDrawingContext::GetContext();
+            if (tdc != nullptr) {
+                tdc->ResetSize(textsize.x + 2 * b->margin, textsize.y + 2 * b->margin);
+                tdc->Clear();
+                SetFont(tdc, fontString, colors[0]);
+                DrawLabel(tdc, msg, wxRect(b->margin, b->margin, textsize.x, textsize.y), wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, cache, fontString, colors, perWord);
+                CopyTextImage(*tdc->FlushAndGetImage(), b->image);
+                TextDrawingContext::ReleaseContext(tdc);
+            }
+            block = TextBlockCache::Add(inf, b);
         }
-        return img;
+
+        // where DrawLabel would have put the text had it been drawn straight into the buffer sized rect
+        int x = (rect.GetLeft() + rect.GetRight() + 1 - textsize.x) / 2;
+        int y = (rect.GetTop() + rect.GetBottom() + 1 - textsize.y) / 2;
+        DrawTextImage(buffer, block->image, x - block->margin, y - block->margin);
+        return;
     }
     
     xlColor c;
@@ -1165,7 +1248,9 @@ wxImage *TextEffect::RenderTextLine(RenderBuffer &buffer,
             break; // static
     }
 
-    return buffer.GetTextDrawingContext()->FlushAndGetImage();
+    CachedImage image;
+    CopyTextImage(*dc->FlushAndGetImage(), image);
+    DrawTextImage(buffer, image, 0, 0);
 }
 
 void TextEffect::FormatCountdown(int Countdown, int state, wxString& Line, RenderBuffer &buffer, wxString& msg, wxString Line_orig) const
@@ -1487,8 +1572,6 @@ void TextEffect::RenderXLText(Effect* effect, const SettingsMap& settings, Rende
     font_mgr.init();  // make sure font class is initialized
     wxString xl_font = settings["CHOICE_Text_Font"];
     xlFont* font = font_mgr.get_font(xl_font);
-    wxBitmap* bmp = font->get_bitmap();
-    wxImage image = bmp->ConvertToImage();
     int char_width = font->GetWidth();
     int char_height = font->GetHeight();
 
@@ -1516,12 +1599,13 @@ void TextEffect::RenderXLText(Effect* effect, const SettingsMap& settings, Rende
             f.Close();
         }
         else {
-            if (lyricTrack != "") {
+            SequenceElements* sequenceElements = GetRenderSequenceElements();
+            if (lyricTrack != "" && sequenceElements != nullptr) {
                 Element* t = nullptr;
-                for (int i = 0; i < mSequenceElements->GetElementCount(); i++) {
+                for (int i = 0; i < sequenceElements->GetElementCount(); i++) {
                     auto lt = lyricTrack.BeforeLast('-');
                     lt = lt.Left(lt.size() - 1);
-                    Element* e = mSequenceElements->GetElement(i);
+                    Element* e = sequenceElements->GetElement(i);
                     if (e->GetEffectLayerCount() > 1 && e->GetType() == ElementType::ELEMENT_TYPE_TIMING && e->GetName() == lt) {
                         t = e;
                         break;
@@ -1627,31 +1711,24 @@ void TextEffect::RenderXLText(Effect* effect, const SettingsMap& settings, Rende
                     curPos++;
                 }
                 char ascii = text[i];
-                int x_start_corner = (ascii % 8) * (char_width + 1) + 1;
-                int y_start_corner = (ascii / 8) * (char_height + 1) + 1;
+                const uint8_t* glyph = font->GetGlyph(ascii);
 
                 int actual_width = font->GetCharWidth(ascii);
                 wxASSERT(actual_width > 0);
                 if (rotate_90 && up) {
                     OffsetTop -= actual_width;
                 }
-                for (int w = 0; w < actual_width; w++) {
-                    int x_pos = x_start_corner + w;
-                    for (int y_pos = y_start_corner; y_pos < y_start_corner + char_height; y_pos++) {
-                        if (x_pos >= 0 && x_pos < image.GetWidth() && y_pos >= 0 && y_pos < image.GetHeight()) {
-                            int red = image.GetRed(x_pos, y_pos);
-                            int green = image.GetGreen(x_pos, y_pos);
-                            int blue = image.GetBlue(x_pos, y_pos);
-                            if (red == 255 && green == 255 && blue == 255) {
-                                if (rotate_90) {
-                                    if (up) {
-                                        buffer.SetPixel(y_pos - y_start_corner + OffsetLeft, (buffer.BufferHt - 1) - (actual_width - 1 - x_pos + x_start_corner + OffsetTop), c, false);
-                                    } else {
-                                        buffer.SetPixel(char_height - 1 - y_pos + y_start_corner + OffsetLeft, (buffer.BufferHt - 1) - (x_pos - x_start_corner + OffsetTop), c, false);
-                                    }
+                for (int w = 0; glyph != nullptr && w < actual_width; w++) {
+                    for (int y = 0; y < char_height; y++) {
+                        if (glyph[y * char_width + w]) {
+                            if (rotate_90) {
+                                if (up) {
+                                    buffer.SetPixel(y + OffsetLeft, (buffer.BufferHt - 1) - (actual_width - 1 - w + OffsetTop), c, false);
                                 } else {
-                                    buffer.SetPixel(x_pos - x_start_corner + OffsetLeft, buffer.BufferHt - (y_pos - y_start_corner + OffsetTop) - 1, c, false);
+                                    buffer.SetPixel(char_height - 1 - y + OffsetLeft, (buffer.BufferHt - 1) - (w + OffsetTop), c, false);
                                 }
+                            } else {
+                                buffer.SetPixel(w + OffsetLeft, buffer.BufferHt - (y + OffsetTop) - 1, c, false);
                             }
                         }
                     }
@@ -50,7 +50,7 @@ private:
 
     void ReplaceVaribles(wxString& msg, RenderBuffer& buffer) const;
 
-    wxImage* RenderTextLine(RenderBuffer& buffer,
+    void RenderTextLine(RenderBuffer& buffer,
         TextDrawingContext* dc,
         const wxString& Line_orig,
         const std::string& fontString,
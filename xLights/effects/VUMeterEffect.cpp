@@ -2517,9 +2517,13 @@ Effect* VUMeterEffect::GetTimingEvent(const std::string& timingTrack, uint32_t m
     if (timingTrack == "")
         return nullptr;
 
+    SequenceElements* sequenceElements = GetRenderSequenceElements();
+    if (sequenceElements == nullptr)
+        return nullptr;
+
     Element* t = nullptr;
-    for (int i = 0; i < mSequenceElements->GetElementCount(); i++) {
-        Element* e = mSequenceElements->GetElement(i);
+    for (int i = 0; i < sequenceElements->GetElementCount(); i++) {
+        Element* e = sequenceElements->GetElement(i);
         if (e->GetEffectLayerCount() == 1 && e->GetType() == ElementType::ELEMENT_TYPE_TIMING && e->GetName() == timingTrack) {
             t = e;
             break;
@@ -17,6 +17,7 @@
 #include "VideoEffect.h"
 #include "VideoPanel.h"
 #include "../VideoReader.h"
+#include "../VideoFrameCache.h"
 #include "../sequencer/Effect.h"
 #include "../RenderBuffer.h"
 #include "../UtilClasses.h"
@@ -248,7 +249,7 @@ public:
 		}
 	};
 
-    VideoReader* _videoreader;
+    CachedVideoFrameReader* _videoreader;
 	int _videoframerate;
 	int _loops;
     int _frameMS;
@@ -300,7 +301,7 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
     }
 
     int &_loops = cache->_loops;
-    VideoReader* &_videoreader = cache->_videoreader;
+    CachedVideoFrameReader* &_videoreader = cache->_videoreader;
     int& _frameMS = cache->_frameMS;
     int& _nextManualMS = cache->_nextManualMS;
 
@@ -341,7 +342,8 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
 
             bool useNativeResolution = (sampleSpacing > 0);
 
-            _videoreader = new VideoReader(filename, width, height, aspectratio, useNativeResolution, true);
+            // frames are decoded in the background and shared with any other render of the same video at this size
+            _videoreader = new CachedVideoFrameReader(filename, width, height, aspectratio, useNativeResolution);
 
             if (_videoreader == nullptr)
             {
@@ -357,9 +359,6 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
                     logger_base.warn("VideoEffect: Video %s was read as 0 length.", (const char *)filename.c_str());
                 }
 
-                // read the first frame ... if i dont it thinks the first frame i read is the first frame
-                _videoreader->GetNextFrame(0);
-
                 VideoPanel *fp = static_cast<VideoPanel*>(panel);
                 if (fp != nullptr)
                 {
@@ -410,7 +409,7 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
         if (!vwidthEq || !vheightEq) {
             // need to close and reopen video reader to the new size ... this is inefficient ... but lots of work to do to change video reader size dynamically
             delete _videoreader;
-            _videoreader = new VideoReader(filename, width, height, aspectratio, false, true);
+            _videoreader = new CachedVideoFrameReader(filename, width, height, aspectratio, false);
         }
     }
 
@@ -445,7 +444,7 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
         }
 
         // get the image for the current frame
-        AVFrame* image = _videoreader->GetNextFrame(frame);
+        const VideoFrame* image = _videoreader->GetNextFrame(frame);
 
         // if we have reached the end and we are to loop
         if (_videoreader->AtEnd() && durationTreatment == "Loop")
@@ -483,7 +482,7 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
                     // draw the image
                     xlColor c;
                     for (int y = 0; y < _videoreader->GetHeight() - yoffset - ytail; y++) {
-                        uint8_t* ptr = image->data[0] + (_videoreader->GetHeight() - 1 - y - yoffset) * _videoreader->GetWidth() * ch + xoffset * ch;
+                        const uint8_t* ptr = image->GetData() + (_videoreader->GetHeight() - 1 - y - yoffset) * _videoreader->GetWidth() * ch + xoffset * ch;
 
                         for (int x = 0; x < _videoreader->GetWidth() - xoffset - xtail; x++) {
                             try {
@@ -514,21 +513,21 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
                     // this handles video sampling where we sample pixels from the image rather than scaling it and thus washing out the colours
                     int xneeded = buffer.BufferWi * sampleSpacing;
                     int yneeded = buffer.BufferHt * sampleSpacing;
-                    int imageWidthAfterCropping = ((100 - cropLeft + cropRight) * image->width) / 200;
-                    int imageHeightAferCropping = ((cropTop + 100 - cropBottom) * image->width) / 200;
-                    int startx = imageWidthAfterCropping / 2 - xneeded / 2 + (cropLeft * image->width) / 100;
-                    int starty = imageHeightAferCropping / 2 - yneeded / 2 + ((100 - cropTop) * image->height) / 100;
+                    int imageWidthAfterCropping = ((100 - cropLeft + cropRight) * image->_width) / 200;
+                    int imageHeightAferCropping = ((cropTop + 100 - cropBottom) * image->_width) / 200;
+                    int startx = imageWidthAfterCropping / 2 - xneeded / 2 + (cropLeft * image->_width) / 100;
+                    int starty = imageHeightAferCropping / 2 - yneeded / 2 + ((100 - cropTop) * image->_height) / 100;
 
                     int cury = starty;
                     xlColor c;
                     for (int y = 0; y < buffer.BufferHt; ++y)
                     {
-                        if (cury >= 0 && cury < image->height)
+                        if (cury >= 0 && cury < image->_height)
                         {
                             int curx = startx;
                             for (int x = 0; x < buffer.BufferWi; ++x) {
-                                if (curx >= 0 && curx < image->width) {
-                                    uint8_t* ptr = image->data[0] + (_videoreader->GetHeight() - 1 - cury) * _videoreader->GetWidth() * ch + curx * ch;
+                                if (curx >= 0 && curx < image->_width) {
+                                    const uint8_t* ptr = image->GetData() + (_videoreader->GetHeight() - 1 - cury) * _videoreader->GetWidth() * ch + curx * ch;
                                     try {
                                         c.Set(*(ptr),
                                               *(ptr + 1),
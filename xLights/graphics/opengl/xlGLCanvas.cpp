@@ -14,6 +14,7 @@
 #include "UtilFunctions.h"
 #include "../../ExternalHooks.h"
 #include "xlOGL3GraphicsContext.h"
+#include "../software/xlSoftwareGraphicsContext.h"
 
 BEGIN_EVENT_TABLE(xlGLCanvas, wxGLCanvas)
     EVT_SIZE(xlGLCanvas::Resized)
@@ -23,6 +24,7 @@ END_EVENT_TABLE()
 #include <wx/log.h>
 #include <wx/config.h>
 #include <wx/msgdlg.h>
+#include <wx/dcclient.h>
 #include <log4cpp/Category.hh>
 #include "../xlMesh.h"
 #include "DrawGLUtils.h"
@@ -77,6 +79,7 @@ static bool hasOpenGL3FramebufferObjects()
 static const int DEPTH_BUFFER_BITS[] = {32, 24, 16, 12, 10, 8};
 
 wxGLContext *xlGLCanvas::m_sharedContext = nullptr;
+bool xlGLCanvas::m_softwareRendering = false;
 
 static wxGLAttributes GetAttributes(int &zdepth, bool only2d) {
     DrawGLUtils::SetupDebugLogging();
@@ -262,6 +265,9 @@ xlGLCanvas::~xlGLCanvas()
         }
         delete m_context;
     }
+    if (m_softwareContext) {
+        delete m_softwareContext;
+    }
 }
 
 #ifdef __WXMSW__
@@ -387,15 +393,21 @@ void xlGLCanvas::DisplayWarning(const wxString& msg)
 
 wxImage* xlGLCanvas::GrabImage(wxSize size /*=wxSize(0,0)*/)
 {
-    if (m_context == nullptr)
-        return nullptr;
+    bool software = IsSoftwareRendering();
+    if (software) {
+        if (m_softwareContext == nullptr)
+            return nullptr;
+    } else {
+        if (m_context == nullptr)
+            return nullptr;
 
-    if (!m_context->SetCurrent(*this))
-        return nullptr;
+        if (!m_context->SetCurrent(*this))
+            return nullptr;
+    }
 
     int width = mWindowWidth * GetContentScaleFactor();
     int height = mWindowHeight * GetContentScaleFactor();
-    bool canScale = hasOpenGL3FramebufferObjects() && IsCoreProfile();
+    bool canScale = !software && hasOpenGL3FramebufferObjects() && IsCoreProfile();
     if (canScale && size != wxSize(0, 0)) {
         width = size.GetWidth();
         height = size.GetHeight();
@@ -408,10 +420,14 @@ wxImage* xlGLCanvas::GrabImage(wxSize size /*=wxSize(0,0)*/)
     GLubyte* tmpBuf = new GLubyte[width * 4 * height];
 
     GLint currentUnpackAlignment = 1;
-    glGetIntegerv(GL_UNPACK_ALIGNMENT, &currentUnpackAlignment);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (!software) {
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &currentUnpackAlignment);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
 
-    if (canScale) {
+    if (software) {
+        m_softwareContext->ReadPixels(0, 0, width, height, tmpBuf);
+    } else if (canScale) {
         GLuint fbID = 0, rbID = 0;
 
         glGenRenderbuffers(1, &rbID);
@@ -443,7 +459,9 @@ wxImage* xlGLCanvas::GrabImage(wxSize size /*=wxSize(0,0)*/)
         glReadBuffer(currentReadBuffer);
     }
 
-    glPixelStorei(GL_UNPACK_ALIGNMENT, currentUnpackAlignment);
+    if (!software) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, currentUnpackAlignment);
+    }
 
     // copying to wxImage
     wxSize dstSize = (canScale && size != wxSize(0, 0))
@@ -476,7 +494,11 @@ void xlGLCanvas::SetCurrentGLContext()
     if (m_context == nullptr) {
         LOG_GL_ERRORV(CreateGLContext());
         if (m_context == nullptr) {
-            if (!errorDisplayed) {
+            if (m_sharedContext == nullptr && !IsSoftwareRendering()) {
+                // OpenGL has never worked in this process so draw everything on the CPU instead
+                logger_opengl.error("Could not create GL context ... falling back to software rendering.");
+                SetSoftwareRendering(true);
+            } else if (!errorDisplayed) {
                 errorDisplayed = true;
                 logger_opengl.error("Could not create GL context ... aborting.");
                 wxMessageBox("Critical error preparing context to draw on. Likely you need to update your video drivers.");
@@ -622,8 +644,18 @@ xlGraphicsContext *xlGLCanvas::PrepareContextForDrawing() {
     return PrepareContextForDrawing(ClearBackgroundColor());
 }
 xlGraphicsContext* xlGLCanvas::PrepareContextForDrawing(const xlColor &bg) {
-    InitializeGLContext();
-    SetCurrentGLContext();
+    if (!IsSoftwareRendering()) {
+        InitializeGLContext();
+        SetCurrentGLContext();
+    }
+    if (IsSoftwareRendering()) {
+        if (m_softwareContext == nullptr) {
+            m_softwareContext = new xlSoftwareGraphicsContext(this);
+        }
+        double sf = GetContentScaleFactor();
+        m_softwareContext->StartFrame(mWindowWidth * sf, mWindowHeight * sf, sf, bg, is3d, RequiresDepthBuffer());
+        return m_softwareContext;
+    }
 
     float r = bg.red;
     float g = bg.green;
@@ -646,6 +678,25 @@ xlGraphicsContext* xlGLCanvas::PrepareContextForDrawing(const xlColor &bg) {
     return new xlOGL3GraphicsContext(this);
 }
 void xlGLCanvas::FinishDrawing(xlGraphicsContext* ctx, bool display) {
+    if (ctx != nullptr && ctx == m_softwareContext) {
+        // the software context is kept as the frame buffer needs to be available for export/grabbing
+        m_softwareContext->FinishFrame();
+        if (display) {
+            int w = m_softwareContext->GetFrameWidth();
+            int h = m_softwareContext->GetFrameHeight();
+            wxImage image(w, h, false);
+            unsigned char* dst = image.GetData();
+            const uint8_t* src = m_softwareContext->GetFrameData();
+            for (int x = 0; x < w * h; ++x, src += 4, dst += 3) {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+            }
+            wxClientDC dc(this);
+            dc.DrawBitmap(wxBitmap(image, -1, GetContentScaleFactor()), 0, 0);
+        }
+        return;
+    }
     if (display) {
         SwapBuffers();
     }
@@ -662,7 +713,11 @@ bool xlGLCanvas::getFrameForExport(int w, int h, AVFrame *, uint8_t *buffer, int
         return false;
     }
     uint8_t *tmpBuf = new uint8_t[w * 4 * h];
-    glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, tmpBuf);
+    if (m_softwareContext != nullptr && IsSoftwareRendering()) {
+        m_softwareContext->ReadPixels(0, 0, w, h, tmpBuf);
+    } else {
+        glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, tmpBuf);
+    }
 
     unsigned char *dst = buffer;
     if (padHeight) {
@@ -15,6 +15,7 @@
 
 
 class wxImage;
+class xlSoftwareGraphicsContext;
 
 extern "C" {
    struct AVFrame;
@@ -61,6 +62,12 @@ class xlGLCanvas
         bool IsCoreProfile() const { return isCoreProfile;}
         static wxGLContext *GetSharedContext() { return m_sharedContext; }
 
+        // Draw everything with the CPU rasterizer rather than OpenGL. This is process wide as models
+        // cache accumulators/textures created by whichever context they were first drawn with.
+        // It has to be chosen at startup (-sw) so a house preview video export only uses it if xLights was started that way.
+        static void SetSoftwareRendering(bool b) { m_softwareRendering = b; }
+        static bool IsSoftwareRendering() { return m_softwareRendering; }
+
         virtual xlColor ClearBackgroundColor() const { return xlBLACK; }
         virtual bool drawingUsingLogicalSize() const { return true; }
 
@@ -96,6 +103,8 @@ class xlGLCanvas
         int  m_zDepth = 0;
         bool isCoreProfile = false;
         std::map<GLuint, GLuint> vertexArrayIds;
+        xlSoftwareGraphicsContext* m_softwareContext = nullptr;
     
         static wxGLContext *m_sharedContext;
+        static bool m_softwareRendering;
 };
@@ -0,0 +1,1199 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "xlSoftwareGraphicsContext.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <list>
+
+#include <wx/bitmap.h>
+#include <wx/image.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../xlMesh.h"
+#include "../../Parallel.h"
+
+// rows of the frame buffer rasterized by each parallel job
+#define SW_BAND_HEIGHT 32
+
+class xlSoftwareTexture : public xlTexture {
+public:
+    xlSoftwareTexture(int w, int h) : xlTexture(), width(w), height(h) {
+        data.resize(w * h * 4);
+    }
+    xlSoftwareTexture(const wxImage &image) : xlTexture() {
+        width = image.GetWidth();
+        height = image.GetHeight();
+        data.resize(width * height * 4);
+
+        const uint8_t *rgb = image.GetData();
+        const uint8_t *alpha = image.HasAlpha() ? image.GetAlpha() : nullptr;
+        for (int x = 0; x < width * height; x++) {
+            data[x * 4] = rgb[x * 3];
+            data[x * 4 + 1] = rgb[x * 3 + 1];
+            data[x * 4 + 2] = rgb[x * 3 + 2];
+            data[x * 4 + 3] = alpha == nullptr ? 255 : alpha[x];
+        }
+    }
+    virtual ~xlSoftwareTexture() {}
+
+    virtual void UpdatePixel(int x, int y, const xlColor &c, bool copyAlpha) override {
+        if (x < 0 || y < 0 || x >= width || y >= height) {
+            return;
+        }
+        uint8_t *p = &data[(y * width + x) * 4];
+        p[0] = c.red;
+        p[1] = c.green;
+        p[2] = c.blue;
+        if (copyAlpha) {
+            p[3] = c.alpha;
+        }
+    }
+    virtual void UpdateData(uint8_t *d, bool bgr, bool alpha) override {
+        int bpp = alpha ? 4 : 3;
+        for (int x = 0; x < width * height; x++) {
+            const uint8_t *src = &d[x * bpp];
+            uint8_t *dst = &data[x * 4];
+            dst[0] = bgr ? src[2] : src[0];
+            dst[1] = src[1];
+            dst[2] = bgr ? src[0] : src[2];
+            dst[3] = alpha ? src[3] : 255;
+        }
+    }
+
+    // nearest texel as 0-1 floats
+    void Sample(float u, float v, bool repeat, float *out) const {
+        if (repeat) {
+            u -= std::floor(u);
+            v -= std::floor(v);
+        }
+        int x = std::clamp((int)(u * width), 0, width - 1);
+        int y = std::clamp((int)(v * height), 0, height - 1);
+        const uint8_t *p = &data[(y * width + x) * 4];
+        out[0] = p[0] / 255.0f;
+        out[1] = p[1] / 255.0f;
+        out[2] = p[2] / 255.0f;
+        out[3] = p[3] / 255.0f;
+    }
+
+    bool IsValid() const { return width > 0 && height > 0; }
+
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> data;
+};
+
+class xlSoftwareVertexAccumulator : public xlVertexAccumulator {
+public:
+    xlSoftwareVertexAccumulator() {}
+    virtual ~xlSoftwareVertexAccumulator() {}
+
+    virtual void Reset() override {
+        if (!finalized) {
+            count = 0;
+            vertices.resize(0);
+        }
+    }
+    virtual void PreAlloc(unsigned int i) override {
+        vertices.reserve(i * 3);
+    }
+    virtual void AddVertex(float x, float y, float z) override {
+        if (!finalized) {
+            vertices.emplace_back(x);
+            vertices.emplace_back(y);
+            vertices.emplace_back(z);
+            count++;
+        }
+    }
+    virtual uint32_t getCount() override {
+        return count;
+    }
+    virtual void Finalize(bool mc) override {
+        finalized = true;
+    }
+    virtual void SetVertex(uint32_t vertex, float x, float y, float z) override {
+        if (vertex < count) {
+            vertices[vertex * 3] = x;
+            vertices[vertex * 3 + 1] = y;
+            vertices[vertex * 3 + 2] = z;
+        }
+    }
+
+    uint32_t count = 0;
+    std::vector<float> vertices;
+    bool finalized = false;
+};
+
+class xlSoftwareVertexColorAccumulator : public xlVertexColorAccumulator {
+public:
+    xlSoftwareVertexColorAccumulator() {}
+    virtual ~xlSoftwareVertexColorAccumulator() {}
+
+    virtual uint32_t getCount() override {
+        return count;
+    }
+    virtual void Reset() override {
+        if (!finalized) {
+            count = 0;
+            vertices.resize(0);
+            colors.resize(0);
+        }
+    }
+    virtual void PreAlloc(unsigned int i) override {
+        vertices.reserve(i * 3);
+        colors.reserve(i);
+    }
+    virtual void AddVertex(float x, float y, float z, const xlColor &c) override {
+        if (!finalized) {
+            vertices.emplace_back(x);
+            vertices.emplace_back(y);
+            vertices.emplace_back(z);
+            colors.emplace_back(c);
+            count++;
+        }
+    }
+    virtual void Finalize(bool mcv, bool mcc) override {
+        finalized = true;
+    }
+    virtual void SetVertex(uint32_t vertex, float x, float y, float z, const xlColor &c) override {
+        if (vertex < count) {
+            vertices[vertex * 3] = x;
+            vertices[vertex * 3 + 1] = y;
+            vertices[vertex * 3 + 2] = z;
+            colors[vertex] = c;
+        }
+    }
+    virtual void SetVertex(uint32_t vertex, float x, float y, float z) override {
+        if (vertex < count) {
+            vertices[vertex * 3] = x;
+            vertices[vertex * 3 + 1] = y;
+            vertices[vertex * 3 + 2] = z;
+        }
+    }
+    virtual void SetVertex(uint32_t vertex, const xlColor &c) override {
+        if (vertex < count) {
+            colors[vertex] = c;
+        }
+    }
+
+    uint32_t count = 0;
+    std::vector<float> vertices;
+    std::vector<xlColor> colors;
+    bool finalized = false;
+};
+
+// nothing is uploaded anywhere so the colors are looked up when drawn rather than copied on Flush
+class xlSoftwareVertexIndexedColorAccumulator : public xlVertexIndexedColorAccumulator {
+public:
+    virtual void Reset() override {
+        vac.Reset();
+        colorIndexes.resize(0);
+    }
+    virtual void PreAlloc(unsigned int i) override {
+        vac.PreAlloc(i);
+        colorIndexes.reserve(i);
+    };
+    virtual void AddVertex(float x, float y, float z, uint32_t cIdx) override {
+        vac.AddVertex(x, y, z);
+        colorIndexes.push_back(cIdx);
+    }
+    virtual uint32_t getCount() override { return vac.getCount(); }
+
+    virtual void SetColorCount(int c) override {
+        colors.resize(c);
+    }
+    virtual uint32_t GetColorCount() override { return colors.size(); }
+    virtual void SetColor(uint32_t idx, const xlColor &c) override {
+        colors[idx] = c;
+    }
+
+    virtual void Finalize(bool mayChangeVertices, bool mayChangeColors) override {
+        vac.Finalize(mayChangeVertices);
+    }
+    virtual void SetVertex(uint32_t vertex, float x, float y, float z, uint32_t cIdx) override  {
+        vac.SetVertex(vertex, x, y, z);
+        colorIndexes[vertex] = cIdx;
+    }
+    virtual void SetVertex(uint32_t vertex, float x, float y, float z) override {
+        vac.SetVertex(vertex, x, y, z);
+    }
+    virtual void SetVertex(uint32_t vertex, uint32_t cIdx) override {
+        colorIndexes[vertex] = cIdx;
+    }
+
+    const xlColor &GetVertexColor(uint32_t vertex) const {
+        uint32_t idx = colorIndexes[vertex];
+        return idx < colors.size() ? colors[idx] : xlBLACK;
+    }
+
+    xlSoftwareVertexAccumulator vac;
+    std::vector<uint32_t> colorIndexes;
+    std::vector<xlColor> colors;
+};
+
+class xlSoftwareVertexTextureAccumulator : public xlVertexTextureAccumulator {
+public:
+    xlSoftwareVertexTextureAccumulator() {}
+    virtual ~xlSoftwareVertexTextureAccumulator() {}
+
+    virtual void Reset() override {
+        if (!finalized) {
+            count = 0;
+            vertices.resize(0);
+            tvertices.resize(0);
+        }
+    }
+    virtual void PreAlloc(unsigned int i) override {
+        vertices.reserve(i * 3);
+        tvertices.reserve(i * 2);
+    }
+    virtual void AddVertex(float x, float y, float z, float tx, float ty) override {
+        if (!finalized) {
+            vertices.emplace_back(x);
+            vertices.emplace_back(y);
+            vertices.emplace_back(z);
+            tvertices.emplace_back(tx);
+            tvertices.emplace_back(ty);
+            count++;
+        }
+    }
+    virtual uint32_t getCount() override {
+        return count;
+    }
+    virtual void Finalize(bool mcv, bool mct) override {
+        finalized = true;
+    }
+    virtual void SetVertex(uint32_t vertex, float x, float y, float z, float tx, float ty) override {
+        if (vertex < count) {
+            vertices[vertex * 3] = x;
+            vertices[vertex * 3 + 1] = y;
+            vertices[vertex * 3 + 2] = z;
+            tvertices[vertex * 2] = tx;
+            tvertices[vertex * 2 + 1] = ty;
+        }
+    }
+
+    uint32_t count = 0;
+    std::vector<float> vertices;
+    std::vector<float> tvertices;
+    bool finalized = false;
+};
+
+class xlSoftwareMesh : public xlMesh {
+public:
+    struct MeshVertex {
+        glm::vec3 position;
+        glm::vec3 normal;
+        float u, v;
+    };
+    class SubMesh {
+    public:
+        int material = 0;
+        bool points = false;
+        std::vector<MeshVertex> vertices;
+    };
+
+    xlSoftwareMesh(const std::string &file, xlSoftwareGraphicsContext *ctx) : xlMesh(ctx, file) {
+    }
+    virtual ~xlSoftwareMesh() {}
+
+    MeshVertex getVertex(const tinyobj::index_t &idx) const {
+        const auto &attrib = objects.GetAttrib();
+        MeshVertex mv;
+        mv.position = glm::vec3(attrib.vertices[idx.vertex_index * 3], attrib.vertices[idx.vertex_index * 3 + 1], attrib.vertices[idx.vertex_index * 3 + 2]);
+        if (idx.normal_index == -1) {
+            mv.normal = glm::vec3(0.0f);
+        } else {
+            mv.normal = glm::vec3(attrib.normals[idx.normal_index * 3], attrib.normals[idx.normal_index * 3 + 1], attrib.normals[idx.normal_index * 3 + 2]);
+        }
+        if (idx.texcoord_index == -1) {
+            mv.u = mv.v = 0;
+        } else {
+            mv.u = attrib.texcoords[idx.texcoord_index * 2];
+            mv.v = attrib.texcoords[idx.texcoord_index * 2 + 1];
+        }
+        return mv;
+    }
+    // same grouping of faces into runs of a single material as the OpenGL mesh
+    void Load() {
+        loaded = true;
+        SubMesh *lastMesh = nullptr;
+        for (auto &s : objects.GetShapes()) {
+            if (!s.mesh.indices.empty()) {
+                for (size_t idx = 0; idx < s.mesh.material_ids.size(); idx++) {
+                    if (lastMesh == nullptr || lastMesh->points || lastMesh->material != s.mesh.material_ids[idx]) {
+                        subMeshes.emplace_back();
+                        lastMesh = &subMeshes.back();
+                        lastMesh->material = s.mesh.material_ids[idx];
+                    }
+                    for (int v = 0; v < 3; v++) {
+                        lastMesh->vertices.push_back(getVertex(s.mesh.indices[idx * 3 + v]));
+                    }
+                }
+            }
+            for (auto &idx : s.lines.indices) {
+                lines.push_back(getVertex(idx));
+            }
+            if (!s.points.indices.empty()) {
+                subMeshes.emplace_back();
+                lastMesh = &subMeshes.back();
+                lastMesh->points = true;
+                lastMesh->material = -1;
+                for (auto &idx : s.points.indices) {
+                    lastMesh->vertices.push_back(getVertex(idx));
+                }
+            }
+        }
+    }
+
+    bool loaded = false;
+    std::list<SubMesh> subMeshes;
+    std::vector<MeshVertex> lines;
+};
+
+
+xlSoftwareGraphicsContext::xlSoftwareGraphicsContext(wxWindow *w) : xlGraphicsContext(w) {
+}
+xlSoftwareGraphicsContext::~xlSoftwareGraphicsContext() {
+}
+
+void xlSoftwareGraphicsContext::StartFrame(int w, int h, double sf, const xlColor &bg, bool depth, bool clearOn2D) {
+    width = std::max(w, 1);
+    height = std::max(h, 1);
+    scaleFactor = sf;
+    clearColor = bg;
+    depthTest = depth;
+    clearOn2DViewport = clearOn2D;
+    isBlending = false;
+    vpX = 0;
+    vpY = 0;
+    vpW = width;
+    vpH = height;
+    frameData.MVP = glm::mat4(1.0);
+    frameData.modelMatrix = glm::mat4(1.0);
+    frameData.viewMatrix = glm::mat4(1.0);
+    while (!matrixStack.empty()) {
+        matrixStack.pop();
+    }
+    clear();
+}
+
+void xlSoftwareGraphicsContext::clear() {
+    // anything drawn so far would be overwritten so it doesn't need to be rasterized
+    primitives.clear();
+    frameBuffer.resize(width * height * 4);
+    depthBuffer.resize(width * height);
+    uint32_t c = clearColor.GetRGBA();
+    uint32_t *fb = (uint32_t*)frameBuffer.data();
+    std::fill(fb, fb + width * height, c);
+    std::fill(depthBuffer.begin(), depthBuffer.end(), 1.0f);
+}
+
+void xlSoftwareGraphicsContext::FinishFrame() {
+    int bands = (height + SW_BAND_HEIGHT - 1) / SW_BAND_HEIGHT;
+    parallel_for(0, bands, [this](int band) {
+        int y1 = band * SW_BAND_HEIGHT;
+        rasterize(y1, std::min(y1 + SW_BAND_HEIGHT, height));
+    });
+    primitives.clear();
+}
+
+void xlSoftwareGraphicsContext::ReadPixels(int x, int y, int w, int h, uint8_t *data) const {
+    for (int row = 0; row < h; row++) {
+        uint8_t *dst = &data[row * w * 4];
+        int fy = height - 1 - (y + row);
+        for (int col = 0; col < w; col++, dst += 4) {
+            int fx = x + col;
+            if (fy < 0 || fy >= height || fx < 0 || fx >= width) {
+                dst[0] = dst[1] = dst[2] = 0;
+                dst[3] = 255;
+            } else {
+                memcpy(dst, &frameBuffer[(fy * width + fx) * 4], 4);
+            }
+        }
+    }
+}
+
+xlVertexAccumulator *xlSoftwareGraphicsContext::createVertexAccumulator() {
+    return new xlSoftwareVertexAccumulator();
+}
+xlVertexColorAccumulator *xlSoftwareGraphicsContext::createVertexColorAccumulator() {
+    return new xlSoftwareVertexColorAccumulator();
+}
+xlVertexTextureAccumulator *xlSoftwareGraphicsContext::createVertexTextureAccumulator() {
+    return new xlSoftwareVertexTextureAccumulator();
+}
+xlVertexIndexedColorAccumulator *xlSoftwareGraphicsContext::createVertexIndexedColorAccumulator() {
+    return new xlSoftwareVertexIndexedColorAccumulator();
+}
+xlTexture *xlSoftwareGraphicsContext::createTextureMipMaps(const std::vector<wxBitmap> &bitmaps, const std::string &name) {
+    // no mip maps, sampling is nearest texel so the largest image is all we need
+    xlTexture *t = new xlSoftwareTexture(bitmaps[0].ConvertToImage());
+    t->SetName(name);
+    return t;
+}
+xlTexture *xlSoftwareGraphicsContext::createTextureMipMaps(const std::vector<wxImage> &images, const std::string &name) {
+    xlTexture *t = new xlSoftwareTexture(images[0]);
+    t->SetName(name);
+    return t;
+}
+xlTexture *xlSoftwareGraphicsContext::createTexture(const wxImage &image, const std::string &name, bool finalize) {
+    xlTexture *t = new xlSoftwareTexture(image);
+    if (!name.empty()) {
+        t->SetName(name);
+    }
+    if (finalize) {
+        t->Finalize();
+    }
+    return t;
+}
+xlTexture *xlSoftwareGraphicsContext::createTexture(int w, int h, bool bgr, bool alpha) {
+    return new xlSoftwareTexture(w, h);
+}
+xlTexture *xlSoftwareGraphicsContext::createTextureForFont(const xlFontInfo &font) {
+    return createTexture(font.getImage(), "Font-" + std::to_string(font.getSize()));
+}
+xlGraphicsProgram *xlSoftwareGraphicsContext::createGraphicsProgram() {
+    return new xlGraphicsProgram(createVertexColorAccumulator());
+}
+xlMesh *xlSoftwareGraphicsContext::loadMeshFromObjFile(const std::string &file) {
+    return new xlSoftwareMesh(file, this);
+}
+
+
+xlSoftwareGraphicsContext::ClipVertex xlSoftwareGraphicsContext::transform(const glm::mat4 &m, float x, float y, float z, const xlColor &c) const {
+    ClipVertex v;
+    v.pos = m * glm::vec4(x, y, z, 1.0f);
+    v.r = c.red / 255.0f;
+    v.g = c.green / 255.0f;
+    v.b = c.blue / 255.0f;
+    v.a = c.alpha / 255.0f;
+    v.u = v.v = 0;
+    return v;
+}
+
+xlSoftwareGraphicsContext::Vertex xlSoftwareGraphicsContext::toWindow(const ClipVertex &c) const {
+    Vertex v;
+    v.invW = 1.0f / c.pos.w;
+    float nx = c.pos.x * v.invW;
+    float ny = c.pos.y * v.invW;
+    v.z = c.pos.z * v.invW;
+    v.x = vpX + (nx + 1.0f) * 0.5f * vpW;
+    // frame buffer rows are top down, OpenGL window coordinates are bottom up
+    v.y = height - (vpY + (ny + 1.0f) * 0.5f * vpH);
+    v.r = c.r;
+    v.g = c.g;
+    v.b = c.b;
+    v.a = c.a;
+    v.u = c.u;
+    v.v = c.v;
+    return v;
+}
+
+static xlSoftwareGraphicsContext::ClipVertex lerp(const xlSoftwareGraphicsContext::ClipVertex &a, const xlSoftwareGraphicsContext::ClipVertex &b, float t) {
+    xlSoftwareGraphicsContext::ClipVertex v;
+    v.pos = a.pos + (b.pos - a.pos) * t;
+    v.r = a.r + (b.r - a.r) * t;
+    v.g = a.g + (b.g - a.g) * t;
+    v.b = a.b + (b.b - a.b) * t;
+    v.a = a.a + (b.a - a.a) * t;
+    v.u = a.u + (b.u - a.u) * t;
+    v.v = a.v + (b.v - a.v) * t;
+    return v;
+}
+// distance inside the near clip plane
+static inline float nearDistance(const xlSoftwareGraphicsContext::ClipVertex &v) {
+    return v.pos.z + v.pos.w;
+}
+
+void xlSoftwareGraphicsContext::addTriangle(const ClipVertex &v1, const ClipVertex &v2, const ClipVertex &v3, const xlSoftwareTexture *texture, int textureMode, bool repeat) {
+    float d1 = nearDistance(v1);
+    float d2 = nearDistance(v2);
+    float d3 = nearDistance(v3);
+    if (d1 >= 0 && d2 >= 0 && d3 >= 0) {
+        addWindowTriangle(toWindow(v1), toWindow(v2), toWindow(v3), texture, textureMode, repeat);
+        return;
+    }
+    if (d1 < 0 && d2 < 0 && d3 < 0) {
+        return;
+    }
+    // clip against the near plane, then fan out the resulting polygon
+    const ClipVertex *in[3] = { &v1, &v2, &v3 };
+    float d[3] = { d1, d2, d3 };
+    ClipVertex out[4];
+    int count = 0;
+    for (int x = 0; x < 3; x++) {
+        int n = (x + 1) % 3;
+        if (d[x] >= 0) {
+            out[count++] = *in[x];
+        }
+        if ((d[x] >= 0) != (d[n] >= 0)) {
+            out[count++] = lerp(*in[x], *in[n], d[x] / (d[x] - d[n]));
+        }
+    }
+    Vertex first = toWindow(out[0]);
+    Vertex prev = toWindow(out[1]);
+    for (int x = 2; x < count; x++) {
+        Vertex cur = toWindow(out[x]);
+        addWindowTriangle(first, prev, cur, texture, textureMode, repeat);
+        prev = cur;
+    }
+}
+
+void xlSoftwareGraphicsContext::addWindowTriangle(const Vertex &v1, const Vertex &v2, const Vertex &v3, const xlSoftwareTexture *texture, int textureMode, bool repeat) {
+    Primitive p;
+    p.type = PrimitiveType::TRIANGLE;
+    p.blend = isBlending;
+    p.depthTest = depthTest;
+    p.smooth = false;
+    p.repeat = repeat;
+    p.textureMode = textureMode;
+    p.texture = texture;
+    p.pointSize = 0;
+    p.v[0] = v1;
+    p.v[1] = v2;
+    p.v[2] = v3;
+    p.minX = std::min(v1.x, std::min(v2.x, v3.x));
+    p.maxX = std::max(v1.x, std::max(v2.x, v3.x));
+    p.minY = std::min(v1.y, std::min(v2.y, v3.y));
+    p.maxY = std::max(v1.y, std::max(v2.y, v3.y));
+    if (p.maxX < 0 || p.maxY < 0 || p.minX >= width || p.minY >= height) {
+        return;
+    }
+    primitives.push_back(p);
+}
+
+void xlSoftwareGraphicsContext::addLine(const ClipVertex &v1, const ClipVertex &v2) {
+    ClipVertex c1 = v1;
+    ClipVertex c2 = v2;
+    float d1 = nearDistance(c1);
+    float d2 = nearDistance(c2);
+    if (d1 < 0 && d2 < 0) {
+        return;
+    }
+    if (d1 < 0) {
+        c1 = lerp(c1, c2, d1 / (d1 - d2));
+    } else if (d2 < 0) {
+        c2 = lerp(c1, c2, d1 / (d1 - d2));
+    }
+    Vertex w1 = toWindow(c1);
+    Vertex w2 = toWindow(c2);
+
+    // one pixel wide lines are drawn as a thin quad
+    float dx = w2.x - w1.x;
+    float dy = w2.y - w1.y;
+    float len = std::sqrt(dx * dx + dy * dy);
+    if (len < 0.0001f) {
+        dx = 1.0f;
+        dy = 0.0f;
+        len = 1.0f;
+    }
+    float nx = -dy / len * 0.5f;
+    float ny = dx / len * 0.5f;
+    Vertex a = w1, b = w1, c = w2, d = w2;
+    a.x += nx; a.y += ny;
+    b.x -= nx; b.y -= ny;
+    c.x += nx; c.y += ny;
+    d.x -= nx; d.y -= ny;
+    addWindowTriangle(a, b, c, nullptr, 0, false);
+    addWindowTriangle(b, d, c, nullptr, 0, false);
+}
+
+void xlSoftwareGraphicsContext::addPoint(const ClipVertex &c, float pointSize, bool smooth) {
+    if (nearDistance(c) < 0) {
+        return;
+    }
+    Primitive p;
+    p.type = PrimitiveType::POINT;
+    p.blend = isBlending;
+    p.depthTest = depthTest;
+    p.smooth = smooth;
+    p.repeat = false;
+    p.textureMode = 0;
+    p.texture = nullptr;
+    // smooth points are drawn one pixel larger and faded out at the edge just like the shaders
+    p.pointSize = smooth ? pointSize + 1 : std::max(1.0f, std::round(pointSize));
+    p.v[0] = toWindow(c);
+    float half = p.pointSize / 2.0f;
+    p.minX = p.v[0].x - half;
+    p.maxX = p.v[0].x + half;
+    p.minY = p.v[0].y - half;
+    p.maxY = p.v[0].y + half;
+    if (p.maxX < 0 || p.maxY < 0 || p.minX >= width || p.minY >= height) {
+        return;
+    }
+    primitives.push_back(p);
+}
+
+
+enum class SWPrimitive {
+    LINES,
+    LINE_STRIP,
+    TRIANGLES,
+    TRIANGLE_STRIP,
+    POINTS
+};
+
+template <typename F>
+static void drawArrays(xlSoftwareGraphicsContext *ctx, SWPrimitive type, uint32_t total, int start, int count, float pointSize, bool smooth, F &&vertex) {
+    if (start < 0 || (uint32_t)start >= total) {
+        return;
+    }
+    uint32_t c = count < 0 ? total - start : std::min((uint32_t)count, total - start);
+    uint32_t end = start + c;
+    switch (type) {
+    case SWPrimitive::LINES:
+        for (uint32_t x = start; x + 1 < end; x += 2) {
+            ctx->addLine(vertex(x), vertex(x + 1));
+        }
+        break;
+    case SWPrimitive::LINE_STRIP:
+        for (uint32_t x = start; x + 1 < end; x++) {
+            ctx->addLine(vertex(x), vertex(x + 1));
+        }
+        break;
+    case SWPrimitive::TRIANGLES:
+        for (uint32_t x = start; x + 2 < end; x += 3) {
+            ctx->addTriangle(vertex(x), vertex(x + 1), vertex(x + 2));
+        }
+        break;
+    case SWPrimitive::TRIANGLE_STRIP:
+        for (uint32_t x = start; x + 2 < end; x++) {
+            ctx->addTriangle(vertex(x), vertex(x + 1), vertex(x + 2));
+        }
+        break;
+    case SWPrimitive::POINTS:
+        for (uint32_t x = start; x < end; x++) {
+            ctx->addPoint(vertex(x), pointSize, smooth);
+        }
+        break;
+    }
+}
+
+static void drawArrays(xlSoftwareGraphicsContext *ctx, SWPrimitive type, xlVertexAccumulator *vac, const xlColor &c, int start, int count, float pointSize = 1, bool smooth = false) {
+    xlSoftwareVertexAccumulator *va = dynamic_cast<xlSoftwareVertexAccumulator*>(vac);
+    const glm::mat4 &mvp = ctx->getMVP();
+    drawArrays(ctx, type, va->count, start, count, pointSize, smooth, [&](uint32_t x) {
+        return ctx->transform(mvp, va->vertices[x * 3], va->vertices[x * 3 + 1], va->vertices[x * 3 + 2], c);
+    });
+}
+static void drawArrays(xlSoftwareGraphicsContext *ctx, SWPrimitive type, xlVertexColorAccumulator *vac, int start, int count, float pointSize = 1, bool smooth = false) {
+    xlSoftwareVertexColorAccumulator *va = dynamic_cast<xlSoftwareVertexColorAccumulator*>(vac);
+    const glm::mat4 &mvp = ctx->getMVP();
+    drawArrays(ctx, type, va->count, start, count, pointSize, smooth, [&](uint32_t x) {
+        return ctx->transform(mvp, va->vertices[x * 3], va->vertices[x * 3 + 1], va->vertices[x * 3 + 2], va->colors[x]);
+    });
+}
+static void drawArrays(xlSoftwareGraphicsContext *ctx, SWPrimitive type, xlVertexIndexedColorAccumulator *vac, int start, int count, float pointSize = 1, bool smooth = false) {
+    xlSoftwareVertexIndexedColorAccumulator *va = dynamic_cast<xlSoftwareVertexIndexedColorAccumulator*>(vac);
+    const glm::mat4 &mvp = ctx->getMVP();
+    const std::vector<float> &vertices = va->vac.vertices;
+    drawArrays(ctx, type, va->vac.count, start, count, pointSize, smooth, [&](uint32_t x) {
+        return ctx->transform(mvp, vertices[x * 3], vertices[x * 3 + 1], vertices[x * 3 + 2], va->GetVertexColor(x));
+    });
+}
+
+//drawing methods
+xlGraphicsContext* xlSoftwareGraphicsContext::drawLines(xlVertexAccumulator *vac, const xlColor &c, int start, int count) {
+    drawArrays(this, SWPrimitive::LINES, vac, c, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawLineStrip(xlVertexAccumulator *vac, const xlColor &c, int start, int count) {
+    drawArrays(this, SWPrimitive::LINE_STRIP, vac, c, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawTriangles(xlVertexAccumulator *vac, const xlColor &c, int start, int count) {
+    drawArrays(this, SWPrimitive::TRIANGLES, vac, c, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawTriangleStrip(xlVertexAccumulator *vac, const xlColor &c, int start, int count) {
+    drawArrays(this, SWPrimitive::TRIANGLE_STRIP, vac, c, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawPoints(xlVertexAccumulator *vac, const xlColor &c, float pointSize, bool smoothPoints, int start, int count) {
+    drawArrays(this, SWPrimitive::POINTS, vac, c, start, count, pointSize, smoothPoints);
+    return this;
+}
+
+xlGraphicsContext* xlSoftwareGraphicsContext::drawLines(xlVertexColorAccumulator *vac, int start, int count) {
+    drawArrays(this, SWPrimitive::LINES, vac, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawLineStrip(xlVertexColorAccumulator *vac, int start, int count) {
+    drawArrays(this, SWPrimitive::LINE_STRIP, vac, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawTriangles(xlVertexColorAccumulator *vac, int start, int count) {
+    drawArrays(this, SWPrimitive::TRIANGLES, vac, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawTriangleStrip(xlVertexColorAccumulator *vac, int start, int count) {
+    drawArrays(this, SWPrimitive::TRIANGLE_STRIP, vac, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawPoints(xlVertexColorAccumulator *vac, float pointSize, bool smoothPoints, int start, int count) {
+    drawArrays(this, SWPrimitive::POINTS, vac, start, count, pointSize, smoothPoints);
+    return this;
+}
+
+xlGraphicsContext* xlSoftwareGraphicsContext::drawLines(xlVertexIndexedColorAccumulator *vac, int start, int count) {
+    drawArrays(this, SWPrimitive::LINES, vac, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawLineStrip(xlVertexIndexedColorAccumulator *vac, int start, int count) {
+    drawArrays(this, SWPrimitive::LINE_STRIP, vac, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawTriangles(xlVertexIndexedColorAccumulator *vac, int start, int count) {
+    drawArrays(this, SWPrimitive::TRIANGLES, vac, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawTriangleStrip(xlVertexIndexedColorAccumulator *vac, int start, int count) {
+    drawArrays(this, SWPrimitive::TRIANGLE_STRIP, vac, start, count);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawPoints(xlVertexIndexedColorAccumulator *vac, float pointSize, bool smoothPoints, int start, int count) {
+    drawArrays(this, SWPrimitive::POINTS, vac, start, count, pointSize, smoothPoints);
+    return this;
+}
+
+xlGraphicsContext* xlSoftwareGraphicsContext::drawTexture(xlTexture *texture,
+                                                          float x, float y, float x2, float y2,
+                                                          float tx, float ty, float tx2, float ty2,
+                                                          bool nearest,
+                                                          int brightness, int alpha) {
+    xlSoftwareVertexTextureAccumulator va;
+    va.PreAlloc(6);
+
+    va.AddVertex(x, y, 0, tx, ty);
+    va.AddVertex(x, y2, 0, tx, ty2);
+    va.AddVertex(x2, y2, 0, tx2, ty2);
+    va.AddVertex(x, y, 0, tx, ty);
+    va.AddVertex(x2, y2, 0, tx2, ty2);
+    va.AddVertex(x2, y, 0, tx2, ty);
+    return drawTexture(&va, texture, brightness, alpha, 0, 6);
+}
+
+static void drawTextureArrays(xlSoftwareGraphicsContext *ctx, xlVertexTextureAccumulator *vac, xlTexture *texture, const xlColor &c, int textureMode, int start, int count) {
+    xlSoftwareVertexTextureAccumulator *va = dynamic_cast<xlSoftwareVertexTextureAccumulator*>(vac);
+    xlSoftwareTexture *t = (xlSoftwareTexture*)texture;
+    if (t == nullptr || !t->IsValid() || start < 0 || (uint32_t)start >= va->count) {
+        return;
+    }
+    uint32_t end = count < 0 ? va->count : std::min(va->count, (uint32_t)(start + count));
+    const glm::mat4 &mvp = ctx->getMVP();
+    auto vertex = [&](uint32_t x) {
+        xlSoftwareGraphicsContext::ClipVertex v = ctx->transform(mvp, va->vertices[x * 3], va->vertices[x * 3 + 1], va->vertices[x * 3 + 2], c);
+        v.u = va->tvertices[x * 2];
+        v.v = va->tvertices[x * 2 + 1];
+        return v;
+    };
+    for (uint32_t x = start; x + 2 < end; x += 3) {
+        ctx->addTriangle(vertex(x), vertex(x + 1), vertex(x + 2), t, textureMode, false);
+    }
+}
+
+xlGraphicsContext* xlSoftwareGraphicsContext::drawTexture(xlVertexTextureAccumulator *vac, xlTexture *texture, int brightness, uint8_t alpha, int start, int count) {
+    // brightness can be over 100 so go via floats rather than an xlColor
+    xlColor c(255, 255, 255, alpha);
+    size_t first = primitives.size();
+    drawTextureArrays(this, vac, texture, c, 0, start, count);
+    float b = brightness / 100.0f;
+    for (size_t x = first; x < primitives.size(); x++) {
+        for (auto &v : primitives[x].v) {
+            v.r = v.g = v.b = b;
+        }
+    }
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawTexture(xlVertexTextureAccumulator *vac, xlTexture *texture, const xlColor &c, int start, int count) {
+    drawTextureArrays(this, vac, texture, c, 1, start, count);
+    return this;
+}
+
+
+void xlSoftwareGraphicsContext::drawMesh(xlMesh *mesh, int brightness, bool useViewMatrix, bool transparents) {
+    xlSoftwareMesh *swm = (xlSoftwareMesh*)mesh;
+    if (!swm->loaded) {
+        swm->Load();
+    }
+    float b = brightness / 100.0f;
+    glm::mat4 vm = useViewMatrix ? frameData.viewMatrix * frameData.modelMatrix : frameData.modelMatrix;
+    glm::vec3 light = glm::normalize(glm::vec3(0.1f, 0.1f, 1.0f));
+
+    // same lighting as the mesh shaders, just done per vertex
+    auto shade = [&](const xlSoftwareMesh::MeshVertex &mv) {
+        glm::vec3 n = glm::vec3(vm * glm::vec4(mv.normal, 0.0f));
+        float len = glm::length(n);
+        float cosTheta = 1.0f;
+        if (len > 0.0f) {
+            cosTheta = std::abs(std::clamp(glm::dot(n / len, light), -1.0f, 1.0f));
+        }
+        return cosTheta * 0.75f + 0.25f;
+    };
+
+    for (auto &sm : swm->subMeshes) {
+        int mid = sm.material;
+
+        bool output = mid < 0 || swm->GetMaterial(mid).color.alpha == 255;
+        if (transparents) {
+            output = mid > 0 && swm->GetMaterial(mid).color.alpha != 255;
+        }
+        if (!output) {
+            continue;
+        }
+        bool solid = mid < 0 || !swm->GetMaterial(mid).texture || swm->GetMaterial(mid).forceColor;
+        xlColor color = mid < 0 ? xlWHITE : swm->GetMaterial(mid).color;
+        xlSoftwareTexture *t = solid ? nullptr : (xlSoftwareTexture*)swm->GetMaterial(mid).texture;
+
+        auto vertex = [&](const xlSoftwareMesh::MeshVertex &mv) {
+            ClipVertex v = transform(frameData.MVP, mv.position.x, mv.position.y, mv.position.z, color);
+            float s = shade(mv) * b;
+            if (solid) {
+                v.r *= s;
+                v.g *= s;
+                v.b *= s;
+            } else {
+                v.r = v.g = v.b = s;
+                v.a = 1.0f;
+                v.u = mv.u;
+                v.v = mv.v;
+            }
+            return v;
+        };
+        if (sm.points) {
+            for (auto &mv : sm.vertices) {
+                addPoint(vertex(mv), 1.0f, false);
+            }
+        } else {
+            for (size_t x = 0; x + 2 < sm.vertices.size(); x += 3) {
+                addTriangle(vertex(sm.vertices[x]), vertex(sm.vertices[x + 1]), vertex(sm.vertices[x + 2]), t, 0, true);
+            }
+        }
+    }
+    if (!transparents) {
+        for (size_t x = 0; x + 1 < swm->lines.size(); x += 2) {
+            const auto &p1 = swm->lines[x].position;
+            const auto &p2 = swm->lines[x + 1].position;
+            addLine(transform(frameData.MVP, p1.x, p1.y, p1.z, xlBLACK), transform(frameData.MVP, p2.x, p2.y, p2.z, xlBLACK));
+        }
+    }
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawMeshSolids(xlMesh *mesh, int brightness, bool useViewMatrix) {
+    drawMesh(mesh, brightness, useViewMatrix, false);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawMeshTransparents(xlMesh *mesh, int brightness) {
+    drawMesh(mesh, brightness, false, true);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::drawMeshWireframe(xlMesh *mesh, int brightness) {
+    xlSoftwareMesh *swm = (xlSoftwareMesh*)mesh;
+    if (!swm->loaded) {
+        swm->Load();
+    }
+    xlColor c(0, std::min(255, brightness * 255 / 100), 0);
+    for (auto &sm : swm->subMeshes) {
+        if (sm.points) {
+            continue;
+        }
+        for (size_t x = 0; x + 2 < sm.vertices.size(); x += 3) {
+            ClipVertex v[3];
+            for (int i = 0; i < 3; i++) {
+                const auto &p = sm.vertices[x + i].position;
+                v[i] = transform(frameData.MVP, p.x, p.y, p.z, c);
+            }
+            addLine(v[0], v[1]);
+            addLine(v[1], v[2]);
+            addLine(v[2], v[0]);
+        }
+    }
+    return this;
+}
+
+xlGraphicsContext* xlSoftwareGraphicsContext::enableBlending(bool e) {
+    isBlending = e;
+    return this;
+}
+
+// Setup the Viewport
+xlGraphicsContext* xlSoftwareGraphicsContext::SetViewport(int topleft_x, int topleft_y, int bottomright_x, int bottomright_y, bool is3D) {
+    frameData.modelMatrix = glm::mat4(1.0);
+    frameData.viewMatrix = glm::mat4(1.0);
+    if (is3D) {
+        float x = scaleFactor * topleft_x;
+        float y = scaleFactor * bottomright_y;
+        float x2 = scaleFactor * bottomright_x;
+        float y2 = scaleFactor * topleft_y;
+        vpX = x;
+        vpY = y;
+        vpW = x2 - x;
+        vpH = y2 - y;
+
+        // the depth buffer is always full float precision so the closer near plane is fine
+        frameData.MVP = glm::perspective(glm::radians(45.0f), (float) (bottomright_x-topleft_x) / (float)(topleft_y-bottomright_y), 1.0f, 200000.0f);
+
+        clearColor = xlColor(0, 0, 0, 0);
+        depthTest = true;
+        clear();
+    } else {
+        float x = scaleFactor * topleft_x;
+        float y = scaleFactor * std::min(bottomright_y, topleft_y);
+        float x2 = scaleFactor * bottomright_x;
+        float y2 = scaleFactor * std::max(bottomright_y, topleft_y);
+        vpX = std::min(x, x2);
+        vpY = y;
+        vpW = std::max(x, x2) - std::min(x, x2);
+        vpH = y2 - y;
+        frameData.MVP = glm::ortho((float)topleft_x, (float)bottomright_x, (float)bottomright_y, (float)topleft_y);
+
+        if (clearOn2DViewport) {
+            depthTest = true;
+            clear();
+        }
+    }
+    return this;
+}
+
+//manipulating the matrices
+xlGraphicsContext* xlSoftwareGraphicsContext::PushMatrix() {
+    matrixStack.push(frameData.MVP);
+    matrixStack.push(frameData.viewMatrix);
+    matrixStack.push(frameData.modelMatrix);
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::PopMatrix() {
+    if (!matrixStack.empty()) {
+        frameData.modelMatrix = matrixStack.top();
+        matrixStack.pop();
+        frameData.viewMatrix = matrixStack.top();
+        matrixStack.pop();
+        frameData.MVP = matrixStack.top();
+        matrixStack.pop();
+    }
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::Translate(float x, float y, float z) {
+    frameData.MVP = glm::translate(frameData.MVP, glm::vec3(x, y, z));
+    frameData.modelMatrix = glm::translate(frameData.modelMatrix, glm::vec3(x, y, z));
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::Rotate(float angle, float x, float y, float z) {
+    angle = angle * 3.14159f/180.0f;
+    frameData.MVP = glm::rotate(frameData.MVP, angle, glm::vec3(x, y, z));
+    frameData.modelMatrix = glm::rotate(frameData.modelMatrix, angle, glm::vec3(x, y, z));
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::Scale(float w, float h, float z) {
+    frameData.MVP = glm::scale(frameData.MVP, glm::vec3(w, h, z));
+    frameData.modelMatrix = glm::scale(frameData.modelMatrix, glm::vec3(w, h, z));
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::ScaleViewMatrix(float w, float h, float z) {
+    frameData.MVP = glm::scale(frameData.MVP, glm::vec3(w, h, z));
+    frameData.viewMatrix = glm::scale(frameData.viewMatrix, glm::vec3(w, h, z));
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::TranslateViewMatrix(float x, float y, float z) {
+    frameData.MVP = glm::translate(frameData.MVP, glm::vec3(x, y, z));
+    frameData.viewMatrix = glm::translate(frameData.viewMatrix, glm::vec3(x, y, z));
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::SetCamera(const glm::mat4 &m) {
+    frameData.MVP = frameData.MVP * m;
+    frameData.viewMatrix = frameData.viewMatrix * m;
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::SetModelMatrix(const glm::mat4 &m) {
+    frameData.MVP = frameData.MVP * m;
+    frameData.modelMatrix = m;
+    return this;
+}
+xlGraphicsContext* xlSoftwareGraphicsContext::ApplyMatrix(const glm::mat4 &m) {
+    frameData.MVP = frameData.MVP * m;
+    frameData.modelMatrix = frameData.modelMatrix * m;
+    return this;
+}
+
+
+static inline uint8_t toByte(float f) {
+    return (uint8_t)std::clamp((int)(f * 255.0f + 0.5f), 0, 255);
+}
+
+// Writes a fragment subject to the depth test and blending state of the primitive
+static inline void writeFragment(uint8_t *fb, float *depth, float z, const xlSoftwareGraphicsContext::Primitive &p, float r, float g, float b, float a) {
+    if (z < -1.0f || z > 1.0f) {
+        return;
+    }
+    if (p.depthTest) {
+        if (z > *depth) {
+            return;
+        }
+        *depth = z;
+    }
+    if (p.blend) {
+        float ia = 1.0f - a;
+        fb[0] = toByte(r * a + fb[0] / 255.0f * ia);
+        fb[1] = toByte(g * a + fb[1] / 255.0f * ia);
+        fb[2] = toByte(b * a + fb[2] / 255.0f * ia);
+        fb[3] = toByte(a * a + fb[3] / 255.0f * ia);
+    } else {
+        fb[0] = toByte(r);
+        fb[1] = toByte(g);
+        fb[2] = toByte(b);
+        fb[3] = toByte(a);
+    }
+}
+
+static inline float edge(const xlSoftwareGraphicsContext::Vertex &a, const xlSoftwareGraphicsContext::Vertex &b, float x, float y) {
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+// top left fill convention so pixels on shared edges are only drawn once
+static inline bool isTopLeft(const xlSoftwareGraphicsContext::Vertex &a, const xlSoftwareGraphicsContext::Vertex &b) {
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    return (dy == 0.0f && dx > 0.0f) || dy < 0.0f;
+}
+
+void xlSoftwareGraphicsContext::rasterizeTriangle(const Primitive &p, int y1, int y2) {
+    const Vertex *v0 = &p.v[0];
+    const Vertex *v1 = &p.v[1];
+    const Vertex *v2 = &p.v[2];
+    float area = edge(*v0, *v1, v2->x, v2->y);
+    if (std::abs(area) < 0.00001f) {
+        return;
+    }
+    if (area < 0) {
+        std::swap(v1, v2);
+        area = -area;
+    }
+    bool tl0 = isTopLeft(*v1, *v2);
+    bool tl1 = isTopLeft(*v2, *v0);
+    bool tl2 = isTopLeft(*v0, *v1);
+
+    int minX = std::max(0, (int)std::floor(p.minX));
+    int maxX = std::min(width - 1, (int)std::ceil(p.maxX));
+    int minY = std::max(y1, (int)std::floor(p.minY));
+    int maxY = std::min(y2 - 1, (int)std::ceil(p.maxY));
+
+    float invArea = 1.0f / area;
+    for (int y = minY; y <= maxY; y++) {
+        float py = y + 0.5f;
+        uint8_t *fbRow = &frameBuffer[y * width * 4];
+        float *depthRow = &depthBuffer[y * width];
+        for (int x = minX; x <= maxX; x++) {
+            float px = x + 0.5f;
+            float w0 = edge(*v1, *v2, px, py);
+            float w1 = edge(*v2, *v0, px, py);
+            float w2 = edge(*v0, *v1, px, py);
+            if (w0 < 0 || w1 < 0 || w2 < 0) {
+                continue;
+            }
+            if ((w0 == 0 && !tl0) || (w1 == 0 && !tl1) || (w2 == 0 && !tl2)) {
+                continue;
+            }
+            float b0 = w0 * invArea;
+            float b1 = w1 * invArea;
+            float b2 = w2 * invArea;
+            float z = b0 * v0->z + b1 * v1->z + b2 * v2->z;
+
+            // perspective correct attributes
+            float p0 = b0 * v0->invW;
+            float p1 = b1 * v1->invW;
+            float p2 = b2 * v2->invW;
+            float ip = 1.0f / (p0 + p1 + p2);
+            p0 *= ip;
+            p1 *= ip;
+            p2 *= ip;
+            float r = p0 * v0->r + p1 * v1->r + p2 * v2->r;
+            float g = p0 * v0->g + p1 * v1->g + p2 * v2->g;
+            float b = p0 * v0->b + p1 * v1->b + p2 * v2->b;
+            float a = p0 * v0->a + p1 * v1->a + p2 * v2->a;
+            if (p.texture) {
+                float tex[4];
+                p.texture->Sample(p0 * v0->u + p1 * v1->u + p2 * v2->u,
+                                  p0 * v0->v + p1 * v1->v + p2 * v2->v,
+                                  p.repeat, tex);
+                if (p.textureMode == 0) {
+                    r *= tex[0];
+                    g *= tex[1];
+                    b *= tex[2];
+                }
+                a *= tex[3];
+            }
+            writeFragment(&fbRow[x * 4], &depthRow[x], z, p, r, g, b, a);
+        }
+    }
+}
+
+void xlSoftwareGraphicsContext::rasterizePoint(const Primitive &p, int y1, int y2) {
+    const Vertex &v = p.v[0];
+    int minX = std::max(0, (int)std::floor(p.minX));
+    int maxX = std::min(width - 1, (int)std::ceil(p.maxX));
+    int minY = std::max(y1, (int)std::floor(p.minY));
+    int maxY = std::min(y2 - 1, (int)std::ceil(p.maxY));
+
+    float smoothMin = 0;
+    float smoothMax = 0;
+    if (p.smooth) {
+        float ps = p.pointSize - 1;
+        float delta = 1.0 / (ps + 1);
+        float mid = 0.35 + 0.15 * ((ps - 1.0f) / 25.0f);
+        if (mid > 0.5) {
+            mid = 0.5;
+        }
+        smoothMin = std::max(0.0f, mid - delta);
+        smoothMax = std::min(1.0f, mid + delta);
+    }
+
+    for (int y = minY; y <= maxY; y++) {
+        float py = y + 0.5f;
+        if (py < p.minY || py >= p.maxY) {
+            continue;
+        }
+        uint8_t *fbRow = &frameBuffer[y * width * 4];
+        float *depthRow = &depthBuffer[y * width];
+        for (int x = minX; x <= maxX; x++) {
+            float px = x + 0.5f;
+            if (px < p.minX || px >= p.maxX) {
+                continue;
+            }
+            float a = v.a;
+            if (p.smooth) {
+                float dx = (px - p.minX) / p.pointSize - 0.5f;
+                float dy = (py - p.minY) / p.pointSize - 0.5f;
+                float dist = std::sqrt(dx * dx + dy * dy);
+                float t = std::clamp((dist - smoothMin) / (smoothMax - smoothMin), 0.0f, 1.0f);
+                float alpha = 1.0f - t * t * (3.0f - 2.0f * t);
+                if (alpha == 0.0f) {
+                    continue;
+                }
+                a *= alpha;
+            }
+            writeFragment(&fbRow[x * 4], &depthRow[x], v.z, p, v.r, v.g, v.b, a);
+        }
+    }
+}
+
+void xlSoftwareGraphicsContext::rasterize(int y1, int y2) {
+    for (const auto &p : primitives) {
+        if (p.maxY < y1 || p.minY >= y2) {
+            continue;
+        }
+        if (p.type == PrimitiveType::TRIANGLE) {
+            rasterizeTriangle(p, y1, y2);
+        } else {
+            rasterizePoint(p, y1, y2);
+        }
+    }
+}
@@ -0,0 +1,186 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+#pragma once
+
+#include <stack>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/glm.hpp>
+
+#include "../xlGraphicsContext.h"
+
+class xlSoftwareTexture;
+
+// CPU only implementation of the graphics context used when there is no usable OpenGL
+// (no GPU, remote sessions, broken drivers). It still draws into a window so a display,
+// even a virtual one, is required.
+//
+// Draw calls transform their vertices to window coordinates and record the resulting
+// triangles/points. FinishFrame then rasterizes them into an RGBA frame buffer in parallel
+// horizontal bands, each band replaying the primitives in the order they were drawn so
+// depth testing and blending match what the OpenGL context produces.
+//
+// The context persists across frames so the frame buffer remains readable after drawing
+// for exporting and grabbing images.
+class xlSoftwareGraphicsContext : public xlGraphicsContext {
+public:
+    xlSoftwareGraphicsContext(wxWindow *w);
+    virtual ~xlSoftwareGraphicsContext();
+
+    // start a new frame of the given size in pixels, cleared to bg. clearOn2D matches
+    // canvases which require a depth buffer and so clear again when the 2D viewport is set
+    void StartFrame(int width, int height, double scaleFactor, const xlColor &bg, bool depthTest, bool clearOn2D);
+    // rasterize everything drawn since StartFrame
+    void FinishFrame();
+
+    int GetFrameWidth() const { return width; }
+    int GetFrameHeight() const { return height; }
+    // RGBA, rows top down
+    const uint8_t *GetFrameData() const { return frameBuffer.data(); }
+    // RGBA, rows bottom up exactly like glReadPixels. Anything outside the frame is black
+    void ReadPixels(int x, int y, int w, int h, uint8_t *data) const;
+
+    virtual xlVertexAccumulator *createVertexAccumulator() override;
+    virtual xlVertexColorAccumulator *createVertexColorAccumulator() override;
+    virtual xlVertexTextureAccumulator *createVertexTextureAccumulator() override;
+    virtual xlVertexIndexedColorAccumulator *createVertexIndexedColorAccumulator() override;
+    virtual xlTexture *createTextureMipMaps(const std::vector<wxBitmap> &bitmaps, const std::string &name) override;
+    virtual xlTexture *createTextureMipMaps(const std::vector<wxImage> &images, const std::string &name) override;
+    virtual xlTexture *createTexture(const wxImage &image, const std::string &name, bool finalize = false) override;
+    virtual xlTexture *createTexture(int w, int h, bool bgr, bool alpha) override;
+    virtual xlTexture *createTextureForFont(const xlFontInfo &font) override;
+    virtual xlGraphicsProgram *createGraphicsProgram() override;
+    virtual xlMesh *loadMeshFromObjFile(const std::string &file) override;
+
+    //drawing methods
+    virtual xlGraphicsContext* drawLines(xlVertexAccumulator *vac, const xlColor &c, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawLineStrip(xlVertexAccumulator *vac, const xlColor &c, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawTriangles(xlVertexAccumulator *vac, const xlColor &c, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawTriangleStrip(xlVertexAccumulator *vac, const xlColor &c, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawPoints(xlVertexAccumulator *vac, const xlColor &c, float pointSize, bool smoothPoints, int start = 0, int count = -1) override;
+
+    virtual xlGraphicsContext* drawLines(xlVertexColorAccumulator *vac, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawLineStrip(xlVertexColorAccumulator *vac, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawTriangles(xlVertexColorAccumulator *vac, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawTriangleStrip(xlVertexColorAccumulator *vac, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawPoints(xlVertexColorAccumulator *vac, float pointSize, bool smoothPoints, int start = 0, int count = -1) override;
+
+    virtual xlGraphicsContext* drawLines(xlVertexIndexedColorAccumulator *vac, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawLineStrip(xlVertexIndexedColorAccumulator *vac, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawTriangles(xlVertexIndexedColorAccumulator *vac, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawTriangleStrip(xlVertexIndexedColorAccumulator *vac, int start = 0, int count = -1) override;
+    virtual xlGraphicsContext* drawPoints(xlVertexIndexedColorAccumulator *vac, float pointSize, bool smoothPoints, int start = 0, int count = -1) override;
+
+    virtual xlGraphicsContext* drawTexture(xlTexture *texture,
+                                           float x, float y, float x2, float y2,
+                                           float tx = 0.0, float ty = 0.0, float tx2 = 1.0, float ty2 = 1.0,
+                                           bool nearest = true,
+                                           int brightness = 100, int alpha = 255) override;
+    virtual xlGraphicsContext* drawTexture(xlVertexTextureAccumulator *vac, xlTexture *texture, int brightness, uint8_t alpha, int start, int count) override;
+    virtual xlGraphicsContext* drawTexture(xlVertexTextureAccumulator *vac, xlTexture *texture, const xlColor &c, int start = 0, int count = -1) override;
+
+    virtual xlGraphicsContext* drawMeshSolids(xlMesh *mesh, int brightness, bool useViewMatrix) override;
+    virtual xlGraphicsContext* drawMeshTransparents(xlMesh *mesh, int brightness) override;
+    virtual xlGraphicsContext* drawMeshWireframe(xlMesh *mesh, int brightness) override;
+
+    virtual xlGraphicsContext* enableBlending(bool e = true) override;
+
+    // Setup the Viewport
+    virtual xlGraphicsContext* SetViewport(int x1, int y1, int x2, int y2, bool is3D = false) override;
+
+    //manipulating the matrices
+    virtual xlGraphicsContext* PushMatrix() override;
+    virtual xlGraphicsContext* PopMatrix() override;
+    virtual xlGraphicsContext* Translate(float x, float y, float z) override;
+    virtual xlGraphicsContext* Rotate(float angle, float x, float y, float z) override;
+    virtual xlGraphicsContext* Scale(float w, float h, float z) override;
+    virtual xlGraphicsContext* SetCamera(const glm::mat4 &m) override;
+    virtual xlGraphicsContext* SetModelMatrix(const glm::mat4 &m) override;
+    virtual xlGraphicsContext* ApplyMatrix(const glm::mat4 &m) override;
+    virtual xlGraphicsContext* ScaleViewMatrix(float w, float h, float z) override;
+    virtual xlGraphicsContext* TranslateViewMatrix(float x, float y, float z) override;
+
+    // a vertex after transformation ... x/y in frame buffer pixels (y down), z is NDC depth
+    struct Vertex {
+        float x, y, z;
+        float invW;
+        float r, g, b, a;
+        float u, v;
+    };
+    enum class PrimitiveType : uint8_t {
+        TRIANGLE,
+        POINT
+    };
+    struct Primitive {
+        PrimitiveType type;
+        bool blend;
+        bool depthTest;
+        bool smooth;
+        bool repeat;
+        int textureMode; // 0 - modulate vertex color, 1 - vertex color with texture alpha
+        const xlSoftwareTexture *texture;
+        float pointSize;
+        float minX, minY, maxX, maxY;
+        Vertex v[3];
+    };
+
+    // clip space vertex prior to the perspective divide
+    struct ClipVertex {
+        glm::vec4 pos;
+        float r, g, b, a;
+        float u, v;
+    };
+    void addTriangle(const ClipVertex &v1, const ClipVertex &v2, const ClipVertex &v3, const xlSoftwareTexture *texture = nullptr, int textureMode = 0, bool repeat = false);
+    void addLine(const ClipVertex &v1, const ClipVertex &v2);
+    void addPoint(const ClipVertex &v, float pointSize, bool smooth);
+    ClipVertex transform(const glm::mat4 &m, float x, float y, float z, const xlColor &c) const;
+    const glm::mat4 &getMVP() const { return frameData.MVP; }
+    const glm::mat4 &getViewMatrix() const { return frameData.viewMatrix; }
+    const glm::mat4 &getModelMatrix() const { return frameData.modelMatrix; }
+
+private:
+    class FrameData {
+    public:
+        glm::mat4 MVP;
+        glm::mat4 modelMatrix;
+        glm::mat4 viewMatrix;
+    };
+
+    void clear();
+    Vertex toWindow(const ClipVertex &v) const;
+    void addWindowTriangle(const Vertex &v1, const Vertex &v2, const Vertex &v3, const xlSoftwareTexture *texture, int textureMode, bool repeat);
+    void rasterize(int y1, int y2);
+    void rasterizeTriangle(const Primitive &p, int y1, int y2);
+    void rasterizePoint(const Primitive &p, int y1, int y2);
+    void drawMesh(xlMesh *mesh, int brightness, bool useViewMatrix, bool transparents);
+
+    int width = 0;
+    int height = 0;
+    double scaleFactor = 1.0;
+    std::vector<uint8_t> frameBuffer;
+    std::vector<float> depthBuffer;
+
+    // viewport in frame buffer pixels with the origin bottom left like glViewport
+    float vpX = 0;
+    float vpY = 0;
+    float vpW = 0;
+    float vpH = 0;
+
+    xlColor clearColor = xlBLACK;
+    bool clearOn2DViewport = false;
+    bool isBlending = false;
+    bool depthTest = false;
+
+    FrameData frameData;
+    std::stack<glm::mat4> matrixStack;
+
+    std::vector<Primitive> primitives;
+};
@@ -262,6 +262,21 @@ public:
         }
     }
 
+    // If SetFromChannels is just a copy of channel bytes into the colour this fills in the channel offset
+    // each colour byte comes from (255 if it is not set) so many nodes can be converted in one pass.
+    // Returns false if the node needs SetFromChannels.
+    virtual bool GetDirectChannelMapping(uint8_t mapping[3]) const {
+        for (int x = 0; x < 3; x++) {
+            mapping[x] = offsets[x];
+        }
+        return true;
+    }
+
+    // the colour bytes in rgb order ... only for filling in from a direct channel mapping
+    uint8_t* GetColorData() {
+        return c;
+    }
+
     virtual const std::string& GetNodeType() const;
 
     uint32_t GetChanCount() const {
@@ -527,6 +542,10 @@ public:
     virtual void SetFromChannels(const unsigned char* buf) override {
         c[0] = c[1] = c[2] = buf[0];
     }
+    virtual bool GetDirectChannelMapping(uint8_t mapping[3]) const override {
+        mapping[0] = mapping[1] = mapping[2] = 0;
+        return true;
+    }
     virtual void GetForChannels(unsigned char* buf) const override {
         buf[0] = std::min(c[0], std::min(c[1], c[2]));
     }
@@ -554,6 +573,9 @@ public:
 
     virtual void SetFromChannels(const unsigned char* buf) override;
     virtual void GetForChannels(unsigned char* buf) const override;
+    virtual bool GetDirectChannelMapping(uint8_t mapping[3]) const override {
+        return false;
+    }
     virtual const std::string& GetNodeType() const override;
 
     virtual NodeBaseClass* clone() const override {
@@ -582,6 +604,9 @@ public:
 
     virtual void SetFromChannels(const unsigned char* buf) override;
     virtual void GetForChannels(unsigned char* buf) const override;
+    virtual bool GetDirectChannelMapping(uint8_t mapping[3]) const override {
+        return false;
+    }
     virtual const std::string& GetNodeType() const override;
 
     virtual NodeBaseClass* clone() const override {
@@ -609,6 +634,9 @@ public:
 
     virtual void SetFromChannels(const unsigned char* buf) override;
     virtual void GetForChannels(unsigned char* buf) const override;
+    virtual bool GetDirectChannelMapping(uint8_t mapping[3]) const override {
+        return false;
+    }
     virtual NodeBaseClass* clone() const override {
         return new NodeClassSuperString(*this);
     }
@@ -398,7 +398,13 @@ void ArtNetOutput::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         _data[12] = _sequenceNum;
-        _datagram->SendTo(_remoteAddr, _data, ARTNET_PACKET_LEN - (512 - _channels));
+        if (_frameData != nullptr) {
+            PacketPart parts[] = { { _data, ARTNET_PACKET_HEADERLEN }, { _frameData, (size_t)_channels } };
+            SendPacket(_datagram, _remoteAddr, parts, 2);
+        }
+        else {
+            _datagram->SendTo(_remoteAddr, _data, ARTNET_PACKET_LEN - (512 - _channels));
+        }
         _sequenceNum = _sequenceNum == 255 ? 0 : _sequenceNum + 1;
         FrameOutput();
         _changed = false;
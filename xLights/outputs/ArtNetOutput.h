@@ -50,6 +50,7 @@ class ArtNetOutput : public IPOutput
 
 #pragma region Private Functions
     void OpenDatagram();
+    virtual uint8_t* GetChannelBuffer() override { return &_data[ARTNET_PACKET_HEADERLEN]; }
 #pragma endregion
 
 public:
@@ -532,9 +532,14 @@ void DDPOutput::EndFrame(int suppressFrames) {
             _data[8] = (thissend & 0xFF00) >> 8;
             _data[9] = thissend & 0x00FF;
 
-            memcpy(&_data[10], _fulldata + index, thissend);
-
-            _datagram->SendTo(_remoteAddr, &_data[0], DDP_PACKET_LEN - (1440 - thissend));
+            if (_frameData != nullptr) {
+                PacketPart parts[] = { { _data, DDP_PACKET_HEADERLEN }, { _frameData + index, (size_t)thissend } };
+                SendPacket(_datagram, _remoteAddr, parts, 2);
+            }
+            else {
+                memcpy(&_data[10], _fulldata + index, thissend);
+                _datagram->SendTo(_remoteAddr, &_data[0], DDP_PACKET_LEN - (1440 - thissend));
+            }
             _sequenceNum = _sequenceNum == 15 ? 1 : _sequenceNum + 1;
 
             tosend -= thissend;
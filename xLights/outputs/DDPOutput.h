@@ -64,6 +64,7 @@ class DDPOutput : public IPOutput
 
     #pragma region Private Functions
     void OpenDatagram();
+    virtual uint8_t* GetChannelBuffer() override { return _fulldata; }
     #pragma  endregion
 
 public:
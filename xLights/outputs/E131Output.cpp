@@ -445,7 +445,13 @@ void E131Output::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         _data[111] = _sequenceNum;
-        _datagram->SendTo(_remoteAddr, _data, E131_PACKET_LEN - (512 - _channels));
+        if (_frameData != nullptr) {
+            PacketPart parts[] = { { _data, E131_PACKET_HEADERLEN }, { _frameData, (size_t)_channels } };
+            SendPacket(_datagram, _remoteAddr, parts, 2);
+        }
+        else {
+            _datagram->SendTo(_remoteAddr, _data, E131_PACKET_LEN - (512 - _channels));
+        }
         _sequenceNum = _sequenceNum == 255 ? 0 : _sequenceNum + 1;
         FrameOutput();
     }
@@ -44,6 +44,7 @@ class E131Output : public IPOutput
     // this is used to create any sub universes in this output
     void CreateMultiUniverses_CONVERT(int num);
     void OpenDatagram();
+    virtual uint8_t* GetChannelBuffer() override { return &_data[E131_PACKET_HEADERLEN]; }
     #pragma endregion
 
 public:
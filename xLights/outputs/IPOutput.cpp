@@ -22,11 +22,19 @@
 #include <Ws2tcpip.h>
 #include <iphlpapi.h>
 #include <icmpapi.h>
+#else
+#include <sys/socket.h>
+#include <sys/uio.h>
 #endif
 
 #include "utils/Curl.h"
+#include "utils/NetworkProbe.h"
 #include "utils/ip_utils.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include <log4cpp/Category.hh>
 
 #pragma region Private Functions
@@ -41,6 +49,55 @@ void IPOutput::Save(wxXmlNode* node) {
 }
 #pragma endregion
 
+#pragma region Packet Sending
+// The parts are handed to the socket as a scatter/gather list so the channel data goes out from wherever it
+// already is. If the socket would block, or the platform call fails, the parts are put together and sent the
+// normal way which waits as SendTo always has.
+void IPOutput::SendPacket(wxDatagramSocket* datagram, const wxIPV4address& remoteAddr, const PacketPart* parts, int count) {
+
+    if (datagram == nullptr || count <= 0 || count > MAX_PACKET_PARTS) return;
+
+    wxSOCKET_T sock = datagram->GetSocket();
+    const sockaddr* addr = remoteAddr.GetAddressData();
+    if (sock != wxSOCKET_T(-1) && addr != nullptr) {
+#ifdef __WXMSW__
+        WSABUF bufs[MAX_PACKET_PARTS];
+        for (int i = 0; i < count; i++) {
+            bufs[i].buf = (CHAR*)parts[i].data;
+            bufs[i].len = (ULONG)parts[i].len;
+        }
+        DWORD sent = 0;
+        if (WSASendTo(sock, bufs, count, &sent, 0, addr, remoteAddr.GetAddressDataLen(), nullptr, nullptr) == 0) return;
+#else
+        iovec iov[MAX_PACKET_PARTS];
+        for (int i = 0; i < count; i++) {
+            iov[i].iov_base = (void*)parts[i].data;
+            iov[i].iov_len = parts[i].len;
+        }
+        msghdr msg;
+        memset(&msg, 0x00, sizeof(msg));
+        msg.msg_name = (void*)addr;
+        msg.msg_namelen = remoteAddr.GetAddressDataLen();
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        if (sendmsg(sock, &msg, 0) >= 0) return;
+#endif
+    }
+
+    size_t len = 0;
+    for (int i = 0; i < count; i++) {
+        len += parts[i].len;
+    }
+    std::vector<uint8_t> packet(len);
+    size_t pos = 0;
+    for (int i = 0; i < count; i++) {
+        memcpy(&packet[pos], parts[i].data, parts[i].len);
+        pos += parts[i].len;
+    }
+    datagram->SendTo(remoteAddr, packet.data(), len);
+}
+#pragma endregion
+
 #pragma region Constructors and Destructors
 IPOutput::IPOutput(wxXmlNode* node, bool isActive) : Output(node) {
     _ip = node->GetAttribute("ComPort", "").ToStdString();
@@ -129,6 +186,41 @@ Output::PINGSTATE IPOutput::Ping(const std::string& ip, const std::string& proxy
     }
 #endif
 }
+
+// the address is already resolved as this is called again from the probe callback to retry
+static void PingResolved(const void* owner, const std::string& address, const std::string& ip, bool proxied, int tries, std::function<void(Output::PINGSTATE state)>&& callback) {
+    auto done = [owner, address, ip, proxied, tries, callback](Output::PINGSTATE state) mutable {
+        if (state == Output::PINGSTATE::PING_ALLFAILED && tries > 1) {
+            PingResolved(owner, address, ip, proxied, tries - 1, std::move(callback));
+        } else {
+            callback(state);
+        }
+    };
+    if (!proxied) {
+        NetworkProbe::INSTANCE.Ping(owner, address, 1000, [done](const NetworkProbe::Result& result) mutable {
+            if (!result.ok) {
+                done(Output::PINGSTATE::PING_ALLFAILED);
+            } else {
+                // without ICMP the probe connects to the web server instead
+                done(result.connected ? Output::PINGSTATE::PING_WEBOK : Output::PINGSTATE::PING_OK);
+            }
+        });
+    } else {
+        // as Ping does, ask the proxy for the page
+        NetworkProbe::INSTANCE.HTTPGet(owner, address, 80, "/proxy/" + ip + "/", 2000, [done](const NetworkProbe::Result& result) mutable {
+            done(result.ok && result.body != "" ? Output::PINGSTATE::PING_WEBOK : Output::PINGSTATE::PING_ALLFAILED);
+        });
+    }
+}
+
+void IPOutput::PingAsync(const void* owner, const std::string& ip, const std::string& proxy, int tries, std::function<void(Output::PINGSTATE state)>&& callback) {
+    // resolving can block so it is done here once rather than on the probe thread for each try
+    if (proxy == "") {
+        PingResolved(owner, ip_utils::ResolveIP(ip), ip, false, tries, std::move(callback));
+    } else {
+        PingResolved(owner, ip_utils::ResolveIP(proxy), ip, true, tries, std::move(callback));
+    }
+}
 #pragma endregion 
 
 #pragma region Getters and Setters
@@ -145,6 +237,29 @@ void IPOutput::SetIP(const std::string& ip, bool isActive, bool resolve) {
 }
 #pragma endregion 
 
+#pragma region Data Setting
+bool IPOutput::SetFrameData(const uint8_t* data, size_t size) {
+
+    uint8_t* buffer = GetChannelBuffer();
+    if (data == nullptr) {
+        // bring our own copy up to date so sending carries on from where the frame data left off
+        if (_frameData != nullptr && buffer != nullptr) {
+            memcpy(buffer, _frameData, std::min(_frameDataSize, (size_t)std::max(0, (int)_channels)));
+        }
+        _frameData = nullptr;
+        _frameDataSize = 0;
+        return true;
+    }
+
+    if (_fppProxyOutput != nullptr || buffer == nullptr || size < (size_t)_channels) return false;
+
+    _frameData = data;
+    _frameDataSize = size;
+    _changed = true;
+    return true;
+}
+#pragma endregion
+
 #pragma region Operators
 bool IPOutput::operator==(const IPOutput& output) const {
     if (GetType() != output.GetType()) return false;
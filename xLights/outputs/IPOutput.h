@@ -10,16 +10,38 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <functional>
 #include <map>
 
 #include "Output.h"
 
+class wxDatagramSocket;
+class wxIPV4address;
+
 class IPOutput : public Output
 {
 protected:
 
+    #pragma region Member Variables
+    const uint8_t* _frameData = nullptr; // while set the channels are sent straight from here
+    size_t _frameDataSize = 0;
+    #pragma endregion
+
     #pragma region Private Functions
     virtual void Save(wxXmlNode* node) override;
+    // the output's own copy of its channels ... nullptr if it cannot send from frame data
+    virtual uint8_t* GetChannelBuffer() { return nullptr; }
+    #pragma endregion
+
+    #pragma region Packet Sending
+    // a piece of a datagram, sent in order without first being copied together
+    struct PacketPart
+    {
+        const uint8_t* data;
+        size_t len;
+    };
+    static const int MAX_PACKET_PARTS = 4;
+    static void SendPacket(wxDatagramSocket* datagram, const wxIPV4address& remoteAddr, const PacketPart* parts, int count);
     #pragma endregion
 
 public:
@@ -34,6 +56,10 @@ public:
 
     #pragma region Static Functions
     static Output::PINGSTATE Ping(const std::string& ip, const std::string& proxy);
+    // Ping without blocking using NetworkProbe, trying up to tries times until one succeeds. Host names are resolved
+    // on the calling thread so never call this from a probe callback. The callback is called on the probe thread and
+    // owner must cancel its pings with NetworkProbe::INSTANCE.Cancel before it is destroyed.
+    static void PingAsync(const void* owner, const std::string& ip, const std::string& proxy, int tries, std::function<void(Output::PINGSTATE state)>&& callback);
     #pragma endregion 
 
     #pragma region Getters and Setters
@@ -52,4 +78,9 @@ public:
     #pragma region Start and Stop
     virtual bool Open() override { return Output::Open(); }
     #pragma endregion 
+
+    #pragma region Data Setting
+    virtual bool SetFrameData(const uint8_t* data, size_t size) override;
+    virtual void FrameDataChanged() override { if (_frameData != nullptr) _changed = true; }
+    #pragma endregion
 };
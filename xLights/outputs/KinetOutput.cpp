@@ -243,7 +243,13 @@ void KinetOutput::EndFrame(int suppressFrames) {
         _data[9] = (_sequenceNum >> 8) & 0xFF;
         _data[10] = (_sequenceNum >> 16) & 0xFF;
         _data[11] = (_sequenceNum >> 24) & 0xFF;
-        _datagram->SendTo(_remoteAddr, _data, GetHeaderPacketLength() + _channels);
+        if (_frameData != nullptr) {
+            PacketPart parts[] = { { _data, (size_t)GetHeaderPacketLength() }, { _frameData, (size_t)_channels } };
+            SendPacket(_datagram, _remoteAddr, parts, 2);
+        }
+        else {
+            _datagram->SendTo(_remoteAddr, _data, GetHeaderPacketLength() + _channels);
+        }
         _sequenceNum++;
         FrameOutput();
         _changed = false;
@@ -38,6 +38,7 @@ class KinetOutput : public IPOutput
 		return KINET_V2_PACKET_HEADERLEN;
 	}
 	void PopulateHeader();
+    virtual uint8_t* GetChannelBuffer() override { return &_data[GetHeaderPacketLength()]; }
     #pragma endregion
 
 public:
@@ -225,7 +225,12 @@ public:
     virtual void SetOneChannel(int32_t channel, unsigned char data) = 0;
     virtual void SetManyChannels(int32_t channel, unsigned char* data, size_t size);
     virtual void AllOff() = 0;
-    #pragma endregion 
+    // Points the output at a buffer holding all its channels which it then sends from rather than its own copy.
+    // Returns false if the output cannot do this. nullptr goes back to the output's own copy.
+    virtual bool SetFrameData(const uint8_t* data, size_t size) { return false; }
+    // the channels in the frame data have been changed
+    virtual void FrameDataChanged() {}
+    #pragma endregion
 
     virtual void SendHeartbeat() const {}
 
@@ -28,12 +28,15 @@
 #include "DDPOutput.h"
 #include "xxxEthernetOutput.h"
 #include "OPCOutput.h"
+#include "OutputTransmitter.h"
 #include "TestPreset.h"
 #include "../Parallel.h"
 #include "../UtilFunctions.h"
 #include "utils/ip_utils.h"
 #include <wx/regex.h>
 
+#include <algorithm>
+#include <cstring>
 #include <numeric>
 
 #include <log4cpp/Category.hh>
@@ -555,6 +558,8 @@ void OutputManager::AddController(Controller* controller, int pos)
         std::advance(it, pos);
         _controllers.insert(it, controller);
     }
+    InvalidateLastFrame();
+    InvalidateChannelIndex();
     UpdateUnmanaged();
 }
 
@@ -567,11 +572,15 @@ void OutputManager::DeleteController(const std::string& controllerName) {
             break;
         }
     }
+    InvalidateLastFrame();
+    InvalidateChannelIndex();
     UpdateUnmanaged();
 }
 
 void OutputManager::DeleteAllControllers() {
     ip_utils::waitForAllToResolve();
+    InvalidateLastFrame();
+    InvalidateChannelIndex();
     while (_controllers.size() > 0) {
         delete _controllers.front();
         _controllers.pop_front();
@@ -585,6 +594,9 @@ void OutputManager::DeleteAllControllers() {
 
 void OutputManager::MoveController(Controller* controller, int toControllerNumber) {
 
+    InvalidateLastFrame();
+    InvalidateChannelIndex();
+
     std::list<Controller*> res;
     int i = 1;
     bool added = false;
@@ -752,14 +764,13 @@ Output* OutputManager::GetOutput_CONVERT(int outputNumber) const {
 // get an output based on an absolute channel number
 Output* OutputManager::GetOutput(int32_t absoluteChannel, int32_t& startChannel) const {
 
-    auto outputs = GetAllOutputs();
-    for (const auto& it : outputs) {
-        if (absoluteChannel >= it->GetStartChannel() && absoluteChannel <= it->GetEndChannel()) {
-            startChannel = absoluteChannel - it->GetStartChannel() + 1;
-            return it;
-        }
-    }
-    return nullptr;
+    CheckChannelIndex();
+    auto index = GetChannelIndex();
+    int const pos = index->Find(absoluteChannel);
+    if (pos < 0) return nullptr;
+    auto const& r = index->outputs[pos];
+    startChannel = absoluteChannel - r.start + 1;
+    return r.output;
 }
 
 // get an output based on a universe/id number
@@ -1075,11 +1086,13 @@ int OutputManager::UniqueId() {
 
 // Need to call this whenever something may have changed in an output to ensure all the transient data it updated
 void OutputManager::SomethingChanged() const {
+    InvalidateLastFrame();
     int nullcnt = 0;
     int start = 1;
     for (auto& it : _controllers) {
         it->SetTransientData(start, nullcnt);
     }
+    InvalidateChannelIndex();
 }
 
 bool OutputManager::IsDirty() const {
@@ -1200,6 +1213,11 @@ bool OutputManager::StartOutput() {
         _outputting = true;
     }
 
+    if (_outputting) {
+        StartTransmitters();
+    }
+    InvalidateLastFrame();
+
     _outputCriticalSection.Leave();
 
     if (_outputting) {
@@ -1220,6 +1238,9 @@ void OutputManager::StopOutput() {
 
     _outputting = false;
 
+    StopTransmitters();
+    InvalidateLastFrame();
+
     for (const auto& it : GetAllOutputs()) {
         it->Close();
     }
@@ -1244,6 +1265,122 @@ bool OutputManager::TxEmpty() {
     }
     return true;
 }
+
+// Serial outputs can block for much of a frame writing to the port so while outputting each gets its own
+// transmit thread rather than holding up the network outputs
+void OutputManager::StartTransmitters() {
+
+    for (const auto& it : GetAllOutputs()) {
+        if (it->IsSerialOutput() && it->IsEnabled() && it->IsOk() && _transmitters.find(it) == _transmitters.end()) {
+            _transmitters[it] = new OutputTransmitter(it, _suppressFrames);
+        }
+    }
+    _lastFrameMS = -1;
+}
+
+void OutputManager::StopTransmitters() {
+
+    for (auto& it : _transmitters) {
+        delete it.second;
+    }
+    _transmitters.clear();
+}
+
+// _lastFrame is about to be rebuilt or no longer matches the outputs so any output sending straight from it
+// goes back to its own copy of its channels first
+void OutputManager::InvalidateLastFrame() const {
+
+    if (_attachedOutputs > 0) {
+        for (const auto& it : GetAllOutputs()) {
+            it->SetFrameData(nullptr, 0);
+        }
+        _attachedOutputs = 0;
+    }
+    _lastFrameKnown.clear();
+}
+
+// Called for every channel set so it only rebuilds once the index has been invalidated. CheckChannelIndex catches
+// outputs changed without us being told
+std::shared_ptr<const OutputManager::ChannelIndex> OutputManager::GetChannelIndex() const {
+
+    std::unique_lock<std::mutex> lock(_channelIndexLock);
+    if (_channelIndex != nullptr) {
+        return _channelIndex;
+    }
+
+    auto index = std::make_shared<ChannelIndex>();
+    index->outputCount = GetOutputCount();
+    index->totalChannels = GetTotalChannels();
+    index->outputs.reserve(index->outputCount);
+    int32_t lastEnd = 0;
+    for (const auto& it : _controllers) {
+        for (const auto& it2 : it->GetOutputs()) {
+            ChannelRange r;
+            r.start = it2->GetStartChannel();
+            r.end = it2->GetEndChannel();
+            r.output = it2;
+            if (r.end >= r.start) {
+                if (r.start <= lastEnd) index->ordered = false;
+                lastEnd = r.end;
+                index->lookup.push_back(index->outputs.size());
+            }
+            index->outputs.push_back(r);
+        }
+    }
+    _channelIndex = index;
+    return _channelIndex;
+}
+
+void OutputManager::InvalidateChannelIndex() const {
+
+    std::unique_lock<std::mutex> lock(_channelIndexLock);
+    _channelIndex = nullptr;
+}
+
+// outputs can be replaced inside a controller without us being told so the counts the index was built with are
+// compared with the outputs as they are now. This walks every controller so it is done once a frame, not per channel
+void OutputManager::CheckChannelIndex() const {
+
+    int const outputCount = GetOutputCount();
+    int32_t const totalChannels = GetTotalChannels();
+
+    std::unique_lock<std::mutex> lock(_channelIndexLock);
+    if (_channelIndex != nullptr && (_channelIndex->outputCount != outputCount || _channelIndex->totalChannels != totalChannels)) {
+        _channelIndex = nullptr;
+    }
+}
+
+int OutputManager::ChannelIndex::Find(int32_t absoluteChannel) const {
+
+    if (ordered) {
+        auto it = std::upper_bound(begin(lookup), end(lookup), absoluteChannel, [this](int32_t ch, uint32_t pos) { return ch < outputs[pos].start; });
+        if (it == begin(lookup)) return -1;
+        --it;
+        return absoluteChannel <= outputs[*it].end ? (int)*it : -1;
+    }
+
+    for (size_t i = 0; i < outputs.size(); i++) {
+        if (absoluteChannel >= outputs[i].start && absoluteChannel <= outputs[i].end) return (int)i;
+    }
+    return -1;
+}
+
+OutputTransmitter* OutputManager::GetTransmitter(Output* output) const {
+
+    if (_transmitters.empty()) return nullptr;
+    auto it = _transmitters.find(output);
+    return it == _transmitters.end() ? nullptr : it->second;
+}
+
+bool OutputManager::GetTransmitterStats(Output* output, uint64_t& sent, uint64_t& late, uint64_t& skipped) const {
+
+    auto t = GetTransmitter(output);
+    if (t == nullptr) return false;
+    sent = t->GetSent();
+    late = t->GetLate();
+    skipped = t->GetSkipped();
+    return true;
+}
 #pragma endregion
 
 #pragma region Frame Handling
@@ -1252,8 +1389,19 @@ void OutputManager::StartFrame(long msec) {
     if (!_outputting) return;
     if (!_outputCriticalSection.TryEnter()) return;
     
+    if (_lastFrameMS >= 0 && msec > _lastFrameMS && msec - _lastFrameMS < 1000) {
+        _frameMS = msec - _lastFrameMS;
+    }
+    _lastFrameMS = msec;
+    CheckChannelIndex();
+
     for (const auto& it : GetAllOutputs()) {
-        it->StartFrame(msec);
+        auto t = GetTransmitter(it);
+        if (t != nullptr) {
+            t->StartFrame(msec);
+        } else {
+            it->StartFrame(msec);
+        }
     }
     _outputCriticalSection.Leave();
 }
@@ -1264,7 +1412,9 @@ void OutputManager::ResetFrame() {
     if (!_outputCriticalSection.TryEnter()) return;
 
     for (const auto& it : GetAllOutputs()) {
-        it->ResetFrame();
+        if (GetTransmitter(it) == nullptr) {
+            it->ResetFrame();
+        }
     }
     _outputCriticalSection.Leave();
 }
@@ -1275,6 +1425,13 @@ void OutputManager::EndFrame() {
     if (!_outputCriticalSection.TryEnter()) return;
 
     auto outputs = GetAllOutputs();
+    if (!_transmitters.empty()) {
+        // hand the serial outputs their frame first so they start sending while the rest go out
+        for (auto& it : _transmitters) {
+            it.second->EndFrame(_frameMS);
+        }
+        outputs.remove_if([this](Output* o) { return GetTransmitter(o) != nullptr; });
+    }
     if (_parallelTransmission) {
         std::function<void(Output*&, int)> f = [this](Output*&o, int n) {
             o->EndFrame(_suppressFrames);
@@ -1316,7 +1473,12 @@ void OutputManager::EndFrame() {
 void OutputManager::SendHeartbeat() {
 
     for (const auto& it : GetAllOutputs()) {
-        it->SendHeartbeat();
+        auto t = GetTransmitter(it);
+        if (t != nullptr) {
+            t->SendHeartbeat();
+        } else {
+            it->SendHeartbeat();
+        }
     }
 }
 #pragma endregion
@@ -1325,11 +1487,22 @@ void OutputManager::SendHeartbeat() {
 // channel here is zero based
 void OutputManager::SetOneChannel(int32_t channel, unsigned char data) {
 
-    int32_t sc = 0;
-    Output* output = GetOutput(channel + 1, sc);
-    if (output != nullptr) {
+    auto index = GetChannelIndex();
+    int const pos = index->Find(channel + 1);
+    if (pos >= 0) {
+        Output* output = index->outputs[pos].output;
+        int32_t const sc = channel + 1 - index->outputs[pos].start + 1;
+        if (channel < (int32_t)_lastFrame.size()) {
+            _lastFrame[channel] = data;
+            output->FrameDataChanged();
+        }
         if (output->IsEnabled()) {
-            output->SetOneChannel(sc - 1, data);
+            auto t = GetTransmitter(output);
+            if (t != nullptr) {
+                t->SetOneChannel(sc - 1, data);
+            } else {
+                output->SetOneChannel(sc - 1, data);
+            }
         }
     }
 }
@@ -1339,36 +1512,81 @@ void OutputManager::SetManyChannels(int32_t channel, unsigned char* data, size_t
 
     if (size == 0) return;
 
-    int32_t stch;
-    Output* o = GetOutput(channel + 1, stch);
+    auto index = GetChannelIndex();
+    int const pos = index->Find(channel + 1);
 
     // if this doesnt map to an output then skip it
-    if (o == nullptr) return;
+    if (pos < 0) return;
 
-    // get an iterator to the output which contains our first channel
-    auto outputs = GetAllOutputs();
-    auto it = outputs.begin();
-    while (*it != o && it != outputs.end()) ++it;
+    ScatterChannels(*index, pos, channel + 1 - index->outputs[pos].start + 1, channel, data, size);
+}
+
+// Outputs are laid out in channel order so a whole frame is handed out by walking them from the first copying
+// each its run of channels in one go
+void OutputManager::SetFrame(unsigned char* data, size_t size) {
+
+    if (size == 0) return;
+
+    auto index = GetChannelIndex();
+    int const pos = index->Find(1);
+    if (pos < 0) return;
+
+    ScatterChannels(*index, pos, 2 - index->outputs[pos].start, 0, data, size);
+}
+
+// hands size channels starting at the zero based channel to the outputs from the one at pos onwards. stch is
+// the 1 based channel within that first output
+void OutputManager::ScatterChannels(const ChannelIndex& index, int pos, int32_t stch, int32_t channel, unsigned char* data, size_t size) {
+
+    bool const track = _outputting;
+    if (track && _lastFrameKnown.size() != index.outputs.size()) {
+        InvalidateLastFrame();
+        _lastFrame.assign(GetTotalChannels(), 0);
+        _lastFrameKnown.assign(index.outputs.size(), 0);
+    }
 
     size_t left = size;
-    while (left > 0 && o != nullptr) {
+    for (size_t i = pos; left > 0 && i < index.outputs.size(); i++) {
+        Output* o = index.outputs[i].output;
         wxASSERT(!o->IsOutputCollection_CONVERT());
         size_t mx = o->GetChannels() - stch + 1;
         size_t send = std::min(left, mx);
         if (o->IsEnabled()) {
-            o->SetManyChannels(stch - 1, &data[size - left], send);
+            unsigned char* src = &data[size - left];
+            size_t const abs = channel + (size - left);
+            bool changed = true;
+            bool attach = false;
+            // serial outputs may do more than take a copy of the data (LOR resends periodically) so always get it
+            if (track && o->IsIpOutput() && abs + send <= _lastFrame.size()) {
+                if (_lastFrameKnown[i] && memcmp(&_lastFrame[abs], src, send) == 0) {
+                    changed = false;
+                } else {
+                    memcpy(&_lastFrame[abs], src, send);
+                    if (_lastFrameKnown[i] == FRAME_ATTACHED) {
+                        // the output sends from _lastFrame so there is nothing to copy into it
+                        o->FrameDataChanged();
+                        changed = false;
+                    } else if (stch == 1 && send == (size_t)o->GetChannels()) {
+                        _lastFrameKnown[i] = FRAME_KNOWN;
+                        attach = _zeroCopyOutput;
+                    }
+                }
+            }
+            if (changed) {
+                auto t = GetTransmitter(o);
+                if (t != nullptr) {
+                    t->SetManyChannels(stch - 1, src, send);
+                } else {
+                    o->SetManyChannels(stch - 1, src, send);
+                }
+            }
+            if (attach && o->SetFrameData(&_lastFrame[abs], send)) {
+                _lastFrameKnown[i] = FRAME_ATTACHED;
+                _attachedOutputs++;
+            }
         }
         stch = 1;
         left -= send;
-
-        // Move to the next output
-        ++it;
-        if (it == outputs.end()) {
-            o = nullptr;
-        }
-        else {
-            o = *it;
-        }
     }
 }
 
@@ -1376,10 +1594,20 @@ void OutputManager::AllOff(bool send) {
 
     if (!_outputCriticalSection.TryEnter()) return;
 
+    InvalidateLastFrame();
+
     for (const auto& it : GetAllOutputs()) {
-        it->AllOff();
-        if (send) {
-            it->EndFrame(_suppressFrames);
+        auto t = GetTransmitter(it);
+        if (t != nullptr) {
+            t->AllOff();
+            if (send) {
+                t->EndFrame(_frameMS);
+            }
+        } else {
+            it->AllOff();
+            if (send) {
+                it->EndFrame(_suppressFrames);
+            }
         }
     }
     _outputCriticalSection.Leave();
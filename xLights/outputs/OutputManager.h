@@ -14,6 +14,8 @@
 
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -23,6 +25,7 @@ class wxXmlNode;
 class Output;
 class Controller;
 class TestPreset;
+class OutputTransmitter;
 class Controller;
 class ControllerEthernet;
 
@@ -45,6 +48,37 @@ class OutputManager
     std::string _globalFPPProxy;
     std::string _globalForceLocalIP;
     wxCriticalSection _outputCriticalSection; // used to protect areas that must be single threaded
+    std::map<Output*, OutputTransmitter*> _transmitters; // serial outputs sent on their own thread while outputting
+    long _lastFrameMS = -1;
+    long _frameMS = 50; // time between the last two frames
+    // while outputting, the channels last handed to the outputs so outputs whose channels have not changed are
+    // skipped rather than each comparing and copying them again. An output is only skipped once _lastFrame
+    // holds all of its channels, as recorded in _lastFrameKnown (indexed by output position). With zero copy
+    // output the network outputs then send their channels straight from _lastFrame (FRAME_ATTACHED)
+    mutable std::vector<uint8_t> _lastFrame;
+    mutable std::vector<uint8_t> _lastFrameKnown;
+    static const uint8_t FRAME_KNOWN = 1;
+    static const uint8_t FRAME_ATTACHED = 2;
+    mutable int _attachedOutputs = 0;
+    bool _zeroCopyOutput = true;
+    // where each output's channels are so the output holding a channel is found by a binary search rather
+    // than by walking every controller's outputs. Built when first needed after the outputs change and swapped
+    // whole so a lookup on another thread keeps the one it started with
+    struct ChannelRange {
+        int32_t start = 0; // absolute, 1 based
+        int32_t end = 0;
+        Output* output = nullptr;
+    };
+    struct ChannelIndex {
+        std::vector<ChannelRange> outputs; // every output in order ... positions match _lastFrameKnown
+        std::vector<uint32_t> lookup;      // positions of the outputs with channels in start channel order
+        bool ordered = true;               // false if outputs overlap ... lookups then scan like they used to
+        int outputCount = 0;
+        int32_t totalChannels = 0;
+        int Find(int32_t absoluteChannel) const; // position of the output holding the channel or -1
+    };
+    mutable std::mutex _channelIndexLock;
+    mutable std::shared_ptr<const ChannelIndex> _channelIndex;
     std::string _baseShowDir = "";
     bool _autoUpdateFromBaseShowDir = false;
     #pragma endregion 
@@ -63,6 +97,14 @@ class OutputManager
     bool SetGlobalOutputtingFlag(bool state, bool force = false);
     bool ConvertStartChannel(const std::string sc, std::string& newsc) const;
     void AsyncPingAll();
+    void StartTransmitters();
+    void StopTransmitters();
+    OutputTransmitter* GetTransmitter(Output* output) const;
+    void InvalidateLastFrame() const;
+    std::shared_ptr<const ChannelIndex> GetChannelIndex() const;
+    void InvalidateChannelIndex() const;
+    void CheckChannelIndex() const;
+    void ScatterChannels(const ChannelIndex& index, int pos, int32_t stch, int32_t channel, unsigned char* data, size_t size);
     #pragma endregion 
 
 public:
@@ -175,6 +217,8 @@ public:
     
     void SetParallelTransmission(bool parallel) { _parallelTransmission = parallel; }
     bool GetParallelTransmission() const { return _parallelTransmission; }
+    void SetZeroCopyOutput(bool zeroCopy) { if (_zeroCopyOutput != zeroCopy) { InvalidateLastFrame(); _zeroCopyOutput = zeroCopy; } }
+    bool GetZeroCopyOutput() const { return _zeroCopyOutput; }
     
     int GetPacketsPerSecond() const;
     
@@ -205,6 +249,8 @@ public:
     bool IsOutputting() const { return _outputting; }
     size_t TxNonEmptyCount();
     bool TxEmpty();
+    // sent/late/skipped frame counts for an output sent on its own thread. false if it isnt
+    bool GetTransmitterStats(Output* output, uint64_t& sent, uint64_t& late, uint64_t& skipped) const;
     #pragma endregion 
 
     #pragma region Frame Handling
@@ -230,6 +276,7 @@ public:
     #pragma region Data Setting
     void SetOneChannel(int32_t channel, unsigned char data);
     void SetManyChannels(int32_t channel, unsigned char* data, size_t size);
+    void SetFrame(unsigned char* data, size_t size); // the whole frame from channel 0
     void AllOff(bool send = true);
     #pragma endregion 
 
@@ -0,0 +1,125 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "OutputTransmitter.h"
+#include "Output.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <log4cpp/Category.hh>
+
+OutputTransmitter::OutputTransmitter(Output* output, int suppressFrames) :
+    _output(output), _suppressFrames(suppressFrames)
+{
+    size_t channels = std::max(0, (int)output->GetChannels());
+    _working.resize(channels);
+    for (auto& f : _frames) {
+        f._data.resize(channels);
+    }
+    _thread = std::thread(&OutputTransmitter::Run, this);
+}
+
+OutputTransmitter::~OutputTransmitter()
+{
+    Stop();
+}
+
+void OutputTransmitter::Stop()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (!_thread.joinable()) return;
+
+    // any frame already handed over is still sent ... it is usually the all off frame
+    _stop = true;
+    Wake();
+    _thread.join();
+
+    logger_base.debug("OutputTransmitter: %s stopped. Sent %llu, late %llu, skipped %llu.",
+                      (const char*)_output->GetCommPort().c_str(),
+                      (unsigned long long)GetSent(), (unsigned long long)GetLate(), (unsigned long long)GetSkipped());
+}
+
+void OutputTransmitter::Wake()
+{
+    {
+        std::lock_guard<std::mutex> l(_wakeLock);
+    }
+    _wake.notify_one();
+}
+
+void OutputTransmitter::SetOneChannel(int32_t channel, uint8_t data)
+{
+    if (channel >= 0 && channel < (int32_t)_working.size()) {
+        _working[channel] = data;
+    }
+}
+
+void OutputTransmitter::SetManyChannels(int32_t channel, const uint8_t* data, size_t size)
+{
+    if (channel < 0 || channel >= (int32_t)_working.size()) return;
+    size = std::min(size, _working.size() - channel);
+    memcpy(&_working[channel], data, size);
+}
+
+void OutputTransmitter::AllOff()
+{
+    memset(_working.data(), 0x00, _working.size());
+}
+
+void OutputTransmitter::EndFrame(long frameMS)
+{
+    Frame& f = _frames[_back];
+    memcpy(f._data.data(), _working.data(), _working.size());
+    f._msec = _msec;
+    f._deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(frameMS);
+
+    int prev = _middle.exchange(_back | FRESH);
+    if (prev & FRESH) {
+        ++_skipped;
+    }
+    _back = prev & ~FRESH;
+    Wake();
+}
+
+void OutputTransmitter::SendHeartbeat()
+{
+    _heartbeat = true;
+    Wake();
+}
+
+void OutputTransmitter::Run()
+{
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> l(_wakeLock);
+            _wake.wait(l, [this] { return _stop || (_middle & FRESH) || _heartbeat; });
+        }
+
+        if (_heartbeat.exchange(false)) {
+            _output->SendHeartbeat();
+        }
+
+        if (_middle & FRESH) {
+            _front = _middle.exchange(_front) & ~FRESH;
+            Frame& f = _frames[_front];
+            _output->StartFrame(f._msec);
+            _output->SetManyChannels(0, f._data.data(), f._data.size());
+            _output->EndFrame(_suppressFrames);
+            ++_sent;
+            if (std::chrono::steady_clock::now() > f._deadline) {
+                ++_late;
+            }
+        }
+
+        if (_stop && !(_middle & FRESH)) break;
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+class Output;
+
+// Sends the frames for one output on its own thread.
+//
+// Used for the serial/USB outputs where writing a frame can block for a good part of the frame time. The
+// frame thread sets channels into a working copy of the output's channels as it would the output and at the
+// end of the frame the copy is handed over through a lock free triple buffer, so the frame thread never waits
+// on the port and the network outputs go out on time. The transmit thread always sends the newest frame ... a
+// frame replaced before it could be sent is counted as skipped and one which finished sending after the next
+// frame was due is counted as late.
+//
+// While a transmitter exists it is the only thing which may call the output's frame and data functions.
+class OutputTransmitter
+{
+    struct Frame
+    {
+        std::vector<uint8_t> _data;
+        long _msec = 0;
+        std::chrono::steady_clock::time_point _deadline;
+    };
+
+    static constexpr int FRESH = 4; // set in _middle when it holds a frame not yet taken by the transmit thread
+
+    Output* _output = nullptr;
+    int _suppressFrames = 0;
+
+    // only used by the frame thread
+    std::vector<uint8_t> _working;
+    long _msec = 0;
+    int _back = 0;
+
+    // only used by the transmit thread
+    int _front = 1;
+
+    Frame _frames[3];
+    std::atomic<int> _middle = 2;
+    std::atomic<bool> _heartbeat = false;
+    std::atomic<bool> _stop = false;
+    std::mutex _wakeLock; // only held to sleep and wake the transmit thread
+    std::condition_variable _wake;
+    std::thread _thread;
+
+    std::atomic<uint64_t> _sent = 0;
+    std::atomic<uint64_t> _late = 0;
+    std::atomic<uint64_t> _skipped = 0;
+
+    void Wake();
+    void Run();
+
+public:
+    OutputTransmitter(Output* output, int suppressFrames);
+    virtual ~OutputTransmitter();
+    void Stop();
+
+    Output* GetOutput() const { return _output; }
+
+    // frame thread. channel is zero based within the output
+    void StartFrame(long msec) { _msec = msec; }
+    void SetOneChannel(int32_t channel, uint8_t data);
+    void SetManyChannels(int32_t channel, const uint8_t* data, size_t size);
+    void AllOff();
+    // frameMS is how long until the next frame is due
+    void EndFrame(long frameMS);
+    void SendHeartbeat();
+
+    uint64_t GetSent() const { return _sent; }
+    uint64_t GetLate() const { return _late; }
+    uint64_t GetSkipped() const { return _skipped; }
+};
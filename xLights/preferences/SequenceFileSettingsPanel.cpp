@@ -46,6 +46,7 @@ const long SequenceFileSettingsPanel::ID_BUTTON_ADDMEDIA = wxNewId();
 const long SequenceFileSettingsPanel::ID_BUTTON_REMOVE_MEDIA = wxNewId();
 const long SequenceFileSettingsPanel::ID_STATICTEXT2 = wxNewId();
 const long SequenceFileSettingsPanel::ID_CHOICE_VIEW_DEFAULT = wxNewId();
+const long SequenceFileSettingsPanel::ID_CHECKBOX_BINARYCOPY = wxNewId();
 //*)
 
 BEGIN_EVENT_TABLE(SequenceFileSettingsPanel,wxPanel)
@@ -165,6 +166,10 @@ SequenceFileSettingsPanel::SequenceFileSettingsPanel(wxWindow* parent,xLightsFra
 	ViewDefaultChoice->SetMinSize(wxSize(200,-1));
 	ViewDefaultChoice->SetToolTip(_("This option is used to select which models will populate the master view when a new sequence is created."));
 	GridBagSizer1->Add(ViewDefaultChoice, wxGBPosition(3, 1), wxDefaultSpan, wxALL|wxEXPAND, 5);
+	CheckBox_BinaryCopy = new wxCheckBox(this, ID_CHECKBOX_BINARYCOPY, _("Keep Binary Copy Of Sequences For Fast Loading"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX_BINARYCOPY"));
+	CheckBox_BinaryCopy->SetValue(false);
+	CheckBox_BinaryCopy->SetToolTip(_("When a sequence is saved a .xsqb file is written beside the .xsq. It is used in place of the .xsq when opening as long as the .xsq has not changed since."));
+	GridBagSizer1->Add(CheckBox_BinaryCopy, wxGBPosition(11, 0), wxGBSpan(1, 2), wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
 	SetSizer(GridBagSizer1);
 	GridBagSizer1->Fit(this);
 	GridBagSizer1->SetSizeHints(this);
@@ -185,6 +190,7 @@ SequenceFileSettingsPanel::SequenceFileSettingsPanel(wxWindow* parent,xLightsFra
 	Connect(ID_BUTTON_ADDMEDIA,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnAddMediaButtonClick);
 	Connect(ID_BUTTON_REMOVE_MEDIA,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnRemoveMediaButtonClick);
 	Connect(ID_CHOICE_VIEW_DEFAULT,wxEVT_COMMAND_CHOICE_SELECTED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnViewDefaultChoiceSelect);
+	Connect(ID_CHECKBOX_BINARYCOPY,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnCheckBox_BinaryCopyClick);
 	//*)
 
 	GridBagSizer1->Fit(this);
@@ -207,6 +213,7 @@ bool SequenceFileSettingsPanel::TransferDataFromWindow() {
     frame->SetSaveFseqOnSave(FSEQSaveCheckBox->IsChecked());
     frame->SetModelBlendDefaultOff(ModelBlendDefaultChoice->GetSelection());
     frame->SetLowDefinitionRender(CheckBox_LowDefinitionRender->IsChecked());
+    frame->SetSaveBinarySequenceCopy(CheckBox_BinaryCopy->IsChecked());
 
     switch (AutoSaveIntervalChoice->GetSelection()) {
         case 0:
@@ -315,6 +322,7 @@ bool SequenceFileSettingsPanel::TransferDataToWindow() {
     RenderCacheChoice->SetStringSelection(rc);
     FSEQSaveCheckBox->SetValue(frame->SaveFseqOnSave());
     RenderOnSaveCheckBox->SetValue(frame->RenderOnSave());
+    CheckBox_BinaryCopy->SetValue(frame->SaveBinarySequenceCopy());
     
     ModelBlendDefaultChoice->SetSelection(frame->ModelBlendDefaultOff());
     switch (frame->AutoSaveInterval()) {
@@ -540,3 +548,10 @@ void SequenceFileSettingsPanel::OnChoice_MaximumRenderCacheSelect(wxCommandEvent
         TransferDataFromWindow();
     }
 }
+
+void SequenceFileSettingsPanel::OnCheckBox_BinaryCopyClick(wxCommandEvent& event)
+{
+    if (wxPreferencesEditor::ShouldApplyChangesImmediately()) {
+        TransferDataFromWindow();
+    }
+}
@@ -519,6 +519,13 @@ std::string Effect::GetSettingsAsJSON() const
     return mSettings.AsJSON();
 }
 
+// true if GetSettingsAsString() would return settings
+bool Effect::SettingsMatch(const std::string& settings) const
+{
+    std::unique_lock<std::recursive_mutex> lock(settingsLock);
+    return mSettings.MatchesString(settings);
+}
+
 void Effect::SetSettings(const std::string& settings, bool keepxsettings, bool json) {
     std::unique_lock<std::recursive_mutex> lock(settingsLock);
 
@@ -744,6 +751,12 @@ std::string Effect::GetPaletteAsString() const
     return mPaletteMap.AsString();
 }
 
+bool Effect::PaletteMatches(const std::string& palette) const
+{
+    std::unique_lock<std::recursive_mutex> lock(settingsLock);
+    return mPaletteMap.MatchesString(palette);
+}
+
 std::string Effect::GetPaletteAsJSON() const
 {
     std::unique_lock<std::recursive_mutex> lock(settingsLock);
@@ -121,6 +121,7 @@ public:
 
     std::string GetSettingsAsString() const;
     std::string GetSettingsAsJSON() const;
+    bool SettingsMatch(const std::string& settings) const;
     void SetSettings(const std::string &settings, bool keepxsettings, bool json = false);
     bool SettingsChanged(const std::string& settings);
     void ApplySetting(const std::string& id, const std::string& value, ValueCurve* vc, const std::string& vcid);
@@ -137,6 +138,7 @@ public:
     const SettingsMap &GetPaletteMap() const { return mPaletteMap; }
     std::string GetPaletteAsString() const;
     std::string GetPaletteAsJSON() const;
+    bool PaletteMatches(const std::string& palette) const;
     void SetPalette(const std::string& i);
     void SetColourOnlyPalette(const std::string& i, bool json = false);
     void CopyPalette(xlColorVector &target, xlColorCurveVector& newcc) const;
@@ -0,0 +1,138 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "UndoManager.h"
+#include "Element.h"
+#include "SequenceElements.h"
+#include <log4cpp/Category.hh>
+
+// The parts of the undo manager which read and change the sequence. The history itself is in UndoManager.cpp
+
+ModifiedEffectInfo::ModifiedEffectInfo( UndoStrings& strings, const std::string &element_name_, int layer_index_, Effect *ef)
+: element_name(strings.Add(element_name_)), layer_index(layer_index_), id(ef->GetID()),
+    settings(strings.AddSettings(ef->GetSettingsAsString())), palette(strings.AddSettings(ef->GetPaletteAsString())),
+    effectName(strings.Add(ef->GetEffectName())), effectType(ef->GetEffectIndex())
+{
+}
+
+void UndoManager::CaptureModifiedEffect( const std::string &element_name, int layer_index, Effect *ef )
+{
+    AddStep(mUndoSteps, UNDO_EFFECT_MODIFIED, new ModifiedEffectInfo( mStrings, element_name, layer_index, ef ));
+}
+
+AddedEffectInfo* UndoManager::UndoDeleted(const DeletedEffectInfo& info)
+{
+    Element* element = mParentSequence->GetElement(mStrings.Get(info.element_name));
+    if (element != nullptr)
+    {
+        EffectLayer* el = element->GetEffectLayerFromExclusiveIndex(info.layer_index);
+        if (el != nullptr)
+        {
+            Effect* eff = el->AddEffect(0,
+                mStrings.Get(info.name),
+                mStrings.GetSettings(info.settings),
+                mStrings.GetSettings(info.palette),
+                info.startTimeMS,
+                info.endTimeMS,
+                info.Selected,
+                info.Protected);
+
+            return new AddedEffectInfo(mStrings, el->GetParentElement()->GetModelName(), el->GetIndex(), eff->GetID());
+        }
+    }
+    return nullptr;
+}
+
+DeletedEffectInfo* UndoManager::UndoAdded(const AddedEffectInfo& info)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    Element* element = mParentSequence->GetElement(mStrings.Get(info.element_name));
+    if (element != nullptr)
+    {
+        EffectLayer* el = element->GetEffectLayerFromExclusiveIndex(info.layer_index);
+        if (el != nullptr)
+        {
+            Effect* eff = el->GetEffectFromID(info.id);
+            if (eff == nullptr)
+            {
+                logger_base.warn("UndoLastStep:UNDO_EFFECT_ADDED Effect not found %d.", info.id);
+                return nullptr;
+            }
+            DeletedEffectInfo* replaced = new DeletedEffectInfo(mStrings, el->GetParentElement()->GetModelName(), el->GetIndex(), eff->GetEffectName(), eff->GetSettingsAsString(), eff->GetPaletteAsString(), eff->GetStartTimeMS(), eff->GetEndTimeMS(), EFFECT_NOT_SELECTED, false);
+
+            // Delete the effect
+            el->DeleteEffect(info.id);
+            return replaced;
+        }
+    }
+    return nullptr;
+}
+
+MovedEffectInfo* UndoManager::UndoMoved(const MovedEffectInfo& info)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    Element* element = mParentSequence->GetElement(mStrings.Get(info.element_name));
+    if (element != nullptr)
+    {
+        EffectLayer* el = element->GetEffectLayerFromExclusiveIndex(info.layer_index);
+        if (el == nullptr)
+        {
+            logger_base.warn("UndoLastStep:UNDO_EFFECT_MOVED Element not found %d.", info.layer_index);
+        }
+        else
+        {
+            Effect* eff = el->GetEffectFromID(info.id);
+            if (eff != nullptr)
+            {
+                // Capture for other list
+                MovedEffectInfo* replaced = new MovedEffectInfo(mStrings, el->GetParentElement()->GetModelName(), el->GetIndex(), eff->GetID(), eff->GetStartTimeMS(), eff->GetEndTimeMS());
+
+                // Move the effect
+                eff->SetStartTimeMS(info.startTimeMS);
+                eff->SetEndTimeMS(info.endTimeMS);
+                return replaced;
+            }
+        }
+    }
+    return nullptr;
+}
+
+ModifiedEffectInfo* UndoManager::UndoModified(const ModifiedEffectInfo& info)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    Element* element = mParentSequence->GetElement(mStrings.Get(info.element_name));
+    if (element != nullptr)
+    {
+        EffectLayer* el = element->GetEffectLayerFromExclusiveIndex(info.layer_index);
+        if (el == nullptr)
+        {
+            logger_base.warn("UndoLastStep:UNDO_EFFECT_MODIFIED Element not found %d.", info.layer_index);
+        }
+        else
+        {
+            Effect* eff = el->GetEffectFromID(info.id);
+            if (eff != nullptr)
+            {
+                // Capture for other list
+                ModifiedEffectInfo* replaced = new ModifiedEffectInfo(mStrings, el->GetParentElement()->GetModelName(), el->GetIndex(), eff);
+
+                // Modify the effect
+                if (info.effectType >= 0) {
+                    eff->SetEffectName(mStrings.Get(info.effectName));
+                    eff->SetEffectIndex(info.effectType);
+                }
+                eff->SetSettings(mStrings.GetSettings(info.settings), false);
+                eff->SetPalette(mStrings.GetSettings(info.palette));
+                return replaced;
+            }
+        }
+    }
+    return nullptr;
+}
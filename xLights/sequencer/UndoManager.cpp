@@ -8,79 +8,366 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <wx/filename.h>
+
 #include "UndoManager.h"
-#include "Element.h"
-#include "SequenceElements.h"
+#include "../TempFileManager.h"
 #include <log4cpp/Category.hh>
 
-DeletedEffectInfo::DeletedEffectInfo( const std::string &element_name_, int layer_index_, const std::string &name_, const std::string &settings_,
+#include <algorithm>
+#include <cstring>
+
+uint32_t UndoStrings::Add(const std::string& s)
+{
+    auto it = _ids.find(std::string_view(s));
+    if (it != _ids.end()) return it->second;
+
+    uint32_t id = _strings.size();
+    _strings.push_back(s);
+    _ids[std::string_view(_strings.back())] = id;
+    _memory += sizeof(std::string) + _strings.back().capacity() + sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void*);
+    return id;
+}
+
+std::vector<uint32_t> UndoStrings::AddSettings(const std::string& settings)
+{
+    std::vector<uint32_t> res;
+    size_t start = 0;
+    while (true) {
+        size_t end = settings.find(',', start);
+        if (end == std::string::npos) {
+            res.push_back(Add(settings.substr(start)));
+            break;
+        }
+        res.push_back(Add(settings.substr(start, end - start)));
+        start = end + 1;
+    }
+    res.shrink_to_fit();
+    return res;
+}
+
+std::string UndoStrings::GetSettings(const std::vector<uint32_t>& settings) const
+{
+    std::string res;
+    for (size_t i = 0; i < settings.size(); i++) {
+        if (i > 0) res += ",";
+        res += _strings[settings[i]];
+    }
+    return res;
+}
+
+void UndoStrings::Clear()
+{
+    _ids.clear();
+    _strings.clear();
+    _memory = 0;
+}
+
+DeletedEffectInfo::DeletedEffectInfo( UndoStrings& strings, const std::string &element_name_, int layer_index_, const std::string &name_, const std::string &settings_,
                                       const std::string &palette_, int startTimeMS_, int endTimeMS_, int Selected_, bool Protected_ )
-: element_name(element_name_), layer_index(layer_index_), name(name_), settings(settings_),
-  palette(palette_), startTimeMS(startTimeMS_), endTimeMS(endTimeMS_), Selected(Selected_), Protected(Protected_)
+: element_name(strings.Add(element_name_)), layer_index(layer_index_), name(strings.Add(name_)), settings(strings.AddSettings(settings_)),
+  palette(strings.AddSettings(palette_)), startTimeMS(startTimeMS_), endTimeMS(endTimeMS_), Selected(Selected_), Protected(Protected_)
 {
 }
 
-AddedEffectInfo::AddedEffectInfo( const std::string &element_name_, int layer_index_, int id_ )
-: element_name(element_name_), layer_index(layer_index_), id(id_)
+size_t DeletedEffectInfo::GetMemoryUsage() const
 {
+    return sizeof(DeletedEffectInfo) + (settings.capacity() + palette.capacity()) * sizeof(uint32_t);
 }
 
-MovedEffectInfo::MovedEffectInfo( const std::string &element_name_, int layer_index_, int id_, int startTimeMS_, int endTimeMS_ )
-: element_name(element_name_), layer_index(layer_index_), id(id_), startTimeMS(startTimeMS_), endTimeMS(endTimeMS_)
+AddedEffectInfo::AddedEffectInfo( UndoStrings& strings, const std::string &element_name_, int layer_index_, int id_ )
+: element_name(strings.Add(element_name_)), layer_index(layer_index_), id(id_)
 {
 }
 
-ModifiedEffectInfo::ModifiedEffectInfo( const std::string &element_name_, int layer_index_, int id_, const std::string &settings_, const std::string &palette_ )
-: element_name(element_name_), layer_index(layer_index_), id(id_), settings(settings_), palette(palette_), effectName(""), effectType(-1)
+MovedEffectInfo::MovedEffectInfo( UndoStrings& strings, const std::string &element_name_, int layer_index_, int id_, int startTimeMS_, int endTimeMS_ )
+: element_name(strings.Add(element_name_)), layer_index(layer_index_), id(id_), startTimeMS(startTimeMS_), endTimeMS(endTimeMS_)
 {
 }
 
+ModifiedEffectInfo::ModifiedEffectInfo( UndoStrings& strings, const std::string &element_name_, int layer_index_, int id_, const std::string &settings_, const std::string &palette_ )
+: element_name(strings.Add(element_name_)), layer_index(layer_index_), id(id_), settings(strings.AddSettings(settings_)), palette(strings.AddSettings(palette_)),
+  effectName(strings.Add("")), effectType(-1)
+{
+}
 
-ModifiedEffectInfo::ModifiedEffectInfo( const std::string &element_name_, int layer_index_, Effect *ef)
-: element_name(element_name_), layer_index(layer_index_), id(ef->GetID()),
-    settings(ef->GetSettingsAsString()), palette(ef->GetPaletteAsString()), effectName(ef->GetEffectName()), effectType(ef->GetEffectIndex())
+size_t ModifiedEffectInfo::GetMemoryUsage() const
 {
+    return sizeof(ModifiedEffectInfo) + (settings.capacity() + palette.capacity()) * sizeof(uint32_t);
 }
 
 UndoStep::UndoStep( UNDO_ACTIONS action )
-: undo_action(action)
+: undo_action(action), memory(sizeof(UndoStep))
+{
+}
+
+UndoStep::~UndoStep()
 {
+    for (auto it : deleted_effect_info) delete it;
+    for (auto it : added_effect_info) delete it;
+    for (auto it : moved_effect_info) delete it;
+    for (auto it : modified_effect_info) delete it;
 }
 
-UndoStep::UndoStep( UNDO_ACTIONS action, DeletedEffectInfo* effect_info )
-: undo_action(action)
+size_t UndoStep::Add( DeletedEffectInfo* effect_info )
 {
     deleted_effect_info.push_back(effect_info);
+    size_t const m = effect_info->GetMemoryUsage() + sizeof(void*);
+    memory += m;
+    return m;
 }
 
-UndoStep::UndoStep( UNDO_ACTIONS action, AddedEffectInfo* effect_info )
-: undo_action(action)
+size_t UndoStep::Add( AddedEffectInfo* effect_info )
 {
     added_effect_info.push_back(effect_info);
+    size_t const m = effect_info->GetMemoryUsage() + sizeof(void*);
+    memory += m;
+    return m;
 }
 
-UndoStep::UndoStep( UNDO_ACTIONS action, MovedEffectInfo* effect_info )
-: undo_action(action)
+size_t UndoStep::Add( MovedEffectInfo* effect_info )
 {
     moved_effect_info.push_back(effect_info);
+    size_t const m = effect_info->GetMemoryUsage() + sizeof(void*);
+    memory += m;
+    return m;
 }
 
-UndoStep::UndoStep( UNDO_ACTIONS action, ModifiedEffectInfo* effect_info )
-: undo_action(action)
+size_t UndoStep::Add( ModifiedEffectInfo* effect_info )
 {
     modified_effect_info.push_back(effect_info);
+    size_t const m = effect_info->GetMemoryUsage() + sizeof(void*);
+    memory += m;
+    return m;
+}
+
+size_t UndoStep::RemoveLast()
+{
+    size_t m = 0;
+    switch (undo_action)
+    {
+    case UNDO_EFFECT_DELETED:
+        if (!deleted_effect_info.empty()) {
+            m = deleted_effect_info.back()->GetMemoryUsage() + sizeof(void*);
+            delete deleted_effect_info.back();
+            deleted_effect_info.pop_back();
+        }
+        break;
+    case UNDO_EFFECT_ADDED:
+        if (!added_effect_info.empty()) {
+            m = added_effect_info.back()->GetMemoryUsage() + sizeof(void*);
+            delete added_effect_info.back();
+            added_effect_info.pop_back();
+        }
+        break;
+    case UNDO_EFFECT_MOVED:
+        if (!moved_effect_info.empty()) {
+            m = moved_effect_info.back()->GetMemoryUsage() + sizeof(void*);
+            delete moved_effect_info.back();
+            moved_effect_info.pop_back();
+        }
+        break;
+    case UNDO_EFFECT_MODIFIED:
+        if (!modified_effect_info.empty()) {
+            m = modified_effect_info.back()->GetMemoryUsage() + sizeof(void*);
+            delete modified_effect_info.back();
+            modified_effect_info.pop_back();
+        }
+        break;
+    case UNDO_MARKER:
+        break;
+    }
+    memory -= m;
+    return m;
+}
+
+bool UndoStep::IsEmpty() const
+{
+    return deleted_effect_info.empty() && added_effect_info.empty() && moved_effect_info.empty() && modified_effect_info.empty();
+}
+
+#pragma region Spill File
+// Spilled operations are written as their steps with the strings in full so reading them back does not depend on
+// the string ids of the time
+
+static void WriteInt(std::string& buffer, int32_t value)
+{
+    buffer.append((const char*)&value, sizeof(value));
+}
+
+static void WriteString(std::string& buffer, const std::string& value)
+{
+    WriteInt(buffer, (int32_t)value.size());
+    buffer.append(value);
+}
+
+static void WriteSettings(std::string& buffer, const UndoStrings& strings, const std::vector<uint32_t>& settings)
+{
+    WriteString(buffer, strings.GetSettings(settings));
+}
+
+class SpillReader
+{
+public:
+    SpillReader(const std::string& buffer) : _pos(buffer.data()), _end(buffer.data() + buffer.size()) {}
+
+    int32_t ReadInt()
+    {
+        int32_t value = 0;
+        if ((size_t)(_end - _pos) < sizeof(value)) {
+            _ok = false;
+            return 0;
+        }
+        memcpy(&value, _pos, sizeof(value));
+        _pos += sizeof(value);
+        return value;
+    }
+    std::string ReadString()
+    {
+        int32_t size = ReadInt();
+        if (size < 0 || (size_t)(_end - _pos) < (size_t)size) {
+            _ok = false;
+            return "";
+        }
+        std::string value(_pos, size);
+        _pos += size;
+        return value;
+    }
+    bool IsOk() const { return _ok; }
+
+private:
+    const char* _pos;
+    const char* _end;
+    bool _ok = true;
+};
+
+static void WriteStep(std::string& buffer, const UndoStrings& strings, const UndoStep* step)
+{
+    WriteInt(buffer, step->undo_action);
+    switch (step->undo_action)
+    {
+    case UNDO_EFFECT_DELETED:
+        WriteInt(buffer, (int32_t)step->deleted_effect_info.size());
+        for (const auto& it : step->deleted_effect_info) {
+            WriteString(buffer, strings.Get(it->element_name));
+            WriteInt(buffer, it->layer_index);
+            WriteString(buffer, strings.Get(it->name));
+            WriteSettings(buffer, strings, it->settings);
+            WriteSettings(buffer, strings, it->palette);
+            WriteInt(buffer, it->startTimeMS);
+            WriteInt(buffer, it->endTimeMS);
+            WriteInt(buffer, it->Selected);
+            WriteInt(buffer, it->Protected);
+        }
+        break;
+    case UNDO_EFFECT_ADDED:
+        WriteInt(buffer, (int32_t)step->added_effect_info.size());
+        for (const auto& it : step->added_effect_info) {
+            WriteString(buffer, strings.Get(it->element_name));
+            WriteInt(buffer, it->layer_index);
+            WriteInt(buffer, it->id);
+        }
+        break;
+    case UNDO_EFFECT_MOVED:
+        WriteInt(buffer, (int32_t)step->moved_effect_info.size());
+        for (const auto& it : step->moved_effect_info) {
+            WriteString(buffer, strings.Get(it->element_name));
+            WriteInt(buffer, it->layer_index);
+            WriteInt(buffer, it->id);
+            WriteInt(buffer, it->startTimeMS);
+            WriteInt(buffer, it->endTimeMS);
+        }
+        break;
+    case UNDO_EFFECT_MODIFIED:
+        WriteInt(buffer, (int32_t)step->modified_effect_info.size());
+        for (const auto& it : step->modified_effect_info) {
+            WriteString(buffer, strings.Get(it->element_name));
+            WriteInt(buffer, it->layer_index);
+            WriteInt(buffer, it->id);
+            WriteSettings(buffer, strings, it->settings);
+            WriteSettings(buffer, strings, it->palette);
+            WriteString(buffer, strings.Get(it->effectName));
+            WriteInt(buffer, it->effectType);
+        }
+        break;
+    case UNDO_MARKER:
+        WriteInt(buffer, 0);
+        break;
+    }
 }
 
+static UndoStep* ReadStep(SpillReader& reader, UndoStrings& strings)
+{
+    UndoStep* step = new UndoStep((UNDO_ACTIONS)reader.ReadInt());
+    int32_t count = reader.ReadInt();
+    for (int32_t i = 0; i < count && reader.IsOk(); i++) {
+        switch (step->undo_action)
+        {
+        case UNDO_EFFECT_DELETED:
+        {
+            std::string element_name = reader.ReadString();
+            int layer_index = reader.ReadInt();
+            std::string name = reader.ReadString();
+            std::string settings = reader.ReadString();
+            std::string palette = reader.ReadString();
+            int startTimeMS = reader.ReadInt();
+            int endTimeMS = reader.ReadInt();
+            int Selected = reader.ReadInt();
+            bool Protected = reader.ReadInt() != 0;
+            step->Add(new DeletedEffectInfo(strings, element_name, layer_index, name, settings, palette, startTimeMS, endTimeMS, Selected, Protected));
+        }
+        break;
+        case UNDO_EFFECT_ADDED:
+        {
+            std::string element_name = reader.ReadString();
+            int layer_index = reader.ReadInt();
+            int id = reader.ReadInt();
+            step->Add(new AddedEffectInfo(strings, element_name, layer_index, id));
+        }
+        break;
+        case UNDO_EFFECT_MOVED:
+        {
+            std::string element_name = reader.ReadString();
+            int layer_index = reader.ReadInt();
+            int id = reader.ReadInt();
+            int startTimeMS = reader.ReadInt();
+            int endTimeMS = reader.ReadInt();
+            step->Add(new MovedEffectInfo(strings, element_name, layer_index, id, startTimeMS, endTimeMS));
+        }
+        break;
+        case UNDO_EFFECT_MODIFIED:
+        {
+            std::string element_name = reader.ReadString();
+            int layer_index = reader.ReadInt();
+            int id = reader.ReadInt();
+            std::string settings = reader.ReadString();
+            std::string palette = reader.ReadString();
+            ModifiedEffectInfo* info = new ModifiedEffectInfo(strings, element_name, layer_index, id, settings, palette);
+            info->effectName = strings.Add(reader.ReadString());
+            info->effectType = reader.ReadInt();
+            step->Add(info);
+        }
+        break;
+        case UNDO_MARKER:
+            break;
+        }
+    }
+    return step;
+}
+#pragma endregion
+
 UndoManager::UndoManager(SequenceElements* parent)
-: mParentSequence(parent), mCaptureUndo(false)
+: mParentSequence(parent), mCaptureUndo(false), mMemory(0), mMemoryLimit(256 * 1024 * 1024), mCompactedStrings(0)
 {
 }
 
 UndoManager::~UndoManager()
 {
-    for( size_t i = 0; i < mUndoSteps.size(); i++ )
-    {
-        delete mUndoSteps[i];
+    DeleteSteps(mUndoSteps);
+    DeleteSteps(mRedoSteps);
+    ClearSpilled();
+    if (mSpillFileName != "") {
+        wxRemoveFile(mSpillFileName);
     }
 }
 
@@ -89,6 +376,32 @@ void UndoManager::SetCaptureUndo( bool value )
     mCaptureUndo = value;
 }
 
+template<typename T>
+void UndoManager::AddStep(std::vector<UndoStep*> &list, UNDO_ACTIONS action, T* effect_info)
+{
+    // consecutive changes of the same kind are batched into one step
+    if (list.empty() || list.back()->undo_action != action) {
+        UndoStep* step = new UndoStep(action);
+        mMemory += step->GetMemoryUsage();
+        list.push_back(step);
+    }
+    mMemory += list.back()->Add(effect_info);
+}
+
+void UndoManager::DeleteStep(UndoStep* step)
+{
+    mMemory -= std::min(mMemory, step->GetMemoryUsage());
+    delete step;
+}
+
+void UndoManager::DeleteSteps(std::vector<UndoStep*> &list)
+{
+    for (auto it : list) {
+        DeleteStep(it);
+    }
+    list.clear();
+}
+
 void UndoManager::RemoveUnusedMarkers()
 {
     if( mUndoSteps.size() > 0 )
@@ -98,6 +411,7 @@ void UndoManager::RemoveUnusedMarkers()
         if( last_action->undo_action == UNDO_MARKER )
         {
             mUndoSteps.pop_back();
+            DeleteStep(last_action);
         }
     }
 }
@@ -117,26 +431,22 @@ bool UndoManager::ChangeCaptured()
 
 void UndoManager::Clear() {
     RemoveUnusedMarkers();
-    for (size_t i = 0; i < mUndoSteps.size(); i++)
-    {
-        delete mUndoSteps[i];
-    }
-    mUndoSteps.clear();
+    DeleteSteps(mUndoSteps);
     ClearRedo();
+    ClearSpilled();
+    mStrings.Clear();
+    mCompactedStrings = 0;
+    mMemory = 0;
 }
 
 void UndoManager::ClearRedo() {
-    for (size_t i = 0; i < mRedoSteps.size(); i++)
-    {
-        delete mRedoSteps[i];
-    }
-    mRedoSteps.clear();
+    DeleteSteps(mRedoSteps);
 }
 
 bool UndoManager::CanUndo()
 {
     RemoveUnusedMarkers();
-    return mUndoSteps.size() > 0;
+    return mUndoSteps.size() > 0 || mSpilled.size() > 0;
 }
 
 bool UndoManager::CanRedo()
@@ -148,55 +458,53 @@ void UndoManager::CreateUndoStep()
 {
     ClearRedo();
     RemoveUnusedMarkers();
+    LimitMemory();
     UndoStep* action = new UndoStep(UNDO_MARKER);
+    mMemory += action->GetMemoryUsage();
     mUndoSteps.push_back(action);
 }
 
 void UndoManager::CaptureEffectToBeDeleted( const std::string &element_name, int layer_index, const std::string &name, const std::string &settings,
                                             const std::string &palette, int startTimeMS, int endTimeMS, int Selected, bool Protected )
 {
-    DeletedEffectInfo* effect_undo_action = new DeletedEffectInfo( element_name, layer_index, name, settings, palette, startTimeMS, endTimeMS, Selected, Protected );
-    UndoStep* action = new UndoStep(UNDO_EFFECT_DELETED, effect_undo_action);
-    mUndoSteps.push_back(action);
+    AddStep(mUndoSteps, UNDO_EFFECT_DELETED, new DeletedEffectInfo( mStrings, element_name, layer_index, name, settings, palette, startTimeMS, endTimeMS, Selected, Protected ));
 }
 
 void UndoManager::CaptureAddedEffect( const std::string &element_name, int layer_index, int id )
 {
-    AddedEffectInfo* effect_undo_action = new AddedEffectInfo( element_name, layer_index, id );
-    UndoStep* action = new UndoStep(UNDO_EFFECT_ADDED, effect_undo_action);
-    mUndoSteps.push_back(action);
+    AddStep(mUndoSteps, UNDO_EFFECT_ADDED, new AddedEffectInfo( mStrings, element_name, layer_index, id ));
 }
 
 void UndoManager::CaptureEffectToBeMoved( const std::string &element_name, int layer_index, int id, int startTimeMS, int endTimeMS )
 {
-    MovedEffectInfo* effect_undo_action = new MovedEffectInfo( element_name, layer_index, id, startTimeMS, endTimeMS );
-    UndoStep* action = new UndoStep(UNDO_EFFECT_MOVED, effect_undo_action);
-    mUndoSteps.push_back(action);
+    AddStep(mUndoSteps, UNDO_EFFECT_MOVED, new MovedEffectInfo( mStrings, element_name, layer_index, id, startTimeMS, endTimeMS ));
 }
 
 void UndoManager::CaptureModifiedEffect( const std::string &element_name, int layer_index, int id, const std::string &settings, const std::string &palette )
 {
-    ModifiedEffectInfo* effect_undo_action = new ModifiedEffectInfo( element_name, layer_index, id, settings, palette );
-    UndoStep* action = new UndoStep(UNDO_EFFECT_MODIFIED, effect_undo_action);
-    mUndoSteps.push_back(action);
+    AddStep(mUndoSteps, UNDO_EFFECT_MODIFIED, new ModifiedEffectInfo( mStrings, element_name, layer_index, id, settings, palette ));
 }
 
-void UndoManager::CaptureModifiedEffect( const std::string &element_name, int layer_index, Effect *ef )
-{
-    ModifiedEffectInfo* effect_undo_action = new ModifiedEffectInfo( element_name, layer_index, ef );
-    UndoStep* action = new UndoStep(UNDO_EFFECT_MODIFIED, effect_undo_action);
-    mUndoSteps.push_back(action);
-}
+// drops the last change captured
 void UndoManager::CancelLastStep() {
     if (!mUndoSteps.empty()) {
-        delete mUndoSteps.back();
-        mUndoSteps.pop_back();
+        UndoStep* step = mUndoSteps.back();
+        mMemory -= std::min(mMemory, step->RemoveLast());
+        if (step->IsEmpty()) {
+            mUndoSteps.pop_back();
+            DeleteStep(step);
+        }
     }
 }
 
 void UndoManager::UndoLastStep()
 {
+    RemoveUnusedMarkers();
+    if (mUndoSteps.empty()) {
+        LoadSpilled();
+    }
     UndoStep* action = new UndoStep(UNDO_MARKER);
+    mMemory += action->GetMemoryUsage();
     mRedoSteps.push_back(action);
     ProcessUndoStep(mUndoSteps, mRedoSteps);
 }
@@ -204,141 +512,56 @@ void UndoManager::UndoLastStep()
 void UndoManager::RedoLastStep()
 {
     UndoStep* action = new UndoStep(UNDO_MARKER);
+    mMemory += action->GetMemoryUsage();
     mUndoSteps.push_back(action);
     ProcessUndoStep(mRedoSteps, mUndoSteps);
 }
 
+// Puts back the steps of the last operation on fromList, capturing what each change replaced on toList so it can be
+// put back in turn. The changes themselves are made to the sequence in UndoApply.cpp
 void UndoManager::ProcessUndoStep(std::vector<UndoStep*> &fromList, std::vector<UndoStep*> &toList)
 {
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     bool done = false;
     while (fromList.size() > 0 && !done)
     {
         UndoStep* next_action = fromList.back();
+        // the changes batched in a step are undone in the reverse of the order they were made
         switch (next_action->undo_action)
         {
         case UNDO_MARKER:
             done = true;
             break;
         case UNDO_EFFECT_DELETED:
-        {
-            if (next_action->deleted_effect_info.size() == 0) {
-                logger_base.crit("UndoManager::ProcessUndoStep about to access past end of array. This wont end well. XXX");
-            }
-            Element* element = mParentSequence->GetElement(next_action->deleted_effect_info[0]->element_name);
-            if (element != nullptr)
+            for (auto it = next_action->deleted_effect_info.rbegin(); it != next_action->deleted_effect_info.rend(); ++it)
             {
-                EffectLayer* el = element->GetEffectLayerFromExclusiveIndex(next_action->deleted_effect_info[0]->layer_index);
-                if (el != nullptr)
-                {
-                    Effect* eff = el->AddEffect(0,
-                        next_action->deleted_effect_info[0]->name,
-                        next_action->deleted_effect_info[0]->settings,
-                        next_action->deleted_effect_info[0]->palette,
-                        next_action->deleted_effect_info[0]->startTimeMS,
-                        next_action->deleted_effect_info[0]->endTimeMS,
-                        next_action->deleted_effect_info[0]->Selected,
-                        next_action->deleted_effect_info[0]->Protected);
-
-                    // Move effect to other list
-                    AddedEffectInfo* effect_undo_action = new AddedEffectInfo(el->GetParentElement()->GetModelName(), el->GetIndex(), eff->GetID());
-                    UndoStep* action = new UndoStep(UNDO_EFFECT_ADDED, effect_undo_action);
-                    toList.push_back(action);
-                }
+                AddedEffectInfo* replaced = UndoDeleted(**it);
+                if (replaced != nullptr) AddStep(toList, UNDO_EFFECT_ADDED, replaced);
             }
-        }
-        break;
+            break;
         case UNDO_EFFECT_ADDED:
-        {
-            if (next_action->added_effect_info.size() == 0) {
-                logger_base.crit("UndoManager::ProcessUndoStep about to access past end of array. This wont end well. AAA");
-            }
-            Element* element = mParentSequence->GetElement(next_action->added_effect_info[0]->element_name);
-            if (element != nullptr)
+            for (auto it = next_action->added_effect_info.rbegin(); it != next_action->added_effect_info.rend(); ++it)
             {
-                EffectLayer* el = element->GetEffectLayerFromExclusiveIndex(next_action->added_effect_info[0]->layer_index);
-                if (el != nullptr)
-                {
-                    // Move effect to other list
-                    Effect* eff = el->GetEffectFromID(next_action->added_effect_info[0]->id);
-                    DeletedEffectInfo* effect_undo_action = new DeletedEffectInfo(el->GetParentElement()->GetModelName(), el->GetIndex(), eff->GetEffectName(), eff->GetSettingsAsString(), eff->GetPaletteAsString(), eff->GetStartTimeMS(), eff->GetEndTimeMS(), EFFECT_NOT_SELECTED, false);
-                    UndoStep* action = new UndoStep(UNDO_EFFECT_DELETED, effect_undo_action);
-                    toList.push_back(action);
-
-                    // Delete the effect
-                    el->DeleteEffect(next_action->added_effect_info[0]->id);
-                }
+                DeletedEffectInfo* replaced = UndoAdded(**it);
+                if (replaced != nullptr) AddStep(toList, UNDO_EFFECT_DELETED, replaced);
             }
-        }
-        break;
+            break;
         case UNDO_EFFECT_MOVED:
-        {
-            if (next_action->moved_effect_info.size() == 0) {
-                logger_base.crit("UndoManager::ProcessUndoStep about to access past end of array. This wont end well. BBB");
-            }
-            Element* element = mParentSequence->GetElement(next_action->moved_effect_info[0]->element_name);
-            if (element != nullptr)
+            for (auto it = next_action->moved_effect_info.rbegin(); it != next_action->moved_effect_info.rend(); ++it)
             {
-                EffectLayer* el = element->GetEffectLayerFromExclusiveIndex(next_action->moved_effect_info[0]->layer_index);
-                if (el == nullptr)
-                {
-                    logger_base.warn("UndoLastStep:UNDO_EFFECT_MOVED Element not found %d.", next_action->moved_effect_info[0]->layer_index);
-                }
-                else
-                {
-                    Effect* eff = el->GetEffectFromID(next_action->moved_effect_info[0]->id);
-                    if (eff != nullptr)
-                    {
-                        // Capture for other list
-                        MovedEffectInfo* effect_undo_action = new MovedEffectInfo(el->GetParentElement()->GetModelName(), el->GetIndex(), eff->GetID(), eff->GetStartTimeMS(), eff->GetEndTimeMS());
-                        UndoStep* action = new UndoStep(UNDO_EFFECT_MOVED, effect_undo_action);
-                        toList.push_back(action);
-
-                        // Move the effect
-                        eff->SetStartTimeMS(next_action->moved_effect_info[0]->startTimeMS);
-                        eff->SetEndTimeMS(next_action->moved_effect_info[0]->endTimeMS);
-                    }
-                }
+                MovedEffectInfo* replaced = UndoMoved(**it);
+                if (replaced != nullptr) AddStep(toList, UNDO_EFFECT_MOVED, replaced);
             }
-        }
-        break;
+            break;
         case UNDO_EFFECT_MODIFIED:
-        {
-            if (next_action->modified_effect_info.size() == 0) {
-                logger_base.crit("UndoManager::ProcessUndoStep about to access past end of array. This wont end well. CCC");
-            }
-            Element* element = mParentSequence->GetElement(next_action->modified_effect_info[0]->element_name);
-            if (element != nullptr)
+            for (auto it = next_action->modified_effect_info.rbegin(); it != next_action->modified_effect_info.rend(); ++it)
             {
-                EffectLayer* el = element->GetEffectLayerFromExclusiveIndex(next_action->modified_effect_info[0]->layer_index);
-                if (el == nullptr)
-                {
-                    logger_base.warn("UndoLastStep:UNDO_EFFECT_MODIFIED Element not found %d.", next_action->modified_effect_info[0]->layer_index);
-                }
-                else
-                {
-                    Effect* eff = el->GetEffectFromID(next_action->modified_effect_info[0]->id);
-                    if (eff != nullptr)
-                    {
-                        // Capture for other list
-                        ModifiedEffectInfo* effect_undo_action = new ModifiedEffectInfo(el->GetParentElement()->GetModelName(), el->GetIndex(), eff);
-                        UndoStep* action = new UndoStep(UNDO_EFFECT_MODIFIED, effect_undo_action);
-                        toList.push_back(action);
-
-                        // Modify the effect
-                        if (next_action->modified_effect_info[0]->effectType >= 0) {
-                            eff->SetEffectName(next_action->modified_effect_info[0]->effectName);
-                            eff->SetEffectIndex(next_action->modified_effect_info[0]->effectType);
-                        }
-                        eff->SetSettings(next_action->modified_effect_info[0]->settings, false);
-                        eff->SetPalette(next_action->modified_effect_info[0]->palette);
-                    }
-                }
+                ModifiedEffectInfo* replaced = UndoModified(**it);
+                if (replaced != nullptr) AddStep(toList, UNDO_EFFECT_MODIFIED, replaced);
             }
-        }
-        break;
+            break;
         }
         fromList.pop_back();
+        DeleteStep(next_action);
     }
 }
 
@@ -346,26 +569,32 @@ std::string UndoManager::GetUndoString()
 {
     std::string undo_string = "Undo";
 
+    UNDO_ACTIONS action = UNDO_MARKER;
     if (mUndoSteps.size() > 0)
     {
-        UndoStep* next_action = mUndoSteps.back();
-        switch (next_action->undo_action)
-        {
-        case UNDO_EFFECT_DELETED:
-            undo_string = "Undo: Effect(s) Deleted";
-            break;
-        case UNDO_EFFECT_ADDED:
-            undo_string = "Undo: Effect(s) Added";
-            break;
-        case UNDO_EFFECT_MOVED:
-            undo_string = "Undo: Effect(s) Moved";
-            break;
-        case UNDO_EFFECT_MODIFIED:
-            undo_string = "Undo: Effect(s) Modified";
-            break;
-        case UNDO_MARKER:
-            break;
-        }
+        action = mUndoSteps.back()->undo_action;
+    }
+    else if (mSpilled.size() > 0)
+    {
+        action = mSpilled.back().lastAction;
+    }
+
+    switch (action)
+    {
+    case UNDO_EFFECT_DELETED:
+        undo_string = "Undo: Effect(s) Deleted";
+        break;
+    case UNDO_EFFECT_ADDED:
+        undo_string = "Undo: Effect(s) Added";
+        break;
+    case UNDO_EFFECT_MOVED:
+        undo_string = "Undo: Effect(s) Moved";
+        break;
+    case UNDO_EFFECT_MODIFIED:
+        undo_string = "Undo: Effect(s) Modified";
+        break;
+    case UNDO_MARKER:
+        break;
     }
     return undo_string;
 }
@@ -397,3 +626,168 @@ std::string UndoManager::GetRedoString()
     }
     return redo_string;
 }
+
+size_t UndoManager::GetSpilledSize() const
+{
+    size_t size = 0;
+    for (const auto& it : mSpilled) {
+        size += it.size;
+    }
+    return size;
+}
+
+std::string UndoManager::GetUsageString() const
+{
+    return wxString::Format("%.1fMB in memory (%d strings), %.1fMB in %d operations written to disk.",
+                            (double)GetMemoryUsage() / (1024.0 * 1024.0), (int)mStrings.GetCount(),
+                            (double)GetSpilledSize() / (1024.0 * 1024.0), (int)mSpilled.size()).ToStdString();
+}
+
+// Called as each operation starts so everything in mUndoSteps is a whole operation. The newest is always kept
+void UndoManager::LimitMemory()
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    // strings only dropped or spilled steps used are still held so every so often rebuild them from what is left
+    if (mStrings.GetMemoryUsage() > mMemoryLimit / 2 && mStrings.GetMemoryUsage() > 2 * mCompactedStrings) {
+        CompactStrings();
+    }
+
+    if (GetMemoryUsage() <= mMemoryLimit) return;
+
+    // spilling frees the steps but not their strings so spill until the steps fit beside the strings as they are,
+    // then rebuild the strings and go again if the ones still needed do not leave enough room
+    while (GetMemoryUsage() > mMemoryLimit) {
+        size_t const strings = std::min(mStrings.GetMemoryUsage(), mMemoryLimit);
+        bool spilled = false;
+        while (mMemory + strings > mMemoryLimit && SpillOldest()) {
+            spilled = true;
+        }
+        if (!spilled) break;
+        CompactStrings();
+    }
+
+    logger_base.debug("Undo history: %s", (const char*)GetUsageString().c_str());
+}
+
+bool UndoManager::SpillOldest()
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    // the oldest operation runs up to the next marker
+    size_t end = 1;
+    while (end < mUndoSteps.size() && mUndoSteps[end]->undo_action != UNDO_MARKER) {
+        ++end;
+    }
+    if (end >= mUndoSteps.size()) return false;
+
+    if (!mSpillFile.IsOpened()) {
+        if (mSpillFileName == "") {
+            mSpillFileName = wxFileName::CreateTempFileName("xLightsUndo").ToStdString();
+            if (mSpillFileName == "") return false;
+            TempFileManager::GetTempFileManager().AddTempFile(mSpillFileName);
+        }
+        if (!mSpillFile.Open(mSpillFileName, wxFile::read_write)) {
+            logger_base.error("Unable to open undo file %s.", (const char*)mSpillFileName.c_str());
+            return false;
+        }
+    }
+
+    std::string buffer;
+    WriteInt(buffer, (int32_t)end);
+    for (size_t i = 0; i < end; i++) {
+        WriteStep(buffer, mStrings, mUndoSteps[i]);
+    }
+
+    SpilledSteps spilled;
+    spilled.offset = mSpilled.empty() ? 0 : mSpilled.back().offset + mSpilled.back().size;
+    spilled.size = buffer.size();
+    spilled.lastAction = mUndoSteps[end - 1]->undo_action;
+    if (mSpillFile.Seek(spilled.offset) == wxInvalidOffset || mSpillFile.Write(buffer.data(), buffer.size()) != buffer.size()) {
+        logger_base.error("Unable to write to undo file %s.", (const char*)mSpillFileName.c_str());
+        return false;
+    }
+    mSpilled.push_back(spilled);
+
+    for (size_t i = 0; i < end; i++) {
+        DeleteStep(mUndoSteps[i]);
+    }
+    mUndoSteps.erase(mUndoSteps.begin(), mUndoSteps.begin() + end);
+    return true;
+}
+
+// reads back the newest spilled operation ahead of anything in mUndoSteps
+bool UndoManager::LoadSpilled()
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (mSpilled.empty() || !mSpillFile.IsOpened()) return false;
+
+    SpilledSteps spilled = mSpilled.back();
+    mSpilled.pop_back();
+
+    std::string buffer(spilled.size, '\0');
+    if (mSpillFile.Seek(spilled.offset) == wxInvalidOffset || mSpillFile.Read(&buffer[0], spilled.size) != (ssize_t)spilled.size) {
+        logger_base.error("Unable to read from undo file %s. Older undo history has been lost.", (const char*)mSpillFileName.c_str());
+        ClearSpilled();
+        return false;
+    }
+
+    SpillReader reader(buffer);
+    std::vector<UndoStep*> steps;
+    int32_t count = reader.ReadInt();
+    for (int32_t i = 0; i < count && reader.IsOk(); i++) {
+        UndoStep* step = ReadStep(reader, mStrings);
+        mMemory += step->GetMemoryUsage();
+        steps.push_back(step);
+    }
+    if (!reader.IsOk()) {
+        logger_base.error("Undo file %s is corrupt. Older undo history has been lost.", (const char*)mSpillFileName.c_str());
+        DeleteSteps(steps);
+        ClearSpilled();
+        return false;
+    }
+    mUndoSteps.insert(mUndoSteps.begin(), steps.begin(), steps.end());
+    return true;
+}
+
+void UndoManager::ClearSpilled()
+{
+    mSpilled.clear();
+    if (mSpillFile.IsOpened()) {
+        mSpillFile.Close();
+    }
+}
+
+// rebuilds the strings keeping only those steps still in memory use
+void UndoManager::CompactStrings()
+{
+    UndoStrings strings;
+    auto remap = [this, &strings](uint32_t& id) { id = strings.Add(mStrings.Get(id)); };
+    auto remapSettings = [&remap](std::vector<uint32_t>& settings) { for (auto& it : settings) remap(it); };
+
+    for (auto list : { &mUndoSteps, &mRedoSteps }) {
+        for (auto step : *list) {
+            for (auto it : step->deleted_effect_info) {
+                remap(it->element_name);
+                remap(it->name);
+                remapSettings(it->settings);
+                remapSettings(it->palette);
+            }
+            for (auto it : step->added_effect_info) {
+                remap(it->element_name);
+            }
+            for (auto it : step->moved_effect_info) {
+                remap(it->element_name);
+            }
+            for (auto it : step->modified_effect_info) {
+                remap(it->element_name);
+                remapSettings(it->settings);
+                remapSettings(it->palette);
+                remap(it->effectName);
+            }
+        }
+    }
+    std::swap(mStrings, strings);
+    mCompactedStrings = mStrings.GetMemoryUsage();
+}
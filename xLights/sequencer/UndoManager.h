@@ -11,6 +11,12 @@
  **************************************************************/
 
 #include "wx/wx.h"
+#include <wx/file.h>
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 class SequenceElements;
@@ -25,71 +31,109 @@ enum UNDO_ACTIONS
     UNDO_EFFECT_MOVED
 };
 
+// The strings held by the undo history. Element and effect names and each key=value of the effect settings and
+// palettes are stored once however many steps refer to them so a bulk change to thousands of effects costs a few
+// bytes per key per effect rather than a copy of every settings string
+class UndoStrings
+{
+public:
+    uint32_t Add(const std::string& s);
+    const std::string& Get(uint32_t id) const { return _strings[id]; }
+    // settings are split at the commas between keys (commas in values are escaped) and put back exactly
+    std::vector<uint32_t> AddSettings(const std::string& settings);
+    std::string GetSettings(const std::vector<uint32_t>& settings) const;
+    size_t GetCount() const { return _strings.size(); }
+    size_t GetMemoryUsage() const { return _memory; }
+    void Clear();
+
+private:
+    std::deque<std::string> _strings; // a deque so the views in _ids stay valid as it grows
+    std::unordered_map<std::string_view, uint32_t> _ids;
+    size_t _memory = 0;
+};
+
 class DeletedEffectInfo
 {
 public:
-    std::string element_name;
-    int layer_index;
-    std::string name;
-    std::string settings;
-    std::string palette;
-    int startTimeMS;
-    int endTimeMS;
-    int Selected;
-    bool Protected;
-    DeletedEffectInfo( const std::string &element_name_, int layer_index_, const std::string &name_, const std::string &settings_,
+    uint32_t element_name = 0;
+    int layer_index = 0;
+    uint32_t name = 0;
+    std::vector<uint32_t> settings;
+    std::vector<uint32_t> palette;
+    int startTimeMS = 0;
+    int endTimeMS = 0;
+    int Selected = 0;
+    bool Protected = false;
+    DeletedEffectInfo() {}
+    DeletedEffectInfo( UndoStrings& strings, const std::string &element_name_, int layer_index_, const std::string &name_, const std::string &settings_,
                        const std::string &palette_, int startTimeMS_, int endTimeMS_, int Selected_, bool Protected_ );
+    size_t GetMemoryUsage() const;
 };
 
 class AddedEffectInfo
 {
 public:
-    std::string element_name;
-    int layer_index;
-    int id;
-    AddedEffectInfo( const std::string &element_name_, int layer_index_, int id_ );
+    uint32_t element_name = 0;
+    int layer_index = 0;
+    int id = 0;
+    AddedEffectInfo() {}
+    AddedEffectInfo( UndoStrings& strings, const std::string &element_name_, int layer_index_, int id_ );
+    size_t GetMemoryUsage() const { return sizeof(AddedEffectInfo); }
 };
 
 class MovedEffectInfo
 {
 public:
-    std::string element_name;
-    int layer_index;
-    int id;
-    int startTimeMS;
-    int endTimeMS;
-    MovedEffectInfo( const std::string &element_name_, int layer_index_, int id_, int startTimeMS_, int endTimeMS_ );
+    uint32_t element_name = 0;
+    int layer_index = 0;
+    int id = 0;
+    int startTimeMS = 0;
+    int endTimeMS = 0;
+    MovedEffectInfo() {}
+    MovedEffectInfo( UndoStrings& strings, const std::string &element_name_, int layer_index_, int id_, int startTimeMS_, int endTimeMS_ );
+    size_t GetMemoryUsage() const { return sizeof(MovedEffectInfo); }
 };
 
 class ModifiedEffectInfo
 {
 public:
-    std::string element_name;
-    int layer_index;
-    int id;
-    std::string settings;
-    std::string palette;
-    std::string effectName;
-    int effectType;
-    
-    ModifiedEffectInfo( const std::string &element_name_, int layer_index_, int id_, const std::string &settings_, const std::string &palette_ );
-    ModifiedEffectInfo( const std::string &element_name_, int layer_index_, Effect *ef);
+    uint32_t element_name = 0;
+    int layer_index = 0;
+    int id = 0;
+    std::vector<uint32_t> settings;
+    std::vector<uint32_t> palette;
+    uint32_t effectName = 0;
+    int effectType = -1;
+
+    ModifiedEffectInfo() {}
+    ModifiedEffectInfo( UndoStrings& strings, const std::string &element_name_, int layer_index_, int id_, const std::string &settings_, const std::string &palette_ );
+    ModifiedEffectInfo( UndoStrings& strings, const std::string &element_name_, int layer_index_, Effect *ef);
+    size_t GetMemoryUsage() const;
 };
 
+// All the changes of one kind made in a row by an operation are batched into a single step
 class UndoStep
 {
 public:
     explicit UndoStep( UNDO_ACTIONS action );
-    UndoStep( UNDO_ACTIONS action, DeletedEffectInfo* effect_info );
-    UndoStep( UNDO_ACTIONS action, AddedEffectInfo* effect_info );
-    UndoStep( UNDO_ACTIONS action, MovedEffectInfo* effect_info );
-    UndoStep( UNDO_ACTIONS action, ModifiedEffectInfo* effect_info );
+    ~UndoStep();
+
+    // each returns roughly how much memory the step grew by
+    size_t Add( DeletedEffectInfo* effect_info );
+    size_t Add( AddedEffectInfo* effect_info );
+    size_t Add( MovedEffectInfo* effect_info );
+    size_t Add( ModifiedEffectInfo* effect_info );
+    // drops the last change added and returns how much memory that freed
+    size_t RemoveLast();
+    bool IsEmpty() const;
+    size_t GetMemoryUsage() const { return memory; }
 
     UNDO_ACTIONS undo_action;
     std::vector<DeletedEffectInfo*> deleted_effect_info;
     std::vector<AddedEffectInfo*> added_effect_info;
     std::vector<MovedEffectInfo*> moved_effect_info;
     std::vector<ModifiedEffectInfo*> modified_effect_info;
+    size_t memory;
 };
 
 class UndoManager
@@ -97,7 +141,7 @@ class UndoManager
     public:
         explicit UndoManager(SequenceElements* parent);
         virtual ~UndoManager();
-    
+
         void Clear();
         void ClearRedo();
         void RemoveUnusedMarkers();
@@ -121,13 +165,55 @@ class UndoManager
         void CaptureEffectToBeMoved( const std::string &element_name, int layer_index, int id, int startTimeMS, int endTimeMS );
         void CaptureModifiedEffect( const std::string &element_name, int layer_index, int id, const std::string &settings, const std::string &palette );
         void CaptureModifiedEffect( const std::string &element_name, int layer_index, Effect *ef);
+
+        // Once the history in memory passes the limit the oldest operations are written to a temporary file and
+        // read back when undo reaches them
+        void SetMemoryLimit( size_t limit ) { mMemoryLimit = limit; }
+        size_t GetMemoryLimit() const { return mMemoryLimit; }
+        size_t GetMemoryUsage() const { return mMemory + mStrings.GetMemoryUsage(); }
+        size_t GetSpilledSize() const;
+        std::string GetUsageString() const;
+
     protected:
         void ProcessUndoStep(std::vector<UndoStep*> &fromList, std::vector<UndoStep*> &toList);
+        // Each puts back one change to the sequence and returns what it replaced, or nullptr if the effect is no
+        // longer there. These are the only parts of undo which touch the sequence ... they are in UndoApply.cpp
+        virtual AddedEffectInfo* UndoDeleted(const DeletedEffectInfo& info);
+        virtual DeletedEffectInfo* UndoAdded(const AddedEffectInfo& info);
+        virtual MovedEffectInfo* UndoMoved(const MovedEffectInfo& info);
+        virtual ModifiedEffectInfo* UndoModified(const ModifiedEffectInfo& info);
+        // reads back the newest spilled operation ahead of the steps still in memory
+        bool LoadSpilled();
+        const std::vector<UndoStep*>& GetUndoSteps() const { return mUndoSteps; }
+        const UndoStrings& GetStrings() const { return mStrings; }
+        UndoStrings& GetStrings() { return mStrings; }
 
     private:
+        // an operation written out to the spill file ... these are always older than everything in mUndoSteps
+        struct SpilledSteps {
+            wxFileOffset offset;
+            size_t size;
+            UNDO_ACTIONS lastAction;
+        };
+
+        template<typename T> void AddStep(std::vector<UndoStep*> &list, UNDO_ACTIONS action, T* effect_info);
+        void DeleteStep(UndoStep* step);
+        void DeleteSteps(std::vector<UndoStep*> &list);
+        void LimitMemory();
+        bool SpillOldest();
+        void ClearSpilled();
+        void CompactStrings();
+
         std::vector<UndoStep*> mUndoSteps;
         std::vector<UndoStep*> mRedoSteps;
         SequenceElements* mParentSequence;
         bool mCaptureUndo;
+        UndoStrings mStrings;
+        size_t mMemory;      // held by the steps in both lists ... mStrings is on top of this
+        size_t mMemoryLimit;
+        size_t mCompactedStrings; // size of mStrings after it was last compacted
+        std::vector<SpilledSteps> mSpilled;
+        std::string mSpillFileName;
+        wxFile mSpillFile;
 
 };
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <list>
 #include <mutex>
@@ -13,6 +14,7 @@
 
 #include <wx/string.h>
 #include <wx/app.h>
+#include <wx/thread.h>
 #include "../xLightsVersion.h"
 #include "string_utils.h"
 
@@ -79,7 +81,11 @@ CURL* CurlManager::createCurl(const std::string& fullUrl, CurlPrivateData** cpd,
     static std::string USERAGENT = wxAppConsole::GetInstance()->GetAppName().ToStdString() + "-" + xlights_version_string;
 
     const std::string host = getHost(fullUrl);
-    HostData* hd = getHostData(host);
+    HostData hd;
+    {
+        std::unique_lock<std::mutex> l(lock);
+        hd = *getHostData(host);
+    }
     CURL* c = curl_easy_init();
     curl_easy_setopt(c, CURLOPT_URL, fullUrl.c_str());
     curl_easy_setopt(c, CURLOPT_USERAGENT, USERAGENT.c_str());
@@ -93,16 +99,16 @@ CURL* CurlManager::createCurl(const std::string& fullUrl, CurlPrivateData** cpd,
     curl_easy_setopt(c, CURLOPT_WRITEFUNCTION, urlWriteData);
     CurlPrivateData* data = new CurlPrivateData();
     data->host = host;
-    if (hd->allowHTTP0_9) {
+    if (hd.allowHTTP0_9) {
         curl_easy_setopt(c, CURLOPT_HTTP09_ALLOWED, 1L);
         data->isHTTP_0_9 = true;
     }
     curl_easy_setopt(c, CURLOPT_ERRORBUFFER, data->errorResp);
     curl_easy_setopt(c, CURLOPT_WRITEDATA, &data->resp);
     curl_easy_setopt(c, CURLOPT_PRIVATE, data);
-    if (hd->username != "") {
-        curl_easy_setopt(c, CURLOPT_USERNAME, hd->username.c_str());
-        curl_easy_setopt(c, CURLOPT_PASSWORD, hd->password.c_str());
+    if (hd.username != "") {
+        curl_easy_setopt(c, CURLOPT_USERNAME, hd.username.c_str());
+        curl_easy_setopt(c, CURLOPT_PASSWORD, hd.password.c_str());
         curl_easy_setopt(c, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
     }
     if (upload) {
@@ -184,17 +190,28 @@ void CurlManager::addPut(const std::string& url, const std::string& data, const
     add(url, "PUT", data, { "Content-Type: " + contentType }, [callback](int rc, const std::string& resp) { callback(rc, resp); });
 }
 
+// the synchronous methods are also used from background threads (connecting to several controllers
+// at once). Those perform the request themselves rather than driving the shared multi handle, which
+// would run the callbacks of requests added by other threads on them
+void CurlManager::performSync(const std::string& furl, CURL* curl) {
+    if (!wxThread::IsMain()) {
+        curl_easy_perform(curl);
+        return;
+    }
+    std::atomic_bool done = false;
+    addCURL(furl, curl, [&done](CURL* c) { done = true; }, false);
+    while (!done && processCurls()) {
+        wxYieldIfNeeded();
+    }
+}
+
 std::string CurlManager::doGet(const std::string& furl, int& rc) {
     static log4cpp::Category& logger_curl = log4cpp::Category::getInstance(std::string("log_curl"));
     CURL* curl = createCurl(furl);
 
     logger_curl.info("Adding Synchronous CURL - URL: %s    Method: GET", furl.c_str());
     
-    bool done = false;
-    addCURL(furl, curl, [&done](CURL* c) { done = true; }, false);
-    while (!done && processCurls()) {
-        wxYieldIfNeeded();
-    }
+    performSync(furl, curl);
 
     CurlPrivateData* data = nullptr;
     long rc2 = 0;
@@ -263,11 +280,7 @@ std::string CurlManager::doPost(const std::string& furl, const std::string& cont
     curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, seek_callback);
     curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)data.size());
 
-    bool done = false;
-    addCURL(furl, curl, [&done](CURL* c) { done = true; }, false);
-    while (!done && processCurls()) {
-        wxYieldIfNeeded();
-    }
+    performSync(furl, curl);
 
     CurlPrivateData* cdata = nullptr;
     long rc2 = 0;
@@ -320,10 +333,7 @@ std::string CurlManager::doPut(const std::string& furl, const std::string& conte
     curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, seek_callback);
     curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)data.size());
 
-    addCURL(furl, curl, [](CURL* c) {}, false);
-    while (processCurls()) {
-        wxYieldIfNeeded();
-    }
+    performSync(furl, curl);
 
     CurlPrivateData* cdata = nullptr;
     long rc2 = 0;
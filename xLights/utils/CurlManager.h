@@ -65,6 +65,7 @@ private:
     ~CurlManager();
 
     bool doProcessCurls();
+    void performSync(const std::string& furl, CURL* curl);
     std::string getHost(const std::string& url);
 
     CURLM* curlMulti = nullptr;
@@ -94,5 +95,6 @@ private:
         bool allowHTTP0_9 = false;
     };
     std::map<std::string, HostData*> hostData;
+    // lock must be held
     HostData* getHostData(const std::string& host);
 };
@@ -0,0 +1,667 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "NetworkProbe.h"
+
+#include <wx/wx.h>
+
+// This must be below the wx includes
+#ifdef __WXMSW__
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <iphlpapi.h>
+#include <icmpapi.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <log4cpp/Category.hh>
+
+#define PROBE_IDLE_MS 5000 // the probing thread ends once it has had nothing to do for this long
+#define PROBE_POLL_MS 10   // longest wait before newly queued probes are started
+
+#ifdef __WXMSW__
+typedef SOCKET probe_socket_t;
+typedef WSAPOLLFD probe_pollfd_t;
+#define PROBE_INVALID_SOCKET INVALID_SOCKET
+#else
+typedef int probe_socket_t;
+typedef pollfd probe_pollfd_t;
+#define PROBE_INVALID_SOCKET -1
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define PROBE_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define PROBE_SEND_FLAGS 0
+#endif
+
+static const char ICMP_DATA[] = "xLights network probe";
+
+NetworkProbe NetworkProbe::INSTANCE;
+
+#pragma region Socket Helpers
+static int LastSocketError() {
+#ifdef __WXMSW__
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+static bool IsWouldBlock(int error) {
+#ifdef __WXMSW__
+    return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS;
+#else
+    return error == EWOULDBLOCK || error == EAGAIN || error == EINPROGRESS;
+#endif
+}
+
+static bool IsRefused(int error) {
+#ifdef __WXMSW__
+    return error == WSAECONNREFUSED;
+#else
+    return error == ECONNREFUSED;
+#endif
+}
+
+static void CloseSocket(probe_socket_t socket) {
+#ifdef __WXMSW__
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+}
+
+static bool SetNonBlocking(probe_socket_t socket) {
+#ifdef __WXMSW__
+    u_long nonBlocking = 1;
+    return ioctlsocket(socket, FIONBIO, &nonBlocking) == 0;
+#else
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    int flags = fcntl(socket, F_GETFL, 0);
+    return flags != -1 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) != -1;
+#endif
+}
+
+static uint16_t ICMPChecksum(const uint8_t* data, size_t len) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        sum += ((uint32_t)data[i] << 8) + data[i + 1];
+    }
+    if (len & 1) {
+        sum += (uint32_t)data[len - 1] << 8;
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return (uint16_t)~sum;
+}
+#pragma endregion
+
+struct NetworkProbe::Probe {
+    enum class STATE {
+        QUEUED,
+        ECHO,
+        CONNECTING,
+        SENDING,
+        RECEIVING,
+        DONE
+    };
+
+    Probe(const void* o, PROBE p, const std::string& ip, int port, int timeout, Callback&& cb) :
+        owner(o), callback(std::move(cb)), timeoutMS(timeout) {
+        result.probe = p;
+        result.ip = ip;
+        result.port = port;
+        memset(&address, 0x00, sizeof(address));
+    }
+
+    const void* owner = nullptr;
+    Callback callback;
+    Result result;
+    int timeoutMS = 0;
+    std::atomic<bool> cancelled = false;
+    STATE state = STATE::QUEUED;
+    sockaddr_in address;
+    probe_socket_t socket = PROBE_INVALID_SOCKET;
+    uint16_t sequence = 0;
+    std::string request;
+    size_t sent = 0;
+    std::string response;
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point deadline;
+#ifdef __WXMSW__
+    HANDLE event = nullptr;
+    bool echoPending = false;
+    std::vector<uint8_t> reply;
+#endif
+};
+
+#pragma region Adding and Cancelling
+NetworkProbe::~NetworkProbe() {
+    {
+        std::unique_lock<std::mutex> l(_lock);
+        _stop = true;
+    }
+    _wake.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+#ifdef __WXMSW__
+    if (_icmpFile != nullptr) {
+        IcmpCloseHandle((HANDLE)_icmpFile);
+    }
+#endif
+}
+
+void NetworkProbe::Ping(const void* owner, const std::string& ip, int timeoutMS, Callback&& callback) {
+    Add(new Probe(owner, PROBE::PING, ip, 0, timeoutMS, std::move(callback)));
+}
+
+void NetworkProbe::Connect(const void* owner, const std::string& ip, int port, int timeoutMS, Callback&& callback) {
+    Add(new Probe(owner, PROBE::CONNECT, ip, port, timeoutMS, std::move(callback)));
+}
+
+void NetworkProbe::HTTPGet(const void* owner, const std::string& ip, int port, const std::string& path, int timeoutMS, Callback&& callback) {
+    auto probe = new Probe(owner, PROBE::HTTP, ip, port, timeoutMS, std::move(callback));
+    probe->request = "GET " + (path == "" ? std::string("/") : path) + " HTTP/1.0\r\nHost: " + ip + "\r\nUser-Agent: xLights\r\nConnection: close\r\n\r\n";
+    Add(probe);
+}
+
+void NetworkProbe::Add(Probe* probe) {
+    {
+        std::unique_lock<std::mutex> l(_lock);
+        _queued.push_back(probe);
+        if (!_running) {
+            // the thread ends when it runs out of work
+            if (_thread.joinable()) {
+                _thread.join();
+            }
+            if (_maxActive == 0) {
+                _maxActive = CalcMaxActive();
+            }
+            _running = true;
+            _stop = false;
+            _thread = std::thread(&NetworkProbe::Run, this);
+        }
+    }
+    _wake.notify_all();
+}
+
+void NetworkProbe::Cancel(const void* owner) {
+    // holding this waits for any callback already under way and stops one queueing another probe behind our back
+    std::unique_lock<std::recursive_mutex> cl(_callbackLock);
+    {
+        std::unique_lock<std::mutex> l(_lock);
+        for (auto it = _queued.begin(); it != _queued.end();) {
+            if ((*it)->owner == owner) {
+                delete *it;
+                it = _queued.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        // those in flight are left to finish but will not be called back
+        for (const auto& it : _active) {
+            if (it->owner == owner) {
+                it->cancelled = true;
+            }
+        }
+    }
+}
+
+size_t NetworkProbe::GetMaxActive() {
+    std::unique_lock<std::mutex> l(_lock);
+    if (_maxActive == 0) {
+        _maxActive = CalcMaxActive();
+    }
+    return _maxActive;
+}
+
+size_t NetworkProbe::CalcMaxActive() {
+#ifdef __WXMSW__
+    // sockets are not file descriptors and WSAPoll has no limit on how many it waits on
+    return MAX_ACTIVE;
+#else
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    // every probe needs a descriptor and the rest of xLights needs plenty too so only use half of them.
+    // The soft limit is often 256 (macOS) or 1024 (linux) but can be raised to the hard limit without privileges
+    rlim_t const want = MAX_ACTIVE * 2 + 256;
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return MIN_ACTIVE;
+    }
+    if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < want && (limit.rlim_max == RLIM_INFINITY || limit.rlim_max > limit.rlim_cur)) {
+        struct rlimit raised = limit;
+        raised.rlim_cur = limit.rlim_max == RLIM_INFINITY ? want : std::min(want, limit.rlim_max);
+        if (setrlimit(RLIMIT_NOFILE, &raised) == 0) {
+            logger_base.debug("NetworkProbe: Raised the open file limit from %llu to %llu.", (unsigned long long)limit.rlim_cur, (unsigned long long)raised.rlim_cur);
+            limit = raised;
+        }
+    }
+    if (limit.rlim_cur == RLIM_INFINITY) {
+        return MAX_ACTIVE;
+    }
+    size_t res = std::clamp((size_t)(limit.rlim_cur / 2), MIN_ACTIVE, MAX_ACTIVE);
+    if (res < MAX_ACTIVE) {
+        logger_base.info("NetworkProbe: The open file limit of %llu allows only %llu probes at once.", (unsigned long long)limit.rlim_cur, (unsigned long long)res);
+    }
+    return res;
+#endif
+}
+
+size_t NetworkProbe::GetPending(const void* owner) const {
+    std::unique_lock<std::mutex> l(_lock);
+    size_t count = 0;
+    for (const auto& it : _queued) {
+        if (owner == nullptr || it->owner == owner) {
+            ++count;
+        }
+    }
+    for (const auto& it : _active) {
+        if (!it->cancelled && (owner == nullptr || it->owner == owner)) {
+            ++count;
+        }
+    }
+    return count;
+}
+#pragma endregion
+
+#pragma region Probing Thread
+void NetworkProbe::Run() {
+#ifdef __WXMSW__
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+
+    std::vector<probe_pollfd_t> fds;
+    std::vector<Probe*> polled;
+    std::vector<Probe*> starting;
+    std::vector<Probe*> done;
+
+    for (;;) {
+        starting.clear();
+        {
+            std::unique_lock<std::mutex> l(_lock);
+            if (_active.empty() && _queued.empty() && !_stop) {
+                _wake.wait_for(l, std::chrono::milliseconds(PROBE_IDLE_MS), [this] { return _stop || !_queued.empty(); });
+            }
+            if (_stop || (_active.empty() && _queued.empty())) {
+                for (const auto& it : _queued) {
+                    delete it;
+                }
+                _queued.clear();
+                for (const auto& it : _active) {
+                    Release(it);
+                }
+                _active.clear();
+                _running = false;
+                break;
+            }
+            while (!_queued.empty() && _active.size() < _maxActive) {
+                starting.push_back(_queued.front());
+                _active.push_back(_queued.front());
+                _queued.pop_front();
+            }
+        }
+
+        for (const auto& it : starting) {
+            Start(it);
+        }
+
+        // work out what to wait for and until when
+        fds.clear();
+        polled.clear();
+        auto now = std::chrono::steady_clock::now();
+        int timeout = PROBE_POLL_MS;
+        for (const auto& it : _active) {
+            if (it->state == Probe::STATE::DONE) continue;
+            if (now >= it->deadline) {
+                Finish(it, false);
+                continue;
+            }
+            timeout = std::min(timeout, (int)std::chrono::duration_cast<std::chrono::milliseconds>(it->deadline - now).count() + 1);
+            if (it->socket != PROBE_INVALID_SOCKET) {
+                probe_pollfd_t fd;
+                memset(&fd, 0x00, sizeof(fd));
+                fd.fd = it->socket;
+                fd.events = (it->state == Probe::STATE::CONNECTING || it->state == Probe::STATE::SENDING) ? POLLOUT : POLLIN;
+                fds.push_back(fd);
+                polled.push_back(it);
+            }
+        }
+
+        if (!fds.empty()) {
+#ifdef __WXMSW__
+            int res = WSAPoll(fds.data(), (ULONG)fds.size(), timeout);
+#else
+            int res = poll(fds.data(), fds.size(), timeout);
+#endif
+            if (res > 0) {
+                for (size_t i = 0; i < fds.size(); i++) {
+                    if (fds[i].revents != 0) {
+                        Service(polled[i], fds[i].revents);
+                    }
+                }
+            }
+        } else {
+            // only windows pings which are signalled by an event rather than a socket
+            std::unique_lock<std::mutex> l(_lock);
+            _wake.wait_for(l, std::chrono::milliseconds(timeout), [this] { return _stop || (!_queued.empty() && _active.size() < _maxActive); });
+        }
+
+#ifdef __WXMSW__
+        for (const auto& it : _active) {
+            if (it->echoPending && WaitForSingleObject(it->event, 0) == WAIT_OBJECT_0) {
+                it->echoPending = false;
+                auto reply = (ICMP_ECHO_REPLY*)it->reply.data();
+                if (IcmpParseReplies(it->reply.data(), (DWORD)it->reply.size()) > 0 && reply->Status == IP_SUCCESS) {
+                    it->result.icmp = true;
+                    Finish(it, true);
+                } else {
+                    Finish(it, false);
+                }
+            }
+        }
+#endif
+
+        // a cancelled probe may as well stop now unless windows is still filling in its reply
+        done.clear();
+        for (const auto& it : _active) {
+            if (it->cancelled && it->state != Probe::STATE::DONE) {
+#ifdef __WXMSW__
+                if (it->echoPending) continue;
+#endif
+                Finish(it, false);
+            }
+            if (it->state == Probe::STATE::DONE) {
+                done.push_back(it);
+            }
+        }
+
+        for (const auto& it : done) {
+            {
+                // held across the callback so Cancel can wait for it
+                std::unique_lock<std::recursive_mutex> cl(_callbackLock);
+                bool cancelled = false;
+                {
+                    std::unique_lock<std::mutex> l(_lock);
+                    _active.remove(it);
+                    cancelled = it->cancelled;
+                }
+                if (!cancelled && it->callback) {
+                    it->callback(it->result);
+                }
+            }
+            Release(it);
+        }
+    }
+
+#ifdef __WXMSW__
+    WSACleanup();
+#endif
+}
+
+void NetworkProbe::Start(Probe* probe) {
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    probe->started = std::chrono::steady_clock::now();
+    probe->deadline = probe->started + std::chrono::milliseconds(probe->timeoutMS);
+
+    probe->address.sin_family = AF_INET;
+    if (inet_pton(AF_INET, probe->result.ip.c_str(), &probe->address.sin_addr) != 1) {
+        logger_base.warn("NetworkProbe: '%s' is not an IP address.", (const char*)probe->result.ip.c_str());
+        Finish(probe, false);
+        return;
+    }
+
+    if (probe->result.probe == PROBE::PING) {
+        if (!_icmpUnavailable) {
+            StartEcho(probe);
+            return;
+        }
+        probe->result.port = 80;
+    }
+    StartConnect(probe);
+}
+
+void NetworkProbe::StartEcho(Probe* probe) {
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+#ifdef __WXMSW__
+    if (_icmpFile == nullptr) {
+        HANDLE icmp = IcmpCreateFile();
+        if (icmp == INVALID_HANDLE_VALUE) {
+            logger_base.warn("NetworkProbe: Unable to create ICMP handle %d. Pinging by connecting to port 80 instead.", (int)GetLastError());
+            _icmpUnavailable = true;
+            probe->result.port = 80;
+            StartConnect(probe);
+            return;
+        }
+        _icmpFile = icmp;
+    }
+
+    probe->event = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if (probe->event == nullptr) {
+        Finish(probe, false);
+        return;
+    }
+    // room for the reply, the data echoed back and an ICMP error
+    probe->reply.resize(sizeof(ICMP_ECHO_REPLY) + sizeof(ICMP_DATA) + 8 + sizeof(IO_STATUS_BLOCK));
+    DWORD res = IcmpSendEcho2((HANDLE)_icmpFile, probe->event, nullptr, nullptr, probe->address.sin_addr.s_addr,
+                              (LPVOID)ICMP_DATA, sizeof(ICMP_DATA), nullptr, probe->reply.data(), (DWORD)probe->reply.size(), probe->timeoutMS);
+    if (res == 0 && GetLastError() != ERROR_IO_PENDING) {
+        Finish(probe, false);
+        return;
+    }
+    probe->echoPending = true;
+    probe->state = Probe::STATE::ECHO;
+    // windows times the ping out itself ... give it time to do so before giving up on the event
+    probe->deadline += std::chrono::milliseconds(1000);
+#else
+    // unprivileged ICMP sockets ... linux only allows these if net.ipv4.ping_group_range covers the user
+    probe->socket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_ICMP);
+    if (probe->socket == PROBE_INVALID_SOCKET) {
+        logger_base.info("NetworkProbe: ICMP sockets are not available %d. Pinging by connecting to port 80 instead.", LastSocketError());
+        _icmpUnavailable = true;
+        probe->result.port = 80;
+        StartConnect(probe);
+        return;
+    }
+    SetNonBlocking(probe->socket);
+
+    uint8_t packet[8 + sizeof(ICMP_DATA)];
+    memset(packet, 0x00, sizeof(packet));
+    probe->sequence = ++_sequence;
+    packet[0] = 8; // echo request
+    packet[4] = (getpid() >> 8) & 0xFF;
+    packet[5] = getpid() & 0xFF;
+    packet[6] = probe->sequence >> 8;
+    packet[7] = probe->sequence & 0xFF;
+    memcpy(&packet[8], ICMP_DATA, sizeof(ICMP_DATA));
+    uint16_t checksum = ICMPChecksum(packet, sizeof(packet));
+    packet[2] = checksum >> 8;
+    packet[3] = checksum & 0xFF;
+
+    if (sendto(probe->socket, packet, sizeof(packet), 0, (sockaddr*)&probe->address, sizeof(probe->address)) < 0) {
+        Finish(probe, false);
+        return;
+    }
+    probe->state = Probe::STATE::ECHO;
+#endif
+}
+
+void NetworkProbe::StartConnect(Probe* probe) {
+    probe->socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (probe->socket == PROBE_INVALID_SOCKET || !SetNonBlocking(probe->socket)) {
+        Finish(probe, false);
+        return;
+    }
+
+    probe->address.sin_port = htons(probe->result.port);
+    if (connect(probe->socket, (sockaddr*)&probe->address, sizeof(probe->address)) == 0) {
+        Connected(probe);
+        return;
+    }
+
+    int error = LastSocketError();
+    if (IsWouldBlock(error)) {
+        probe->state = Probe::STATE::CONNECTING;
+    } else {
+        Refused(probe, IsRefused(error));
+    }
+}
+
+void NetworkProbe::Connected(Probe* probe) {
+    probe->result.connected = true;
+    if (probe->result.probe == PROBE::HTTP) {
+        probe->state = Probe::STATE::SENDING;
+    } else {
+        Finish(probe, true);
+    }
+}
+
+void NetworkProbe::Refused(Probe* probe, bool refused) {
+    // a refused connection still means something is there which is all a ping wants to know
+    probe->result.refused = refused;
+    Finish(probe, refused && probe->result.probe == PROBE::PING);
+}
+
+void NetworkProbe::Service(Probe* probe, short events) {
+    switch (probe->state) {
+    case Probe::STATE::ECHO: {
+#ifndef __WXMSW__
+        uint8_t buffer[1500];
+        for (;;) {
+            sockaddr_in from;
+            socklen_t fromLen = sizeof(from);
+            ssize_t len = recvfrom(probe->socket, buffer, sizeof(buffer), 0, (sockaddr*)&from, &fromLen);
+            if (len <= 0) break;
+            // macOS includes the IP header, linux does not
+            size_t offset = ((buffer[0] >> 4) == 4) ? (buffer[0] & 0x0F) * 4 : 0;
+            if ((size_t)len >= offset + 8 && buffer[offset] == 0 && from.sin_addr.s_addr == probe->address.sin_addr.s_addr &&
+                buffer[offset + 6] == (probe->sequence >> 8) && buffer[offset + 7] == (probe->sequence & 0xFF)) {
+                probe->result.icmp = true;
+                Finish(probe, true);
+                return;
+            }
+        }
+        if ((events & POLLIN) == 0) {
+            // typically the host or network is unreachable
+            Finish(probe, false);
+        }
+#endif
+    } break;
+    case Probe::STATE::CONNECTING: {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (getsockopt(probe->socket, SOL_SOCKET, SO_ERROR, (char*)&error, &len) != 0) {
+            error = LastSocketError();
+        }
+        if (error == 0 && (events & POLLOUT) != 0) {
+            Connected(probe);
+        } else {
+            Refused(probe, IsRefused(error));
+        }
+    } break;
+    case Probe::STATE::SENDING: {
+        if ((events & POLLOUT) == 0) {
+            Finish(probe, false);
+            break;
+        }
+        int sent = send(probe->socket, probe->request.data() + probe->sent, (int)(probe->request.size() - probe->sent), PROBE_SEND_FLAGS);
+        if (sent < 0) {
+            if (!IsWouldBlock(LastSocketError())) {
+                Finish(probe, false);
+            }
+            break;
+        }
+        probe->sent += sent;
+        if (probe->sent == probe->request.size()) {
+            probe->state = Probe::STATE::RECEIVING;
+        }
+    } break;
+    case Probe::STATE::RECEIVING: {
+        char buffer[4096];
+        for (;;) {
+            int len = recv(probe->socket, buffer, sizeof(buffer), 0);
+            if (len > 0) {
+                probe->response.append(buffer, len);
+                if (probe->response.size() < MAX_RESPONSE) continue;
+            } else if (len < 0 && IsWouldBlock(LastSocketError())) {
+                break;
+            }
+            // closed, full or failed ... whatever we have is the response
+            if (probe->response.compare(0, 5, "HTTP/") == 0) {
+                auto space = probe->response.find(' ');
+                if (space != std::string::npos) {
+                    probe->result.httpStatus = atoi(probe->response.c_str() + space + 1);
+                }
+                auto body = probe->response.find("\r\n\r\n");
+                if (body != std::string::npos) {
+                    probe->result.body = probe->response.substr(body + 4, MAX_RESPONSE);
+                }
+            }
+            Finish(probe, probe->result.httpStatus != 0);
+            break;
+        }
+    } break;
+    default:
+        break;
+    }
+}
+
+void NetworkProbe::Finish(Probe* probe, bool ok) {
+    if (probe->state == Probe::STATE::DONE) return;
+
+    probe->result.ok = ok;
+    probe->result.ms = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - probe->started).count();
+    if (probe->socket != PROBE_INVALID_SOCKET) {
+        CloseSocket(probe->socket);
+        probe->socket = PROBE_INVALID_SOCKET;
+    }
+    probe->state = Probe::STATE::DONE;
+}
+
+void NetworkProbe::Release(Probe* probe) {
+    if (probe->socket != PROBE_INVALID_SOCKET) {
+        CloseSocket(probe->socket);
+    }
+#ifdef __WXMSW__
+    if (probe->event != nullptr) {
+        // windows writes the reply into the probe so it cannot go before the ping completes
+        if (probe->echoPending) {
+            WaitForSingleObject(probe->event, probe->timeoutMS + 1000);
+        }
+        CloseHandle(probe->event);
+    }
+#endif
+    delete probe;
+}
+#pragma endregion
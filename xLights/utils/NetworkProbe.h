@@ -0,0 +1,101 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <stdint.h>
+
+// Probes hosts on the network without blocking the caller. Every probe in flight is serviced by one thread
+// which waits on all their sockets at once so checking a whole subnet takes about as long as the longest
+// timeout rather than the sum of them. Up to MAX_ACTIVE probes, enough for a /22, are in flight at once.
+// Where the process cannot raise its open file limit that far fewer are and the rest queue until others
+// finish, so a large subnet then takes a timeout per batch.
+//
+// Callbacks are called on the probing thread so they must be quick and must not wait on other probes.
+// Each probe is tagged with an owner which must call Cancel before it is destroyed ... once Cancel returns
+// none of its callbacks will be called.
+class NetworkProbe
+{
+public:
+    static NetworkProbe INSTANCE;
+
+    static const size_t MAX_ACTIVE = 1024;    // probes in flight at once ... each needs a socket
+    static const size_t MIN_ACTIVE = 64;      // in flight however low the open file limit is
+    static const size_t MAX_RESPONSE = 65536; // bytes of an HTTP response kept
+
+    enum class PROBE {
+        PING,    // ICMP echo. Where ICMP sockets are not allowed a TCP connection to port 80 is tried instead
+        CONNECT, // TCP connection
+        HTTP     // HTTP/1.0 GET
+    };
+
+    struct Result {
+        PROBE probe = PROBE::PING;
+        std::string ip;
+        int port = 0;
+        bool ok = false;        // the host answered
+        bool icmp = false;      // PING: answered by an ICMP echo reply
+        bool connected = false; // a TCP connection was accepted
+        bool refused = false;   // a TCP connection was actively refused ... the host is there but nothing is listening
+        int httpStatus = 0;     // HTTP: the status code
+        std::string body;       // HTTP: the body of the response (up to MAX_RESPONSE)
+        uint32_t ms = 0;        // how long it took to answer
+    };
+    typedef std::function<void(const Result& result)> Callback;
+
+    void Ping(const void* owner, const std::string& ip, int timeoutMS, Callback&& callback);
+    void Connect(const void* owner, const std::string& ip, int port, int timeoutMS, Callback&& callback);
+    void HTTPGet(const void* owner, const std::string& ip, int port, const std::string& path, int timeoutMS, Callback&& callback);
+
+    // drops every probe belonging to owner
+    void Cancel(const void* owner);
+    // probes waiting or in flight for owner ... or for everyone if owner is nullptr
+    size_t GetPending(const void* owner = nullptr) const;
+    // how many probes can be in flight at once in this process
+    size_t GetMaxActive();
+
+private:
+    struct Probe;
+
+    NetworkProbe() {}
+    ~NetworkProbe();
+
+    static size_t CalcMaxActive();
+    void Add(Probe* probe);
+    void Run();
+    void Start(Probe* probe);
+    void StartEcho(Probe* probe);
+    void StartConnect(Probe* probe);
+    void Connected(Probe* probe);
+    void Refused(Probe* probe, bool refused);
+    void Service(Probe* probe, short events);
+    void Finish(Probe* probe, bool ok);
+    void Release(Probe* probe);
+
+    mutable std::mutex _lock;
+    std::recursive_mutex _callbackLock; // held while calling back so Cancel can wait for a callback to end
+    std::condition_variable _wake;
+    std::list<Probe*> _queued;
+    std::list<Probe*> _active;
+    std::thread _thread;
+    bool _running = false;
+    bool _stop = false;
+    bool _icmpUnavailable = false;
+    size_t _maxActive = 0;
+    uint16_t _sequence = 0;
+    void* _icmpFile = nullptr; // windows only
+};
@@ -0,0 +1,387 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "UDPReceiver.h"
+
+#include <wx/wx.h>
+#include <wx/socket.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef __WXMSW__
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+#include <log4cpp/Category.hh>
+
+#define UDPRECEIVER_E131_PORT 5568
+#define UDPRECEIVER_ARTNET_PORT 0x1936
+#define UDPRECEIVER_DDP_PORT 4048
+#define UDPRECEIVER_SOCKET_BUFFER (8 * 1024 * 1024)
+
+UDPReceiver::UDPReceiver(PROTOCOL protocol, const std::string& bindIP, const std::string& multicastIP, const std::list<int>& multicastUniverses, std::function<void()> onData, size_t expectedUniverses, size_t maxQueuePackets)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    _protocol = protocol;
+    _onData = onData;
+
+    // ring size must be a power of 2 so indexes can just be masked. It starts with room for a few frames of
+    // every universe we expect and grows if that is not enough
+    _maxSlots = 1;
+    while (_maxSlots < std::max(maxQueuePackets, BATCH)) _maxSlots <<= 1;
+    size_t const queuePackets = std::max(expectedUniverses, multicastUniverses.size()) * QUEUE_FRAMES;
+    size_t size = MIN_QUEUE_PACKETS;
+    while (size < queuePackets && size < _maxSlots) size <<= 1;
+    size = std::min(size, _maxSlots);
+    _slots.resize(size);
+    _mask = size - 1;
+    _scratch.resize(BATCH);
+
+    const char* name = GetName();
+
+    wxIPV4address addr;
+    if (bindIP == "") {
+        addr.AnyAddress();
+    } else {
+        addr.Hostname(bindIP);
+    }
+    switch (_protocol) {
+    case PROTOCOL::E131:
+        addr.Service(UDPRECEIVER_E131_PORT);
+        break;
+    case PROTOCOL::ARTNET:
+        addr.Service(UDPRECEIVER_ARTNET_PORT);
+        break;
+    case PROTOCOL::DDP:
+        addr.Service(UDPRECEIVER_DDP_PORT);
+        break;
+    }
+
+    _socket = new wxDatagramSocket(addr);
+    if (!_socket->IsOk() || _socket->Error() != wxSOCKET_NOERROR) {
+        logger_base.error("UDPReceiver: Problem listening for %s on %s.", name, (const char*)addr.IPAddress().c_str());
+        delete _socket;
+        _socket = nullptr;
+        return;
+    }
+    _socket->Notify(false);
+
+    // a big kernel buffer rides out the consumer or this thread being briefly descheduled
+    int rcvbuf = UDPRECEIVER_SOCKET_BUFFER;
+    if (!_socket->SetOption(SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf))) {
+        logger_base.warn("UDPReceiver: Unable to set %s socket receive buffer size.", name);
+    }
+    int actual = 0;
+    int len = sizeof(actual);
+    if (_socket->GetOption(SOL_SOCKET, SO_RCVBUF, &actual, &len)) {
+        logger_base.debug("UDPReceiver: %s socket receive buffer %d bytes.", name, actual);
+        if (actual < rcvbuf) {
+            logger_base.debug("    The OS limited this. On linux raise net.core.rmem_max to allow more.");
+        }
+    }
+
+    if (_protocol == PROTOCOL::E131) {
+        for (const auto& it : multicastUniverses) {
+            struct ip_mreq mreq;
+            wxString ip = wxString::Format("239.255.%d.%d", it >> 8, it & 0xFF);
+            mreq.imr_multiaddr.s_addr = inet_addr(ip.c_str());
+            mreq.imr_interface.s_addr = multicastIP == "" ? htonl(INADDR_ANY) : inet_addr(multicastIP.c_str());
+            if (!_socket->SetOption(IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char*)&mreq, sizeof(mreq))) {
+                logger_base.warn("    Error opening E131 multicast listener %s.", (const char*)ip.c_str());
+            }
+        }
+    }
+
+    logger_base.debug("UDPReceiver: %s listening on %s.", name, (const char*)addr.IPAddress().c_str());
+
+    _thread = std::thread(&UDPReceiver::Run, this);
+}
+
+UDPReceiver::~UDPReceiver()
+{
+    Stop();
+}
+
+void UDPReceiver::Stop()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    _stop = true;
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    if (_socket != nullptr) {
+        logger_base.debug("UDPReceiver: %s stopped. Received %llu, lost %llu, overflowed %llu.",
+                          GetName(),
+                          (unsigned long long)GetReceived(), (unsigned long long)GetLost(), (unsigned long long)GetOverflowed());
+        _socket->Close();
+        delete _socket;
+        _socket = nullptr;
+    }
+}
+
+const char* UDPReceiver::GetName() const
+{
+    switch (_protocol) {
+    case PROTOCOL::E131:
+        return "E131";
+    case PROTOCOL::ARTNET:
+        return "ArtNET";
+    case PROTOCOL::DDP:
+        return "DDP";
+    }
+    return "";
+}
+
+static bool IsReadable(wxSOCKET_T fd, int timeoutMS)
+{
+    fd_set read;
+    FD_ZERO(&read);
+    FD_SET(fd, &read);
+    struct timeval tv;
+    tv.tv_sec = timeoutMS / 1000;
+    tv.tv_usec = (timeoutMS % 1000) * 1000;
+    return select(fd + 1, &read, nullptr, nullptr, &tv) > 0;
+}
+
+// Reads up to count waiting packets without blocking. Returns how many were read.
+int UDPReceiver::ReceiveBatch(Packet** targets, int count)
+{
+    wxSOCKET_T fd = _socket->GetSocket();
+
+#ifdef __linux__
+    struct mmsghdr msgs[BATCH];
+    struct iovec iovs[BATCH];
+    memset(msgs, 0x00, sizeof(msgs));
+    for (int i = 0; i < count; i++) {
+        iovs[i].iov_base = targets[i]->_data;
+        iovs[i].iov_len = MAX_PACKET;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int res = recvmmsg(fd, msgs, count, MSG_DONTWAIT, nullptr);
+    if (res <= 0) return 0;
+    for (int i = 0; i < res; i++) {
+        targets[i]->_size = msgs[i].msg_len;
+    }
+    return res;
+#else
+    int res = 0;
+    while (res < count && IsReadable(fd, 0)) {
+        int read = recv(fd, (char*)targets[res]->_data, MAX_PACKET, 0);
+        if (read <= 0) break;
+        targets[res]->_size = read;
+        res++;
+    }
+    return res;
+#endif
+}
+
+void UDPReceiver::Track(Packet** packets, int count)
+{
+    std::unique_lock<std::mutex> lock(_statsLock);
+
+    for (int i = 0; i < count; i++) {
+        const uint8_t* p = packets[i]->_data;
+        int size = packets[i]->_size;
+
+        uint32_t universe = 0;
+        int seq = 0;
+        int modulus = 256;
+        if (_protocol == PROTOCOL::E131) {
+            if (size < 126 || memcmp(&p[4], "ASC-E1.17", 9) != 0) continue;
+            universe = ((uint32_t)p[113] << 8) + (uint32_t)p[114];
+            seq = p[111];
+        } else if (_protocol == PROTOCOL::DDP) {
+            // display data only, not queries or replies. The sequence numbers run across every packet from a
+            // sender rather than per channel range so gaps are not tracked
+            if (size < 10 || (p[0] & 0xC0) != 0x40 || (p[0] & 0x06) != 0 || p[3] != 0x01) continue;
+            universe = ((uint32_t)p[4] << 24) + ((uint32_t)p[5] << 16) + ((uint32_t)p[6] << 8) + (uint32_t)p[7];
+            _stats[universe]._packets++;
+            continue;
+        } else {
+            // artdmx only ... sequence 0 means the sender does not use them and they run 1-255
+            if (size < 18 || memcmp(p, "Art-Net", 8) != 0 || p[9] != 0x50) continue;
+            universe = ((uint32_t)p[15] << 8) + (uint32_t)p[14];
+            if (p[12] == 0) {
+                _stats[universe]._packets++;
+                continue;
+            }
+            seq = p[12] - 1;
+            modulus = 255;
+        }
+
+        auto& s = _stats[universe];
+        s._packets++;
+        if (s._lastSeq != -1) {
+            int gap = (seq - s._lastSeq + modulus) % modulus;
+            if (gap == 0 || gap > modulus - 20) {
+                // E1.31 treats anything up to 20 behind as out of order rather than a restarted source
+                s._outOfOrder++;
+                continue;
+            }
+            if (gap < modulus / 2) {
+                s._lost += gap - 1;
+            }
+        }
+        s._lastSeq = seq;
+    }
+}
+
+// Doubles the ring keeping the queued packets in order. Only called on the receive thread and only while
+// nothing is draining so neither index can move underneath us. Returns false if it is already as big as allowed
+// or the consumer is busy draining, in which case slots are about to come free anyway.
+bool UDPReceiver::Grow()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (_slots.size() >= _maxSlots) return false;
+
+    std::unique_lock<std::mutex> lock(_drainLock, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+
+    size_t const tail = _tail.load(std::memory_order_acquire);
+    size_t const head = _head.load(std::memory_order_relaxed);
+
+    std::vector<Packet> slots(_slots.size() * 2);
+    for (size_t i = tail; i != head; i++) {
+        slots[i - tail] = _slots[i & _mask];
+    }
+    _slots.swap(slots);
+    _mask = _slots.size() - 1;
+    _tail.store(0, std::memory_order_relaxed);
+    _head.store(head - tail, std::memory_order_release);
+
+    logger_base.debug("UDPReceiver: %s receive queue grown to %llu packets.", GetName(), (unsigned long long)_slots.size());
+    return true;
+}
+
+void UDPReceiver::Run()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    logger_base.debug("UDPReceiver: receive thread started.");
+
+    Packet* targets[BATCH];
+
+    while (!_stop) {
+        if (!IsReadable(_socket->GetSocket(), 100)) continue;
+
+        // keep going until the socket is empty
+        while (!_stop) {
+            size_t head = _head.load(std::memory_order_relaxed);
+            size_t free = _slots.size() - (head - _tail.load(std::memory_order_acquire));
+
+            if (free == 0) {
+                if (Grow()) continue;
+                if (_slots.size() < _maxSlots) {
+                    // a drain is under way and will hand slots back shortly ... the socket buffer holds the rest until then
+                    std::this_thread::yield();
+                    continue;
+                }
+            }
+
+            int count = std::min(free, BATCH);
+            if (count > 0) {
+                for (int i = 0; i < count; i++) {
+                    targets[i] = &_slots[(head + i) & _mask];
+                }
+            } else {
+                // the ring is as big as it can get and the consumer is too far behind ... keep emptying the socket and discard this batch so the kernel buffer does not fill with stale data
+                count = BATCH;
+                for (int i = 0; i < count; i++) {
+                    targets[i] = &_scratch[i];
+                }
+            }
+
+            int got = ReceiveBatch(targets, count);
+            if (got == 0) break;
+
+            uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            for (int i = 0; i < got; i++) {
+                targets[i]->_timeMS = now;
+            }
+            Track(targets, got);
+            _received += got;
+
+            if (free == 0) {
+                _overflowed += got;
+            } else {
+                _head.store(head + got, std::memory_order_release);
+                if (!_pending.exchange(true) && _onData) {
+                    _onData();
+                }
+            }
+
+            if (got < count) break;
+        }
+    }
+
+    logger_base.debug("UDPReceiver: receive thread exiting.");
+}
+
+size_t UDPReceiver::Drain(const std::function<void(const Packet&)>& process)
+{
+    std::unique_lock<std::mutex> lock(_drainLock);
+
+    // clear this first so anything arriving while we drain calls back again
+    _pending = false;
+
+    size_t count = 0;
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    size_t head = _head.load(std::memory_order_acquire);
+    while (tail != head) {
+        process(_slots[tail & _mask]);
+        tail++;
+        count++;
+
+        // hand slots back regularly so the receive thread is not starved while we process
+        if ((count & (BATCH - 1)) == 0) {
+            _tail.store(tail, std::memory_order_release);
+        }
+    }
+    _tail.store(tail, std::memory_order_release);
+
+    return count;
+}
+
+uint64_t UDPReceiver::GetLost()
+{
+    std::unique_lock<std::mutex> lock(_statsLock);
+    uint64_t lost = 0;
+    for (const auto& it : _stats) {
+        lost += it.second._lost;
+    }
+    return lost;
+}
+
+std::map<uint32_t, UDPReceiver::UniverseStats> UDPReceiver::GetUniverseStats()
+{
+    std::unique_lock<std::mutex> lock(_statsLock);
+    return _stats;
+}
+
+void UDPReceiver::ResetStats()
+{
+    std::unique_lock<std::mutex> lock(_statsLock);
+    _stats.clear();
+    _received = 0;
+    _overflowed = 0;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+class wxDatagramSocket;
+
+// High rate E1.31/ArtNET/DDP listener.
+//
+// A dedicated thread drains the socket in batches (recvmmsg on linux, recvfrom elsewhere) straight into a
+// single producer/single consumer ring of packet slots so the socket is emptied as fast as it fills even
+// when the consumer is busy. The ring starts sized for a few frames of the expected universes and doubles
+// whenever it fills, up to a cap, so a receiver only holds as much memory as its traffic needs. The consumer is told there is data via the callback and then calls Drain.
+// Per universe sequence gaps are tracked on the receive thread so they reflect what arrived on the wire.
+class UDPReceiver
+{
+public:
+    enum class PROTOCOL
+    {
+        E131,
+        ARTNET,
+        DDP
+    };
+
+    static constexpr size_t MAX_PACKET = 1454; // DDP header with timecode + 1440 channels ... E1.31 is at most 638
+    static constexpr size_t MIN_QUEUE_PACKETS = 256;
+    static constexpr size_t MAX_QUEUE_PACKETS = 16384;
+    static constexpr size_t QUEUE_FRAMES = 8; // frames of each expected universe the ring starts out holding
+
+    struct Packet
+    {
+        uint64_t _timeMS = 0; // wall clock time the packet was received in ms since the epoch
+        uint16_t _size = 0;
+        uint8_t _data[MAX_PACKET];
+    };
+
+    // DDP has no universes so its packets are counted against the channel they start at
+    struct UniverseStats
+    {
+        uint64_t _packets = 0;
+        uint64_t _lost = 0;       // packets missing based on gaps in the sequence numbers
+        uint64_t _outOfOrder = 0; // packets which arrived after a later sequence number
+        int _lastSeq = -1;
+    };
+
+private:
+    static constexpr size_t BATCH = 64;
+
+    PROTOCOL _protocol;
+    wxDatagramSocket* _socket = nullptr;
+    std::function<void()> _onData;
+
+    std::vector<Packet> _slots;
+    std::vector<Packet> _scratch; // where packets go when the ring is full
+    size_t _mask = 0;
+    std::atomic<size_t> _head = 0; // only written by the receive thread
+    std::atomic<size_t> _tail = 0; // only written by the consumer
+    size_t _maxSlots = MAX_QUEUE_PACKETS;
+    std::mutex _drainLock;          // held by Drain so the receive thread can only grow the ring while nothing is draining
+    std::atomic<bool> _pending = false;
+
+    std::atomic<bool> _stop = false;
+    std::thread _thread;
+
+    std::atomic<uint64_t> _received = 0;
+    std::atomic<uint64_t> _overflowed = 0;
+
+    std::mutex _statsLock;
+    std::map<uint32_t, UniverseStats> _stats;
+
+    const char* GetName() const;
+    int ReceiveBatch(Packet** targets, int count);
+    void Track(Packet** packets, int count);
+    bool Grow();
+    void Run();
+
+public:
+
+    // bindIP blank listens on all interfaces. multicastIP is the interface to join the E1.31 multicast groups on.
+    // onData is called on the receive thread whenever data arrives after the last Drain ... keep it cheap.
+    // expectedUniverses sizes the initial ring when they are not all multicast ones. maxQueuePackets caps how far it grows.
+    UDPReceiver(PROTOCOL protocol, const std::string& bindIP, const std::string& multicastIP, const std::list<int>& multicastUniverses, std::function<void()> onData, size_t expectedUniverses = 0, size_t maxQueuePackets = MAX_QUEUE_PACKETS);
+    virtual ~UDPReceiver();
+
+    bool IsOk() const { return _socket != nullptr; }
+    void Stop();
+
+    // Processes everything queued on the calling thread. Returns the number of packets processed.
+    size_t Drain(const std::function<void(const Packet&)>& process);
+
+    uint64_t GetReceived() const { return _received; }
+    // packets received but discarded because the consumer fell too far behind
+    uint64_t GetOverflowed() const { return _overflowed; }
+    uint64_t GetLost();
+    // packet slots currently allocated
+    size_t GetQueueSize() const { return _slots.size(); }
+    std::map<uint32_t, UniverseStats> GetUniverseStats();
+    void ResetStats();
+};
@@ -40,6 +40,8 @@
 #include "utils/CurlManager.h"
 #include "SequencePackage.h"
 
+#include "graphics/opengl/xlGLCanvas.h"
+
 #ifndef __WXMSW__
 #include "automation/automation.h"
 #endif
@@ -528,6 +530,7 @@ bool xLightsApp::OnInit()
     {
         { wxCMD_LINE_SWITCH, "h", "help", "displays help on the command line parameters", wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
         { wxCMD_LINE_SWITCH, "r", "render", "render files and exit"},
+        { wxCMD_LINE_OPTION, "j", "jobs", "with -r render this many sequences at once", wxCMD_LINE_VAL_NUMBER },
         { wxCMD_LINE_SWITCH, "cs", "checksequence", "run check sequence and exit" },
         { wxCMD_LINE_OPTION, "m", "media", "specify media directory"},
         { wxCMD_LINE_OPTION, "s", "show", "specify show directory" },
@@ -535,6 +538,7 @@ bool xLightsApp::OnInit()
         { wxCMD_LINE_SWITCH, "o", "on", "turn on output to lights" },
         { wxCMD_LINE_SWITCH, "a", "aport", "turn on xFade A port" },
         { wxCMD_LINE_SWITCH, "b", "bport", "turn on xFade B port" },
+        { wxCMD_LINE_SWITCH, "sw", "softwarerender", "draw previews on the CPU rather than with OpenGL ... a display is still needed" },
 #ifdef __LINUX__
         { wxCMD_LINE_SWITCH, "x", "xschedule", "run xschedule" },
         { wxCMD_LINE_SWITCH, "xs", "xsmsdaemon", "run xsmsdaemon" },
@@ -632,6 +636,11 @@ bool xLightsApp::OnInit()
             ab = 2;
         }
 
+        if (parser.Found("sw")) {
+            logger_base.info("-sw: Software rendering enabled.");
+            xlGLCanvas::SetSoftwareRendering(true);
+        }
+
         if (parser.Found("m", &mediaDir)) {
             logger_base.info("-m: Media directory set to %s.", (const char *)mediaDir.c_str());
             info += _("Setting media directory to ") + mediaDir + "\n";
@@ -683,6 +692,10 @@ bool xLightsApp::OnInit()
         logger_base.info("-r: Render mode is ON");
         renderOnlyMode = true;
     }
+    long renderJobs = 1;
+    if (renderOnlyMode && parser.Found("j", &renderJobs)) {
+        logger_base.info("-j: Rendering %d sequences at once", (int)renderJobs);
+    }
 
     wxFileName xsqFile;
 
@@ -732,7 +745,13 @@ bool xLightsApp::OnInit()
     __frame = topFrame;
 
     if (renderOnlyMode) {
-        topFrame->CallAfter(&xLightsFrame::OpenRenderAndSaveSequencesF, sequenceFiles, xLightsFrame::RENDER_EXIT_ON_DONE);
+        if (renderJobs > 1) {
+            topFrame->CallAfter([topFrame, renderJobs]() {
+                topFrame->ParallelRenderAndSaveSequences(xLightsApp::sequenceFiles, (int)renderJobs, true);
+            });
+        } else {
+            topFrame->CallAfter(&xLightsFrame::OpenRenderAndSaveSequencesF, sequenceFiles, xLightsFrame::RENDER_EXIT_ON_DONE);
+        }
     }
 
     if (readOnlyZipFile != "") {
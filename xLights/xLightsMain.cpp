@@ -29,6 +29,7 @@
 #include <wx/regex.h>
 #include <wx/sstream.h>
 #include <wx/taskbar.h>
+#include <wx/spinctrl.h>
 #include <wx/textctrl.h>
 #include <wx/textdlg.h>
 #include <wx/tokenzr.h>
@@ -75,6 +76,7 @@
 #include "RenderCommandEvent.h"
 #include "RestoreBackupDialog.h"
 #include "SeqSettingsDialog.h"
+#include "SequenceBinaryFile.h"
 #include "ShaderDownloadDialog.h"
 #include "SpecialOptions.h"
 #include "SplashDialog.h"
@@ -1744,6 +1746,11 @@ xLightsFrame::xLightsFrame(wxWindow* parent, int ab, wxWindowID id, bool renderO
     config->Read("xLightsSaveFseqOnSave", &mSaveFseqOnSave, true);
     logger_base.debug("Save Fseq on save: %s.", toStr(mSaveFseqOnSave));
 
+    bool saveBinaryCopy = false;
+    config->Read("xLightsSaveBinarySequence", &saveBinaryCopy, false);
+    SequenceBinaryFile::SetEnabled(saveBinaryCopy);
+    logger_base.debug("Keep binary copy of sequences: %s.", toStr(saveBinaryCopy));
+
     if (!mSaveFseqOnSave) {
         logger_base.debug("Render on save changed to false, because Save Fseq on save is false.");
         mRenderOnSave = false;
@@ -2135,6 +2142,7 @@ xLightsFrame::~xLightsFrame()
     config->Write("xLightsGridNodeValues", mGridNodeValues);
     config->Write("xLightsRenderOnSave", mRenderOnSave);
     config->Write("xLightsSaveFseqOnSave", mSaveFseqOnSave);
+    config->Write("xLightsSaveBinarySequence", SequenceBinaryFile::IsEnabled());
     config->Write("xLightsBackupSubdirectories", _backupSubfolders);
     config->Write("xLightsExcludePresetsPkgSeq", _excludePresetsFromPackagedSequences);
     config->Write("xLightsPromptBatchRenderIssues", _promptBatchRenderIssues);
@@ -3619,6 +3627,16 @@ void xLightsFrame::SetSaveFseqOnSave(bool b)
     }
 }
 
+bool xLightsFrame::SaveBinarySequenceCopy() const
+{
+    return SequenceBinaryFile::IsEnabled();
+}
+
+void xLightsFrame::SetSaveBinarySequenceCopy(bool b)
+{
+    SequenceBinaryFile::SetEnabled(b);
+}
+
 void xLightsFrame::SetEffectAssistMode(int i)
 {
     mEffectAssistMode = i;
@@ -4148,7 +4166,7 @@ void xLightsFrame::SaveWorkingLayout()
     SaveEffectsFile(true);
 }
 
-bool xLightsFrame::SaveWorking()
+bool xLightsFrame::SaveWorking(bool background)
 {
     // dont save if no file in existence
     if (CurrentSeqXmlFile == nullptr)
@@ -4177,6 +4195,19 @@ bool xLightsFrame::SaveWorking()
     }
     wxFileName ftmp(tmp);
 
+    if (background) {
+        // only the snapshot is taken here, the sequence is written while editing continues
+        return CurrentSeqXmlFile->SaveInBackground(_sequenceElements, tmp, [this, tmp](bool ok) {
+            if (!ok) {
+                CallAfter([this, tmp]() {
+                    // try again at the next autosave
+                    mLastAutosaveCount = -1;
+                    DisplayError("Error Saving Sequence to " + tmp, this);
+                });
+            }
+        });
+    }
+
     CurrentSeqXmlFile->SetPath(ftmp.GetPath());
     CurrentSeqXmlFile->SetFullName(ftmp.GetFullName());
 
@@ -4201,7 +4232,7 @@ void xLightsFrame::OnTimer_AutoSaveTrigger(wxTimerEvent& event)
         wxStopWatch sw;
         if (mSavedChangeCount != _sequenceElements.GetChangeCount()) {
             if (_sequenceElements.GetChangeCount() != mLastAutosaveCount) {
-                if (SaveWorking()) {
+                if (SaveWorking(true)) {
                     mLastAutosaveCount = _sequenceElements.GetChangeCount();
                 }
             } else {
@@ -4984,6 +5015,7 @@ std::string xLightsFrame::CheckSequence(bool displayInEditor, bool writeToFile)
         wxFileName fn(CurrentSeqXmlFile->GetFullPath());
         fn.SetExt("xsq");
         LogAndWrite(f, "Sequence: " + fn.GetFullPath());
+        LogAndWrite(f, "Undo history: " + _sequenceElements.get_undo_mgr().GetUsageString());
     } else {
         LogAndWrite(f, "Sequence: No sequence open.");
     }
@@ -7893,7 +7925,7 @@ void xLightsFrame::ValidateWindow()
 void xLightsFrame::TimerOutput(int period)
 {
     if (CheckBoxLightOutput->IsChecked()) {
-        _outputManager.SetManyChannels(0, &_seqData[period][0], _seqData.NumChannels());
+        _outputManager.SetFrame(&_seqData[period][0], _seqData.NumChannels());
     }
 }
 
@@ -8764,7 +8796,7 @@ void xLightsFrame::OnMenuItemBatchRenderSelected(wxCommandEvent& event)
             if (dlg.CheckBox_ForceHighDefinition->IsChecked()) {
                 _lowDefinitionRender = false;
             }
-            OpenRenderAndSaveSequences(filesToRender, false);
+            ParallelRenderAndSaveSequences(filesToRender, dlg.SpinCtrl_Concurrent->GetValue(), false);
             if (filesToRender.size() == 0) {
                 _lowDefinitionRender = _saveLowDefinitionRender;
                 _renderMode = false;
@@ -49,6 +49,7 @@
 #include <wx/propgrid/propgrid.h>
 #include <wx/propgrid/advprops.h>
 #include <wx/appprogress.h>
+#include <wx/stopwatch.h>
 
 #include <unordered_map>
 #include <map>
@@ -115,6 +116,7 @@ class ZCPPOutput;
 class UDControllerPort;
 class Model;
 class ControllerEthernet;
+class BaseController;
 class HttpServer;
 class HttpConnection;
 class HttpRequest;
@@ -226,6 +228,30 @@ class RenderProgressDialog;
 class RenderProgressInfo;
 class wxLed;
 
+// A sequence rendered by ParallelRenderAndSaveSequences. It is never opened in the sequencer so it
+// carries its own xml file, elements and data. Models and the layout are shared with everything else.
+class ParallelRenderSequence
+{
+public:
+    ParallelRenderSequence(xLightsFrame* frame, const wxString& file) :
+        filename(file), elements(frame) {}
+    ~ParallelRenderSequence() {
+        elements.Clear();
+        delete xmlFile;
+    }
+
+    wxString filename;
+    wxString fseqFilename;
+    std::string media;
+    xLightsXmlFile* xmlFile = nullptr;
+    SequenceElements elements;
+    SequenceData data;
+    bool retried = false;
+    wxStopWatch timer;
+    long loadMS = 0;
+    long renderMS = 0;
+};
+
 class xlAuiToolBar : public wxAuiToolBar {
 public:
     xlAuiToolBar(wxWindow* parent,
@@ -398,6 +424,7 @@ public:
     void ConversionError(const wxString& msg);
     void SetMediaFilename(const wxString& filename);
     void RenderIseqData(bool bottom_layers, ConvertLogDialog* plog);
+    void RenderIseqData(bool bottom_layers, ConvertLogDialog* plog, xLightsXmlFile& xmlFile, SequenceData& seqData);
     bool IsSequenceDataValid() const
     { return _seqData.IsValidData(); }
     std::string GetPresetIconFilename(const std::string& preset) const;
@@ -432,7 +459,7 @@ public:
                              const std::string& source,
                              SequenceElements& seqEl,
                              bool eraseExisting);
-    bool SaveWorking();
+    bool SaveWorking(bool background = false);
     void SaveWorkingLayout();
     void PlayerError(const wxString& msg);
     void AskCloseSequence();
@@ -1284,6 +1311,9 @@ public:
     bool SaveFseqOnSave() const { return mSaveFseqOnSave; }
     void SetSaveFseqOnSave(bool b);
 
+    bool SaveBinarySequenceCopy() const;
+    void SetSaveBinarySequenceCopy(bool b);
+
     int AutoSaveInterval() const { return mAutoSaveInterval; }
     void SetAutoSaveInterval(int i);
 
@@ -1374,8 +1404,10 @@ public:
     void ActivateSelectedControllers(const std::string& active);
     void SelectAllControllers();
     ControllerCaps* GetControllerCaps(const std::string& name);
-    bool UploadInputToController(Controller* controller, wxString& message);
-    bool UploadOutputToController(Controller* controller, wxString& message);
+    // connected is an already connected BaseController for the controller, still owned by the caller, in which
+    // case the caller is also responsible for calling RecalcModels first
+    bool UploadInputToController(Controller* controller, wxString& message, BaseController* connected = nullptr);
+    bool UploadOutputToController(Controller* controller, wxString& message, BaseController* connected = nullptr);
     int GetFirstSelectedControllerIndex() const;
     std::list<std::string> GetSelectedControllerNames() const;
     void OnListControllerPopup(wxCommandEvent& event);
@@ -1415,6 +1447,19 @@ public:
     void DoPostStartupCommands();
 
     std::list<RenderProgressInfo *>renderProgressInfo;
+
+    // parallel batch render state
+    ParallelRenderSequence* LoadParallelRenderSequence(const wxString& filename);
+    void StartParallelRenders();
+    void StartParallelRender(ParallelRenderSequence* seq);
+    void ParallelRenderDone(ParallelRenderSequence* seq, bool aborted);
+    std::list<ParallelRenderSequence*> _parallelRenders;
+    wxArrayString _parallelRenderPending;
+    wxArrayString _parallelRenderSerial; // sequences which need the sequencer to render
+    int _parallelRenderMax = 1;
+    bool _parallelRenderExitOnDone = false;
+    bool _parallelRenderCancelled = false;
+    wxStopWatch _parallelRenderTimer;
     std::queue<RenderEvent*> mainThreadRenderEvents;
     std::mutex renderEventLock;
 
@@ -1455,6 +1500,7 @@ public:
     void ReadXlightsFile(const wxString& FileName, wxString *mediaFilename = nullptr);
     void ReadFalconFile(const wxString& FileName, ConvertDialog* convertdlg);
     void WriteFalconPiFile(const wxString& filename, bool allowSparse = true); //  Falcon Pi Player *.fseq
+    void WriteFalconPiFile(const wxString& filename, SequenceData& seqData, SequenceElements& sequenceElements, std::string& media, bool allowSparse = true);
     OutputManager* GetOutputManager() { return &_outputManager; };
     OutputModelManager* GetOutputModelManager() { return&_outputModelManager; }
     void WriteGIFForPreset(const std::string& preset);
@@ -1506,7 +1552,8 @@ public:
                 const std::list<Model *> &restrictToModels,
                 int startFrame, int endFrame,
                 bool progressDialog, bool clear,
-                std::function<void(bool)>&& callback);
+                std::function<void(bool)>&& callback,
+                xLightsXmlFile* sequenceFile = nullptr);
     void BuildRenderTree();
 
     void RenderRange(RenderCommandEvent &cmd);
@@ -1560,6 +1607,8 @@ protected:
     static constexpr int RENDER_ALREADY_RETRIED = 2;
     void OpenRenderAndSaveSequencesF(const wxArrayString &filenames, int flags);
     void OpenRenderAndSaveSequences(const wxArrayString& filenames, bool exitOnDone, bool alreadyRetried = false);
+    // renders up to maxConcurrent sequences at a time without opening them in the sequencer
+    void ParallelRenderAndSaveSequences(const wxArrayString& filenames, int maxConcurrent, bool exitOnDone);
     void OpenAndCheckSequence(const wxArrayString& origFilenames, bool exitOnDone);
     std::string OpenAndCheckSequence(const std::string& origFilenames);
     void AddAllModelsToSequence();
@@ -1627,7 +1676,6 @@ private:
     int mEffectAssistMode = 0;
     int tempEffectAssistMode = 0;
 	bool mRendering;
-    int abortedRenderJobs = 0;
     bool mSaveFseqOnSave;
     int _modelHandleSize = 1;
 
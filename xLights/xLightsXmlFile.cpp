@@ -32,6 +32,7 @@
 #include "sequencer/TimeLine.h"
 #include "Vixen3.h"
 #include "ExternalHooks.h"
+#include "SequenceBinaryFile.h"
 
 #include <log4cpp/Category.hh>
 
@@ -76,6 +77,7 @@ xLightsXmlFile::xLightsXmlFile(const wxFileName& filename, uint32_t frameMS) :
 
 xLightsXmlFile::~xLightsXmlFile()
 {
+    WaitForBackgroundSave();
     models.Clear();
     timing_list.Clear();
     if (audio != nullptr) {
@@ -1056,7 +1058,9 @@ bool xLightsXmlFile::LoadSequence(const wxString& ShowDir, bool ignore_audio, co
         logger_base.info("LoadSequence: Loading sequence " + GetFullPath());
     }
 
-    if (!seqDocument.Load(realFilename.GetFullPath())) {
+    // a binary copy which is still current with the xml saves parsing it
+    bool fromCopy = SequenceBinaryFile::LoadCopy(realFilename.GetFullPath().ToStdString(), seqDocument);
+    if (!fromCopy && !seqDocument.Load(realFilename.GetFullPath())) {
         logger_base.error("LoadSequence: XML file load failed.");
         return false;
     }
@@ -1083,7 +1087,7 @@ bool xLightsXmlFile::LoadSequence(const wxString& ShowDir, bool ignore_audio, co
     }
     supports_model_blending = "true" == root->GetAttribute("ModelBlending", "false");
 
-    if (NeedsTimesCorrected()) {
+    if (fromCopy ? !root->HasAttribute("FixedPointTiming") : NeedsTimesCorrected()) {
         ConvertToFixedPointTiming();
         root->AddAttribute("FixedPointTiming", "1");
     }
@@ -2560,57 +2564,11 @@ wxArrayString xLightsXmlFile::GetTimingList(const SequenceElements& seq_elements
 bool xLightsXmlFile::Save()
 {
     UpdateVersion();
-    return seqDocument.Save(GetFullPath());
-}
-
-void xLightsXmlFile::WriteEffects(EffectLayer *layer,
-                                  wxXmlNode *effect_layer_node,
-                                  StringIntMap &colorPalettes,
-                                  wxXmlNode* colorPalette_node,
-                                  StringIntMap &effectStrings,
-                                  wxXmlNode* effectDB_Node) {
-    int num_effects = layer->GetEffectCount();
-    for(int k = 0; k < num_effects; ++k)
-    {
-        Effect* effect = layer->GetEffect(k);
-        std::string effectStdString = effect->GetSettingsAsString();
-        wxString effectString = ToWXString(effectStdString);
-        int size = effectStrings.size();
-        int ref = effectStrings[effectString] - 1;
-        if (ref == -1) {
-            ref = size;
-            effectStrings[effectString] = ref + 1;
-            AddChildXmlNode(effectDB_Node, "Effect", effectString);
-        }
-
-
-        // Add effect node
-        wxXmlNode* effect_node = AddChildXmlNode(effect_layer_node, "Effect");
-        effect_node->AddAttribute("ref", string_format("%d", ref));
-        effect_node->AddAttribute("name", XmlSafe(effect->GetEffectName()));
-        if (effect->GetProtected()) {
-            effect_node->AddAttribute("protected", "1");
-        }
-        if (effect->GetSelected()) {
-            effect_node->AddAttribute("selected", "1");
-        }
-        if (effect->GetID()) {
-            effect_node->AddAttribute("id", string_format("%d", effect->GetID()));
-        }
-        effect_node->AddAttribute("startTime", string_format("%d", effect->GetStartTimeMS()));
-        effect_node->AddAttribute("endTime", string_format("%d", effect->GetEndTimeMS()));
-        wxString palette = effect->GetPaletteAsString();
-        if (palette != "") {
-            size = colorPalettes.size();
-            int pref = colorPalettes[palette] - 1;
-            if (pref == -1) {
-                pref = size;
-                colorPalettes[palette] = pref + 1;
-                AddChildXmlNode(colorPalette_node, "ColorPalette", palette);
-            }
-            effect_node->AddAttribute("palette", string_format("%d", pref));
-        }
+    if (!seqDocument.Save(GetFullPath())) {
+        return false;
     }
+    SequenceBinaryFile::SaveCopy(seqDocument, GetFullPath().ToStdString());
+    return true;
 }
 
 void xLightsXmlFile::AddJukebox(wxXmlNode* node)
@@ -2630,23 +2588,29 @@ void xLightsXmlFile::AddJukebox(wxXmlNode* node)
     root->AddChild(node);
 }
 
+// the nodes Save rebuilds from the sequence elements each time
+static bool IsSnapshotNode(const wxString& name)
+{
+    return name == "DisplayElements" ||
+           name == "ElementEffects" ||
+           name == "DataLayers" ||
+           name == "ColorPalettes" ||
+           name == "EffectDB" ||
+           name == "TimingTags" ||
+           name == "lastView";
+}
+
 // function used to save sequence data
 bool xLightsXmlFile::Save(SequenceElements& seq_elements)
 {
-    wxXmlNode* root = seqDocument.GetRoot();
+    // a backup still being written must not end up newer than the sequence
+    WaitForBackgroundSave();
 
-    root->DeleteAttribute("ModelBlending");
-    root->AddAttribute("ModelBlending", seq_elements.SupportsModelBlending() ? "true" : "false");
+    wxXmlNode* root = seqDocument.GetRoot();
 
     // Delete nodes that will be replaced
     for (wxXmlNode* e = root->GetChildren(); e != nullptr;) {
-        if (e->GetName() == "DisplayElements" ||
-            e->GetName() == "ElementEffects" ||
-            e->GetName() == "DataLayers" ||
-            e->GetName() == "ColorPalettes" ||
-            e->GetName() == "EffectDB" ||
-            e->GetName() == "TimingTags" ||
-            e->GetName() == "lastView") {
+        if (IsSnapshotNode(e->GetName())) {
             wxXmlNode* node_to_delete = e;
             e = e->GetNext();
             root->RemoveChild(node_to_delete);
@@ -2656,178 +2620,9 @@ bool xLightsXmlFile::Save(SequenceElements& seq_elements)
         }
     }
 
-    StringIntMap colorPalettes;
-    wxXmlNode* colorPalette_node = AddChildXmlNode(root, "ColorPalettes");
-    StringIntMap effectStrings;
-    wxXmlNode* effectDB_Node = AddChildXmlNode(root, "EffectDB");
-
     // Now add new elements to our xml document
-    wxXmlNode* data_layer = AddChildXmlNode(root, "DataLayers");
-    wxXmlNode* display_node = AddChildXmlNode(root, "DisplayElements");
-    wxXmlNode* elements_node = AddChildXmlNode(root, "ElementEffects");
-    wxXmlNode* last_view_node = AddChildXmlNode(root, "lastView");
-    wxXmlNode* timing_tags_node = AddChildXmlNode(root, "TimingTags");
-
-    SetNodeContent(last_view_node, wxString::Format("%d", seq_elements.GetCurrentView()));
-
-    int num_data_layers = mDataLayers.GetNumLayers();
-    for (int i = 0; i < num_data_layers; ++i) {
-        DataLayer* layer = mDataLayers.GetDataLayer(i);
-        wxXmlNode* layer_node = AddChildXmlNode(data_layer, "DataLayer");
-        layer_node->AddAttribute("lor_params", wxString::Format("%d", layer->GetLORConvertParams()));
-        layer_node->AddAttribute("channel_offset", wxString::Format("%d", layer->GetChannelOffset()));
-        layer_node->AddAttribute("num_channels", wxString::Format("%d", layer->GetNumChannels()));
-        layer_node->AddAttribute("num_frames", wxString::Format("%d", layer->GetNumFrames()));
-        layer_node->AddAttribute("data", layer->GetDataSource());
-        layer_node->AddAttribute("source", layer->GetSource());
-        layer_node->AddAttribute("name", layer->GetName());
-    }
-
-    if (seq_elements.GetTimeLine() != nullptr) {
-        for (int i = 0; i < 10; ++i) {
-            wxXmlNode* tag_node = AddChildXmlNode(timing_tags_node, "Tag");
-            tag_node->AddAttribute("number", string_format("%d", i));
-            tag_node->AddAttribute("position", string_format("%d", seq_elements.GetTimeLine()->GetTagPosition(i)));
-        }
-    }
-
-    int num_elements = seq_elements.GetElementCount();
-    for (int i = 0; i < num_elements; ++i) {
-        Element* element = seq_elements.GetElement(i);
-
-        // Add display elements
-        wxXmlNode* display_element_node = AddChildXmlNode(display_node, "Element");
-        display_element_node->AddAttribute("collapsed", string_format("%d", element->GetCollapsed()));
-        if (element->IsRenderDisabled()) {
-            display_element_node->AddAttribute("RenderDisabled", "1");
-        }
-        display_element_node->AddAttribute("type", element->GetType() == ElementType::ELEMENT_TYPE_TIMING ? "timing" : "model");
-        display_element_node->AddAttribute("name", element->GetName());
-        if (element->GetType() == ElementType::ELEMENT_TYPE_TIMING) {
-            TimingElement *te = dynamic_cast<TimingElement*>(element);
-            display_element_node->AddAttribute("visible", string_format("%d", te->GetMasterVisible()));
-        } else {
-            display_element_node->AddAttribute("visible", string_format("%d", element->GetVisible()));
-        }
-
-        // Add element node to ElementEffects
-        wxXmlNode* element_effects_node = AddChildXmlNode(elements_node, "Element");
-        element_effects_node->AddAttribute("type", element->GetType() == ElementType::ELEMENT_TYPE_TIMING ? "timing" : "model");
-        element_effects_node->AddAttribute("name", element->GetName());
-
-        if (element->GetType() == ElementType::ELEMENT_TYPE_TIMING) {
-            TimingElement* tm = dynamic_cast<TimingElement*>(element);
-            display_element_node->AddAttribute("views", tm->GetViews());
-            display_element_node->AddAttribute("active", string_format("%d", tm->GetActive()));
-            if (tm->GetSubType() != "") {
-                display_element_node->AddAttribute("subType", tm->GetSubType());
-            }
-            if (tm->GetFixedTiming()) {
-                element_effects_node->AddAttribute("fixed", string_format("%d", tm->GetFixedTiming()));
-                AddChildXmlNode(element_effects_node, "EffectLayer");
-            } else {
-                int num_layers = tm->GetEffectLayerCount();
-                for (int j = 0; j < num_layers; ++j) {
-                    EffectLayer* layer = tm->GetEffectLayer(j);
-                    // Add layer node
-                    wxXmlNode* effect_layer_node = AddChildXmlNode(element_effects_node, "EffectLayer");
-
-                    // Add effects
-                    int num_effects = layer->GetEffectCount();
-                    for (int k = 0; k < num_effects; ++k) {
-                        Effect* effect = layer->GetEffect(k);
-                        // Add effect node
-                        wxXmlNode* effect_node = AddChildXmlNode(effect_layer_node, "Effect", effect->GetSettingsAsString());
-
-                        effect_node->AddAttribute("label", effect->GetEffectName());
-                        if (effect->GetProtected()) {
-                            effect_node->AddAttribute("protected", "1");
-                        }
-                        if (effect->GetSelected()) {
-                            effect_node->AddAttribute("selected", "1");
-                        }
-                        effect_node->AddAttribute("startTime", string_format("%d", effect->GetStartTimeMS()));
-                        effect_node->AddAttribute("endTime", string_format("%d", effect->GetEndTimeMS()));
-                    }
-                }
-            }
-        } else if (element->GetType() == ElementType::ELEMENT_TYPE_MODEL) {
-            ModelElement* me = dynamic_cast<ModelElement*>(element);
-            int num_layers = me->GetEffectLayerCount();
-            for (int j = 0; j < num_layers; ++j) {
-                EffectLayer* layer = me->GetEffectLayer(j);
-
-                // Add layer node
-                wxXmlNode* effect_layer_node = AddChildXmlNode(element_effects_node, "EffectLayer");
-                if (!layer->GetLayerName().empty()) {
-                    effect_layer_node->AddAttribute("layerName", layer->GetLayerName());
-                }
-                WriteEffects(layer, effect_layer_node, colorPalettes,
-                             colorPalette_node,
-                             effectStrings,
-                             effectDB_Node);
-            }
-
-            int num_strands = me->GetSubModelAndStrandCount();
-            for (int strand = 0; strand < num_strands; strand++) {
-                SubModelElement* se = me->GetSubModel(strand);
-                num_layers = se->GetEffectLayerCount();
-                wxXmlNode* effect_layer_node = nullptr;
-
-                StrandElement* strEl = dynamic_cast<StrandElement*>(se);
-                for (int j = 0; j < num_layers; ++j) {
-                    EffectLayer* layer = se->GetEffectLayer(j);
-
-                    if (layer->GetEffectCount() != 0 || !layer->GetLayerName().empty()) {
-                        wxXmlNode* eln = AddChildXmlNode(element_effects_node, strEl == nullptr ? "SubModelEffectLayer" : "Strand");
-                        if (strEl != nullptr) {
-                            eln->AddAttribute("index", string_format("%d", strEl->GetStrand()));
-                            if (j == 0) {
-                                effect_layer_node = eln;
-                            }
-                        }
-                        if (!layer->GetLayerName().empty()) {
-                            eln->AddAttribute("layerName", layer->GetLayerName());
-                        }
-                        if (j > 0) {
-                            eln->AddAttribute("layer", string_format("%d", j));
-                        }
-                        if (se->GetName() != "") {
-                            eln->AddAttribute("name", se->GetName());
-                        }
-                        WriteEffects(layer, eln, colorPalettes,
-                                     colorPalette_node,
-                                     effectStrings,
-                                     effectDB_Node);
-                    }
-                }
-                if (strEl != nullptr) {
-                    for (int n = 0; n < strEl->GetNodeLayerCount(); n++) {
-                        NodeLayer* nlayer = strEl->GetNodeLayer(n);
-                        if (nlayer->GetEffectCount() == 0) {
-                            continue;
-                        }
-                        if (effect_layer_node == nullptr) {
-                            effect_layer_node = AddChildXmlNode(element_effects_node, "Strand");
-                            effect_layer_node->AddAttribute("index", string_format("%d", strEl->GetStrand()));
-                            if (se->GetName() != "") {
-                                effect_layer_node->AddAttribute("name", se->GetName());
-                            }
-                        }
-                        wxXmlNode* neffect_layer_node = AddChildXmlNode(effect_layer_node, "Node");
-                        neffect_layer_node->AddAttribute("index", string_format("%d", n));
-                        if (nlayer->GetNodeName() != "") {
-                            neffect_layer_node->AddAttribute("name", nlayer->GetNodeName());
-                        }
-                        WriteEffects(nlayer, neffect_layer_node, colorPalettes,
-                                     colorPalette_node,
-                                     effectStrings,
-                                     effectDB_Node);
-                    }
-                }
-            }
-        }
-    }
+    SequenceSnapshot snapshot(seq_elements, mDataLayers, _saveCache);
+    snapshot.AddToDocument(root);
     UpdateVersion();
 
 #ifdef USE_COMPRESSION
@@ -2861,18 +2656,91 @@ bool xLightsXmlFile::Save(SequenceElements& seq_elements)
     }
 #endif
 
-    wxFileOutputStream fout(GetFullPath());
-    wxBufferedOutputStream *bout = new wxBufferedOutputStream(fout, 2 * 1024 * 1024);
-    if (!seqDocument.Save(*bout)) {
-        delete bout;
+    if (!WriteDocument(seqDocument, GetFullPath())) {
         return false;
     }
-    delete bout;
-    if (!fout.Close()) {
+    SequenceBinaryFile::SaveCopy(seqDocument, GetFullPath().ToStdString());
+
+    MarkNewFileRevision(GetFullPath());
+    return true;
+}
+
+bool xLightsXmlFile::SaveInBackground(SequenceElements& seq_elements, const wxString& filename, std::function<void(bool)> done)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (_backgroundSaveRunning) {
+        logger_base.debug("Background save of %s skipped as the previous one is still running.", (const char*)filename.c_str());
         return false;
     }
+    if (_saveThread.joinable()) {
+        _saveThread.join();
+    }
 
-    MarkNewFileRevision(GetFullPath());
+    wxStopWatch sw;
+    UpdateVersion();
+
+    // the document is copied without the nodes the snapshot replaces so the thread shares nothing with seqDocument
+    wxXmlNode* root = seqDocument.GetRoot();
+    wxXmlNode* newRoot = new wxXmlNode(wxXML_ELEMENT_NODE, root->GetName());
+    for (wxXmlAttribute* a = root->GetAttributes(); a != nullptr; a = a->GetNext()) {
+        newRoot->AddAttribute(a->GetName(), a->GetValue());
+    }
+    for (wxXmlNode* e = root->GetChildren(); e != nullptr; e = e->GetNext()) {
+        if (!IsSnapshotNode(e->GetName())) {
+            newRoot->AddChild(new wxXmlNode(*e));
+        }
+    }
+    auto doc = std::make_unique<wxXmlDocument>();
+    doc->SetVersion(seqDocument.GetVersion());
+    doc->SetFileEncoding(seqDocument.GetFileEncoding());
+    doc->SetRoot(newRoot);
+
+    auto snapshot = std::make_unique<SequenceSnapshot>(seq_elements, mDataLayers, _saveCache);
+    logger_base.debug("Snapshot of %d elements for background save, %d unchanged since the last, took %ldms.",
+                      (int)snapshot->GetElementCount(), (int)snapshot->GetReusedElementCount(), sw.Time());
+
+    _backgroundSaveRunning = true;
+    _saveThread = std::thread([this, doc = std::move(doc), snapshot = std::move(snapshot), filename, done]() {
+        wxStopWatch sw;
+        snapshot->AddToDocument(doc->GetRoot());
+        bool ok = WriteDocument(*doc, filename);
+        if (ok) {
+            logger_base.debug("Background save of %s took %ldms.", (const char*)filename.c_str(), sw.Time());
+        } else {
+            logger_base.error("Background save of %s failed.", (const char*)filename.c_str());
+        }
+        _backgroundSaveRunning = false;
+        if (done) {
+            done(ok);
+        }
+    });
+    return true;
+}
+
+void xLightsXmlFile::WaitForBackgroundSave()
+{
+    if (_saveThread.joinable()) {
+        _saveThread.join();
+    }
+}
+
+// writes beside the file and renames it into place so a failed or interrupted save never damages the existing file
+bool xLightsXmlFile::WriteDocument(const wxXmlDocument& doc, const wxString& filename)
+{
+    wxString tmp = filename + ".tmp";
+    wxFileOutputStream fout(tmp);
+    if (!fout.IsOk()) {
+        return false;
+    }
+    wxBufferedOutputStream *bout = new wxBufferedOutputStream(fout, 2 * 1024 * 1024);
+    bool ok = doc.Save(*bout);
+    delete bout;
+    ok = fout.Close() && ok;
+    if (!ok || !wxRenameFile(tmp, filename, true)) {
+        wxRemoveFile(tmp);
+        return false;
+    }
     return true;
 }
 
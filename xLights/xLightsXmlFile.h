@@ -16,8 +16,12 @@
 #include "DataLayer.h"
 #include "AudioManager.h"
 #include "Vixen3.h"
+#include "SequenceSnapshot.h"
 
 #include <array>
+#include <atomic>
+#include <functional>
+#include <thread>
 
 class SequenceElements;  // forward declaration needed due to circular dependency
 class xLightsFrame;
@@ -50,6 +54,11 @@ public:
 
     void AddJukebox(wxXmlNode* node);
     bool Save(SequenceElements& elements);
+    // Saves the elements as they are now to filename on a background thread so editing can carry on.
+    // done is called on that thread with the result. Returns false, saving nothing, if the previous
+    // background save has not finished
+    bool SaveInBackground(SequenceElements& elements, const wxString& filename, std::function<void(bool)> done);
+    void WaitForBackgroundSave();
     wxXmlDocument& GetXmlDocument()
     {
         return seqDocument;
@@ -213,6 +222,9 @@ private:
     bool sequence_loaded = false; // flag to indicate the sequencer has been loaded with this xml data
     DataLayerSet mDataLayers;
     AudioManager* audio = nullptr;
+    SequenceSnapshot::Cache _saveCache;
+    std::thread _saveThread;
+    std::atomic_bool _backgroundSaveRunning = false;
 
     void CreateNew();
     bool LoadSequence(const wxString& ShowDir, bool ignore_audio, const wxFileName &realFilename);
@@ -251,11 +263,5 @@ private:
     // void SetSequenceDuration(const wxString& length, wxXmlNode* node);
 
     static wxString InsertMissing(wxString str, wxString missing_array, bool INSERT);
-
-    void WriteEffects(EffectLayer* layer,
-                      wxXmlNode* effect_layer_node,
-                      StringIntMap& colorPalettes,
-                      wxXmlNode* colorPalette_node,
-                      StringIntMap& effectStrings,
-                      wxXmlNode* effectDB_Node);
+    static bool WriteDocument(const wxXmlDocument& doc, const wxString& filename);
 };
@@ -12,6 +12,8 @@
 #include "xScannerMain.h"
 #include "xScannerApp.h"
 #include "../xLights/utils/Curl.h"
+#include "../xLights/utils/NetworkProbe.h"
+#include "../xLights/utils/ip_utils.h"
 #include "../xLights/UtilFunctions.h"
 #include "../xSchedule/wxJSON/jsonreader.h"
 #include "../xLights/controllers/Falcon.h"
@@ -51,7 +53,7 @@ void WorkManager::Start()
 			_threadsPing.push_back(new ScanThread(*this, ThreadType::TTPING));
 			_threadsOther.push_back(new ScanThread(*this, ThreadType::TTOTHER));
 			_threadsOther.push_back(new ScanThread(*this, ThreadType::TTOTHER));
-			_threadsHTTP.push_back(new ScanThread(*this, ThreadType::TTMAIN, new wxSocketClient(wxSOCKET_WAITALL | wxSOCKET_BLOCK)));
+			_threadsHTTP.push_back(new ScanThread(*this, ThreadType::TTMAIN));
 		}
 		else {
 			for (size_t i = 0; i < PING_THREADS; i++) {
@@ -61,7 +63,7 @@ void WorkManager::Start()
 				_threadsOther.push_back(new ScanThread(*this, ThreadType::TTOTHER));
 			}
 			for (size_t i = 0; i < HTTP_THREADS; i++) {
-				_threadsHTTP.push_back(new ScanThread(*this, ThreadType::TTMAIN, new wxSocketClient(wxSOCKET_WAITALL | wxSOCKET_BLOCK)));
+				_threadsHTTP.push_back(new ScanThread(*this, ThreadType::TTMAIN));
 			}
 		}
 	}
@@ -102,6 +104,8 @@ void WorkManager::Stop()
 
 WorkManager::~WorkManager()
 {
+	NetworkProbe::INSTANCE.Cancel(this);
+
 	while (_threadsHTTP.size() > 0) {
 		ScanThread* t = _threadsHTTP.back();
 		_threadsHTTP.pop_back();
@@ -266,21 +270,25 @@ void PingWork::DoWork(WorkManager& workManager, wxSocketClient* client)
 		results.push_back({ "Network", wxString::Format("%d.%d.%d.0", ip1, ip2, ip3)});
 		results.push_back({ "Network Type", privateNetwork ? "Private" : "Public" });
 
-		auto const& result = IPOutput::Ping(_ip, _proxy);
-		if (result == IPOutput::PINGSTATE::PING_OK || result == IPOutput::PINGSTATE::PING_WEBOK) {
-			results.push_back({ "PING", "OK" });
-			workManager.AddFoundIP(_ip);
-			workManager.AddHTTP(_ip, 80, _proxy);
-			//workManager.AddHTTP(_ip, 81);
-			//workManager.AddHTTP(_ip, 8080);
-			//workManager.AddHTTP(_ip, 8081);
-			PublishResult(workManager, results);
-		}
-		else {
-			results.push_back({ "PING", "FAILED" });
-			PublishResult(workManager, results);
-			workManager.AddHTTP(_ip, 80, _proxy); // we still try to open as it may be behind a http proxy
-		}
+		// the ping is made by the network probe alongside all the others ... this work is done once it is sent
+		std::string ip = _ip;
+		std::string proxy = _proxy;
+		IPOutput::PingAsync(&workManager, _ip, _proxy, 1, [&workManager, ip, proxy, results](Output::PINGSTATE result) mutable {
+			if (result == IPOutput::PINGSTATE::PING_OK || result == IPOutput::PINGSTATE::PING_WEBOK) {
+				results.push_back({ "PING", "OK" });
+				workManager.AddFoundIP(ip);
+				workManager.AddHTTP(ip, 80, proxy);
+				//workManager.AddHTTP(ip, 81);
+				//workManager.AddHTTP(ip, 8080);
+				//workManager.AddHTTP(ip, 8081);
+				PublishResult(workManager, results);
+			}
+			else {
+				results.push_back({ "PING", "FAILED" });
+				PublishResult(workManager, results);
+				workManager.AddHTTP(ip, 80, proxy); // we still try to open as it may be behind a http proxy
+			}
+		});
 	}
 }
 
@@ -343,61 +351,63 @@ void HTTPWork::DoWork(WorkManager& workManager, wxSocketClient* client)
 
 	logger_base.debug("HTTPWork %s:%d Proxy: %s", (const char*)_ip.c_str(), _port, (const char*)_proxy.c_str());
 
-	wxIPV4address addr;
-	addr.Hostname(_ip);
-	addr.Service(_port);
-
-	if (client != nullptr) {
-		if (client->Connect(addr)) {
-			client->Close();
-			logger_base.debug("    HTTP Connected.");
-			results.push_back({ "IP", _ip });
-			results.push_back({ "Type", "HTTP" });
-			if (_proxy != "") {
-				results.push_back({ "Web", wxString::Format("Via proxy %s OK on port %d", _proxy, _port) });
+	if (!_connected) {
+		// the network probe checks something is listening ... only then does this come back to fetch the page
+		std::string ip = _ip;
+		int port = _port;
+		std::string proxy = _proxy;
+		NetworkProbe::INSTANCE.Connect(&workManager, ip_utils::ResolveIP(_ip), _port, 3000, [&workManager, ip, port, proxy](const NetworkProbe::Result& result) {
+			static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+			if (result.connected) {
+				workManager.AddWork(new HTTPWork(ip, port, proxy, true));
 			}
 			else {
-				results.push_back({ "Web", wxString::Format("Direct OK on port %d", _port) });
+				logger_base.debug("    HTTP Connect %s:%d failed.", (const char*)ip.c_str(), port);
 			}
+		});
+		return;
+	}
 
-			try {
-                logger_base.debug("    Getting the web page.");
-                std::string page = Curl::HTTPSGet(_proxy + _ip, "", "", SLOW_TIMEOUT);
-                logger_base.debug("    Got the web page.");
-
-				if (page != "") {
-                    logger_base.debug("    Getting the title.");
-                    std::string title = GetTitle(page);
-                    logger_base.debug("    Got the title.");
-                    if (title != "") {
-						results.push_back({ "Title", title });
-					}
+	logger_base.debug("    HTTP Connected.");
+	results.push_back({ "IP", _ip });
+	results.push_back({ "Type", "HTTP" });
+	if (_proxy != "") {
+		results.push_back({ "Web", wxString::Format("Via proxy %s OK on port %d", _proxy, _port) });
+	}
+	else {
+		results.push_back({ "Web", wxString::Format("Direct OK on port %d", _port) });
+	}
 
-                    logger_base.debug("    Determining controller type.");
-                    std::string controller = GetControllerTypeBasedOnPageContent(page);
-                    logger_base.debug("    Got the controller type.");
-                    if (controller != "") {
-						results.push_back({ "Controller", controller });
-					}
-				}
+	try {
+        logger_base.debug("    Getting the web page.");
+        std::string page = Curl::HTTPSGet(_proxy + _ip, "", "", SLOW_TIMEOUT);
+        logger_base.debug("    Got the web page.");
+
+		if (page != "") {
+            logger_base.debug("    Getting the title.");
+            std::string title = GetTitle(page);
+            logger_base.debug("    Got the title.");
+            if (title != "") {
+				results.push_back({ "Title", title });
 			}
-			catch (...) {
 
+            logger_base.debug("    Determining controller type.");
+            std::string controller = GetControllerTypeBasedOnPageContent(page);
+            logger_base.debug("    Got the controller type.");
+            if (controller != "") {
+				results.push_back({ "Controller", controller });
 			}
-
-			PublishResult(workManager, results);
-
-			workManager.AddWork(new FPPWork(_ip, _proxy));
-			workManager.AddWork(new FalconWork(_ip, _proxy));
-			workManager.AddWork(new xScheduleWork(_ip));
-		}
-		else {
-			logger_base.debug("    HTTP Connect failed.");
 		}
 	}
-	else {
-		wxASSERT(false);
+	catch (...) {
+
 	}
+
+	PublishResult(workManager, results);
+
+	workManager.AddWork(new FPPWork(_ip, _proxy));
+	workManager.AddWork(new FalconWork(_ip, _proxy));
+	workManager.AddWork(new xScheduleWork(_ip));
 }
 
 #pragma endregion
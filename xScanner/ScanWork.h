@@ -12,6 +12,7 @@
 #include <atomic>
 
 #include "../xLights/outputs/OutputManager.h"
+#include "../xLights/utils/NetworkProbe.h"
 
 // seed with ... xLights defined stuff
 // seed with networks we are attached to
@@ -128,7 +129,7 @@ public:
     virtual ~ScanWork() {}
     WorkType GetWorkType() const { return _type; }
     virtual void DoWork(WorkManager& workManager, wxSocketClient* client) = 0;
-    void PublishResult(WorkManager& workManager, std::list<std::pair<std::string, std::string>>& result);
+    static void PublishResult(WorkManager& workManager, std::list<std::pair<std::string, std::string>>& result);
     virtual bool IsMainThread() { return false; }
     void Terminate() { _terminate = true; }
 };
@@ -178,6 +179,8 @@ public:
     }
     void Restart()
     {
+        // pings and connects already under way are dropped too
+        NetworkProbe::INSTANCE.Cancel(this);
         while (_queuePing.size() > 0)             {
             _queuePing.pop();
         }
@@ -234,7 +237,7 @@ public:
     }
     std::string GetPendingWork()
     {
-        return wxString::Format("HTTP %d : Ping %d : Other %d", (int)_queueHTTP.size(), (int)_queuePing.size(), (int)_queueOther.size());
+        return wxString::Format("HTTP %d : Ping %d : Probing %d : Other %d", (int)_queueHTTP.size(), (int)_queuePing.size(), (int)NetworkProbe::INSTANCE.GetPending(this), (int)_queueOther.size());
     }
     void AddHTTP(const std::string& ip, int port, const std::string& proxy = "");
     void AddIP(const std::string& ip, const std::string& why, const std::string& proxy = "");
@@ -344,12 +347,13 @@ protected:
     std::string _ip;
     int _port = 80;
     std::string _proxy;
+    bool _connected = false; // the network probe has already connected to the port
 
     std::string GetTitle(const std::string& page);
     std::string GetControllerTypeBasedOnPageContent(const std::string& page);
 
 public:
-    HTTPWork(const std::string& ip, int port = 80, const std::string& proxy = "") : ScanWork(WorkType::WTHTTP) { _ip = ip; _port = port; _proxy = proxy; }
+    HTTPWork(const std::string& ip, int port = 80, const std::string& proxy = "", bool connected = false) : ScanWork(WorkType::WTHTTP) { _ip = ip; _port = port; _proxy = proxy; _connected = connected; }
     virtual ~HTTPWork() {}
     virtual void DoWork(WorkManager& workManager, wxSocketClient* client) override;
     virtual bool IsMainThread() override { return true; }
@@ -0,0 +1,174 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "FSEQReadAhead.h"
+#include "../xLights/FSEQFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <log4cpp/Category.hh>
+
+FSEQReadAhead::FSEQReadAhead(FSEQFile* fseq, const std::vector<std::pair<uint32_t, uint32_t>>& ranges, uint32_t startFrame, int aheadFrames)
+{
+    _fseq = fseq;
+    _frameSize = fseq->getMaxChannel() + 1;
+    _numFrames = fseq->getNumFrames();
+    _blendChannels = _frameSize;
+    _wanted = startFrame;
+
+    _fseq->prepareRead(ranges, startFrame);
+
+    // channels outside the ranges are never written so the buffers start zeroed and stay that way
+    _slots.resize(std::max(2, aheadFrames));
+    for (auto& it : _slots) {
+        it._data.resize(_frameSize, 0);
+    }
+
+    _thread = std::thread(&FSEQReadAhead::Run, this);
+}
+
+FSEQReadAhead::~FSEQReadAhead()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _stop = true;
+        _signal.notify_all();
+    }
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    logger_base.debug("FSEQ read ahead for %s stopped. %ld frames played, %ld had to be waited for.",
+                      (const char*)_fseq->getFilename().c_str(), (long)_frames, (long)_waits);
+}
+
+FSEQReadAhead* FSEQReadAhead::Create(FSEQFile* fseq, size_t startChannel, size_t channels)
+{
+    if (fseq == nullptr) return nullptr;
+
+    // only read the channels we are going to blend
+    uint32_t start = 0;
+    uint32_t count = fseq->getMaxChannel() + 1;
+    if (channels > 0) {
+        start = std::min(startChannel > 0 ? (uint32_t)startChannel - 1 : 0, count);
+        count = std::min((uint32_t)channels, count - start);
+    }
+
+    auto ra = new FSEQReadAhead(fseq, { { start, count } });
+    ra->_blendOffset = start;
+    ra->_blendChannels = count;
+    return ra;
+}
+
+bool FSEQReadAhead::BlendFrame(uint32_t frame, uint8_t* buffer, size_t size, APPLYMETHOD applyMethod)
+{
+    if (frame >= _numFrames) return false;
+
+    // blend straight out of the read ahead buffer ... no copy needed
+    uint8_t* data = GetFrame(frame);
+    if (data == nullptr) return true;
+
+    Blend(buffer, size, data + _blendOffset, _blendChannels, applyMethod, _blendOffset);
+    return true;
+}
+
+int FSEQReadAhead::FindSlot(long frame) const
+{
+    for (size_t i = 0; i < _slots.size(); i++) {
+        if (_slots[i]._frame == frame) return i;
+    }
+    return -1;
+}
+
+bool FSEQReadAhead::IsLoaded(long frame) const
+{
+    return FindSlot(frame) != -1;
+}
+
+void FSEQReadAhead::Run()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::unique_lock<std::mutex> lock(_lock);
+    while (!_stop) {
+        long first = _wanted;
+        long last = std::min(first + (long)_slots.size(), (long)_numFrames);
+
+        long frame = -1;
+        for (long f = first; f < last; f++) {
+            if (!IsLoaded(f)) {
+                frame = f;
+                break;
+            }
+        }
+
+        // reuse a slot holding a frame we no longer need
+        int slot = -1;
+        if (frame != -1) {
+            for (size_t i = 0; i < _slots.size(); i++) {
+                if (_slots[i]._frame < first || _slots[i]._frame >= last) {
+                    slot = i;
+                    break;
+                }
+            }
+        }
+
+        if (slot == -1) {
+            _signal.wait(lock);
+            continue;
+        }
+
+        auto& s = _slots[slot];
+        s._frame = frame;
+        s._ready = false;
+        s._failed = false;
+
+        lock.unlock();
+        bool ok = _fseq->readFrame(frame, s._data.data(), _frameSize);
+        lock.lock();
+
+        if (!ok) {
+            logger_base.warn("FSEQ read ahead failed to read frame %ld from %s. It will be skipped.", frame, (const char*)_fseq->getFilename().c_str());
+        }
+        s._failed = !ok;
+        s._ready = true;
+        _signal.notify_all();
+    }
+}
+
+uint8_t* FSEQReadAhead::GetFrame(uint32_t frame)
+{
+    if (frame >= _numFrames) return nullptr;
+
+    std::unique_lock<std::mutex> lock(_lock);
+
+    if (_wanted != frame) {
+        _wanted = frame;
+        _signal.notify_all();
+    }
+
+    _frames++;
+    int slot = FindSlot(frame);
+    if (slot == -1 || !_slots[slot]._ready) {
+        _waits++;
+        while (!_stop) {
+            slot = FindSlot(frame);
+            if (slot != -1 && _slots[slot]._ready) break;
+            _signal.wait(lock);
+        }
+    }
+
+    // stale data from the slot's last frame is worse than nothing
+    if (slot == -1 || _slots[slot]._failed) return nullptr;
+    return _slots[slot]._data.data();
+}
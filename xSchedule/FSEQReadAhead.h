@@ -0,0 +1,86 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <stdint.h>
+
+#include "Blend.h"
+
+class FSEQFile;
+
+// Reads and decompresses FSEQ frames on a background thread into a small ring of
+// reusable frame buffers so playback never allocates or waits on decompression
+// in the frame timer.
+//
+// Once created the read ahead owns all frame reads from the FSEQFile. The FSEQFile
+// must outlive it.
+class FSEQReadAhead
+{
+    FSEQFile* _fseq = nullptr;
+    uint32_t _frameSize = 0;
+    uint32_t _numFrames = 0;
+    uint32_t _blendOffset = 0;
+    uint32_t _blendChannels = 0;
+
+    struct Slot
+    {
+        std::vector<uint8_t> _data;
+        long _frame = -1;
+        bool _ready = false;
+        bool _failed = false; // the read failed so _data holds whatever was there before
+    };
+    std::vector<Slot> _slots;
+
+    std::mutex _lock;
+    std::condition_variable _signal;
+    std::thread _thread;
+    bool _stop = false;
+    long _wanted = 0;
+
+    std::atomic<long> _frames = 0;
+    std::atomic<long> _waits = 0;
+
+    bool IsLoaded(long frame) const;
+    int FindSlot(long frame) const;
+    void Run();
+
+public:
+
+    // ranges are the channel ranges the caller needs ... passed on to FSEQFile::prepareRead
+    FSEQReadAhead(FSEQFile* fseq, const std::vector<std::pair<uint32_t, uint32_t>>& ranges, uint32_t startFrame = 0, int aheadFrames = 10);
+    virtual ~FSEQReadAhead();
+
+    // A read ahead of only the channels a play list item blends ... startChannel is 1 based and a channels
+    // of 0 means the whole frame
+    static FSEQReadAhead* Create(FSEQFile* fseq, size_t startChannel, size_t channels);
+
+    // Blends the channels the read ahead was created for into the buffer at the same position.
+    // Returns false if the frame does not exist. A frame which could not be read is skipped
+    // leaving the buffer as it was.
+    bool BlendFrame(uint32_t frame, uint8_t* buffer, size_t size, APPLYMETHOD applyMethod);
+
+    // Returns the channel indexed frame data or nullptr if the frame does not exist or could not be read.
+    // The pointer remains valid until the next call to GetFrame and must not be written to.
+    uint8_t* GetFrame(uint32_t frame);
+
+    uint32_t GetFrameSize() const { return _frameSize; }
+
+    // number of frames the caller had to wait for because they were not read ahead
+    long GetWaits() const { return _waits; }
+    long GetFrames() const { return _frames; }
+};
@@ -16,6 +16,7 @@
 class wxXmlNode;
 class OutputManager;
 class OutputProcessExcludeDim;
+class OutputProcessPlan;
 
 class OutputProcess
 {
@@ -57,4 +58,8 @@ class OutputProcess
         static std::list<OutputProcessExcludeDim*> GetExcludeDim(std::list<OutputProcess*>& processes, size_t sc, size_t ec);
 
         virtual void Frame(uint8_t* buffer, size_t size, std::list<OutputProcess*>& processes) = 0;
+
+        // Processes which are a simple per channel lookup or channel move describe themselves to the plan
+        // so they can be fused with their neighbours. Return false if Frame must be called instead.
+        virtual bool AddToPlan(OutputProcessPlan& plan, size_t size, std::list<OutputProcess*>& processes) { return false; }
 };
@@ -9,6 +9,7 @@
  **************************************************************/
 
 #include "OutputProcessColourOrder.h"
+#include "OutputProcessPlan.h"
 #include <wx/xml/xml.h>
 
 OutputProcessColourOrder::OutputProcessColourOrder(OutputManager* outputManager, wxXmlNode* node) : OutputProcess(outputManager, node)
@@ -94,3 +95,37 @@ void OutputProcessColourOrder::Frame(uint8_t* buffer, size_t size, std::list<Out
 		}
     }
 }
+
+bool OutputProcessColourOrder::AddToPlan(OutputProcessPlan& plan, size_t size, std::list<OutputProcess*>& processes)
+{
+    if (!_enabled) return true;
+    if (_colourOrder == 123) return true;
+
+    // offset of the input channel each output channel takes its value from
+    int from[3];
+    switch (_colourOrder) {
+    case 132: from[0] = 0; from[1] = 2; from[2] = 1; break;
+    case 213: from[0] = 1; from[1] = 0; from[2] = 2; break;
+    case 231: from[0] = 1; from[1] = 2; from[2] = 0; break;
+    case 312: from[0] = 2; from[1] = 0; from[2] = 1; break;
+    case 321: from[0] = 2; from[1] = 1; from[2] = 0; break;
+    default:
+        // let Frame report the bad colour order
+        return false;
+    }
+
+    size_t sc = GetStartChannelAsNumber();
+    if (sc == 0 || sc > size) return true;
+
+    size_t nodes = std::min(_nodes, (size - (sc - 1)) / 3);
+
+    plan.BeginMove();
+    for (size_t i = 0; i < nodes; i++) {
+        size_t c = (sc - 1) + (i * 3);
+        plan.Move(c, c + from[0]);
+        plan.Move(c + 1, c + from[1]);
+        plan.Move(c + 2, c + from[2]);
+    }
+    plan.EndMove();
+    return true;
+}
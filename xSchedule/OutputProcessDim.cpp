@@ -9,6 +9,7 @@
  **************************************************************/
 
 #include "OutputProcessDim.h"
+#include "OutputProcessPlan.h"
 #include "OutputProcessExcludeDim.h"
 #include <wx/xml/xml.h>
 
@@ -106,3 +107,23 @@ void OutputProcessDim::Frame(uint8_t* buffer, size_t size, std::list<OutputProce
         }
     }
 }
+
+bool OutputProcessDim::AddToPlan(OutputProcessPlan& plan, size_t size, std::list<OutputProcess*>& processes)
+{
+    if (!_enabled) return true;
+    if (_dim == 100) return true;
+
+    size_t sc = GetStartChannelAsNumber();
+    if (sc == 0 || sc > size) return true;
+
+    size_t chs = std::min(_channels, size - (sc - 1));
+
+    auto ed = GetExcludeDim(processes, sc, sc + chs - 1);
+
+    for (size_t i = 0; i < chs; i++) {
+        if (ed.size() == 0 || !OutputProcessPlan::IsExcluded(ed, sc + i)) {
+            plan.ApplyLookup(sc - 1 + i, _dimTable);
+        }
+    }
+    return true;
+}
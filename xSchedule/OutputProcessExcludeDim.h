@@ -25,6 +25,7 @@ public:
     virtual ~OutputProcessExcludeDim() {}
     virtual wxXmlNode* Save() override;
     virtual void Frame(uint8_t* buffer, size_t size, std::list<OutputProcess*>& processes) override {}
+    virtual bool AddToPlan(OutputProcessPlan& plan, size_t size, std::list<OutputProcess*>& processes) override { return true; }
     virtual size_t GetP1() const override { return _channels; }
     virtual size_t GetP2() const override { return 0; }
     virtual std::string GetType() const override { return "Exclude Dim"; }
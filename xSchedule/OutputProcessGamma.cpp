@@ -9,6 +9,7 @@
  **************************************************************/
 
 #include "OutputProcessGamma.h"
+#include "OutputProcessPlan.h"
 #include "OutputProcessExcludeDim.h"
 #include <wx/xml/xml.h>
 
@@ -145,3 +146,35 @@ void OutputProcessGamma::Frame(uint8_t* buffer, size_t size, std::list<OutputPro
         }
     }
 }
+
+bool OutputProcessGamma::AddToPlan(OutputProcessPlan& plan, size_t size, std::list<OutputProcess*>& processes)
+{
+    if (!_enabled) return true;
+    if (_gamma == 1.0) return true;
+    if (_gamma == 0.00 && _gammaR == 1.0 && _gammaG == 1.0 && _gammaB == 1.0) return true;
+
+    size_t sc = GetStartChannelAsNumber();
+    if (sc == 0 || sc > size) return true;
+
+    size_t nodes = std::min(_nodes, (size - (sc - 1)) / 3);
+
+    auto ed = GetExcludeDim(processes, sc, sc + nodes * 3 - 1);
+
+    for (size_t i = 0; i < nodes; i++) {
+        size_t c = (sc - 1) + (i * 3);
+
+        // like Frame a node is excluded based on its first channel
+        if (ed.size() != 0 && OutputProcessPlan::IsExcluded(ed, c + 1)) continue;
+
+        if (_gamma != 0.0) {
+            plan.ApplyLookup(c, _gammaData);
+            plan.ApplyLookup(c + 1, _gammaData);
+            plan.ApplyLookup(c + 2, _gammaData);
+        } else {
+            plan.ApplyLookup(c, _gammaDataR);
+            plan.ApplyLookup(c + 1, _gammaDataG);
+            plan.ApplyLookup(c + 2, _gammaDataB);
+        }
+    }
+    return true;
+}
@@ -37,6 +37,7 @@ public:
     virtual ~OutputProcessGamma() {}
     virtual wxXmlNode* Save() override;
     virtual void Frame(uint8_t* buffer, size_t size, std::list<OutputProcess*>& processes) override;
+    virtual bool AddToPlan(OutputProcessPlan& plan, size_t size, std::list<OutputProcess*>& processes) override;
     virtual size_t GetP1() const override { return _nodes; }
     virtual size_t GetP2() const override { return 0; }
     virtual std::string GetType() const override { return "Gamma"; }
@@ -0,0 +1,257 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "OutputProcessPlan.h"
+#include "OutputProcess.h"
+#include "OutputProcessExcludeDim.h"
+
+#include <chrono>
+#include <cstring>
+
+#include <log4cpp/Category.hh>
+
+#pragma region FusedStage
+OutputProcessPlan::FusedStage::FusedStage(size_t size)
+{
+    _source.resize(size);
+    for (size_t i = 0; i < size; i++) {
+        _source[i] = i;
+    }
+    _lookup.resize(size, 0);
+    _tables.resize(256);
+    for (int i = 0; i < 256; i++) {
+        _tables[i] = i;
+    }
+}
+
+uint16_t OutputProcessPlan::FusedStage::Compose(uint16_t prior, const uint8_t* table)
+{
+    auto key = std::make_pair(prior, table);
+    auto it = _composed.find(key);
+    if (it != _composed.end()) return it->second;
+
+    uint16_t res = GetTableCount();
+    _tables.resize(_tables.size() + 256);
+    const uint8_t* p = _tables.data() + prior * 256;
+    uint8_t* n = _tables.data() + res * 256;
+    for (int i = 0; i < 256; i++) {
+        n[i] = table[p[i]];
+    }
+    _composed[key] = res;
+    return res;
+}
+
+// Trim the stage down to the channels it actually touches. Returns false if it turned out to do nothing.
+bool OutputProcessPlan::FusedStage::Finish()
+{
+    _composed.clear();
+
+    size_t first = _source.size();
+    size_t last = 0;
+    for (size_t i = 0; i < _source.size(); i++) {
+        if (_source[i] != i || _lookup[i] != 0) {
+            if (_runs.size() == 0 || _runs.back().second != i) {
+                _runs.push_back({ i, i + 1 });
+            } else {
+                _runs.back().second = i + 1;
+            }
+            first = std::min(first, std::min(i, (size_t)_source[i]));
+            last = std::max(last, std::max(i, (size_t)_source[i]));
+            if (_source[i] != i) _moves = true;
+        }
+    }
+
+    if (_runs.size() == 0) return false;
+
+    _first = first;
+    _last = last;
+
+    std::vector<uint32_t> source(_source.begin() + first, _source.begin() + last + 1);
+    for (auto& it : source) {
+        it -= first;
+    }
+    std::vector<uint16_t> lookup(_lookup.begin() + first, _lookup.begin() + last + 1);
+    _source.swap(source);
+    _lookup.swap(lookup);
+    _tables.shrink_to_fit();
+
+    if (_moves) {
+        _scratch.resize(_last - _first + 1);
+    }
+
+    return true;
+}
+
+void OutputProcessPlan::FusedStage::Frame(uint8_t* buffer)
+{
+    const uint8_t* tables = _tables.data();
+    const uint16_t* lookup = _lookup.data();
+
+    if (_moves) {
+        // moves read the values as they were before this stage so take a copy of the affected range
+        memcpy(_scratch.data(), buffer + _first, _scratch.size());
+        const uint8_t* in = _scratch.data();
+        const uint32_t* source = _source.data();
+        uint8_t* out = buffer + _first;
+        for (const auto& r : _runs) {
+            for (size_t i = r.first - _first; i < r.second - _first; i++) {
+                out[i] = tables[lookup[i] * 256 + in[source[i]]];
+            }
+        }
+    } else {
+        uint8_t* out = buffer + _first;
+        for (const auto& r : _runs) {
+            for (size_t i = r.first - _first; i < r.second - _first; i++) {
+                out[i] = tables[lookup[i] * 256 + out[i]];
+            }
+        }
+    }
+}
+#pragma endregion
+
+#pragma region Building
+OutputProcessPlan::FusedStage* OutputProcessPlan::GetStage()
+{
+    if (_building == nullptr) {
+        _building = std::make_unique<FusedStage>(_size);
+    }
+    return _building.get();
+}
+
+void OutputProcessPlan::FinishStage()
+{
+    wxASSERT(_pendingMoves.size() == 0);
+
+    if (_building == nullptr) return;
+
+    if (_building->Finish()) {
+        Step step;
+        step._stage = std::move(_building);
+        _steps.push_back(std::move(step));
+    }
+    _building = nullptr;
+}
+
+void OutputProcessPlan::ApplyLookup(size_t channel, const uint8_t* table)
+{
+    if (channel >= _size) return;
+
+    auto stage = GetStage();
+    if (stage->IsFull()) {
+        FinishStage();
+        stage = GetStage();
+    }
+    stage->_lookup[channel] = stage->Compose(stage->_lookup[channel], table);
+}
+
+void OutputProcessPlan::SetValue(size_t channel, uint8_t value)
+{
+    ApplyLookup(channel, _constants.data() + value * 256);
+}
+
+void OutputProcessPlan::BeginMove()
+{
+    wxASSERT(_pendingMoves.size() == 0);
+    auto stage = GetStage();
+    if (stage->IsFull()) {
+        FinishStage();
+    }
+}
+
+void OutputProcessPlan::Move(size_t to, size_t from)
+{
+    if (to >= _size || from >= _size) return;
+
+    // resolve against the state before this move batch started
+    auto stage = GetStage();
+    _pendingMoves.push_back({ to, { stage->_source[from], stage->_lookup[from] } });
+}
+
+void OutputProcessPlan::EndMove()
+{
+    auto stage = GetStage();
+    for (const auto& it : _pendingMoves) {
+        stage->_source[it.first] = it.second.first;
+        stage->_lookup[it.first] = it.second.second;
+    }
+    _pendingMoves.clear();
+}
+
+bool OutputProcessPlan::IsExcluded(const std::list<OutputProcessExcludeDim*>& excludes, size_t channel)
+{
+    for (const auto& it : excludes) {
+        if (channel >= it->GetFirstExcludeChannel() && channel <= it->GetLastExcludeChannel()) return true;
+    }
+    return false;
+}
+
+void OutputProcessPlan::Build(std::list<OutputProcess*>& processes, size_t size)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    _steps.clear();
+    _building = nullptr;
+    _pendingMoves.clear();
+    _size = size;
+    _fusedProcesses = 0;
+
+    if (_constants.size() == 0) {
+        _constants.resize(256 * 256);
+        for (int i = 0; i < 256; i++) {
+            memset(_constants.data() + i * 256, i, 256);
+        }
+    }
+
+    for (const auto& it : processes) {
+        if (it->AddToPlan(*this, size, processes)) {
+            _fusedProcesses++;
+        } else {
+            FinishStage();
+            Step step;
+            step._process = it;
+            _steps.push_back(std::move(step));
+        }
+    }
+    FinishStage();
+
+    size_t tables = 0;
+    for (const auto& it : _steps) {
+        if (it._stage != nullptr) tables += it._stage->GetTableCount();
+    }
+    logger_base.debug("Output processing plan built: %d processes, %d fused into %d steps using %d lookup tables.",
+                      (int)processes.size(), (int)_fusedProcesses, (int)_steps.size(), (int)tables);
+
+    _valid = true;
+}
+#pragma endregion
+
+void OutputProcessPlan::Frame(uint8_t* buffer, size_t size, std::list<OutputProcess*>& processes)
+{
+    if (processes.size() == 0) {
+        _lastFrameUS = 0;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (!_valid || size != _size) {
+        Build(processes, size);
+    }
+
+    for (const auto& it : _steps) {
+        if (it._stage != nullptr) {
+            it._stage->Frame(buffer);
+        } else {
+            it._process->Frame(buffer, size, processes);
+        }
+    }
+
+    _lastFrameUS = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <stdint.h>
+
+class OutputProcess;
+class OutputProcessExcludeDim;
+
+// The output process list compiled into as few passes over the buffer as possible.
+//
+// Processes which are a pure per channel value lookup (dim, gamma, set) or a pure channel move
+// (remap, colour order) describe themselves to the plan via OutputProcess::AddToPlan. Consecutive
+// runs of these are folded into a single fused stage where every channel is
+//
+//     out[c] = lookup[c][in[source[c]]]
+//
+// with lookups composed into shared 256 entry tables. Anything else (sustain, reverse, three to four ...)
+// is a barrier and runs its own Frame exactly as before.
+class OutputProcessPlan
+{
+    class FusedStage
+    {
+        friend class OutputProcessPlan;
+
+        // while building these cover the whole buffer ... once finished they only cover _first to _last
+        std::vector<uint32_t> _source;
+        std::vector<uint16_t> _lookup;
+        std::vector<std::pair<size_t, size_t>> _runs; // [start, end) of channels this stage writes
+        std::vector<uint8_t> _tables; // 256 entries per table ... table 0 is the identity
+        std::vector<uint8_t> _scratch;
+        size_t _first = 0;
+        size_t _last = 0;
+        bool _moves = false;
+
+        // (prior table, applied table) -> composed table
+        std::map<std::pair<uint16_t, const uint8_t*>, uint16_t> _composed;
+
+        uint16_t Compose(uint16_t prior, const uint8_t* table);
+
+    public:
+        FusedStage(size_t size);
+        bool IsFull() const { return GetTableCount() >= 0xFFFF; }
+        bool Finish();
+        void Frame(uint8_t* buffer);
+        size_t GetTableCount() const { return _tables.size() / 256; }
+    };
+
+    struct Step
+    {
+        OutputProcess* _process = nullptr;
+        std::unique_ptr<FusedStage> _stage;
+    };
+
+    std::vector<Step> _steps;
+    std::unique_ptr<FusedStage> _building;
+    std::vector<std::pair<size_t, std::pair<uint32_t, uint16_t>>> _pendingMoves;
+    std::vector<uint8_t> _constants;
+    size_t _size = 0;
+    std::atomic<bool> _valid = false;
+    std::atomic<long> _lastFrameUS = 0;
+    size_t _fusedProcesses = 0;
+
+    FusedStage* GetStage();
+    void FinishStage();
+    void Build(std::list<OutputProcess*>& processes, size_t size);
+
+public:
+
+    OutputProcessPlan() {}
+    virtual ~OutputProcessPlan() {}
+
+    // Call whenever any process is changed and before the process list is changed ... the plan runs the processes it
+    // could not fuse directly so it must not run again with a list whose processes have been deleted
+    void Invalidate() { _valid = false; }
+
+    // Runs all the output processing against the buffer rebuilding the plan first if required
+    void Frame(uint8_t* buffer, size_t size, std::list<OutputProcess*>& processes);
+
+    long GetLastFrameUS() const { return _lastFrameUS; }
+    size_t GetStepCount() const { return _steps.size(); }
+    size_t GetFusedProcessCount() const { return _fusedProcesses; }
+
+    // These are called by processes from within AddToPlan. Channels are zero based.
+    void ApplyLookup(size_t channel, const uint8_t* table);
+    void SetValue(size_t channel, uint8_t value);
+    void BeginMove();
+    void Move(size_t to, size_t from);
+    void EndMove();
+
+    // channel is one based to match the exclude dim ranges
+    static bool IsExcluded(const std::list<OutputProcessExcludeDim*>& excludes, size_t channel);
+};
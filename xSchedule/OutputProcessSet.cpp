@@ -9,6 +9,7 @@
  **************************************************************/
 
 #include "OutputProcessSet.h"
+#include "OutputProcessPlan.h"
 #include <wx/xml/xml.h>
 
 OutputProcessSet::OutputProcessSet(OutputManager* outputManager, wxXmlNode* node) : OutputProcess(outputManager, node)
@@ -54,3 +55,16 @@ void OutputProcessSet::Frame(uint8_t* buffer, size_t size, std::list<OutputProce
 
     memset(buffer + sc - 1, (uint8_t)_value, chs);
 }
+
+bool OutputProcessSet::AddToPlan(OutputProcessPlan& plan, size_t size, std::list<OutputProcess*>& processes)
+{
+    size_t sc = GetStartChannelAsNumber();
+    if (sc == 0 || sc > size) return true;
+
+    size_t chs = std::min(_channels, size - (sc - 1));
+
+    for (size_t i = 0; i < chs; i++) {
+        plan.SetValue(sc - 1 + i, (uint8_t)_value);
+    }
+    return true;
+}
@@ -29,6 +29,7 @@
 #include "AddReverseDialog.h"
 #include "GammaDialog.h"
 #include "OutputProcessGamma.h"
+#include "OutputProcessPlan.h"
 #include "DeadChannelDialog.h"
 #include "SustainDialog.h"
 
@@ -61,7 +62,7 @@ BEGIN_EVENT_TABLE(OutputProcessingDialog,wxDialog)
 	//*)
 END_EVENT_TABLE()
 
-OutputProcessingDialog::OutputProcessingDialog(wxWindow* parent, OutputManager* outputManager, std::list<OutputProcess*>* op,wxWindowID id,const wxPoint& pos,const wxSize& size) : _op(op)
+OutputProcessingDialog::OutputProcessingDialog(wxWindow* parent, OutputManager* outputManager, std::list<OutputProcess*>* op, OutputProcessPlan* plan,wxWindowID id,const wxPoint& pos,const wxSize& size) : _op(op), _plan(plan)
 {
     _outputManager = outputManager;
     _dragging = false;
@@ -349,6 +350,11 @@ void OutputProcessingDialog::OnButton_AddSetClick(wxCommandEvent& event)
 
 void OutputProcessingDialog::OnButton_OkClick(wxCommandEvent& event)
 {
+    // the plan holds the processes it could not fuse so it must not run again until it is rebuilt from the new list
+    if (_plan != nullptr) {
+        _plan->Invalidate();
+    }
+
     while (_op->size() > 0) {
         auto todelete = _op->front();
         _op->remove(todelete);
@@ -21,11 +21,13 @@
 
 class OutputProcess;
 class OutputManager;
+class OutputProcessPlan;
 
 class OutputProcessingDialog: public wxDialog
 {
     OutputManager* _outputManager;
     std::list<OutputProcess*>* _op;
+    OutputProcessPlan* _plan; // compiled from _op so it must be invalidated before the processes are deleted
     void ValidateWindow();
     void DeleteSelectedItem();
     bool EditSelectedItem();
@@ -36,7 +38,7 @@ class OutputProcessingDialog: public wxDialog
 
 	public:
 
-		OutputProcessingDialog(wxWindow* parent, OutputManager* outputManager, std::list<OutputProcess*>* op, wxWindowID id=wxID_ANY,const wxPoint& pos=wxDefaultPosition,const wxSize& size=wxDefaultSize);
+		OutputProcessingDialog(wxWindow* parent, OutputManager* outputManager, std::list<OutputProcess*>* op, OutputProcessPlan* plan, wxWindowID id=wxID_ANY,const wxPoint& pos=wxDefaultPosition,const wxSize& size=wxDefaultSize);
 		virtual ~OutputProcessingDialog();
 
 		//(*Declarations(OutputProcessingDialog)
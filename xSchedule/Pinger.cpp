@@ -13,72 +13,51 @@
 #include "../xLights/outputs/ControllerEthernet.h"
 #include "../xLights/outputs/ControllerSerial.h"
 #include "../xLights/outputs/OutputManager.h"
+#include "../xLights/utils/NetworkProbe.h"
 #include "events/ListenerManager.h"
 
 #include <atomic>
 
 #include <log4cpp/Category.hh>
 
+// if ping fails try this many times before setting the result
+#define PINGRETRIES 3
+
+// One thread starts every pinger's pings when they are due. The pings themselves are made by the network
+// probe so they all run at once rather than each pinger needing its own thread.
 class PingThread : public wxThread {
-    APinger* _pinger;
+    Pinger* _pinger;
     std::atomic<bool> _stop;
-    std::atomic<bool> _running;
 
 public:
-    PingThread(APinger* pinger) :
+    PingThread(Pinger* pinger) :
         wxThread(wxTHREAD_JOINABLE) {
         _pinger = pinger;
         _stop = false;
-        _running = false;
     }
 
     virtual ~PingThread() {
-        // static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-
-        if (_running && !_stop) {
-            _stop = true;
-        }
     }
 
     void Stop() {
         static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-        logger_base.debug("Asking pinging thread %s to stop", (const char*)_pinger->GetName().c_str());
+        logger_base.debug("Asking pinging thread to stop");
         _stop = true;
     }
 
-    // if ping fails try this many times before setting the result
-#define PINGRETRIES 3
-
     virtual void* Entry() override {
-        _running = true;
-
         static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-        logger_base.debug("Pinging thread %s started", (const char*)_pinger->GetName().c_str());
+        logger_base.debug("Pinging thread started");
 
         while (!_stop) {
-            auto res = Output::PINGSTATE::PING_UNKNOWN;
-
-            // if it previously failed ... only try once
-            int loops = PINGRETRIES;
-            if (_pinger->GetFailCount() > 0)
-                loops = 1;
-
-            for (int i = 0; !_stop && i < loops; i++) {
-                res = _pinger->Ping();
-                if (res != Output::PINGSTATE::PING_ALLFAILED) {
-                    break;
-                }
-            }
-            _pinger->SetPingResult(res);
+            _pinger->PingDue();
 
             int count = 0;
-
-            while (!_stop && count < _pinger->GetPingInterval() * 100) {
+            while (!_stop && count < 10) {
                 wxMilliSleep(10);
                 count++;
             }
         }
-        _running = false;
 
         return nullptr;
     }
@@ -97,9 +76,6 @@ APinger::APinger(ListenerManager* lm, Controller* controller) {
     _active = controller->IsActive();
     _lastResult = Output::PINGSTATE::PING_UNKNOWN;
     _failCount = 0;
-    _pingThread = new PingThread(this);
-    _pingThread->Create();
-    _pingThread->Run();
 }
 
 APinger::APinger(ListenerManager* lm, const std::string ip, const std::string why) {
@@ -112,9 +88,6 @@ APinger::APinger(ListenerManager* lm, const std::string ip, const std::string wh
     CheckLocal();
 
     _failCount = 0;
-    _pingThread = new PingThread(this);
-    _pingThread->Create();
-    _pingThread->Run();
 }
 
 APinger::~APinger() {
@@ -165,6 +138,62 @@ Output::PINGSTATE APinger::Ping() {
     return IPOutput::Ping(_ip, "");
 }
 
+bool APinger::IsDue() const {
+    return !_pinging && (_controller != nullptr || _ip != "") && (uint64_t)wxGetLocalTimeMillis().GetValue() >= _nextPing;
+}
+
+void APinger::StartPing() {
+    _pinging = true;
+
+    // if it previously failed ... only try once
+    _tries = _failCount > 0 ? 1 : PINGRETRIES;
+
+    if (_controller != nullptr && dynamic_cast<ControllerEthernet*>(_controller) == nullptr) {
+        // serial controllers have to open their port to ping so do that off the ping thread
+        _blockingPing = std::async(std::launch::async, [this]() {
+            auto res = Output::PINGSTATE::PING_UNKNOWN;
+            for (int i = 0; i < _tries; i++) {
+                res = Ping();
+                if (res != Output::PINGSTATE::PING_ALLFAILED) {
+                    break;
+                }
+            }
+            PingDone(res);
+        });
+        return;
+    }
+    SendPing();
+}
+
+void APinger::SendPing() {
+    std::string ip = _ip;
+    std::string proxy;
+    auto eth = dynamic_cast<ControllerEthernet*>(_controller);
+    if (eth != nullptr) {
+        // as ControllerEthernet::Ping does
+        if (eth->GetResolvedIP(false) == "MULTICAST") {
+            PingDone(Output::PINGSTATE::PING_UNAVAILABLE);
+            return;
+        }
+        ip = eth->GetResolvedIP(true);
+        if (ip.empty()) {
+            ip = eth->GetIP();
+        }
+        proxy = eth->GetFPPProxy();
+    }
+
+    // retries are made by PingAsync so nothing is resolved on the probe thread
+    IPOutput::PingAsync(this, ip, proxy, _tries, [this](Output::PINGSTATE result) {
+        PingDone(result);
+    });
+}
+
+void APinger::PingDone(Output::PINGSTATE result) {
+    SetPingResult(result);
+    _nextPing = wxGetLocalTimeMillis().GetValue() + GetPingInterval() * 1000;
+    _pinging = false;
+}
+
 void APinger::CheckLocal() {
     _isLocal = false;
 
@@ -197,12 +226,10 @@ std::string APinger::GetName() const {
 }
 
 void APinger::Stop() {
-    // tell it to stop ... but it may take a bit of time to stop
-    if (_pingThread != nullptr) {
-        _pingThread->Stop();
-        _pingThread->Delete();
-        delete _pingThread;
-        _pingThread = nullptr;
+    // once cancelled the network probe wont call us back
+    NetworkProbe::INSTANCE.Cancel(this);
+    if (_blockingPing.valid()) {
+        _blockingPing.wait();
     }
     _controller = nullptr;
     _ip = "";
@@ -242,21 +269,40 @@ Pinger::Pinger(ListenerManager* listenerManager, OutputManager* outputManager) {
             }
         }
     }
+
+    _pingThread = new PingThread(this);
+    _pingThread->Create();
+    _pingThread->Run();
 }
 
 Pinger::~Pinger() {
-    _stopping = true;
+    {
+        std::unique_lock<std::mutex> l(_lock);
+        _stopping = true;
+    }
+
+    if (_pingThread != nullptr) {
+        _pingThread->Stop();
+        _pingThread->Wait();
+        delete _pingThread;
+        _pingThread = nullptr;
+    }
 
-    // Tell them to stop first ... means when we come to delete them we may not need to wait as long
     for (const auto& it : _pingers) {
         it->Stop();
+        delete it;
     }
+}
 
-    // give the ping threads some CPU time
-    wxMilliSleep(100);
+void Pinger::PingDue() {
+    std::unique_lock<std::mutex> l(_lock);
+    if (_stopping)
+        return;
 
     for (const auto& it : _pingers) {
-        delete it;
+        if (it->IsDue()) {
+            it->StartPing();
+        }
     }
 }
 
@@ -266,6 +312,7 @@ void Pinger::AddIP(const std::string ip, const std::string why) {
     if (ip == "255.255.255.255")
         return;
 
+    std::unique_lock<std::mutex> l(_lock);
     for (const auto& it : _pingers) {
         if (it->GetIP() == ip)
             return;
@@ -275,6 +322,7 @@ void Pinger::AddIP(const std::string ip, const std::string why) {
 }
 
 void Pinger::RemoveNonOutputIPs() {
+    std::unique_lock<std::mutex> l(_lock);
     std::list<APinger*> newPingers;
     for (const auto& it : _pingers) {
         if (!it->IsOutput()) {
@@ -288,6 +336,7 @@ void Pinger::RemoveNonOutputIPs() {
 }
 
 APinger* Pinger::GetPinger(const std::string& ip) const {
+    std::unique_lock<std::mutex> l(_lock);
     if (_stopping)
         return nullptr;
 
@@ -300,6 +349,7 @@ APinger* Pinger::GetPinger(const std::string& ip) const {
 }
 
 APinger* Pinger::GetPingerByIndex(int index) const {
+    std::unique_lock<std::mutex> l(_lock);
     if (_stopping)
         return nullptr;
 
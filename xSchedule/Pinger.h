@@ -13,6 +13,8 @@
 #include <string>
 #include <list>
 #include <atomic>
+#include <future>
+#include <mutex>
 
 #include "../xLights/outputs/Output.h"
 
@@ -25,7 +27,6 @@ class Controller;
 
 class APinger
 {
-    PingThread* _pingThread = nullptr;
 	Controller* _controller = nullptr;
 	std::atomic<Output::PINGSTATE> _lastResult;
     std::string _ip;
@@ -34,8 +35,14 @@ class APinger
     std::atomic<int> _failCount;
     bool _isLocal = false;
     bool _active = true;
+    std::atomic<bool> _pinging = false;
+    std::atomic<int> _tries = 0;
+    std::atomic<uint64_t> _nextPing = 0;
+    std::future<void> _blockingPing;
 
     void CheckLocal();
+    void SendPing();
+    void PingDone(Output::PINGSTATE result);
 
     public:
 
@@ -48,6 +55,8 @@ class APinger
     bool GetPingResult(Output::PINGSTATE state) const;
     static std::string GetPingResultName(Output::PINGSTATE state);
     Output::PINGSTATE Ping();
+    bool IsDue() const;
+    void StartPing();
 	std::string GetName() const;
     int GetPingInterval() const { return PINGINTERVAL; }
     void Stop();
@@ -64,14 +73,17 @@ class Pinger
 {
     ListenerManager* _listenerManager = nullptr;
     std::list<APinger*> _pingers;
+    PingThread* _pingThread = nullptr;
+    mutable std::mutex _lock;
     bool _stopping = false;
 	
 	public:
 		Pinger(ListenerManager* listenerManager, OutputManager* outputManager);
 		virtual ~Pinger();
-        std::list<APinger*> GetPingers() const { if (_stopping) return std::list<APinger*>(); return _pingers; }
+        std::list<APinger*> GetPingers() const { std::unique_lock<std::mutex> l(_lock); if (_stopping) return std::list<APinger*>(); return _pingers; }
         void AddIP(const std::string ip, const std::string why);
         void RemoveNonOutputIPs();
         APinger* GetPinger(const std::string& ip) const;
         APinger* GetPingerByIndex(int index) const;
+        void PingDue();
 };
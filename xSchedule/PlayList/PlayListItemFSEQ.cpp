@@ -12,6 +12,7 @@
 #include "PlayListItemFSEQPanel.h"
 #include "../../xLights/AudioManager.h"
 #include "../../xLights/FSEQFile.h"
+#include "../FSEQReadAhead.h"
 #include "../../xLights/UtilFunctions.h"
 #include "../../xLights/outputs/OutputManager.h"
 #include "wx/xml/xml.h"
@@ -421,21 +422,10 @@ void PlayListItemFSEQ::Frame(uint8_t* buffer, size_t size, size_t ms, size_t fra
                 ms -= _delay;
 
                 int frame = ms / framems;
-                FSEQFile::FrameData* data = _fseqFile->getFrame(frame);
-                if (data != nullptr) {
-                    std::vector<uint8_t> buf(_fseqFile->getMaxChannel() + 1);
-                    data->readFrame(&buf[0], buf.size());
-                    size_t channelsPerFrame = (size_t)_fseqFile->getMaxChannel() + 1;
-                    if (_channels > 0)
-                        channelsPerFrame = std::min(_channels, (size_t)_fseqFile->getMaxChannel() + 1);
-                    if (_channels > 0) {
-                        long offset = GetStartChannelAsNumber() - 1;
-                        Blend(buffer, size, &buf[offset], channelsPerFrame, _applyMethod, offset);
-                    } else {
-                        Blend(buffer, size, &buf[0], channelsPerFrame, _applyMethod, 0);
-                    }
-                    delete data;
-                } else {
+                if (_readAhead == nullptr) {
+                    StartReadAhead();
+                }
+                if (!_readAhead->BlendFrame(frame, buffer, size, _applyMethod)) {
                     wxASSERT(false);
                 }
             }
@@ -457,6 +447,15 @@ void PlayListItemFSEQ::Restart() {
     _currentFrame = 0;
 }
 
+void PlayListItemFSEQ::StartReadAhead() {
+    if (_readAhead != nullptr) {
+        delete _readAhead;
+        _readAhead = nullptr;
+    }
+
+    _readAhead = FSEQReadAhead::Create(_fseqFile, GetStartChannelAsNumber(), _channels);
+}
+
 void PlayListItemFSEQ::Start(long stepLengthMS) {
     PlayListItem::Start(stepLengthMS);
 
@@ -464,9 +463,7 @@ void PlayListItemFSEQ::Start(long stepLengthMS) {
     // load the audio
     LoadFiles();
 
-    if (_fseqFile != nullptr) {
-        _fseqFile->prepareRead({ { 0, _fseqFile->getMaxChannel() + 1 } });
-    }
+    StartReadAhead();
 
     if (ControlsTiming() && _audioManager != nullptr) {
         if (_delay == 0) {
@@ -508,6 +505,11 @@ void PlayListItemFSEQ::Stop() {
 }
 
 void PlayListItemFSEQ::CloseFiles() {
+    if (_readAhead != nullptr) {
+        delete _readAhead;
+        _readAhead = nullptr;
+    }
+
     if (_fseqFile != nullptr) {
         delete _fseqFile;
         _fseqFile = nullptr;
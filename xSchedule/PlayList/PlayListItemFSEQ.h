@@ -19,6 +19,7 @@ class wxWindow;
 class AudioManager;
 class OutputManager;
 class FSEQFile;
+class FSEQReadAhead;
 
 #define FSEQFILES "FSEQ files|*.fseq|All files (*.*)|*.*"
 
@@ -30,6 +31,7 @@ protected:
     std::string _audioFile;
     bool _overrideAudio;
     FSEQFile* _fseqFile;
+    FSEQReadAhead* _readAhead = nullptr;
     AudioManager* _audioManager;
     size_t _durationMS;
     bool _controlsTimingCache;
@@ -44,6 +46,7 @@ protected:
 
     void LoadFiles();
     void CloseFiles();
+    void StartReadAhead();
     void FastSetDuration();
     void LoadAudio();
 
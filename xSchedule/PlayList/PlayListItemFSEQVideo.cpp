@@ -18,6 +18,7 @@
 #include "PlayerWindow.h"
 #include "../../xLights/AudioManager.h"
 #include "../../xLights/FSEQFile.h"
+#include "../FSEQReadAhead.h"
 #include "../../xLights/UtilFunctions.h"
 #include "../../xLights/VideoReader.h"
 #include "../../xLights/outputs/OutputManager.h"
@@ -520,21 +521,10 @@ void PlayListItemFSEQVideo::Frame(uint8_t* buffer, size_t size, size_t ms, size_
 
             if (_fseqFile != nullptr) {
                 int frame = adjustedMS / framems;
-                FSEQFile::FrameData* data = _fseqFile->getFrame(frame);
-                if (data != nullptr) {
-                    std::vector<uint8_t> buf(_fseqFile->getMaxChannel() + 1);
-                    data->readFrame(&buf[0], buf.size());
-                    size_t channelsPerFrame = (size_t)_fseqFile->getMaxChannel() + 1;
-                    if (_channels > 0)
-                        channelsPerFrame = std::min(_channels, (size_t)_fseqFile->getMaxChannel() + 1);
-                    if (_channels > 0) {
-                        long offset = GetStartChannelAsNumber() - 1;
-                        Blend(buffer, size, &buf[offset], channelsPerFrame, _applyMethod, offset);
-                    } else {
-                        Blend(buffer, size, &buf[0], channelsPerFrame, _applyMethod, 0);
-                    }
-                    delete data;
-                } else {
+                if (_readAhead == nullptr) {
+                    StartReadAhead();
+                }
+                if (!_readAhead->BlendFrame(frame, buffer, size, _applyMethod)) {
                     wxASSERT(false);
                 }
             }
@@ -589,7 +579,7 @@ void PlayListItemFSEQVideo::Frame(uint8_t* buffer, size_t size, size_t ms, size_
                         adjustedMS -= videoLength;
                     }
 
-                    _window->SetImage(CachedVideoReader::FadeImage(_cachedVideoReader->GetNextFrame(adjustedMS), brightness));
+                    _window->SetImage(_cachedVideoReader->GetNextFrame(adjustedMS), _cachedVideoReader->GetWidth(), _cachedVideoReader->GetHeight(), brightness);
                 }
             } else {
                 if (_videoReader != nullptr) {
@@ -622,6 +612,15 @@ void PlayListItemFSEQVideo::Restart() {
     _currentFrame = 0;
 }
 
+void PlayListItemFSEQVideo::StartReadAhead() {
+    if (_readAhead != nullptr) {
+        delete _readAhead;
+        _readAhead = nullptr;
+    }
+
+    _readAhead = FSEQReadAhead::Create(_fseqFile, GetStartChannelAsNumber(), _channels);
+}
+
 void PlayListItemFSEQVideo::Start(long stepLengthMS) {
     PlayListItem::Start(stepLengthMS);
 
@@ -633,9 +632,7 @@ void PlayListItemFSEQVideo::Start(long stepLengthMS) {
     // load the audio
     LoadFiles(true);
 
-    if (_fseqFile != nullptr) {
-        _fseqFile->prepareRead({ { 0, _fseqFile->getMaxChannel() + 1 } });
-    }
+    StartReadAhead();
 
     _currentFrame = 0;
     if (ControlsTiming() && _audioManager != nullptr) {
@@ -738,6 +735,11 @@ void PlayListItemFSEQVideo::Stop() {
 }
 
 void PlayListItemFSEQVideo::CloseFiles() {
+    if (_readAhead != nullptr) {
+        delete _readAhead;
+        _readAhead = nullptr;
+    }
+
     if (_fseqFile != nullptr) {
         delete _fseqFile;
         _fseqFile = nullptr;
@@ -24,6 +24,7 @@ class VideoReader;
 class CachedVideoReader;
 class OutputManager;
 class FSEQFile;
+class FSEQReadAhead;
 class ScheduleOptions;
 
 class PlayListItemFSEQVideo : public PlayListItem {
@@ -36,6 +37,7 @@ protected:
     bool _topMost = false;
     bool _suppressVirtualMatrix = false;
     FSEQFile* _fseqFile = nullptr;
+    FSEQReadAhead* _readAhead = nullptr;
     AudioManager* _audioManager = nullptr;
     size_t _durationMS = 0;
     size_t _videoLength = 0;
@@ -63,6 +65,7 @@ protected:
 
     void LoadFiles(bool doCache);
     void CloseFiles();
+    void StartReadAhead();
     void FastSetDuration();
     void LoadAudio();
 
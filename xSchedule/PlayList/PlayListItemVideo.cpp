@@ -295,7 +295,7 @@ void PlayListItemVideo::Frame(uint8_t* buffer, size_t size, size_t ms, size_t fr
                         adjustedMS -= videoLength;
                     }
 
-                    if (_window != nullptr) _window->SetImage(CachedVideoReader::FadeImage(_cachedVideoReader->GetNextFrame(adjustedMS), brightness));
+                    if (_window != nullptr) _window->SetImage(_cachedVideoReader->GetNextFrame(adjustedMS), _cachedVideoReader->GetWidth(), _cachedVideoReader->GetHeight(), brightness);
                 }
             }
             else {
@@ -12,6 +12,9 @@
 #include <wx/stopwatch.h>
 #include <wx/display.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include "PlayerWindow.h"
 #include "../VirtualMatrix.h"
 
@@ -170,6 +173,41 @@ void PlayerWindow::SetImage(const wxImage& image)
     }
 }
 
+void PlayerWindow::SetImage(const uint8_t* data, int width, int height, int brightness)
+{
+    if (width <= 0 || height <= 0) return;
+
+    std::unique_lock<std::timed_mutex> lock(_mutex);
+
+    size_t size = (size_t)width * height * 3;
+    bool resized = _inputImage.GetWidth() != width || _inputImage.GetHeight() != height;
+    if (resized) {
+        _inputImage.Destroy();
+        _inputImage.Create(width, height, true);
+    }
+    uint8_t* target = _inputImage.GetData();
+
+    if (data == nullptr || brightness <= 0) {
+        // only repaint if it was not already black
+        if (!resized && std::all_of(target, target + size, [](uint8_t c) { return c == 0; })) return;
+        memset(target, 0x00, size);
+    } else if (brightness >= 100) {
+        if (!resized && memcmp(target, data, size) == 0) return;
+        memcpy(target, data, size);
+    } else {
+        uint8_t btable[256];
+        for (int i = 0; i < 256; i++) {
+            btable[i] = i * brightness / 100;
+        }
+        for (size_t i = 0; i < size; i++) {
+            target[i] = btable[data[i]];
+        }
+    }
+
+    _imageChanged = true;
+    Refresh(false); // force a paint on the main thread
+}
+
 void PlayerWindow::Paint(wxPaintEvent& event)
 {
     wxASSERT(wxThread::IsMain());
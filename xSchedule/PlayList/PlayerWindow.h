@@ -36,6 +36,8 @@ class PlayerWindow: public wxFrame
 		PlayerWindow(wxWindow* parent, bool topMost, wxImageResizeQuality quality = wxIMAGE_QUALITY_HIGH, int swsQuality = -1, wxWindowID id=wxID_ANY,const wxPoint& pos=wxDefaultPosition,const wxSize& size=wxDefaultSize);
 		virtual ~PlayerWindow();
         void SetImage(const wxImage& image);
+        // copies packed RGB straight into the window applying the brightness on the way ... data nullptr shows black
+        void SetImage(const uint8_t* data, int width, int height, int brightness = 100);
 
 	private:
 
@@ -394,6 +394,7 @@ ScheduleManager::~ScheduleManager() {
         _eventPlayLists.pop_front();
     }
 
+    _outputProcessPlan.Invalidate();
     while (_outputProcessing.size() > 0) {
         auto toremove = _outputProcessing.front();
         _outputProcessing.remove(toremove);
@@ -641,9 +642,7 @@ void ScheduleManager::AllOff() {
     }
 
     // apply any output processing
-    for (const auto& it : _outputProcessing) {
-        it->Frame(_buffer, _outputManager->GetTotalChannels(), _outputProcessing);
-    }
+    _outputProcessPlan.Frame(_buffer, _outputManager->GetTotalChannels(), _outputProcessing);
 
     // if (_brightness < 100)
     //{
@@ -654,7 +653,7 @@ void ScheduleManager::AllOff() {
         it->Frame(_buffer, _outputManager->GetTotalChannels());
     }
 
-    _outputManager->SetManyChannels(0, _buffer, _outputManager->GetTotalChannels());
+    _outputManager->SetFrame(_buffer, _outputManager->GetTotalChannels());
     _outputManager->EndFrame();
 }
 
@@ -730,9 +729,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame) {
         }
 
         // apply any output processing
-        for (const auto& it : _outputProcessing) {
-            it->Frame(_buffer, totalChannels, _outputProcessing);
-        }
+        _outputProcessPlan.Frame(_buffer, totalChannels, _outputProcessing);
 
         if (outputframe && _brightness < 100) {
             ApplyBrightness();
@@ -743,7 +740,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame) {
         }
 
         if (outputframe) {
-            _outputManager->SetManyChannels(0, _buffer, totalChannels);
+            _outputManager->SetFrame(_buffer, totalChannels);
             _outputManager->EndFrame();
         }
     } else {
@@ -842,9 +839,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame) {
                 logger_frame.debug("Frame: Overlay data done %ldms", sw.Time());
 
                 // apply any output processing
-                for (auto it = _outputProcessing.begin(); it != _outputProcessing.end(); ++it) {
-                    (*it)->Frame(_buffer, totalChannels, _outputProcessing);
-                }
+                _outputProcessPlan.Frame(_buffer, totalChannels, _outputProcessing);
 
                 logger_frame.debug("Frame: Output processing done %ldms", sw.Time());
 
@@ -864,7 +859,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame) {
 
                 logger_frame.debug("Frame: Listening done %ldms", sw.Time());
 
-                _outputManager->SetManyChannels(0, _buffer, totalChannels);
+                _outputManager->SetFrame(_buffer, totalChannels);
 
                 logger_frame.debug("Frame: Data set %ldms", sw.Time());
 
@@ -929,9 +924,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame) {
                 }
 
                 // apply any output processing
-                for (const auto& it : _outputProcessing) {
-                    it->Frame(_buffer, totalChannels, _outputProcessing);
-                }
+                _outputProcessPlan.Frame(_buffer, totalChannels, _outputProcessing);
 
                 if (outputframe && _brightness < 100) {
                     ApplyBrightness();
@@ -944,7 +937,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame) {
                 _listenerManager->ProcessFrame(_buffer, totalChannels);
 
                 if (outputframe) {
-                    _outputManager->SetManyChannels(0, _buffer, totalChannels);
+                    _outputManager->SetFrame(_buffer, totalChannels);
                     _outputManager->EndFrame();
                 }
             } else {
@@ -971,9 +964,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame) {
                     frame->ManipulateBuffer(_buffer, totalChannels);
 
                     // apply any output processing
-                    for (auto it2 = _outputProcessing.begin(); it2 != _outputProcessing.end(); ++it2) {
-                        (*it2)->Frame(_buffer, totalChannels, _outputProcessing);
-                    }
+                    _outputProcessPlan.Frame(_buffer, totalChannels, _outputProcessing);
 
                     if (outputframe && _brightness < 100) {
                         ApplyBrightness();
@@ -984,7 +975,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame) {
                     }
 
                     if (outputframe) {
-                        _outputManager->SetManyChannels(0, _buffer, totalChannels);
+                        _outputManager->SetFrame(_buffer, totalChannels);
                         _outputManager->EndFrame();
                     }
 
@@ -3031,6 +3022,7 @@ bool ScheduleManager::Query(const wxString& command, const wxString& parameters,
             data = "{\"status\":\"idle\",\"outputtolights\":\"" + std::string(_outputManager->IsOutputting() ? "true" : "false") +
                    "\",\"volume\":\"" + wxString::Format(wxT("%i"), GetVolume()) +
                    "\",\"brightness\":\"" + wxString::Format(wxT("%i"), GetBrightness()) +
+                   "\",\"outputprocessingus\":\"" + wxString::Format(wxT("%ld"), GetOutputProcessingUS()) +
                    "\",\"ip\":\"" + ip +
                    "\",\"version\":\"" + xlights_version_string +
                    "\",\"reference\":\"" + reference +
@@ -3089,6 +3081,7 @@ bool ScheduleManager::Query(const wxString& command, const wxString& parameters,
                    "\",\"queuelength\":\"" + wxString::Format(wxT("%i"), (long)_queuedSongs->GetSteps().size()) +
                    "\",\"volume\":\"" + wxString::Format(wxT("%i"), GetVolume()) +
                    "\",\"brightness\":\"" + wxString::Format(wxT("%i"), GetBrightness()) +
+                   "\",\"outputprocessingus\":\"" + wxString::Format(wxT("%ld"), GetOutputProcessingUS()) +
                    "\",\"time\":\"" + wxDateTime::Now().Format("%Y-%m-%d %H:%M:%S") +
                    "\",\"ip\":\"" + ip +
                    "\",\"reference\":\"" + reference +
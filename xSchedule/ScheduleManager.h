@@ -12,6 +12,7 @@
 
 #include "Blend.h"
 #include "CommandManager.h"
+#include "OutputProcessPlan.h"
 #include "Schedule.h"
 #include "SyncManager.h"
 #include "wxMIDI/src/wxMidi.h"
@@ -99,6 +100,7 @@ class ScheduleManager {
     wxDatagramSocket* _artNetSyncMaster = nullptr;
     wxDatagramSocket* _fppSyncMasterUnicast = nullptr;
     std::list<OutputProcess*> _outputProcessing;
+    OutputProcessPlan _outputProcessPlan;
     ListenerManager* _listenerManager = nullptr;
     XyzzyBase* _xyzzy = nullptr;
     wxDateTime _lastXyzzyCommand;
@@ -181,6 +183,9 @@ public:
     std::list<OutputProcess*>* GetOutputProcessing() {
         return &_outputProcessing;
     }
+    OutputProcessPlan* GetOutputProcessPlan() {
+        return &_outputProcessPlan;
+    }
     void WebRequestReceived() {
         _webRequestToggle = !_webRequestToggle;
     }
@@ -251,8 +256,15 @@ public:
         _changeCount++;
     };
     void OutputProcessingChanged() {
+        _outputProcessPlan.Invalidate();
         _changeCount++;
     };
+    long GetOutputProcessingUS() const {
+        return _outputProcessPlan.GetLastFrameUS();
+    }
+    bool HasOutputProcessing() const {
+        return _outputProcessing.size() != 0;
+    }
     bool Action(const wxString& label, PlayList* selplaylist, PlayListStep* selplayliststep, Schedule* selschedule, size_t& rate, wxString& msg);
     bool Action(const wxString& command, const wxString& parameters, const wxString& data, PlayList* selplaylist, PlayListStep* selplayliststep, Schedule* selschedule, size_t& rate, wxString& msg);
     bool Query(const wxString& command, const wxString& parameters, wxString& data, wxString& msg, const wxString& ip, const wxString& reference);
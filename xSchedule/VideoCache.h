@@ -10,28 +10,51 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
+#include <vector>
 #include <wx/wx.h>
 #include <string>
-#include <map>
-#include "../xLights/JobPool.h"
 
 class VideoReader;
-class VideoCacheItem;
-class CVRThread;
 struct AVFrame;
 
+// Decodes and scales a video on a background thread into a fixed ring of preallocated RGB frame
+// buffers running ahead of the play position so playback never allocates, rescales or waits on
+// the decoder in the frame timer.
 class CachedVideoReader
 {
-    std::map<long, wxImage> _cache;
-    std::mutex _cacheAccess;
-    int _maxItems;
-    CVRThread* _thread;
-    int _frameTime;
+    struct Slot
+    {
+        std::vector<uint8_t> _data;
+        long _frame = -1;
+        bool _ready = false;
+    };
+    std::vector<Slot> _slots;
+
+    std::mutex _lock;
+    std::condition_variable _signal;
+    std::thread _thread;
+    bool _stop = false;
+    long _wanted = 0;
+
+    VideoReader* _videoReader = nullptr; // only used by the decode thread once it is running
     std::string _videoFile;
     wxSize _size;
-    long _lengthMS;
-    bool _done;
+    int _width = 0;
+    int _height = 0;
+    int _frameTime = 50;
+    long _lengthMS = 0;
+
+    std::atomic<long> _frames = 0;
+    std::atomic<long> _waits = 0;
+    std::atomic<long> _late = 0;
+
+    long GetLastFrame() const { return _lengthMS / _frameTime; }
+    int FindSlot(long frame) const;
+    void Run();
 
 public:
     CachedVideoReader(const std::string& videoFile, long startMillisecond, int frameTime, const wxSize& size, bool keepAspectRatio);
@@ -40,13 +63,18 @@ public:
     static wxImage CreateImageFromFrame(AVFrame* frame, const wxSize& size);
     static wxImage FadeImage(const wxImage& image, int brightness);
 
-    bool HasFrame(long millisecond);
-    void CacheImage(long millisecond, const wxImage& image);
-    void SetLengthMS(long lengthMS);
-    void Done();
-    void PurgeCachePriorTo(long start);
-
     long GetLengthMS() const { return _lengthMS; };
-    wxImage GetNextFrame(long ms);
-};
+    int GetWidth() const { return _width; }
+    int GetHeight() const { return _height; }
 
+    // Returns the frame for this time as packed RGB rows of GetWidth() x GetHeight() or nullptr if
+    // there is no frame or it could not be decoded in time. The pointer remains valid until the
+    // next call to GetNextFrame and must not be written to.
+    const uint8_t* GetNextFrame(long ms);
+
+    long GetFrames() const { return _frames; }
+    // frames the caller had to wait for because the decoder was not far enough ahead
+    long GetWaits() const { return _waits; }
+    // frames the decoder did not deliver in time so a blank frame was shown
+    long GetLateFrames() const { return _late; }
+};
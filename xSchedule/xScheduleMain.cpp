@@ -3136,7 +3136,7 @@ void xScheduleFrame::EditSelectedItem(bool forceadvanced)
 
 void xScheduleFrame::OnMenu_OutputProcessingSelected(wxCommandEvent& event)
 {
-    OutputProcessingDialog dlg(this, __schedule->GetOutputManager(), __schedule->GetOutputProcessing());
+    OutputProcessingDialog dlg(this, __schedule->GetOutputManager(), __schedule->GetOutputProcessing(), __schedule->GetOutputProcessPlan());
 
     if (dlg.ShowModal() == wxID_OK)
     {
@@ -3250,7 +3250,11 @@ void xScheduleFrame::UpdateUI(bool force)
 
     if (!minimiseUIUpdates) {
 
-        StaticText_PacketsPerSec->SetLabel(wxString::Format("Packets/Sec: %d", __schedule->GetPPS()));
+        if (__schedule->HasOutputProcessing()) {
+            StaticText_PacketsPerSec->SetLabel(wxString::Format("Packets/Sec: %d Output Processing: %.2fms", __schedule->GetPPS(), (double)__schedule->GetOutputProcessingUS() / 1000.0));
+        } else {
+            StaticText_PacketsPerSec->SetLabel(wxString::Format("Packets/Sec: %d", __schedule->GetPPS()));
+        }
 
         if (__schedule->GetWebRequestToggle()) {
             if (!_webIconDisplayed) {